@@ -36,14 +36,16 @@ class Codegen {
 
   bool initialize(
       const std::string_view& codegenOptionsJson,
-      bool lazyLoading = true) {
+      bool lazyLoading = true,
+      bool backgroundCompilation = false) {
     LOG(INFO) << "Codegen disabled, doing nothing : " << std::endl;
     return true;
   }
 
   bool initializeFromFile(
       const std::filesystem::path& codegenOptionsJsonFile,
-      bool lazyLoading = true) {
+      bool lazyLoading = true,
+      bool backgroundCompilation = false) {
     LOG(INFO) << "Codegen disabled, doing nothing : " << std::endl;
     return true;
   };
@@ -158,3 +158,25 @@ TEST(SimpleLRUCache, insertLargerThanCacheFails) {
   ASSERT_FALSE(cache.add(123, value, 11));
   delete value;
 }
+
+TEST(SimpleLRUCache, erase) {
+  SimpleLRUCache<int, int> cache(10);
+
+  ASSERT_TRUE(cache.add(1, new int(11), 4));
+  ASSERT_TRUE(cache.add(2, new int(22), 4));
+  ASSERT_FALSE(cache.erase(3));
+
+  ASSERT_NE(cache.get(1), nullptr);
+  ASSERT_FALSE(cache.erase(1));
+  cache.release(1);
+  ASSERT_TRUE(cache.erase(1));
+  ASSERT_EQ(cache.get(1), nullptr);
+  ASSERT_EQ(cache.currentSize(), 4);
+
+  // The key can be added again once erased.
+  ASSERT_TRUE(cache.add(1, new int(33), 4));
+  int* value = cache.get(1);
+  ASSERT_NE(value, nullptr);
+  ASSERT_EQ(*value, 33);
+  cache.release(1);
+}
@@ -18,7 +18,9 @@
 
 #include <array>
 #include <atomic>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <optional>
 
 #include "velox/common/base/Exceptions.h"
@@ -37,6 +39,9 @@ struct MemoryUsageConfig {
   std::optional<int64_t> maxUserMemory;
   std::optional<int64_t> maxSystemMemory;
   std::optional<int64_t> maxTotalMemory;
+  // If set, the tracker reserves from its parent in multiples of this
+  // many bytes and propagates only changes that cross a multiple.
+  std::optional<int64_t> reservationChunkBytes;
 };
 
 struct MemoryUsageConfigBuilder {
@@ -60,6 +65,11 @@ struct MemoryUsageConfigBuilder {
     return *this;
   }
 
+  MemoryUsageConfigBuilder& reservationChunkBytes(int64_t bytes) {
+    config.reservationChunkBytes = bytes;
+    return *this;
+  }
+
   MemoryUsageConfig build() {
     return config;
   }
@@ -83,9 +93,24 @@ struct MemoryUsageConfigBuilder {
 // when above reservation counts as free up to the reservation size. Freeing
 // data within the reservation drops the usage but not the reservation.
 // release() frees unused reserved capacity.
+//
+// A tracker may also be configured with a reservation chunk size. Such a
+// tracker, typically one per Driver, counts every update in its own
+// counters but takes memory from its parent in whole chunks and returns
+// it only when more than two chunks are unused. Updates that fit in the
+// chunks held do not touch the counters of the ancestors, which are
+// shared by all Drivers of a query. Limits of the ancestors are enforced
+// at chunk granularity.
 class MemoryUsageTracker
     : public std::enable_shared_from_this<MemoryUsageTracker> {
  public:
+  // Called when increasing the usage by 'size' bytes would exceed the
+  // limit of 'exceeded', which is the tracker making the update or
+  // one of its ancestors. The callback may free memory elsewhere in
+  // the tree and returns true if the update should be retried.
+  using GrowCallback =
+      std::function<bool(MemoryUsageTracker& exceeded, int64_t size)>;
+
   // Create default usage tracker. It aggregates both 'user' and 'system' memory
   // from its children and tracks the allocations as 'user' memory. It returns a
   // 'root' tracker.
@@ -110,6 +135,15 @@ class MemoryUsageTracker
             .build());
   }
 
+  ~MemoryUsageTracker() {
+    // Return the unused part of the chunks. Memory still in use stays
+    // counted in the ancestors as for a tracker without chunks.
+    auto available = availableChunkBytes_.load();
+    if (parent_ && available > 0) {
+      parent_->update(type_, -available);
+    }
+  }
+
   // Increments the reservation for 'this' so that we can allocate
   // at least 'size' bytes on top of the current allocation. This is
   // used when an a memory user needs to allocate more memory and
@@ -124,7 +158,7 @@ class MemoryUsageTracker
   void reserve(int64_t size) {
     int64_t actualSize = size - (reservation_ - usedReservation_);
     if (actualSize > 0) {
-      update(type_, actualSize);
+      updateOrGrow(actualSize);
       reservation_ += actualSize;
     }
   }
@@ -147,7 +181,7 @@ class MemoryUsageTracker
   void update(int64_t size) {
     if (int64_t increment = updateUsed(size)) {
       try {
-        update(type_, increment);
+        updateOrGrow(increment);
       } catch (const VeloxRuntimeError& e) {
         // Revert the increment to reservation usage.
         usedReservation_.fetch_sub(size);
@@ -179,6 +213,29 @@ class MemoryUsageTracker
     return std::max<int64_t>(0, reservation_ - usedReservation_);
   }
 
+  // Returns the bytes taken from the parent in chunks that are not used
+  // by 'this' or its descendants.
+  int64_t getAvailableChunkBytes() const {
+    return std::max<int64_t>(0, availableChunkBytes_);
+  }
+
+  // Returns all unused chunk bytes to the parent. Used when memory is
+  // reclaimed so that what was freed is available to the rest of the
+  // tree right away.
+  void releaseAvailableChunks() {
+    if (!reservationChunk_) {
+      return;
+    }
+    std::lock_guard<std::mutex> l(chunkMutex_);
+    auto available = availableChunkBytes_.load();
+    while (available > 0) {
+      if (availableChunkBytes_.compare_exchange_weak(available, 0)) {
+        parent_->update(type_, -available);
+        return;
+      }
+    }
+  }
+
   int64_t getNumAllocs() const {
     return numAllocs_[static_cast<int>(UsageType::kTotalMem)];
   }
@@ -196,6 +253,25 @@ class MemoryUsageTracker
         config);
   }
 
+  // Sets the callback to run when an update of 'this' or a descendant
+  // exceeds a limit. The callback of the nearest tracker on the path
+  // to the root is used. Must be set before 'this' is used by
+  // multiple threads.
+  void setGrowCallback(GrowCallback callback) {
+    growCallback_ = std::move(callback);
+  }
+
+  // Returns true if 'ancestor' is 'this' or on the path from 'this' to
+  // the root.
+  bool isDescendantOf(const MemoryUsageTracker* ancestor) const {
+    for (auto* tracker = this; tracker; tracker = tracker->parent_.get()) {
+      if (tracker == ancestor) {
+        return true;
+      }
+    }
+    return false;
+  }
+
  private:
   enum class UsageType : int { kUserMem = 0, kSystemMem = 1, kTotalMem = 2 };
   std::shared_ptr<MemoryUsageTracker> parent_;
@@ -209,6 +285,21 @@ class MemoryUsageTracker
   int64_t reservation_{0};
   std::atomic<int64_t> usedReservation_{};
 
+  GrowCallback growCallback_;
+
+  // Size of the chunks in which 'this' reserves from 'parent_'. 0 means
+  // that every update is propagated.
+  const int64_t reservationChunk_;
+
+  // Bytes of 'type_' counted in 'parent_' but not yet used by 'this'.
+  // Negative while an update that exceeds the chunks held is being
+  // propagated.
+  std::atomic<int64_t> availableChunkBytes_{0};
+
+  // Serializes taking and returning chunks. Not held for updates that
+  // fit in the chunks held.
+  std::mutex chunkMutex_;
+
   explicit MemoryUsageTracker(
       const std::shared_ptr<MemoryUsageTracker>& parent,
       UsageType type,
@@ -218,7 +309,11 @@ class MemoryUsageTracker
         maxMemory_{
             config.maxUserMemory.value_or(kMaxMemory),
             config.maxSystemMemory.value_or(kMaxMemory),
-            config.maxTotalMemory.value_or(kMaxMemory)} {}
+            config.maxTotalMemory.value_or(kMaxMemory)},
+        reservationChunk_(
+            parent ? config.reservationChunkBytes.value_or(0) : 0) {
+    VELOX_CHECK_GE(reservationChunk_, 0);
+  }
 
   static std::shared_ptr<MemoryUsageTracker> create(
       const std::shared_ptr<MemoryUsageTracker>& parent,
@@ -234,11 +329,57 @@ class MemoryUsageTracker
     }
   }
 
+  // Increments the usage of 'type_' by 'size'. If a limit is exceeded
+  // and there is a GrowCallback that manages to free memory, retries
+  // once.
+  void updateOrGrow(int64_t size) {
+    try {
+      update(type_, size);
+    } catch (const VeloxRuntimeError& e) {
+      if (size <= 0 || e.errorCode() != error_code::kMemCapExceeded) {
+        throw;
+      }
+      auto* callback = findGrowCallback();
+      if (!callback || !(*callback)(*exceededTracker(type_, size), size)) {
+        throw;
+      }
+      update(type_, size);
+    }
+  }
+
+  const GrowCallback* findGrowCallback() const {
+    for (auto* tracker = this; tracker; tracker = tracker->parent_.get()) {
+      if (tracker->growCallback_) {
+        return &tracker->growCallback_;
+      }
+    }
+    return nullptr;
+  }
+
+  // Returns the tracker closest to the root whose limit would be
+  // exceeded by adding 'size' bytes of 'type'. Returns the root if
+  // concurrent frees made room in the meantime.
+  MemoryUsageTracker* exceededTracker(UsageType type, int64_t size) {
+    MemoryUsageTracker* exceeded = nullptr;
+    MemoryUsageTracker* root = this;
+    for (auto* tracker = this; tracker; tracker = tracker->parent_.get()) {
+      root = tracker;
+      auto current = tracker->currentUsageInBytes_[static_cast<int>(type)] +
+          size;
+      auto total = tracker->getCurrentTotalBytes() + size;
+      if (current > tracker->maxMemory_[static_cast<int>(type)] ||
+          total > tracker->maxMemory_[static_cast<int>(UsageType::kTotalMem)]) {
+        exceeded = tracker;
+      }
+    }
+    return exceeded ? exceeded : root;
+  }
+
   void update(UsageType type, int64_t size) {
     // Update parent first. If one of the ancestor's limits are exceeded, it
     // will throw VeloxMemoryCapExceeded exception.
     if (parent_) {
-      parent_->update(type, size);
+      updateParent(type, size);
     }
 
     auto newPeak = currentUsageInBytes_[static_cast<int>(type)].fetch_add(
@@ -265,7 +406,7 @@ class MemoryUsageTracker
       // Exceeded the limit. Fail allocation after reverting changes to
       // parent and currentUsageInBytes_.
       if (parent_) {
-        parent_->update(type, -size);
+        updateParent(type, -size);
       }
       currentUsageInBytes_[static_cast<int>(type)].fetch_add(
           -size, std::memory_order_relaxed);
@@ -277,6 +418,65 @@ class MemoryUsageTracker
     maySetMax(UsageType::kTotalMem, total);
   }
 
+  // Propagates an update of 'size' bytes of 'type' to 'parent_'. With
+  // reservation chunks, only updates that leave no available chunk
+  // bytes or more than two unused chunks reach 'parent_'.
+  void updateParent(UsageType type, int64_t size) {
+    if (!reservationChunk_ || type != type_) {
+      parent_->update(type, size);
+      return;
+    }
+    auto available = availableChunkBytes_.fetch_sub(size) - size;
+    if (available >= 0 && available <= 2 * reservationChunk_) {
+      return;
+    }
+    updateChunks(type, size);
+  }
+
+  // Takes chunks from 'parent_' to cover a negative
+  // 'availableChunkBytes_' or returns all but one unused chunk. 'size' is
+  // the update that found the chunks out of range. If 'parent_' cannot
+  // grow, 'size' is reverted and the exception is rethrown.
+  void updateChunks(UsageType type, int64_t size) {
+    std::lock_guard<std::mutex> l(chunkMutex_);
+    auto available = availableChunkBytes_.load();
+    if (available < 0) {
+      if (size <= 0) {
+        // A concurrent allocation made the shortfall and covers it.
+        return;
+      }
+      auto needed = -available;
+      auto increment =
+          (needed + reservationChunk_ - 1) / reservationChunk_ *
+          reservationChunk_;
+      try {
+        parent_->update(type, increment);
+      } catch (const VeloxRuntimeError&) {
+        // A whole chunk does not fit. Try the exact shortfall so that
+        // limits are not made stricter by the chunk size.
+        try {
+          parent_->update(type, needed);
+          increment = needed;
+        } catch (const VeloxRuntimeError&) {
+          availableChunkBytes_.fetch_add(size);
+          throw;
+        }
+      }
+      availableChunkBytes_.fetch_add(increment);
+      return;
+    }
+    // Return the excess with a compare and swap so that concurrent
+    // allocations never see more than what is counted in 'parent_'.
+    while (available > 2 * reservationChunk_) {
+      auto excess = available - reservationChunk_;
+      if (availableChunkBytes_.compare_exchange_weak(
+              available, available - excess)) {
+        parent_->update(type, -excess);
+        return;
+      }
+    }
+  }
+
   // Increments the amount of 'usedReservation_' by 'size'.  Returns the
   // amount by which current size must be incremented. If both old and
   // new values are below the reservation, there is no increment. If
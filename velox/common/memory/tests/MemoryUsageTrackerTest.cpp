@@ -195,3 +195,129 @@ TEST(MemoryUsageTrackerTest, reserve) {
   EXPECT_EQ(child->getCurrentTotalBytes(), -512);
   EXPECT_EQ(parent->getCurrentTotalBytes(), -512);
 }
+
+TEST(MemoryUsageTrackerTest, growCallback) {
+  auto parent = MemoryUsageTracker::create(
+      MemoryUsageConfigBuilder().maxTotalMemory(1024).build());
+  auto child = parent->addChild();
+  auto other = parent->addChild();
+  other->update(512);
+
+  int32_t numCalls = 0;
+  MemoryUsageTracker* exceededTracker = nullptr;
+  bool freeMemory = false;
+  parent->setGrowCallback(
+      [&](MemoryUsageTracker& exceeded, int64_t size) {
+        ++numCalls;
+        exceededTracker = &exceeded;
+        EXPECT_EQ(768, size);
+        if (freeMemory) {
+          other->update(-512);
+        }
+        return freeMemory;
+      });
+
+  // The callback runs but does not free memory.
+  EXPECT_THROW(child->update(768), VeloxRuntimeError);
+  EXPECT_EQ(1, numCalls);
+  EXPECT_EQ(parent.get(), exceededTracker);
+  EXPECT_EQ(0, child->getCurrentTotalBytes());
+  EXPECT_EQ(512, parent->getCurrentTotalBytes());
+
+  // The callback frees memory of 'other' and the update is retried.
+  freeMemory = true;
+  child->update(768);
+  EXPECT_EQ(2, numCalls);
+  EXPECT_EQ(768, child->getCurrentTotalBytes());
+  EXPECT_EQ(768, parent->getCurrentTotalBytes());
+
+  // Reservations use the callback too.
+  freeMemory = false;
+  EXPECT_THROW(other->reserve(768), VeloxRuntimeError);
+  EXPECT_EQ(3, numCalls);
+  EXPECT_TRUE(child->isDescendantOf(parent.get()));
+  EXPECT_FALSE(child->isDescendantOf(other.get()));
+}
+
+TEST(MemoryUsageTrackerTest, reservationChunks) {
+  constexpr int64_t kChunk = 1024;
+  auto parent = MemoryUsageTracker::create();
+  auto child = parent->addChild(
+      false, MemoryUsageConfigBuilder().reservationChunkBytes(kChunk).build());
+  auto leaf = child->addChild();
+
+  // The first update takes a chunk from 'parent'.
+  leaf->update(100);
+  EXPECT_EQ(100, leaf->getCurrentUserBytes());
+  EXPECT_EQ(100, child->getCurrentUserBytes());
+  EXPECT_EQ(kChunk, parent->getCurrentUserBytes());
+  EXPECT_EQ(kChunk - 100, child->getAvailableChunkBytes());
+
+  // Updates within the chunk are not seen by 'parent'.
+  leaf->update(900);
+  leaf->update(-500);
+  leaf->update(500);
+  EXPECT_EQ(1000, child->getCurrentUserBytes());
+  EXPECT_EQ(kChunk, parent->getCurrentUserBytes());
+  EXPECT_EQ(1, parent->getNumAllocs());
+
+  // Going past the chunk takes another one.
+  leaf->update(100);
+  EXPECT_EQ(1100, child->getCurrentUserBytes());
+  EXPECT_EQ(2 * kChunk, parent->getCurrentUserBytes());
+  EXPECT_EQ(2, parent->getNumAllocs());
+
+  // Large updates are rounded up to whole chunks.
+  leaf->update(3 * kChunk);
+  EXPECT_EQ(5 * kChunk, parent->getCurrentUserBytes());
+  EXPECT_EQ(5 * kChunk, parent->getPeakUserBytes());
+
+  // Freeing returns all but one unused chunk.
+  leaf->update(-3 * kChunk - 1100);
+  EXPECT_EQ(0, child->getCurrentUserBytes());
+  EXPECT_EQ(kChunk, parent->getCurrentUserBytes());
+  EXPECT_EQ(kChunk, child->getAvailableChunkBytes());
+
+  // Releasing returns the last unused chunk.
+  child->releaseAvailableChunks();
+  EXPECT_EQ(0, parent->getCurrentUserBytes());
+  EXPECT_EQ(0, child->getAvailableChunkBytes());
+
+  // The next update takes a chunk again.
+  leaf->update(100);
+  EXPECT_EQ(kChunk, parent->getCurrentUserBytes());
+
+  // Destroying the tracker returns the rest.
+  leaf->update(-100);
+  leaf.reset();
+  child.reset();
+  EXPECT_EQ(0, parent->getCurrentUserBytes());
+}
+
+TEST(MemoryUsageTrackerTest, reservationChunksWithLimit) {
+  constexpr int64_t kChunk = 1024;
+  auto parent = MemoryUsageTracker::create(
+      MemoryUsageConfigBuilder().maxUserMemory(1500).build());
+  auto child = parent->addChild(
+      false, MemoryUsageConfigBuilder().reservationChunkBytes(kChunk).build());
+
+  child->update(1000);
+  EXPECT_EQ(kChunk, parent->getCurrentUserBytes());
+
+  // A whole chunk does not fit under the limit but the exact amount does.
+  child->update(200);
+  EXPECT_EQ(1200, child->getCurrentUserBytes());
+  EXPECT_EQ(1200, parent->getCurrentUserBytes());
+  EXPECT_EQ(0, child->getAvailableChunkBytes());
+
+  // Past the limit the update fails and nothing changes.
+  EXPECT_THROW(child->update(400), VeloxRuntimeError);
+  EXPECT_EQ(1200, child->getCurrentUserBytes());
+  EXPECT_EQ(1200, parent->getCurrentUserBytes());
+  EXPECT_EQ(0, child->getAvailableChunkBytes());
+
+  child->update(-1200);
+  EXPECT_EQ(1200, parent->getCurrentUserBytes());
+  child.reset();
+  EXPECT_EQ(0, parent->getCurrentUserBytes());
+}
@@ -101,6 +101,17 @@ class DataSource {
   // processed.
   virtual RowVectorPtr next(uint64_t size) = 0;
 
+  // True if preloadSplit() does anything.
+  virtual bool canPreloadSplits() const {
+    return false;
+  }
+
+  // Announces that 'split' will be passed to addSplit() after the splits
+  // currently added or preloaded. The DataSource may start opening the split
+  // in the background, e.g. read its metadata and check it against filters.
+  virtual void preloadSplit(
+      const std::shared_ptr<ConnectorSplit>& /*split*/) {}
+
   // Add dynamically generated filter.
   // @param outputChannel index into outputType specified in
   // Connector::createDataSource() that identifies the column this filter
@@ -27,6 +27,18 @@ DEFINE_int32(
     1024,
     "Amount of space for the file handle cache in mb.");
 
+DEFINE_int32(
+    file_metadata_cache_mb,
+    256,
+    "Amount of space for the cache of parsed file footers in mb. 0 disables "
+    "the cache.");
+
+DEFINE_int32(
+    decompress_ahead_kb,
+    0,
+    "Amount of decompressed data per stream to produce on the connector "
+    "executor ahead of the reader in kb. 0 decompresses on demand.");
+
 namespace facebook::velox::connector::hive {
 namespace {
 static const char* kPath = "$path";
@@ -116,6 +128,7 @@ HiveDataSource::HiveDataSource(
         std::string,
         std::shared_ptr<connector::ColumnHandle>>& columnHandles,
     FileHandleFactory* fileHandleFactory,
+    dwrf::FileMetadataCache* fileMetadataCache,
     velox::memory::MemoryPool* pool,
     DataCache* dataCache,
     ExpressionEvaluator* expressionEvaluator,
@@ -124,8 +137,8 @@ HiveDataSource::HiveDataSource(
     folly::Executor* executor)
     : outputType_(outputType),
       fileHandleFactory_(fileHandleFactory),
+      fileMetadataCache_(fileMetadataCache),
       pool_(pool),
-      readerOpts_(pool),
       dataCache_(dataCache),
       expressionEvaluator_(expressionEvaluator),
       mappedMemory_(mappedMemory),
@@ -167,6 +180,8 @@ HiveDataSource::HiveDataSource(
   readerOutputType_ = ROW(std::move(columnNames), std::move(outputTypes));
   scanSpec_ =
       makeScanSpec(hiveTableHandle->subfieldFilters(), readerOutputType_);
+  staticFilterSpec_ =
+      makeScanSpec(hiveTableHandle->subfieldFilters(), readerOutputType_);
 
   const auto& remainingFilter = hiveTableHandle->remainingFilter();
   if (remainingFilter) {
@@ -283,23 +298,33 @@ void HiveDataSource::addDynamicFilter(
     fieldSpec.setFilter(filter->clone());
   }
   scanSpec_->resetCachedValues();
-
-  auto columnReader =
-      dynamic_cast<SelectiveColumnReader*>(rowReader_->columnReader());
-  assert(columnReader);
-  columnReader->resetFilterCaches();
+  hasDynamicFilters_ = true;
+
+  // Unread strides and row groups of the current split are checked against
+  // the new filter. Later splits are checked in addSplit().
+  if (parquetRowReader_) {
+    parquetRowReader_->resetFilterCaches();
+  } else if (rowReader_) {
+    rowReader_->resetFilterCaches();
+  }
 }
 
-void HiveDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
-  VELOX_CHECK(
-      split_ == nullptr,
-      "Previous split has not been processed yet. Call next to process the split.");
-  split_ = std::dynamic_pointer_cast<HiveConnectorSplit>(split);
-  VELOX_CHECK(split_, "Wrong type of split");
-
-  VLOG(1) << "Adding split " << split_->toString();
+HiveDataSource::~HiveDataSource() {
+  // Preloads reference 'this' and allocate from 'pool_'.
+  for (auto& [split, preload] : preloads_) {
+    preload.wait();
+  }
+}
 
-  fileHandle_ = fileHandleFactory_->generate(split_->filePath);
+std::unique_ptr<HiveDataSource::SplitReader> HiveDataSource::openSplit(
+    const HiveConnectorSplit& split,
+    common::ScanSpec* filterSpec) const {
+  auto splitReader = std::make_unique<SplitReader>();
+  splitReader->fileHandle = fileHandleFactory_->generate(split.filePath);
+  auto& fileHandle = splitReader->fileHandle;
+  splitReader->readerOpts =
+      std::make_unique<dwio::common::ReaderOptions>(pool_);
+  auto& readerOpts = *splitReader->readerOpts;
   // Decide between AsyncDataCache, legacy DataCache and no cache. All
   // three are supported to enable comparison.
   if (auto asyncCache = dynamic_cast<cache::AsyncDataCache*>(mappedMemory_)) {
@@ -307,52 +332,133 @@ void HiveDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
         !dataCache_,
         "DataCache should not be present if the MappedMemory is AsyncDataCache");
     // Make DataCacheConfig to pass the filenum and a null DataCache.
-    if (!readerOpts_.getDataCacheConfig()) {
-      auto dataCacheConfig = std::make_shared<dwio::common::DataCacheConfig>();
-      readerOpts_.setDataCacheConfig(std::move(dataCacheConfig));
-    }
-    readerOpts_.getDataCacheConfig()->filenum = fileHandle_->uuid.id();
-    bufferedInputFactory_ = std::make_unique<dwrf::CachedBufferedInputFactory>(
-        (asyncCache),
-        Connector::getTracker(scanId_),
-        fileHandle_->groupId.id(),
-        [factory = fileHandleFactory_,
-         path = split_->filePath,
-         stats = ioStats_]() { return makeStreamHolder(factory, path, stats); },
-        ioStats_,
-        executor_);
-    readerOpts_.setBufferedInputFactory(bufferedInputFactory_.get());
+    auto dataCacheConfig = std::make_shared<dwio::common::DataCacheConfig>();
+    dataCacheConfig->filenum = fileHandle->uuid.id();
+    readerOpts.setDataCacheConfig(std::move(dataCacheConfig));
+    splitReader->bufferedInputFactory =
+        std::make_unique<dwrf::CachedBufferedInputFactory>(
+            (asyncCache),
+            Connector::getTracker(scanId_),
+            fileHandle->groupId.id(),
+            [factory = fileHandleFactory_,
+             path = split.filePath,
+             stats = ioStats_]() {
+              return makeStreamHolder(factory, path, stats);
+            },
+            ioStats_,
+            executor_,
+            static_cast<uint64_t>(FLAGS_decompress_ahead_kb) << 10);
+    readerOpts.setBufferedInputFactory(
+        splitReader->bufferedInputFactory.get());
   } else if (dataCache_) {
     auto dataCacheConfig = std::make_shared<dwio::common::DataCacheConfig>();
     dataCacheConfig->cache = dataCache_;
-    dataCacheConfig->filenum = fileHandle_->uuid.id();
-    readerOpts_.setDataCacheConfig(std::move(dataCacheConfig));
+    dataCacheConfig->filenum = fileHandle->uuid.id();
+    readerOpts.setDataCacheConfig(std::move(dataCacheConfig));
   }
+  if (split.fileFormat == dwio::common::FileFormat::PARQUET) {
+    // Row groups are checked against the filters when reading, so there is
+    // no file level statistics check.
+    splitReader->parquetReader = std::make_unique<parquet::ParquetReader>(
+        std::make_unique<dwio::common::ReadFileInputStream>(
+            fileHandle->file.get(),
+            dwio::common::MetricsLog::voidLog(),
+            ioStats_.get()),
+        readerOpts);
+    splitReader->emptyFile = splitReader->parquetReader->numberOfRows() == 0;
+    return splitReader;
+  }
+  std::shared_ptr<const dwrf::FileMetadata> fileMetadata;
+  if (fileMetadataCache_) {
+    fileMetadata =
+        fileMetadataCache_->get(split.filePath, fileHandle->file->size());
+  }
+  readerOpts.setFileMetadata(fileMetadata);
   // We run with the default BufferedInputFactory and no DataCacheConfig if
   // there is no DataCache and the MappedMemory is not an AsyncDataCache.
-  reader_ = dwrf::DwrfReader::create(
+  splitReader->reader = dwrf::DwrfReader::create(
       std::make_unique<dwio::common::ReadFileInputStream>(
-          fileHandle_->file.get(),
+          fileHandle->file.get(),
           dwio::common::MetricsLog::voidLog(),
           ioStats_.get()),
-      readerOpts_);
+      readerOpts);
+  auto& reader = splitReader->reader;
+  if (fileMetadata) {
+    splitReader->fileMetadataCacheHit = true;
+  } else if (fileMetadataCache_) {
+    fileMetadataCache_->put(split.filePath, *reader);
+  }
+
+  if (reader->getFooter().has_numberofrows() &&
+      reader->getFooter().numberofrows() == 0) {
+    splitReader->emptyFile = true;
+    return splitReader;
+  }
+
+  // Check filters and see if the whole split can be skipped
+  splitReader->skippedByStats =
+      !testFilters(filterSpec, reader.get(), split.filePath);
+  return splitReader;
+}
+
+void HiveDataSource::preloadSplit(
+    const std::shared_ptr<ConnectorSplit>& split) {
+  VELOX_CHECK_NOT_NULL(executor_, "Preloading splits requires an executor");
+  auto hiveSplit = std::dynamic_pointer_cast<HiveConnectorSplit>(split);
+  VELOX_CHECK(hiveSplit, "Wrong type of split");
+  VLOG(1) << "Preloading split " << hiveSplit->toString();
+  preloads_.emplace(
+      split.get(), folly::via(executor_, [this, hiveSplit]() {
+        return openSplit(*hiveSplit, staticFilterSpec_.get());
+      }));
+}
+
+void HiveDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
+  VELOX_CHECK(
+      split_ == nullptr,
+      "Previous split has not been processed yet. Call next to process the split.");
+  split_ = std::dynamic_pointer_cast<HiveConnectorSplit>(split);
+  VELOX_CHECK(split_, "Wrong type of split");
+
+  VLOG(1) << "Adding split " << split_->toString();
+
+  auto it = preloads_.find(split_.get());
+  if (it != preloads_.end()) {
+    auto preload = std::move(it->second);
+    preloads_.erase(it);
+    // Rethrows errors from opening the split.
+    splitReader_ = std::move(preload).get();
+    ++numPreloadedSplits_;
+    // The preload checked only the filters of the table handle.
+    if (hasDynamicFilters_ && splitReader_->reader &&
+        !splitReader_->emptyFile && !splitReader_->skippedByStats) {
+      splitReader_->skippedByStats = !testFilters(
+          scanSpec_.get(), splitReader_->reader.get(), split_->filePath);
+    }
+  } else {
+    splitReader_ = openSplit(*split_, scanSpec_.get());
+  }
+  auto& reader = splitReader_->reader;
+  if (splitReader_->fileMetadataCacheHit) {
+    ++fileMetadataCacheHits_;
+  }
 
   emptySplit_ = false;
-  if (reader_->getFooter().has_numberofrows() &&
-      reader_->getFooter().numberofrows() == 0) {
+  if (splitReader_->emptyFile) {
     emptySplit_ = true;
     return;
   }
 
-  // Check filters and see if the whole split can be skipped
-  if (!testFilters(scanSpec_.get(), reader_.get(), split_->filePath)) {
+  if (splitReader_->skippedByStats) {
     emptySplit_ = true;
     ++skippedSplits_;
     skippedSplitBytes_ += split_->length;
     return;
   }
 
-  auto fileType = reader_->getType();
+  auto fileType = splitReader_->parquetReader
+      ? splitReader_->parquetReader->rowType()
+      : reader->getType();
 
   for (int i = 0; i < readerOutputType_->size(); i++) {
     auto fieldName = readerOutputType_->nameOf(i);
@@ -402,6 +508,12 @@ void HiveDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
         bucketSpec, velox::variant(split_->tableBucketNumber.value()));
   }
 
+  if (splitReader_->parquetReader) {
+    parquetRowReader_ = splitReader_->parquetReader->createRowReader(
+        rowReaderOpts_.range(split_->start, split_->length), scanSpec_.get());
+    return;
+  }
+
   std::vector<std::string> columnNames;
   for (auto& spec : scanSpec_->children()) {
     if (!spec->isConstant()) {
@@ -417,7 +529,7 @@ void HiveDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
     cs = std::make_shared<dwio::common::ColumnSelector>(fileType, columnNames);
   }
 
-  rowReader_ = reader_->createRowReader(
+  rowReader_ = reader->createRowReader(
       rowReaderOpts_.select(cs).range(split_->start, split_->length));
 }
 
@@ -425,8 +537,9 @@ RowVectorPtr HiveDataSource::next(uint64_t size) {
   VELOX_CHECK(split_ != nullptr, "No split to process. Call addSplit first.");
   if (emptySplit_) {
     split_.reset();
-    reader_.reset();
     rowReader_.reset();
+    parquetRowReader_.reset();
+    splitReader_.reset();
     return nullptr;
   }
 
@@ -438,7 +551,9 @@ RowVectorPtr HiveDataSource::next(uint64_t size) {
   // column, e.g. rand() < 0.1. Evaluate that conjunct first, then scan only
   // rows that passed.
 
-  auto rowsScanned = rowReader_->next(size, output_);
+  auto rowsScanned = parquetRowReader_
+      ? parquetRowReader_->next(size, output_)
+      : rowReader_->next(size, output_);
   completedRows_ += rowsScanned;
 
   if (rowsScanned) {
@@ -481,11 +596,18 @@ RowVectorPtr HiveDataSource::next(uint64_t size) {
         pool_, outputType_, BufferPtr(nullptr), rowsRemaining, outputColumns);
   }
 
-  skippedStrides_ += rowReader_->skippedStrides();
+  if (parquetRowReader_) {
+    skippedStripes_ += parquetRowReader_->skippedRowGroups();
+    skippedStrides_ += parquetRowReader_->skippedPages();
+  } else {
+    skippedStripes_ += rowReader_->skippedStripes();
+    skippedStrides_ += rowReader_->skippedStrides();
+  }
 
   split_.reset();
-  reader_.reset();
   rowReader_.reset();
+  parquetRowReader_.reset();
+  splitReader_.reset();
   return nullptr;
 }
 
@@ -514,7 +636,10 @@ std::unordered_map<std::string, int64_t> HiveDataSource::runtimeStats() {
   return {
       {"skippedSplits", skippedSplits_},
       {"skippedSplitBytes", skippedSplitBytes_},
+      {"skippedStripes", skippedStripes_},
       {"skippedStrides", skippedStrides_},
+      {"fileMetadataCacheHits", fileMetadataCacheHits_},
+      {"numPreloadedSplits", numPreloadedSplits_},
       {"numPrefetch", ioStats_->prefetch().count()},
       {"prefetchBytes", ioStats_->prefetch().bytes()},
       {"numStorageRead", ioStats_->read().count()},
@@ -536,6 +661,11 @@ HiveConnector::HiveConnector(
           std::make_unique<SimpleLRUCache<std::string, FileHandle>>(
               FLAGS_file_handle_cache_mb << 20),
           std::make_unique<FileHandleGenerator>()),
+      fileMetadataCache_(
+          FLAGS_file_metadata_cache_mb > 0
+              ? std::make_unique<dwrf::FileMetadataCache>(
+                    static_cast<int64_t>(FLAGS_file_metadata_cache_mb) << 20)
+              : nullptr),
       executor_(executor) {}
 
 VELOX_REGISTER_CONNECTOR_FACTORY(std::make_shared<HiveConnectorFactory>())
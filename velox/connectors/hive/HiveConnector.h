@@ -15,13 +15,17 @@
  */
 #pragma once
 
+#include <folly/futures/Future.h>
+
 #include "velox/common/caching/DataCache.h"
 #include "velox/connectors/hive/FileHandle.h"
 #include "velox/connectors/hive/HiveConnectorSplit.h"
 #include "velox/dwio/dwrf/common/CachedBufferedInput.h"
 #include "velox/dwio/dwrf/reader/DwrfReader.h"
+#include "velox/dwio/dwrf/reader/FileMetadataCache.h"
 #include "velox/dwio/dwrf/reader/ScanSpec.h"
 #include "velox/dwio/dwrf/writer/Writer.h"
+#include "velox/dwio/parquet/reader/ParquetReader.h"
 #include "velox/exec/OperatorUtils.h"
 #include "velox/expression/Expr.h"
 #include "velox/type/Filter.h"
@@ -125,6 +129,7 @@ class HiveDataSource : public DataSource {
           std::string,
           std::shared_ptr<connector::ColumnHandle>>& columnHandles,
       FileHandleFactory* FOLLY_NONNULL fileHandleFactory,
+      dwrf::FileMetadataCache* FOLLY_NULLABLE fileMetadataCache,
       velox::memory::MemoryPool* FOLLY_NONNULL pool,
       DataCache* FOLLY_NULLABLE dataCache,
       ExpressionEvaluator* FOLLY_NONNULL expressionEvaluator,
@@ -132,8 +137,16 @@ class HiveDataSource : public DataSource {
       const std::string& scanId,
       folly::Executor* FOLLY_NULLABLE executor);
 
+  ~HiveDataSource() override;
+
   void addSplit(std::shared_ptr<ConnectorSplit> split) override;
 
+  bool canPreloadSplits() const override {
+    return executor_ != nullptr;
+  }
+
+  void preloadSplit(const std::shared_ptr<ConnectorSplit>& split) override;
+
   void addDynamicFilter(
       ChannelIndex outputChannel,
       const std::shared_ptr<common::Filter>& filter) override;
@@ -151,6 +164,31 @@ class HiveDataSource : public DataSource {
   std::unordered_map<std::string, int64_t> runtimeStats() override;
 
  private:
+  // File handle and reader for one split. Made on the driver thread in
+  // addSplit() or ahead of time on 'executor_' for preloaded splits.
+  struct SplitReader {
+    FileHandleCachedPtr fileHandle;
+    std::unique_ptr<dwrf::BufferedInputFactory> bufferedInputFactory;
+    // Referenced by 'reader'.
+    std::unique_ptr<dwio::common::ReaderOptions> readerOpts;
+    // Set for DWRF files.
+    std::unique_ptr<dwrf::DwrfReader> reader;
+    // Set instead of 'reader' for Parquet files.
+    std::unique_ptr<parquet::ParquetReader> parquetReader;
+    // True if the file has no rows.
+    bool emptyFile{false};
+    // True if column statistics show that no row passes the filters.
+    bool skippedByStats{false};
+    bool fileMetadataCacheHit{false};
+  };
+
+  // Opens the file of 'split' and checks its statistics against the filters
+  // in 'filterSpec'. Does not modify 'this', so it can run on 'executor_'
+  // concurrently with reading the current split.
+  std::unique_ptr<SplitReader> openSplit(
+      const HiveConnectorSplit& split,
+      common::ScanSpec* FOLLY_NONNULL filterSpec) const;
+
   // Evaluates remainingFilter_ on the specified vector. Returns number of rows
   // passed. Populates filterEvalCtx_.selectedIndices and selectedBits if only
   // some rows passed the filter. If no or all rows passed
@@ -167,17 +205,31 @@ class HiveDataSource : public DataSource {
 
   const std::shared_ptr<const RowType> outputType_;
   FileHandleFactory* FOLLY_NONNULL fileHandleFactory_;
+  // Parsed file tails shared across splits and queries. nullptr if disabled.
+  dwrf::FileMetadataCache* FOLLY_NULLABLE fileMetadataCache_;
   velox::memory::MemoryPool* FOLLY_NONNULL pool_;
   std::vector<std::string> regularColumns_;
   std::shared_ptr<dwio::common::IoStatistics> ioStats_;
-  std::unique_ptr<dwrf::BufferedInputFactory> bufferedInputFactory_;
   std::unique_ptr<dwrf::ColumnReaderFactory> columnReaderFactory_;
   std::unique_ptr<common::ScanSpec> scanSpec_;
+  // Filters from the table handle. Unlike 'scanSpec_' this does not change
+  // after construction, so preloads check split statistics against it.
+  std::unique_ptr<common::ScanSpec> staticFilterSpec_;
+  // True once a dynamic filter has been added. Preloaded splits are then
+  // checked against 'scanSpec_' again.
+  bool hasDynamicFilters_{false};
   std::shared_ptr<HiveConnectorSplit> split_;
-  dwio::common::ReaderOptions readerOpts_;
+  std::unique_ptr<SplitReader> splitReader_;
+  // Preloads started by preloadSplit(), keyed by split.
+  std::unordered_map<
+      const ConnectorSplit*,
+      folly::Future<std::unique_ptr<SplitReader>>>
+      preloads_;
   dwio::common::RowReaderOptions rowReaderOpts_;
-  std::unique_ptr<dwrf::DwrfReader> reader_;
+  // Declared after 'splitReader_' so that it is destroyed first.
   std::unique_ptr<dwrf::DwrfRowReader> rowReader_;
+  // Used instead of 'rowReader_' for Parquet splits.
+  std::unique_ptr<parquet::ParquetRowReader> parquetRowReader_;
   std::unique_ptr<exec::ExprSet> remainingFilterExprSet_;
   std::shared_ptr<const RowType> readerOutputType_;
   bool emptySplit_;
@@ -188,11 +240,20 @@ class HiveDataSource : public DataSource {
   // Total bytes in splits skipped based on statistics.
   int64_t skippedSplitBytes_{0};
 
-  // Number of strides (row groups) skipped based on statistics.
+  // Number of stripes (Parquet row groups) skipped based on statistics.
+  int64_t skippedStripes_{0};
+
+  // Number of strides (row groups) skipped based on statistics. Counts data
+  // pages for Parquet.
   int64_t skippedStrides_{0};
 
+  // Number of splits whose file tail came from 'fileMetadataCache_'.
+  int64_t fileMetadataCacheHits_{0};
+
+  // Number of splits opened in the background before being added.
+  int64_t numPreloadedSplits_{0};
+
   VectorPtr output_;
-  FileHandleCachedPtr fileHandle_;
   DataCache* FOLLY_NULLABLE dataCache_;
   ExpressionEvaluator* FOLLY_NONNULL expressionEvaluator_;
   uint64_t completedRows_ = 0;
@@ -227,6 +288,7 @@ class HiveConnector final : public Connector {
         tableHandle,
         columnHandles,
         &fileHandleFactory_,
+        fileMetadataCache_.get(),
         connectorQueryCtx->memoryPool(),
         connectorQueryCtx->config()->get<std::string>(
             kNodeSelectionStrategy, kNodeSelectionStrategyNoPreference) ==
@@ -261,6 +323,7 @@ class HiveConnector final : public Connector {
  private:
   std::unique_ptr<DataCache> dataCache_;
   FileHandleFactory fileHandleFactory_;
+  std::unique_ptr<dwrf::FileMetadataCache> fileMetadataCache_;
   folly::Executor* FOLLY_NULLABLE executor_;
 
   static constexpr const char* FOLLY_NONNULL kNodeSelectionStrategy =
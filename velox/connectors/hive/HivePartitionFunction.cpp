@@ -47,6 +47,31 @@ void hashTyped<TypeKind::BOOLEAN>(
   }
 }
 
+// Hashes flat values without nulls. The loops have no per row branches and
+// no indirections.
+template <typename T, typename HashValue>
+void hashFlat(
+    const DecodedVector& values,
+    vector_size_t size,
+    bool mix,
+    HashValue hashValue,
+    std::vector<int32_t>& hashes) {
+  auto rawValues = values.data<T>();
+  if (mix) {
+    for (auto i = 0; i < size; ++i) {
+      hashes[i] = hashes[i] * 31 + hashValue(rawValues[i]);
+    }
+  } else {
+    for (auto i = 0; i < size; ++i) {
+      hashes[i] = hashValue(rawValues[i]);
+    }
+  }
+}
+
+bool isFlatNoNulls(const DecodedVector& values) {
+  return values.isIdentityMapping() && !values.mayHaveNulls();
+}
+
 int32_t hashInt64(int64_t value) {
   return ((*reinterpret_cast<uint64_t*>(&value)) >> 32) ^ value;
 }
@@ -57,6 +82,15 @@ void hashTyped<TypeKind::BIGINT>(
     vector_size_t size,
     bool mix,
     std::vector<int32_t>& hashes) {
+  if (isFlatNoNulls(values)) {
+    hashFlat<int64_t>(
+        values,
+        size,
+        mix,
+        [](int64_t value) { return hashInt64(value); },
+        hashes);
+    return;
+  }
   for (auto i = 0; i < size; ++i) {
     int32_t hash;
     if (values.isNullAt(i)) {
@@ -90,6 +124,15 @@ void hashTyped<TypeKind::VARCHAR>(
     vector_size_t size,
     bool mix,
     std::vector<int32_t>& hashes) {
+  if (isFlatNoNulls(values)) {
+    hashFlat<StringView>(
+        values,
+        size,
+        mix,
+        [](StringView value) { return hashBytes(value, 0); },
+        hashes);
+    return;
+  }
   for (auto i = 0; i < size; ++i) {
     int32_t hash;
     if (values.isNullAt(i)) {
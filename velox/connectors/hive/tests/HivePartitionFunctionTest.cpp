@@ -83,3 +83,40 @@ TEST_F(HivePartitionFunctionTest, bool) {
   assertPartitions(values, 500, {0, 1, 0, 0, 1});
   assertPartitions(values, 997, {0, 1, 0, 0, 1});
 }
+
+TEST_F(HivePartitionFunctionTest, flatMatchesDictionary) {
+  // Flat keys without nulls take a faster path. Check that it partitions
+  // like the general path over the same keys wrapped in a dictionary.
+  const vector_size_t size = 1'000;
+  std::vector<std::string> strings(size);
+  for (auto i = 0; i < size; ++i) {
+    strings[i] = fmt::format("key number {}", i * 7);
+  }
+  auto bigints = vm_.flatVector<int64_t>(
+      size, [](auto row) { return row * 1'000'000'007L; });
+  auto varchars = vm_.flatVector(strings);
+
+  auto indices = AlignedBuffer::allocate<vector_size_t>(size, pool_.get());
+  std::iota(
+      indices->asMutable<vector_size_t>(),
+      indices->asMutable<vector_size_t>() + size,
+      0);
+  auto wrap = [&](const VectorPtr& vector) {
+    return BaseVector::wrapInDictionary(nullptr, indices, size, vector);
+  };
+
+  const int bucketCount = 997;
+  std::vector<int> bucketToPartition(bucketCount);
+  std::iota(bucketToPartition.begin(), bucketToPartition.end(), 0);
+  connector::hive::HivePartitionFunction partitionFunction(
+      bucketCount, bucketToPartition, {0, 1});
+
+  std::vector<uint32_t> flatPartitions(size);
+  partitionFunction.partition(
+      *vm_.rowVector({bigints, varchars}), flatPartitions);
+  std::vector<uint32_t> dictionaryPartitions(size);
+  partitionFunction.partition(
+      *vm_.rowVector({wrap(bigints), wrap(varchars)}), dictionaryPartitions);
+
+  EXPECT_EQ(dictionaryPartitions, flatPartitions);
+}
@@ -21,6 +21,7 @@
 #include "velox/core/CancelPool.h"
 #include "velox/core/Context.h"
 #include "velox/vector/DecodedVector.h"
+#include "velox/vector/VectorPool.h"
 
 namespace facebook::velox::core {
 
@@ -163,6 +164,10 @@ class QueryCtx : public Context {
     return get<bool>(kCodegenLazyLoading, true);
   }
 
+  bool codegenBackgroundCompilation() const {
+    return get<bool>(kCodegenBackgroundCompilation, false);
+  }
+
   bool adjustTimestampToTimezone() const {
     return get<bool>(kAdjustTimestampToTimezone, false);
   }
@@ -175,12 +180,35 @@ class QueryCtx : public Context {
     return get<bool>(kExprEvalSimplified, false);
   }
 
+  int64_t exprResultCacheMaxBytes() const {
+    return get<int64_t>(kExprResultCacheMaxBytes, 0);
+  }
+
+  int32_t maxSplitPreloadPerDriver() const {
+    return get<int32_t>(kMaxSplitPreloadPerDriver, 2);
+  }
+
+  int64_t driverMemoryReservationChunk() const {
+    return get<int64_t>(kDriverMemoryReservationChunk, 1 << 20);
+  }
+
+  bool memoryArbitrationEnabled() const {
+    return get<bool>(kMemoryArbitrationEnabled, false);
+  }
+
   static constexpr const char* kCodegenEnabled = "driver.codegen.enabled";
   static constexpr const char* kCodegenConfigurationFilePath =
       "driver.codegen.configuration_file_path";
   static constexpr const char* kCodegenLazyLoading =
       "driver.codegen.lazy_loading";
 
+  // If true, expressions whose compiled library is not in the library cache
+  // directory are interpreted while the library compiles in the background.
+  // Later tasks use the library. Requires libraryCacheDirectory in the codegen
+  // configuration file.
+  static constexpr const char* kCodegenBackgroundCompilation =
+      "driver.codegen.background_compilation";
+
   // User provided session timezone. Stores a string with the actual timezone
   // name, e.g: "America/Los_Angeles".
   static constexpr const char* kSessionTimezone = "driver.session.timezone";
@@ -202,6 +230,13 @@ class QueryCtx : public Context {
   static constexpr const char* kExprEvalSimplified =
       "driver.expr_eval.simplified";
 
+  // Memory budget in bytes of the result cache of each call of an expensive
+  // function, see VectorFunction::isExpensive(). The cache is enabled for a
+  // call when a sample of its argument has few distinct values. 0 disables
+  // result caching, which is the default.
+  static constexpr const char* kExprResultCacheMaxBytes =
+      "driver.expr_eval.result_cache_max_bytes";
+
   // Flags used to configure the CAST operator:
 
   // This flag makes the Row conversion to by applied
@@ -221,6 +256,25 @@ class QueryCtx : public Context {
   static constexpr const char* kMaxPartialAggregationMemory =
       "max_partial_aggregation_memory";
 
+  // Number of splits a table scan takes ahead of the one it is reading so
+  // that the connector can open them in the background. 0 disables preload.
+  static constexpr const char* kMaxSplitPreloadPerDriver =
+      "max_split_preload_per_driver";
+
+  // Size of the chunks in which a Driver reserves memory from its Task.
+  // Allocations that fit in the reserved chunks do not update the
+  // memory usage of the Task and the query. 0 propagates every
+  // allocation.
+  static constexpr const char* kDriverMemoryReservationChunk =
+      "driver_memory_reservation_chunk_bytes";
+
+  // If true, the Tasks of the query take part in memory arbitration, see
+  // exec::MemoryArbitrator. Their Operators may be asked to give memory
+  // back and the query may be aborted to free memory for another query.
+  // False by default.
+  static constexpr const char* kMemoryArbitrationEnabled =
+      "memory_arbitration_enabled";
+
   // Overrides the previous configuration. Note that this function is NOT
   // thread-safe and should probably only be used in tests.
   void setConfigOverridesUnsafe(
@@ -263,7 +317,10 @@ class QueryCtx : public Context {
 class ExecCtx : public Context {
  public:
   ExecCtx(memory::MemoryPool* pool, QueryCtx* queryCtx)
-      : Context{ContextScope::QUERY}, pool_(pool), queryCtx_(queryCtx) {}
+      : Context{ContextScope::QUERY},
+        pool_(pool),
+        queryCtx_(queryCtx),
+        vectorPool_(pool) {}
 
   velox::memory::MemoryPool* pool() const {
     return pool_;
@@ -306,6 +363,26 @@ class ExecCtx : public Context {
     decodedVectorPool_.push_back(std::move(vector));
   }
 
+  /// Returns a flat vector of 'type' and 'size' allocated from pool(). Reuses
+  /// a vector given to releaseVector() if possible.
+  VectorPtr getVector(const TypePtr& type, vector_size_t size) {
+    return vectorPool_.get(type, size);
+  }
+
+  /// Takes 'vector' for reuse by getVector() if 'vector' is singly referenced
+  /// and of a recyclable kind. Sets 'vector' to nullptr if taken.
+  bool releaseVector(VectorPtr& vector) {
+    return vectorPool_.release(vector);
+  }
+
+  size_t releaseVectors(std::vector<VectorPtr>& vectors) {
+    return vectorPool_.release(vectors);
+  }
+
+  const VectorPool::Stats& vectorPoolStats() const {
+    return vectorPool_.stats();
+  }
+
  private:
   // Pool for all Buffers for this thread
   memory::MemoryPool* pool_;
@@ -315,6 +392,8 @@ class ExecCtx : public Context {
   // A pool of preallocated SelectivityVectors for use by expressions
   // and operators.
   std::vector<std::unique_ptr<SelectivityVector>> selectivityVectorPool_;
+  // A pool of flat vectors for reuse by expressions and operators.
+  VectorPool vectorPool_;
 };
 
 } // namespace facebook::velox::core
@@ -65,6 +65,15 @@ struct udf_is_deterministic<
     util::detail::void_t<decltype(T::is_deterministic)>>
     : std::integral_constant<bool, T::is_deterministic> {};
 
+// UDFs that never throw declare is_no_throw, which allows evaluating them
+// without per row error handling
+template <class T, class = void>
+struct udf_is_no_throw : std::false_type {};
+
+template <class T>
+struct udf_is_no_throw<T, util::detail::void_t<decltype(T::is_no_throw)>>
+    : std::integral_constant<bool, T::is_no_throw> {};
+
 KOKSI_MEMBER_CHECKER(udf_has_call, &T::call)
 KOKSI_MEMBER_CHECKER(udf_has_callNullable, &T::callNullable)
 
@@ -223,6 +232,7 @@ class UDFHolder final
       "UDF must implement at least one of `call` or `callNullable`");
   static constexpr bool is_default_null_behavior =
       !udf_has_callNullable<Fun>::value;
+  static constexpr bool is_no_throw = udf_is_no_throw<Fun>::value;
 
   using Metadata = core::ScalarFunctionMetadata<Fun, TReturn, TArgs...>;
 
@@ -29,6 +29,7 @@
 namespace facebook::velox::dwrf {
 class BufferedInputFactory;
 class ColumnReaderFactory;
+struct FileMetadata;
 } // namespace facebook::velox::dwrf
 
 namespace facebook {
@@ -302,6 +303,7 @@ class ReaderOptions {
   std::shared_ptr<DataCacheConfig> dataCacheConfig_;
   std::shared_ptr<encryption::DecrypterFactory> decrypterFactory_;
   velox::dwrf::BufferedInputFactory* bufferedInputFactory_ = nullptr;
+  std::shared_ptr<const velox::dwrf::FileMetadata> fileMetadata_;
 
  public:
   ReaderOptions(
@@ -331,6 +333,7 @@ class ReaderOptions {
     dataCacheConfig_ = other.dataCacheConfig_;
     decrypterFactory_ = other.decrypterFactory_;
     bufferedInputFactory_ = other.bufferedInputFactory_;
+    fileMetadata_ = other.fileMetadata_;
     return *this;
   }
 
@@ -424,6 +427,16 @@ class ReaderOptions {
     return *this;
   }
 
+  /**
+   * Set the already parsed tail of the file, e.g. from an earlier reader of
+   * the same file. If set, the reader does not read or parse the tail.
+   */
+  ReaderOptions& setFileMetadata(
+      std::shared_ptr<const velox::dwrf::FileMetadata> fileMetadata) {
+    fileMetadata_ = std::move(fileMetadata);
+    return *this;
+  }
+
   /**
    * Get the data cache config.
    */
@@ -483,6 +496,11 @@ class ReaderOptions {
   velox::dwrf::BufferedInputFactory* getBufferedInputFactory() const {
     return bufferedInputFactory_;
   }
+
+  const std::shared_ptr<const velox::dwrf::FileMetadata>& getFileMetadata()
+      const {
+    return fileMetadata_;
+  }
 };
 
 } // namespace common
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <folly/lang/Bits.h>
+
+#include <algorithm>
+#include <cstdint>
+
+namespace facebook::velox::dwrf {
+
+namespace detail {
+
+// Unpacks 'numGroups' groups of 8 values of kWidth bits. The values are
+// packed MSB first with no padding, so that each group of 8 starts on a byte
+// boundary and takes kWidth bytes. Each value is extracted from an unaligned
+// big endian 64 bit load at the byte holding its first bit, which covers the
+// value for widths up to 57 and for 64. The offsets and shifts are compile
+// time constants once the fixed length inner loop is unrolled, which lets the
+// compiler vectorize the group. Reads up to 8 bytes past the last group.
+template <int32_t kWidth>
+void unpackGroups(const char* input, uint64_t numGroups, int64_t* output) {
+  static_assert(kWidth > 0 && (kWidth <= 57 || kWidth == 64));
+  for (uint64_t group = 0; group < numGroups; ++group) {
+    for (int32_t i = 0; i < 8; ++i) {
+      const int32_t bit = i * kWidth;
+      const uint64_t word =
+          folly::Endian::big(folly::loadUnaligned<uint64_t>(input + bit / 8));
+      output[i] = static_cast<int64_t>((word << (bit % 8)) >> (64 - kWidth));
+    }
+    input += kWidth;
+    output += 8;
+  }
+}
+
+} // namespace detail
+
+// Unpacks a prefix of 'numValues' values of 'bitWidth' bits, bit packed MSB
+// first as in ORC RLEv2, from 'input' to 'output'. 'input' must start at the
+// first bit of the first value and have 'inputSize' readable bytes. Unpacks
+// whole groups of 8 values as long as their loads stay within 'inputSize', so
+// the next value again starts on a byte boundary. Returns the number of
+// values unpacked, which is 0 for widths that have no kernel. The caller
+// decodes the remainder bit by bit.
+inline uint64_t unpackBitPacked(
+    const char* input,
+    uint64_t inputSize,
+    uint32_t bitWidth,
+    uint64_t numValues,
+    int64_t* output) {
+  if (inputSize < sizeof(uint64_t) || bitWidth == 0 || bitWidth > 64 ||
+      (bitWidth > 57 && bitWidth < 64)) {
+    return 0;
+  }
+  const uint64_t numGroups = std::min<uint64_t>(
+      numValues / 8, (inputSize - sizeof(uint64_t)) / bitWidth);
+  if (numGroups == 0) {
+    return 0;
+  }
+  switch (bitWidth) {
+#define VELOX_UNPACK_CASE(width)                           \
+  case width:                                              \
+    detail::unpackGroups<width>(input, numGroups, output); \
+    break;
+    VELOX_UNPACK_CASE(1)
+    VELOX_UNPACK_CASE(2)
+    VELOX_UNPACK_CASE(3)
+    VELOX_UNPACK_CASE(4)
+    VELOX_UNPACK_CASE(5)
+    VELOX_UNPACK_CASE(6)
+    VELOX_UNPACK_CASE(7)
+    VELOX_UNPACK_CASE(8)
+    VELOX_UNPACK_CASE(9)
+    VELOX_UNPACK_CASE(10)
+    VELOX_UNPACK_CASE(11)
+    VELOX_UNPACK_CASE(12)
+    VELOX_UNPACK_CASE(13)
+    VELOX_UNPACK_CASE(14)
+    VELOX_UNPACK_CASE(15)
+    VELOX_UNPACK_CASE(16)
+    VELOX_UNPACK_CASE(17)
+    VELOX_UNPACK_CASE(18)
+    VELOX_UNPACK_CASE(19)
+    VELOX_UNPACK_CASE(20)
+    VELOX_UNPACK_CASE(21)
+    VELOX_UNPACK_CASE(22)
+    VELOX_UNPACK_CASE(23)
+    VELOX_UNPACK_CASE(24)
+    VELOX_UNPACK_CASE(25)
+    VELOX_UNPACK_CASE(26)
+    VELOX_UNPACK_CASE(27)
+    VELOX_UNPACK_CASE(28)
+    VELOX_UNPACK_CASE(29)
+    VELOX_UNPACK_CASE(30)
+    VELOX_UNPACK_CASE(31)
+    VELOX_UNPACK_CASE(32)
+    VELOX_UNPACK_CASE(33)
+    VELOX_UNPACK_CASE(34)
+    VELOX_UNPACK_CASE(35)
+    VELOX_UNPACK_CASE(36)
+    VELOX_UNPACK_CASE(37)
+    VELOX_UNPACK_CASE(38)
+    VELOX_UNPACK_CASE(39)
+    VELOX_UNPACK_CASE(40)
+    VELOX_UNPACK_CASE(41)
+    VELOX_UNPACK_CASE(42)
+    VELOX_UNPACK_CASE(43)
+    VELOX_UNPACK_CASE(44)
+    VELOX_UNPACK_CASE(45)
+    VELOX_UNPACK_CASE(46)
+    VELOX_UNPACK_CASE(47)
+    VELOX_UNPACK_CASE(48)
+    VELOX_UNPACK_CASE(49)
+    VELOX_UNPACK_CASE(50)
+    VELOX_UNPACK_CASE(51)
+    VELOX_UNPACK_CASE(52)
+    VELOX_UNPACK_CASE(53)
+    VELOX_UNPACK_CASE(54)
+    VELOX_UNPACK_CASE(55)
+    VELOX_UNPACK_CASE(56)
+    VELOX_UNPACK_CASE(57)
+    VELOX_UNPACK_CASE(64)
+#undef VELOX_UNPACK_CASE
+    default:
+      return 0;
+  }
+  return numGroups * 8;
+}
+
+} // namespace facebook::velox::dwrf
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/dwrf/common/BloomFilter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "velox/dwio/common/exception/Exception.h"
+
+namespace facebook::velox::dwrf {
+
+namespace {
+
+constexpr uint64_t kMurmurC1 = 0x87c37b91114253d5ULL;
+constexpr uint64_t kMurmurC2 = 0x4cf5ad432745937fULL;
+constexpr uint64_t kMurmurSeed = 104729;
+
+inline uint64_t rotateLeft(uint64_t value, int32_t shift) {
+  return (value << shift) | (value >> (64 - shift));
+}
+
+inline uint64_t murmurMixK(uint64_t k) {
+  k *= kMurmurC1;
+  k = rotateLeft(k, 31);
+  return k * kMurmurC2;
+}
+
+inline uint64_t murmurFinalMix(uint64_t h) {
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+} // namespace
+
+BloomFilter::BloomFilter(uint64_t expectedEntries, double fpp) {
+  DWIO_ENSURE_GT(expectedEntries, 0);
+  DWIO_ENSURE(fpp > 0.0 && fpp < 1.0, "Invalid bloom filter fpp ", fpp);
+  auto numBits = static_cast<uint64_t>(
+      -static_cast<double>(expectedEntries) * std::log(fpp) /
+      (std::log(2.0) * std::log(2.0)));
+  // Round up to a whole number of words. Like ORC, a multiple of 64 still gets
+  // an extra word.
+  bits_.resize(numBits / 64 + 1);
+  numHashFunctions_ = std::max<uint32_t>(
+      1,
+      std::round(
+          static_cast<double>(this->numBits()) / expectedEntries *
+          std::log(2.0)));
+}
+
+BloomFilter::BloomFilter(const proto::BloomFilter& bloomFilter)
+    : numHashFunctions_{bloomFilter.numhashfunctions()} {
+  if (bloomFilter.bitset_size() > 0) {
+    bits_.assign(bloomFilter.bitset().begin(), bloomFilter.bitset().end());
+  } else {
+    const auto& bytes = bloomFilter.utf8bitset();
+    DWIO_ENSURE_EQ(bytes.size() % sizeof(uint64_t), 0);
+    bits_.resize(bytes.size() / sizeof(uint64_t));
+    std::memcpy(bits_.data(), bytes.data(), bytes.size());
+  }
+  DWIO_ENSURE_GT(numHashFunctions_, 0);
+  DWIO_ENSURE(!bits_.empty(), "Empty bloom filter");
+}
+
+void BloomFilter::reset() {
+  std::fill(bits_.begin(), bits_.end(), 0);
+}
+
+void BloomFilter::serialize(proto::BloomFilter& bloomFilter) const {
+  bloomFilter.set_numhashfunctions(numHashFunctions_);
+  // The filters go in BLOOM_FILTER_UTF8 streams, where ORC readers expect
+  // the words as little endian bytes.
+  bloomFilter.clear_bitset();
+  bloomFilter.set_utf8bitset(
+      reinterpret_cast<const char*>(bits_.data()),
+      bits_.size() * sizeof(uint64_t));
+}
+
+void BloomFilter::addHash(uint64_t hash) {
+  for (uint32_t i = 1; i <= numHashFunctions_; ++i) {
+    auto position = probe(hash, i);
+    bits_[position / 64] |= 1ULL << (position % 64);
+  }
+}
+
+bool BloomFilter::testHash(uint64_t hash) const {
+  for (uint32_t i = 1; i <= numHashFunctions_; ++i) {
+    auto position = probe(hash, i);
+    if (!(bits_[position / 64] & (1ULL << (position % 64)))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// static
+uint64_t BloomFilter::hashInt64(int64_t value) {
+  // ORC's getLongHash works on a signed long, so the right shifts are
+  // arithmetic. Additions and left shifts wrap, which is well defined only
+  // on the unsigned type.
+  auto shiftRight = [](uint64_t key, int32_t bits) {
+    return static_cast<uint64_t>(static_cast<int64_t>(key) >> bits);
+  };
+  auto key = static_cast<uint64_t>(value);
+  key = (~key) + (key << 21);
+  key ^= shiftRight(key, 24);
+  key = (key + (key << 3)) + (key << 8);
+  key ^= shiftRight(key, 14);
+  key = (key + (key << 2)) + (key << 4);
+  key ^= shiftRight(key, 28);
+  key += key << 31;
+  return key;
+}
+
+// static
+uint64_t BloomFilter::hashBytes(const char* data, size_t size) {
+  auto bytes = reinterpret_cast<const uint8_t*>(data);
+  uint64_t hash = kMurmurSeed;
+  auto numBlocks = size / 8;
+  for (size_t i = 0; i < numBlocks; ++i) {
+    uint64_t k;
+    std::memcpy(&k, bytes + i * 8, sizeof(k));
+    hash ^= murmurMixK(k);
+    hash = rotateLeft(hash, 27) * 5 + 0x52dce729;
+  }
+  auto tail = bytes + numBlocks * 8;
+  auto tailSize = size - numBlocks * 8;
+  if (tailSize > 0) {
+    uint64_t k = 0;
+    for (size_t i = 0; i < tailSize; ++i) {
+      k ^= static_cast<uint64_t>(tail[i]) << (i * 8);
+    }
+    hash ^= murmurMixK(k);
+  }
+  hash ^= size;
+  return murmurFinalMix(hash);
+}
+
+} // namespace facebook::velox::dwrf
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "velox/dwio/dwrf/common/wrap/dwrf-proto-wrapper.h"
+
+namespace facebook::velox::dwrf {
+
+/// Bloom filter over the values of one row group. The bit layout and the
+/// hashing (Thomas Wang's 64 bit mix for integers, 64 bit Murmur3 for bytes,
+/// combined into k probes with the Kirsch-Mitzenmacher scheme) follow the ORC
+/// bloom filter so that files stay readable by other ORC/DWRF readers.
+class BloomFilter {
+ public:
+  /// Sizes the filter for 'expectedEntries' distinct values at a false
+  /// positive probability of 'fpp'.
+  BloomFilter(uint64_t expectedEntries, double fpp);
+
+  explicit BloomFilter(const proto::BloomFilter& bloomFilter);
+
+  void addInt64(int64_t value) {
+    addHash(hashInt64(value));
+  }
+
+  void addBytes(const char* data, size_t size) {
+    addHash(hashBytes(data, size));
+  }
+
+  /// Returns false if 'value' was definitely not added.
+  bool testInt64(int64_t value) const {
+    return testHash(hashInt64(value));
+  }
+
+  bool testBytes(const char* data, size_t size) const {
+    return testHash(hashBytes(data, size));
+  }
+
+  /// Clears all bits, keeping the size.
+  void reset();
+
+  /// Writes the bits to 'utf8bitset' of 'bloomFilter', as ORC does for
+  /// BLOOM_FILTER_UTF8 streams.
+  void serialize(proto::BloomFilter& bloomFilter) const;
+
+  uint32_t numHashFunctions() const {
+    return numHashFunctions_;
+  }
+
+  uint64_t numBits() const {
+    return bits_.size() * 64;
+  }
+
+  static uint64_t hashInt64(int64_t value);
+
+  static uint64_t hashBytes(const char* data, size_t size);
+
+ private:
+  void addHash(uint64_t hash);
+
+  bool testHash(uint64_t hash) const;
+
+  // Returns the bit position of the 'i'th probe for 'hash'.
+  uint64_t probe(uint64_t hash, uint32_t i) const {
+    auto hash1 = static_cast<uint32_t>(hash);
+    auto hash2 = static_cast<uint32_t>(hash >> 32);
+    auto combined = static_cast<int32_t>(hash1 + i * hash2);
+    if (combined < 0) {
+      combined = ~combined;
+    }
+    return combined % numBits();
+  }
+
+  uint32_t numHashFunctions_;
+  std::vector<uint64_t> bits_;
+};
+
+} // namespace facebook::velox::dwrf
@@ -21,6 +21,8 @@
 #include "velox/dwio/dwrf/common/Common.h"
 #include "velox/dwio/dwrf/common/InputStream.h"
 
+#include <folly/Executor.h>
+
 namespace facebook::velox::dwrf {
 
 class BufferedInput {
@@ -88,6 +90,19 @@ class BufferedInput {
     return false;
   }
 
+  // Executor for decompressing the compression blocks of streams read
+  // through 'this' ahead of the reader. nullptr if blocks are decompressed
+  // on demand by the reading thread.
+  virtual folly::Executor* decompressAheadExecutor() const {
+    return nullptr;
+  }
+
+  // Bound on the uncompressed bytes a stream holds ahead of its reader when
+  // decompressAheadExecutor() is set.
+  virtual uint64_t maxDecompressAheadBytes() const {
+    return 0;
+  }
+
  protected:
   dwio::common::InputStream& input_;
 
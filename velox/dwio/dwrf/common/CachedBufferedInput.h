@@ -53,7 +53,8 @@ class CachedBufferedInput : public BufferedInput {
       uint64_t groupId,
       StreamSource streamSource,
       std::shared_ptr<dwio::common::IoStatistics> ioStats,
-      folly::Executor* executor)
+      folly::Executor* executor,
+      uint64_t maxDecompressAheadBytes = 0)
       : BufferedInput(input, pool, dataCacheConfig),
         cache_(cache),
         fileNum_(dataCacheConfig->filenum),
@@ -61,7 +62,8 @@ class CachedBufferedInput : public BufferedInput {
         groupId_(groupId),
         streamSource_(streamSource),
         ioStats_(std::move(ioStats)),
-        executor_(executor) {}
+        executor_(executor),
+        maxDecompressAheadBytes_(maxDecompressAheadBytes) {}
 
   ~CachedBufferedInput() override {
     for (auto& load : fusedLoads_) {
@@ -92,6 +94,14 @@ class CachedBufferedInput : public BufferedInput {
     return true;
   }
 
+  folly::Executor* decompressAheadExecutor() const override {
+    return maxDecompressAheadBytes_ > 0 ? executor_ : nullptr;
+  }
+
+  uint64_t maxDecompressAheadBytes() const override {
+    return maxDecompressAheadBytes_;
+  }
+
  private:
   struct CacheRequest {
     cache::RawFileCacheKey key;
@@ -123,6 +133,10 @@ class CachedBufferedInput : public BufferedInput {
   std::shared_ptr<dwio::common::IoStatistics> ioStats_;
   folly::Executor* const executor_;
 
+  // If non-0, streams decompress up to this many bytes on 'executor_' ahead
+  // of their reader.
+  const uint64_t maxDecompressAheadBytes_;
+
   //  Percentage of reads over enqueues that qualifies a stream to be
   //  coalesced with nearby streams and prefetched. Anything read less
   //  frequently will be synchronously read on first use.
@@ -142,13 +156,15 @@ class CachedBufferedInputFactory : public BufferedInputFactory {
       uint64_t groupId,
       StreamSource streamSource,
       std::shared_ptr<dwio::common::IoStatistics> ioStats,
-      folly::Executor* executor)
+      folly::Executor* executor,
+      uint64_t maxDecompressAheadBytes = 0)
       : cache_(cache),
         tracker_(std::move(tracker)),
         groupId_(groupId),
         streamSource_(streamSource),
         ioStats_(ioStats),
-        executor_(executor) {}
+        executor_(executor),
+        maxDecompressAheadBytes_(maxDecompressAheadBytes) {}
 
   std::unique_ptr<BufferedInput> create(
       dwio::common::InputStream& input,
@@ -163,7 +179,8 @@ class CachedBufferedInputFactory : public BufferedInputFactory {
         groupId_,
         streamSource_,
         ioStats_,
-        executor_);
+        executor_,
+        maxDecompressAheadBytes_);
   }
 
   std::string toString() const {
@@ -180,5 +197,6 @@ class CachedBufferedInputFactory : public BufferedInputFactory {
   StreamSource streamSource_;
   std::shared_ptr<dwio::common::IoStatistics> ioStats_;
   folly::Executor* executor_;
+  const uint64_t maxDecompressAheadBytes_;
 };
 } // namespace facebook::velox::dwrf
@@ -82,6 +82,13 @@ enum StreamKind {
  */
 std::string streamKindToString(StreamKind kind);
 
+/**
+ * Index streams are laid out ahead of the data streams of a stripe.
+ */
+inline bool isIndexStream(StreamKind kind) {
+  return kind == StreamKind_ROW_INDEX || kind == StreamKind_BLOOM_FILTER_UTF8;
+}
+
 class StreamInformation {
  public:
   virtual ~StreamInformation() = default;
@@ -428,6 +428,28 @@ bool ZlibDecompressionStream::Next(const void** data, int32_t* size) {
   return true;
 }
 
+std::unique_ptr<Decompressor> makeDecompressor(
+    CompressionKind kind,
+    uint64_t blockSize,
+    const std::string& streamDebugInfo) {
+  switch (static_cast<int64_t>(kind)) {
+    case CompressionKind_NONE:
+      return nullptr;
+    case CompressionKind_ZLIB:
+      return std::make_unique<ZlibDecompressor>(blockSize, streamDebugInfo);
+    case CompressionKind_SNAPPY:
+      return std::make_unique<SnappyDecompressor>(blockSize, streamDebugInfo);
+    case CompressionKind_LZO:
+      return std::make_unique<LzoDecompressor>(blockSize, streamDebugInfo);
+    case CompressionKind_LZ4:
+      return std::make_unique<Lz4Decompressor>(blockSize, streamDebugInfo);
+    case CompressionKind_ZSTD:
+      return std::make_unique<ZstdDecompressor>(blockSize, streamDebugInfo);
+    default:
+      DWIO_RAISE("Unknown compression codec ", kind);
+  }
+}
+
 } // namespace
 
 std::unique_ptr<BufferedOutputStream> createCompressor(
@@ -468,50 +490,36 @@ std::unique_ptr<SeekableInputStream> createDecompressor(
     uint64_t blockSize,
     MemoryPool& pool,
     const std::string& streamDebugInfo,
-    const Decrypter* decrypter) {
-  std::unique_ptr<Decompressor> decompressor;
-  switch (static_cast<int64_t>(kind)) {
-    case CompressionKind_NONE:
-      if (!decrypter) {
-        return input;
-      }
-      // decompressor remain as nullptr
-      break;
-    case CompressionKind_ZLIB:
-      if (!decrypter) {
-        // When file is not encrypted, we can use zlib streaming codec to avoid
-        // copying data
-        return std::make_unique<ZlibDecompressionStream>(
-            std::move(input), blockSize, pool, streamDebugInfo);
-      }
-      decompressor =
-          std::make_unique<ZlibDecompressor>(blockSize, streamDebugInfo);
-      break;
-    case CompressionKind_SNAPPY:
-      decompressor =
-          std::make_unique<SnappyDecompressor>(blockSize, streamDebugInfo);
-      break;
-    case CompressionKind_LZO:
-      decompressor =
-          std::make_unique<LzoDecompressor>(blockSize, streamDebugInfo);
-      break;
-    case CompressionKind_LZ4:
-      decompressor =
-          std::make_unique<Lz4Decompressor>(blockSize, streamDebugInfo);
-      break;
-    case CompressionKind_ZSTD:
-      decompressor =
-          std::make_unique<ZstdDecompressor>(blockSize, streamDebugInfo);
-      break;
-    default:
-      DWIO_RAISE("Unknown compression codec ", kind);
+    const Decrypter* decrypter,
+    folly::Executor* decompressAheadExecutor,
+    uint64_t maxDecompressAheadBytes) {
+  if (kind == CompressionKind_NONE && !decrypter) {
+    return input;
   }
-  return std::make_unique<PagedInputStream>(
+  bool decompressAhead = decompressAheadExecutor &&
+      maxDecompressAheadBytes > 0 && kind != CompressionKind_NONE &&
+      !decrypter;
+  if (kind == CompressionKind_ZLIB && !decrypter && !decompressAhead) {
+    // When file is not encrypted, we can use zlib streaming codec to avoid
+    // copying data
+    return std::make_unique<ZlibDecompressionStream>(
+        std::move(input), blockSize, pool, streamDebugInfo);
+  }
+  auto stream = std::make_unique<PagedInputStream>(
       std::move(input),
       pool,
-      std::move(decompressor),
+      makeDecompressor(kind, blockSize, streamDebugInfo),
       decrypter,
       streamDebugInfo);
+  if (decompressAhead) {
+    stream->setDecompressAhead(
+        decompressAheadExecutor,
+        [kind, blockSize, streamDebugInfo]() {
+          return makeDecompressor(kind, blockSize, streamDebugInfo);
+        },
+        maxDecompressAheadBytes);
+  }
+  return stream;
 }
 
 } // namespace facebook::velox::dwrf
@@ -24,6 +24,8 @@
 #include "velox/dwio/dwrf/common/InputStream.h"
 #include "velox/dwio/dwrf/common/OutputStream.h"
 
+#include <folly/Executor.h>
+
 namespace facebook::velox::dwrf {
 
 constexpr uint8_t PAGE_HEADER_SIZE = 3;
@@ -70,6 +72,10 @@ class Decompressor {
  * @param input the input stream that is the underlying source
  * @param bufferSize the maximum size of the buffer
  * @param pool the memory pool
+ * @param decompressAheadExecutor if set, compression blocks are decompressed
+ * on this executor ahead of the reader. Ignored for encrypted streams
+ * @param maxDecompressAheadBytes bound on the uncompressed bytes held ahead
+ * of the reader
  */
 std::unique_ptr<SeekableInputStream> createDecompressor(
     CompressionKind kind,
@@ -77,7 +83,9 @@ std::unique_ptr<SeekableInputStream> createDecompressor(
     uint64_t bufferSize,
     memory::MemoryPool& pool,
     const std::string& streamDebugInfo,
-    const dwio::common::encryption::Decrypter* decryptr = nullptr);
+    const dwio::common::encryption::Decrypter* decryptr = nullptr,
+    folly::Executor* decompressAheadExecutor = nullptr,
+    uint64_t maxDecompressAheadBytes = 0);
 
 /**
  * Create a compressor for the given compression kind.
@@ -105,6 +105,10 @@ class Config {
   static Entry<bool> MAP_FLAT_DICT_SHARE;
   static Entry<const std::vector<uint32_t>> MAP_FLAT_COLS;
   static Entry<uint32_t> MAP_FLAT_MAX_KEYS;
+  // Top level columns that get a bloom filter per row group. Only integer and
+  // string columns are supported.
+  static Entry<const std::vector<uint32_t>> BLOOM_FILTER_COLUMNS;
+  static Entry<double> BLOOM_FILTER_FPP;
   static Entry<uint64_t> MAX_DICTIONARY_SIZE;
   static Entry<uint64_t> STRIPE_SIZE;
   // With this config, we don't even try the more memory intensive encodings
@@ -17,8 +17,76 @@
 #include "velox/dwio/dwrf/common/PagedInputStream.h"
 #include "velox/dwio/common/exception/Exception.h"
 
+#include <atomic>
+
 namespace facebook::velox::dwrf {
 
+struct PagedInputStream::AheadBlock {
+  explicit AheadBlock(memory::MemoryPool& pool) : input{pool} {}
+
+  // True if the caller is the one to decompress 'this'. Both the reading
+  // thread and the background work may try, whichever comes first wins.
+  bool claim() {
+    return !claimed.exchange(true);
+  }
+
+  void decompress(Decompressor& decompressor) {
+    try {
+      size = decompressor.decompress(
+          input.data(), input.size(), output->data(), output->capacity());
+    } catch (...) {
+      error = std::current_exception();
+    }
+  }
+
+  // Frees the buffers. Called on the reading thread once the background
+  // work is done with them, so that they are not freed on a background
+  // thread after the stream and its pool are gone.
+  void freeBuffers() {
+    input.clear();
+    output = nullptr;
+  }
+
+  // Bytes counted against the read ahead budget.
+  uint64_t reservedBytes() const {
+    return output ? output->capacity() : input.size();
+  }
+
+  const char* data() const {
+    return output ? output->data() : input.data();
+  }
+
+  // Offset of the block header in the compressed stream.
+  uint64_t headerOffset{0};
+  // The block as stored in the stream, without header.
+  dwio::common::DataBuffer<char> input;
+  // Decompressed block. nullptr if the block is stored uncompressed.
+  std::unique_ptr<dwio::common::DataBuffer<char>> output;
+  // Bytes of data(). Set by decompress() for compressed blocks.
+  uint64_t size{0};
+  std::atomic<bool> claimed{false};
+  // Posted after decompress(), whichever thread claimed 'this'.
+  folly::Baton<> done;
+  std::exception_ptr error;
+};
+
+PagedInputStream::~PagedInputStream() {
+  clearAhead();
+}
+
+void PagedInputStream::setDecompressAhead(
+    folly::Executor* executor,
+    std::function<std::unique_ptr<Decompressor>()> makeDecompressor,
+    uint64_t maxBytes) {
+  DWIO_ENSURE(
+      decompressor_ && !decrypter_,
+      "Decompressing ahead needs an unencrypted compressed stream");
+  DWIO_ENSURE(makeDecompressor != nullptr);
+  aheadExecutor_ = executor;
+  makeAheadDecompressor_ = std::move(makeDecompressor);
+  maxAheadBytes_ = maxBytes;
+}
+
 void PagedInputStream::prepareOutputBuffer(uint64_t uncompressedLength) {
   if (!outputBuffer_ || uncompressedLength > outputBuffer_->capacity()) {
     outputBuffer_ = std::make_unique<dwio::common::DataBuffer<char>>(
@@ -113,6 +181,10 @@ bool PagedInputStream::Next(const void** data, int32_t* size) {
     return true;
   }
 
+  if (aheadExecutor_) {
+    return nextAhead(data, size);
+  }
+
   // release previous decryption buffer
   decryptionBuffer_ = nullptr;
 
@@ -183,6 +255,130 @@ bool PagedInputStream::Next(const void** data, int32_t* size) {
   return true;
 }
 
+void PagedInputStream::copyInput(char* dest, size_t length) {
+  for (size_t pos = 0; pos < length;) {
+    if (inputBufferPtr_ == inputBufferPtrEnd_) {
+      readBuffer(true);
+    }
+    auto bytes = std::min(
+        static_cast<size_t>(inputBufferPtrEnd_ - inputBufferPtr_),
+        length - pos);
+    std::copy(inputBufferPtr_, inputBufferPtr_ + bytes, dest + pos);
+    inputBufferPtr_ += bytes;
+    pos += bytes;
+  }
+}
+
+void PagedInputStream::readAhead() {
+  // Reading headers ahead must not move the position reported for seeking.
+  auto headerOffset = lastHeaderOffset_;
+  auto bytesReturnedAtHeader = bytesReturnedAtLastHeaderOffset_;
+  std::vector<std::shared_ptr<AheadBlock>> batch;
+  while (state_ != State::END &&
+         (aheadBlocks_.empty() || aheadBytes_ < maxAheadBytes_)) {
+    readHeader();
+    if (state_ == State::END) {
+      break;
+    }
+    auto block = std::make_shared<AheadBlock>(pool_);
+    block->headerOffset = lastHeaderOffset_;
+    block->input.resize(remainingLength_);
+    copyInput(block->input.data(), remainingLength_);
+    if (state_ == State::START) {
+      block->output = std::make_unique<dwio::common::DataBuffer<char>>(
+          pool_,
+          decompressor_->getUncompressedLength(
+              block->input.data(), remainingLength_));
+      batch.push_back(block);
+    } else {
+      block->claimed = true;
+      block->size = remainingLength_;
+    }
+    state_ = State::HEADER;
+    remainingLength_ = 0;
+    aheadBytes_ += block->reservedBytes();
+    aheadBlocks_.push_back(std::move(block));
+  }
+  lastHeaderOffset_ = headerOffset;
+  bytesReturnedAtLastHeaderOffset_ = bytesReturnedAtHeader;
+  if (batch.empty()) {
+    return;
+  }
+  // Each batch has its own Decompressor, so that the reading thread never
+  // waits for an earlier batch the executor has not gotten to. Blocks the
+  // reading thread claims first are skipped here.
+  aheadExecutor_->add([batch = std::move(batch),
+                       decompressor = makeAheadDecompressor_()]() {
+    for (auto& block : batch) {
+      if (block->claim()) {
+        block->decompress(*decompressor);
+        block->done.post();
+      }
+    }
+  });
+}
+
+void PagedInputStream::releaseAheadBlock(std::shared_ptr<AheadBlock>& block) {
+  if (!block) {
+    return;
+  }
+  if (!block->claim() && block->output) {
+    // The background work is decompressing 'block'. This waits for running
+    // work only, never for work that is still queued.
+    block->done.wait();
+  }
+  block->freeBuffers();
+  block = nullptr;
+}
+
+bool PagedInputStream::nextAhead(const void** data, int32_t* size) {
+  releaseAheadBlock(currentAheadBlock_);
+  if (aheadBlocks_.empty()) {
+    readAhead();
+    if (aheadBlocks_.empty()) {
+      return false;
+    }
+  }
+  auto block = std::move(aheadBlocks_.front());
+  aheadBlocks_.pop_front();
+  aheadBytes_ -= block->reservedBytes();
+  if (block->output) {
+    if (block->claim()) {
+      // The background work has not gotten to 'block' yet.
+      block->decompress(*decompressor_);
+      block->done.post();
+    } else {
+      block->done.wait();
+    }
+    if (block->error) {
+      std::rethrow_exception(block->error);
+    }
+  }
+  lastHeaderOffset_ = block->headerOffset;
+  bytesReturnedAtLastHeaderOffset_ = bytesReturned_;
+  *data = block->data();
+  *size = static_cast<int32_t>(block->size);
+  outputBufferPtr_ = block->data() + block->size;
+  outputBufferLength_ = 0;
+  bytesReturned_ += block->size;
+  currentAheadBlock_ = std::move(block);
+  // Top up when half of the budget is consumed.
+  if (aheadBytes_ < maxAheadBytes_ / 2) {
+    readAhead();
+  }
+  return true;
+}
+
+void PagedInputStream::clearAhead() {
+  // Claiming the blocks detaches them from batches that have not run yet.
+  for (auto& block : aheadBlocks_) {
+    releaseAheadBlock(block);
+  }
+  aheadBlocks_.clear();
+  aheadBytes_ = 0;
+  releaseAheadBlock(currentAheadBlock_);
+}
+
 void PagedInputStream::BackUp(int32_t count) {
   DWIO_ENSURE(
       outputBufferPtr_ != nullptr,
@@ -213,6 +409,7 @@ bool PagedInputStream::Skip(int32_t count) {
 }
 
 void PagedInputStream::clearDecompressionState() {
+  clearAhead();
   state_ = State::HEADER;
   outputBufferLength_ = 0;
   remainingLength_ = 0;
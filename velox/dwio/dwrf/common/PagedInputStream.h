@@ -18,6 +18,12 @@
 
 #include "velox/dwio/dwrf/common/Compression.h"
 
+#include <folly/Executor.h>
+#include <folly/synchronization/Baton.h>
+
+#include <deque>
+#include <functional>
+
 namespace facebook::velox::dwrf {
 
 class PagedInputStream : public SeekableInputStream {
@@ -39,6 +45,17 @@ class PagedInputStream : public SeekableInputStream {
         "one of decompressor or decryptor is required");
   }
 
+  ~PagedInputStream() override;
+
+  // Decompresses up to 'maxBytes' of the compression blocks following the
+  // read position on 'executor' ahead of Next(). 'makeDecompressor' makes a
+  // Decompressor for each batch of blocks given to 'executor'. Not
+  // supported for encrypted streams.
+  void setDecompressAhead(
+      folly::Executor* executor,
+      std::function<std::unique_ptr<Decompressor>()> makeDecompressor,
+      uint64_t maxBytes);
+
   bool Next(const void** data, int32_t* size) override;
   void BackUp(int32_t count) override;
   bool Skip(int32_t count) override;
@@ -138,8 +155,49 @@ class PagedInputStream : public SeekableInputStream {
   const dwio::common::encryption::Decrypter* decrypter_;
 
  private:
+  // A compression block read ahead of Next().
+  struct AheadBlock;
+
+  // Returns the next block from 'aheadBlocks_', reading more blocks ahead as
+  // needed.
+  bool nextAhead(const void** data, int32_t* size);
+
+  // Reads whole compression blocks from 'input_' into 'aheadBlocks_' until
+  // 'maxAheadBytes_' are buffered and schedules their decompression on
+  // 'aheadExecutor_'.
+  void readAhead();
+
+  // Drops the blocks read ahead. Blocks that background work has not
+  // started on are skipped by it.
+  void clearAhead();
+
+  // Frees the buffers of 'block' and resets it. Waits if the background
+  // work is decompressing 'block'.
+  void releaseAheadBlock(std::shared_ptr<AheadBlock>& block);
+
+  // Copies the next 'length' bytes of 'input_' to 'dest'.
+  void copyInput(char* dest, size_t length);
+
   // Stream Debug Info
   const std::string streamDebugInfo_;
+
+  folly::Executor* aheadExecutor_{nullptr};
+
+  // Makes a Decompressor for each batch of background work. Blocks
+  // decompressed on the reading thread use 'decompressor_'.
+  std::function<std::unique_ptr<Decompressor>()> makeAheadDecompressor_;
+
+  // Bound on the uncompressed bytes in 'aheadBlocks_'.
+  uint64_t maxAheadBytes_{0};
+
+  // Blocks read ahead of the current position, in stream order.
+  std::deque<std::shared_ptr<AheadBlock>> aheadBlocks_;
+
+  // Uncompressed bytes in 'aheadBlocks_'.
+  uint64_t aheadBytes_{0};
+
+  // The block returned by the last Next(). Keeps its buffer alive.
+  std::shared_ptr<AheadBlock> currentAheadBlock_;
 };
 
 } // namespace facebook::velox::dwrf
@@ -21,6 +21,7 @@
 #include "velox/dwio/common/DataBuffer.h"
 #include "velox/dwio/common/exception/Exception.h"
 #include "velox/dwio/dwrf/common/Adaptor.h"
+#include "velox/dwio/dwrf/common/BitUnpack.h"
 #include "velox/dwio/dwrf/common/IntDecoder.h"
 
 #include <vector>
@@ -113,9 +114,24 @@ class RleDecoderV2 : public IntDecoder<isSigned> {
       uint64_t fb,
       const uint64_t* nulls = nullptr) {
     uint64_t ret = 0;
+    uint64_t i = offset;
+
+    // Unpack whole groups of 8 straight from the input buffer when the next
+    // value starts on a byte boundary.
+    if (!nulls && bitsLeft == 0) {
+      auto& bufferStart = IntDecoder<isSigned>::bufferStart;
+      const auto numUnpacked = unpackBitPacked(
+          bufferStart,
+          IntDecoder<isSigned>::bufferEnd - bufferStart,
+          fb,
+          len,
+          data + offset);
+      bufferStart += numUnpacked / 8 * fb;
+      i += numUnpacked;
+      ret += numUnpacked;
+    }
 
-    // TODO: unroll to improve performance
-    for (uint64_t i = offset; i < (offset + len); i++) {
+    for (; i < (offset + len); i++) {
       // skip null positions
       if (nulls && bits::isBitNull(nulls, i)) {
         continue;
@@ -860,9 +860,9 @@ class StringDictionaryColumnReader : public ColumnReader {
   std::unique_ptr<proto::RowIndex> rowIndex_;
   const StrideIndexProvider& provider;
 
-  // lazy load the dictionary
-  std::unique_ptr<IntDecoder</*isSigned*/ false>> lengthDecoder;
-  std::unique_ptr<SeekableInputStream> blobStream;
+  // lazy load the dictionary, shared with other readers of the stripe
+  std::function<std::shared_ptr<StringDictionary>()> dictInit_;
+  std::shared_ptr<StringDictionary> dictionary_;
   const bool returnFlatVector_;
   const TypePtr type_;
   bool initialized_{false};
@@ -934,17 +934,7 @@ StringDictionaryColumnReader::StringDictionaryColumnReader(
       dictVInts,
       INT_BYTE_SIZE);
 
-  const auto lenId = ek.forKind(proto::Stream_Kind_LENGTH);
-  bool lenVInts = stripe.getUseVInts(lenId);
-  lengthDecoder = IntDecoder</*isSigned*/ false>::createRle(
-      stripe.getStream(lenId, false),
-      rleVersion,
-      memoryPool,
-      lenVInts,
-      INT_BYTE_SIZE);
-
-  blobStream =
-      stripe.getStream(ek.forKind(proto::Stream_Kind_DICTIONARY_DATA), false);
+  dictInit_ = stripe.getStringDictionaryInitializerForNode(ek);
 
   // handle in dictionary stream
   std::unique_ptr<SeekableInputStream> inDictStream =
@@ -1034,7 +1024,7 @@ void StringDictionaryColumnReader::loadStrideDictionary() {
 
   lastStrideIndex = nextStride;
 
-  dictionaryValues_.reset();
+  // The stripe dictionary is unchanged, only the combined one is stale.
   combinedDictionaryValues_.reset();
 }
 
@@ -1177,19 +1167,22 @@ void StringDictionaryColumnReader::readDictionaryVector(
     }
   }
 
+  if (!dictionaryValues_) {
+    dictionaryValues_ = dictionary_->values(type_, &memoryPool);
+  }
+
   VectorPtr dictionaryValues;
-  const auto* dictionaryBlobPtr = dictionaryBlob->as<char>();
-  const auto* dictionaryOffsetsPtr = dictionaryOffset->as<int64_t>();
   if (hasStrideDict) {
     if (!combinedDictionaryValues_) {
       // TODO Reuse memory
       BufferPtr values = AlignedBuffer::allocate<StringView>(
           dictionaryCount + strideDictCount, &memoryPool);
       auto* valuesPtr = values->asMutable<StringView>();
-      for (size_t i = 0; i < dictionaryCount; i++) {
-        valuesPtr[i] = StringView(
-            dictionaryBlobPtr + dictionaryOffsetsPtr[i],
-            dictionaryOffsetsPtr[i + 1] - dictionaryOffsetsPtr[i]);
+      if (dictionaryCount > 0) {
+        memcpy(
+            valuesPtr,
+            dictionaryValues_->rawValues(),
+            dictionaryCount * sizeof(StringView));
       }
 
       const auto* strideDictPtr = strideDict->as<char>();
@@ -1211,25 +1204,6 @@ void StringDictionaryColumnReader::readDictionaryVector(
 
     dictionaryValues = combinedDictionaryValues_;
   } else {
-    if (!dictionaryValues_) {
-      // TODO Reuse memory
-      BufferPtr values =
-          AlignedBuffer::allocate<StringView>(dictionaryCount, &memoryPool);
-      auto* valuesPtr = values->asMutable<StringView>();
-      for (size_t i = 0; i < dictionaryCount; i++) {
-        valuesPtr[i] = StringView(
-            dictionaryBlobPtr + dictionaryOffsetsPtr[i],
-            dictionaryOffsetsPtr[i + 1] - dictionaryOffsetsPtr[i]);
-      }
-
-      dictionaryValues_ = std::make_shared<FlatVector<StringView>>(
-          &memoryPool,
-          type_,
-          BufferPtr(nullptr), // TODO nulls
-          dictionaryCount /*length*/,
-          values,
-          std::vector<BufferPtr>{dictionaryBlob});
-    }
     dictionaryValues = dictionaryValues_;
   }
 
@@ -1275,7 +1249,7 @@ void StringDictionaryColumnReader::readFlatVector(
     strideDictOffsetPtr = strideDictOffset->asMutable<int64_t>();
   }
   auto* dictionaryBlobPtr = dictionaryBlob->as<char>();
-  auto* dictionaryOffsetsPtr = dictionaryOffset->asMutable<int64_t>();
+  auto* dictionaryOffsetsPtr = dictionaryOffset->as<int64_t>();
   bool hasStrideDict = false;
   const char* strData;
   int64_t strLen;
@@ -1334,9 +1308,10 @@ void StringDictionaryColumnReader::ensureInitialized() {
     return;
   }
 
-  ensureCapacity<int64_t>(dictionaryOffset, dictionaryCount + 1, &memoryPool);
-  dictionaryBlob = loadDictionary(
-      dictionaryCount, *blobStream, *lengthDecoder, dictionaryOffset);
+  dictionary_ = dictInit_();
+  DWIO_ENSURE_EQ(dictionary_->count(), dictionaryCount);
+  dictionaryBlob = dictionary_->blob();
+  dictionaryOffset = dictionary_->offsets();
   dictionaryValues_.reset();
   combinedDictionaryValues_.reset();
 
@@ -16,6 +16,7 @@
 
 #include "velox/dwio/dwrf/reader/DwrfReader.h"
 #include "velox/dwio/common/exception/Exception.h"
+#include "velox/dwio/dwrf/reader/SelectiveColumnReader.h"
 
 namespace facebook::velox::dwrf {
 
@@ -40,14 +41,17 @@ void DwrfRowReader::checkSkipStrides(
     return;
   }
 
-  if (currentRowInStripe == 0) {
+  if (currentRowInStripe == 0 || stridesToSkipStale_) {
     stridesToSkip_ = columnReader_->filterRowGroups(strideSize, context);
+    stridesToSkipStale_ = false;
   }
 
   if (stridesToSkip_.empty()) {
     return;
   }
 
+  bool atStripeStart = currentRowInStripe == 0;
+
   bool foundStridesToSkip = false;
   auto currentStride = currentRowInStripe / strideSize;
   for (auto strideToSkip : stridesToSkip_) {
@@ -66,6 +70,21 @@ void DwrfRowReader::checkSkipStrides(
   if (foundStridesToSkip && currentRowInStripe < rowsInCurrentStripe) {
     columnReader_->seekToRowGroup(currentStride);
   }
+  if (atStripeStart && currentRowInStripe >= rowsInCurrentStripe) {
+    skippedStripes_++;
+  }
+}
+
+void DwrfRowReader::resetFilterCaches() {
+  if (!columnReader_) {
+    // The column readers of the next stripe see the new filters.
+    return;
+  }
+  if (auto selectiveReader =
+          dynamic_cast<SelectiveColumnReader*>(columnReader_.get())) {
+    selectiveReader->resetFilterCaches();
+  }
+  stridesToSkipStale_ = true;
 }
 
 uint64_t DwrfRowReader::next(uint64_t size, VectorPtr& result) {
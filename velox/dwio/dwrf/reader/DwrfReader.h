@@ -61,6 +61,16 @@ class DwrfRowReader : public DwrfRowReaderShared {
     return skippedStrides_;
   }
 
+  // Number of stripes whose strides were all skipped based on the row index.
+  int64_t skippedStripes() const {
+    return skippedStripes_;
+  }
+
+  // Discards filter results cached by the column readers and checks the
+  // row index of the current stripe again at the next stride. Called after a
+  // filter in the ScanSpec changes, e.g. when a dynamic filter is added.
+  void resetFilterCaches();
+
   ColumnReader* columnReader() {
     return columnReader_.get();
   }
@@ -70,9 +80,15 @@ class DwrfRowReader : public DwrfRowReaderShared {
 
   std::unique_ptr<ColumnReader> columnReader_;
   std::vector<uint32_t> stridesToSkip_;
+  // True if 'stridesToSkip_' was computed with filters that have since
+  // changed.
+  bool stridesToSkipStale_{false};
 
   // Number of skipped strides.
   int64_t skippedStrides_{0};
+
+  // Number of stripes skipped as a whole.
+  int64_t skippedStripes_{0};
 };
 
 class DwrfReader : public DwrfReaderShared {
@@ -197,7 +197,8 @@ DwrfReaderShared::DwrfReaderShared(
           options.getBufferedInputFactory()
               ? options.getBufferedInputFactory()
               : BufferedInputFactory::baseFactory(),
-          options.getDataCacheConfig().get())),
+          options.getDataCacheConfig().get(),
+          options.getFileMetadata())),
       options_(options) {}
 
 std::unique_ptr<StripeInformation> DwrfReaderShared::getStripe(
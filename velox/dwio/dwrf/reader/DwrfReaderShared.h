@@ -199,6 +199,13 @@ class DwrfReaderShared {
     return readerBase_->getFooter();
   }
 
+  /// Returns the parsed tail of the file for opening later readers of the
+  /// same file. See ReaderBase::makeFileMetadata.
+  std::shared_ptr<const FileMetadata> makeFileMetadata(
+      memory::MemoryPool& pool) const {
+    return readerBase_->makeFileMetadata(pool);
+  }
+
   static uint64_t getMemoryUse(
       ReaderBase& readerBase,
       int32_t stripeIx,
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/dwrf/reader/FileMetadataCache.h"
+
+namespace facebook::velox::dwrf {
+
+std::shared_ptr<const FileMetadata> FileMetadataCache::get(
+    const std::string& path,
+    uint64_t fileLength) {
+  std::shared_ptr<const FileMetadata> metadata;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (auto entry = cache_.get(path)) {
+      metadata = *entry;
+      cache_.release(path);
+      // The file has been rewritten. Drop the stale entry so that the new
+      // tail can be put.
+      if (metadata->fileLength != fileLength) {
+        cache_.erase(path);
+        metadata = nullptr;
+      }
+    }
+  }
+  if (metadata) {
+    ++numHits_;
+    return metadata;
+  }
+  ++numMisses_;
+  return nullptr;
+}
+
+void FileMetadataCache::put(
+    const std::string& path,
+    const DwrfReaderShared& reader) {
+  // Copying out of 'reader' is done outside of the lock.
+  auto metadata = reader.makeFileMetadata(*pool_);
+  auto size = metadata->memoryUsage();
+  auto entry = std::make_unique<std::shared_ptr<const FileMetadata>>(
+      std::move(metadata));
+  std::lock_guard<std::mutex> l(mutex_);
+  // Replaces an entry for a previous version of the file.
+  if (auto existing = cache_.get(path)) {
+    auto existingLength = (*existing)->fileLength;
+    cache_.release(path);
+    if (existingLength == (*entry)->fileLength) {
+      return;
+    }
+    cache_.erase(path);
+  }
+  if (cache_.add(path, entry.get(), size)) {
+    entry.release();
+  }
+}
+
+} // namespace facebook::velox::dwrf
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+
+#include "velox/common/caching/SimpleLRUCache.h"
+#include "velox/dwio/dwrf/reader/DwrfReaderShared.h"
+
+namespace facebook::velox::dwrf {
+
+/// Size-bounded LRU cache of parsed DWRF file tails keyed by file path. Lets
+/// splits of the same file, also across queries, skip reading and parsing the
+/// postscript, footer and stripe metadata cache. Meant to be shared by all
+/// readers in the process. Thread-safe.
+class FileMetadataCache {
+ public:
+  explicit FileMetadataCache(int64_t maxBytes)
+      : cache_(maxBytes), pool_(memory::getDefaultScopedMemoryPool()) {}
+
+  /// Returns the metadata for 'path' or nullptr if there is none. An entry
+  /// made for a file of a different length than 'fileLength', e.g. one that
+  /// has since been overwritten, is not returned and is evicted.
+  std::shared_ptr<const FileMetadata> get(
+      const std::string& path,
+      uint64_t fileLength);
+
+  /// Adds the tail of the file 'reader' is open on under 'path', replacing
+  /// an entry for a file of a different length. No-op if 'path' is already
+  /// present with the same length or if the tail does not fit.
+  void put(const std::string& path, const DwrfReaderShared& reader);
+
+  int64_t numHits() const {
+    return numHits_;
+  }
+
+  int64_t numMisses() const {
+    return numMisses_;
+  }
+
+  /// Bytes of metadata currently cached.
+  int64_t currentSize() const {
+    std::lock_guard<std::mutex> l(mutex_);
+    return cache_.currentSize();
+  }
+
+ private:
+  mutable std::mutex mutex_;
+  SimpleLRUCache<std::string, std::shared_ptr<const FileMetadata>> cache_;
+  // Holds the stripe metadata caches of the entries. Entries may outlive
+  // their reader and query, so these cannot come from the reader's pool.
+  std::unique_ptr<memory::ScopedMemoryPool> pool_;
+  std::atomic<int64_t> numHits_{0};
+  std::atomic<int64_t> numMisses_{0};
+};
+
+} // namespace facebook::velox::dwrf
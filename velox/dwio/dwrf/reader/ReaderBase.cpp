@@ -86,7 +86,8 @@ ReaderBase::ReaderBase(
     std::unique_ptr<InputStream> stream,
     DecrypterFactory* factory,
     BufferedInputFactory* bufferedInputFactory,
-    dwio::common::DataCacheConfig* dataCacheConfig)
+    dwio::common::DataCacheConfig* dataCacheConfig,
+    std::shared_ptr<const FileMetadata> fileMetadata)
     : pool_{pool},
       stream_{std::move(stream)},
       arena_(std::make_unique<google::protobuf::Arena>()),
@@ -94,6 +95,23 @@ ReaderBase::ReaderBase(
       dataCacheConfig_(dataCacheConfig) {
   input_ = bufferedInputFactory_->create(*stream_, pool, dataCacheConfig);
 
+  // The tail may have been parsed by an earlier reader of the same file, in
+  // which case we skip both the read and the parse.
+  if (fileMetadata) {
+    fileMetadata_ = std::move(fileMetadata);
+    postScript_ =
+        std::make_unique<proto::PostScript>(*fileMetadata_->postScript);
+    footer_ = fileMetadata_->footer;
+    schema_ = fileMetadata_->schema;
+    schemaWithId_ = fileMetadata_->schemaWithId;
+    cache_ = fileMetadata_->stripeCache;
+    fileLength_ = fileMetadata_->fileLength;
+    psLength_ = fileMetadata_->psLength;
+    prefetchStripeFooters();
+    handler_ = DecryptionHandler::create(*footer_, factory);
+    return;
+  }
+
   // We may have cached the tail before, in which case we can skip the read.
   if (dataCacheConfig && dataCacheConfig->cache) {
     const std::string tailKey = TailKey(dataCacheConfig->filenum);
@@ -122,6 +140,7 @@ ReaderBase::ReaderBase(
         cache_ = std::make_unique<StripeMetadataCache>(
             *postScript_, *footer_, std::move(cacheBuffer));
       }
+      fileLength_ = stream_->getLength();
       handler_ = DecryptionHandler::create(*footer_, factory);
       return;
     }
@@ -211,22 +230,55 @@ ReaderBase::ReaderBase(
     const std::string tailKey = TailKey(dataCacheConfig->filenum);
     dataCacheConfig->cache->put(tailKey, {tail.get(), tailSize});
   }
-  if (input_->shouldPrefetchStripes()) {
-    auto numStripes = getFooter().stripes_size();
-    for (auto i = 0; i < numStripes; i++) {
-      const auto& stripe = getFooter().stripes(i);
-      input_->enqueue(
-          {stripe.offset() + stripe.indexlength() + stripe.datalength(),
-           stripe.footerlength()});
-    }
-    if (numStripes) {
-      input_->load(LogType::FOOTER);
-    }
-  }
+  prefetchStripeFooters();
   // initialize file decrypter
   handler_ = DecryptionHandler::create(*footer_, factory);
 }
 
+void ReaderBase::prefetchStripeFooters() {
+  if (!input_->shouldPrefetchStripes()) {
+    return;
+  }
+  auto numStripes = getFooter().stripes_size();
+  for (auto i = 0; i < numStripes; i++) {
+    const auto& stripe = getFooter().stripes(i);
+    input_->enqueue(
+        {stripe.offset() + stripe.indexlength() + stripe.datalength(),
+         stripe.footerlength()});
+  }
+  if (numStripes) {
+    input_->load(LogType::FOOTER);
+  }
+}
+
+uint64_t FileMetadata::memoryUsage() const {
+  return sizeof(*this) + arena->SpaceAllocated() + postScript->SpaceUsedLong() +
+      (stripeCache ? stripeCache->sizeInBytes() : 0);
+}
+
+std::shared_ptr<const FileMetadata> ReaderBase::makeFileMetadata(
+    MemoryPool& pool) const {
+  if (fileMetadata_) {
+    return fileMetadata_;
+  }
+  auto metadata = std::make_shared<FileMetadata>();
+  metadata->arena = std::make_unique<google::protobuf::Arena>();
+  metadata->postScript = std::make_unique<proto::PostScript>(*postScript_);
+  // The footer is copied because 'arena_' also holds the stripe footers of
+  // this reader, which are not to be retained with the metadata.
+  metadata->footer = google::protobuf::Arena::CreateMessage<proto::Footer>(
+      metadata->arena.get());
+  metadata->footer->CopyFrom(*footer_);
+  metadata->schema = schema_;
+  metadata->schemaWithId = getSchemaWithId();
+  if (cache_) {
+    metadata->stripeCache = cache_->copy(pool);
+  }
+  metadata->fileLength = fileLength_;
+  metadata->psLength = psLength_;
+  return metadata;
+}
+
 std::vector<uint64_t> ReaderBase::getRowsPerStripe() const {
   std::vector<uint64_t> rowsPerStripe;
   auto numStripes = getFooter().stripes_size();
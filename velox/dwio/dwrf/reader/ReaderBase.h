@@ -32,6 +32,27 @@ constexpr uint64_t FILE_PRELOAD_THRESHOLD = 1024 * 1024 * 8;
 
 class ReaderBase;
 
+/// Parsed, immutable tail of a DWRF file: postscript, footer, schema and the
+/// stripe metadata cache. Made from an open ReaderBase and handed to later
+/// ReaderBases on the same file so that these skip reading and parsing the
+/// tail. Owns all its memory, so it may outlive the reader and the query it
+/// was made from.
+struct FileMetadata {
+  std::unique_ptr<google::protobuf::Arena> arena;
+  std::unique_ptr<proto::PostScript> postScript;
+  // Allocated in 'arena'.
+  proto::Footer* footer{nullptr};
+  std::shared_ptr<const RowType> schema;
+  std::shared_ptr<const dwio::common::TypeWithId> schemaWithId;
+  // nullptr if the file has no stripe metadata cache.
+  std::shared_ptr<StripeMetadataCache> stripeCache;
+  uint64_t fileLength{0};
+  uint64_t psLength{0};
+
+  /// Approximate memory held by 'this', for sizing caches.
+  uint64_t memoryUsage() const;
+};
+
 class FooterStatisticsImpl : public Statistics {
  private:
   std::vector<std::unique_ptr<ColumnStatistics>> colStats_;
@@ -67,7 +88,8 @@ class ReaderBase {
       dwio::common::encryption::DecrypterFactory* factory = nullptr,
       BufferedInputFactory* bufferedInputFactory =
           BufferedInputFactory::baseFactory(),
-      dwio::common::DataCacheConfig* dataCacheConfig = nullptr);
+      dwio::common::DataCacheConfig* dataCacheConfig = nullptr,
+      std::shared_ptr<const FileMetadata> fileMetadata = nullptr);
 
   // create reader base from metadata
   ReaderBase(
@@ -137,7 +159,7 @@ class ReaderBase {
                                  : *BufferedInputFactory::baseFactory();
   }
 
-  const std::unique_ptr<StripeMetadataCache>& getMetadataCache() const {
+  const std::shared_ptr<StripeMetadataCache>& getMetadataCache() const {
     return cache_;
   }
 
@@ -195,14 +217,18 @@ class ReaderBase {
   std::unique_ptr<SeekableInputStream> createDecompressedStream(
       std::unique_ptr<SeekableInputStream> compressed,
       const std::string& streamDebugInfo,
-      const dwio::common::encryption::Decrypter* decrypter = nullptr) const {
+      const dwio::common::encryption::Decrypter* decrypter = nullptr,
+      folly::Executor* decompressAheadExecutor = nullptr,
+      uint64_t maxDecompressAheadBytes = 0) const {
     return createDecompressor(
         getCompressionKind(),
         std::move(compressed),
         getCompressionBlockSize(),
         pool_,
         streamDebugInfo,
-        decrypter);
+        decrypter,
+        decompressAheadExecutor,
+        maxDecompressAheadBytes);
   }
 
   template <typename T>
@@ -223,17 +249,30 @@ class ReaderBase {
     return arena_.get();
   }
 
+  /// Returns a copy of the parsed file tail that later readers of the same
+  /// file can be opened with. The stripe metadata cache is copied into
+  /// 'pool', which must outlive the result. Returns the metadata 'this' was
+  /// opened with, if any.
+  std::shared_ptr<const FileMetadata> makeFileMetadata(
+      memory::MemoryPool& pool) const;
+
  private:
   static std::shared_ptr<const Type> convertType(
       const proto::Footer& footer,
       uint32_t index = 0);
 
+  // Enqueues and loads the stripe footers if 'input_' prefetches stripes.
+  void prefetchStripeFooters();
+
   memory::MemoryPool& pool_;
   std::unique_ptr<dwio::common::InputStream> stream_;
   std::unique_ptr<google::protobuf::Arena> arena_;
   std::unique_ptr<proto::PostScript> postScript_;
   proto::Footer* footer_ = nullptr;
-  std::unique_ptr<StripeMetadataCache> cache_;
+  std::shared_ptr<StripeMetadataCache> cache_;
+  // Set if the tail came from a previously opened reader. Keeps 'footer_'
+  // alive.
+  std::shared_ptr<const FileMetadata> fileMetadata_;
   std::unique_ptr<encryption::DecryptionHandler> handler_;
   BufferedInputFactory* bufferedInputFactory_ =
       BufferedInputFactory::baseFactory();
@@ -243,8 +282,8 @@ class ReaderBase {
   std::shared_ptr<const RowType> schema_;
   // Lazily populated
   mutable std::shared_ptr<const dwio::common::TypeWithId> schemaWithId_;
-  uint64_t fileLength_;
-  uint64_t psLength_;
+  uint64_t fileLength_{0};
+  uint64_t psLength_{0};
 };
 
 } // namespace facebook::velox::dwrf
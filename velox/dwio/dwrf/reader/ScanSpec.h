@@ -41,12 +41,25 @@ class ScanSpec {
   static constexpr ChannelIndex kNoChannel = ~0;
 
   explicit ScanSpec(const Subfield::PathElement& element) {
-    if (element.kind() == kNestedField) {
-      auto field = reinterpret_cast<const Subfield::NestedField*>(&element);
-      fieldName_ = field->name();
-
-    } else {
-      VELOX_CHECK(false, "Only nested fields are supported");
+    switch (element.kind()) {
+      case kNestedField:
+        fieldName_ =
+            reinterpret_cast<const Subfield::NestedField*>(&element)->name();
+        break;
+      case kLongSubscript:
+        // A subscript of an integer-keyed map, e.g. a flat map key. The
+        // key is also kept as 'fieldName_' for matching with map keys.
+        subscript_ =
+            reinterpret_cast<const Subfield::LongSubscript*>(&element)->index();
+        fieldName_ = std::to_string(subscript_);
+        break;
+      case kStringSubscript:
+        fieldName_ =
+            reinterpret_cast<const Subfield::StringSubscript*>(&element)
+                ->index();
+        break;
+      default:
+        VELOX_CHECK(false, "Only nested fields and subscripts are supported");
     }
   }
 
@@ -19,9 +19,11 @@
 #include "velox/aggregates/AggregationHook.h"
 #include "velox/common/base/Portability.h"
 #include "velox/dwio/common/TypeUtils.h"
+#include "velox/dwio/dwrf/common/BloomFilter.h"
 #include "velox/dwio/dwrf/common/DirectDecoder.h"
 #include "velox/dwio/dwrf/common/FloatingPointDecoder.h"
 #include "velox/dwio/dwrf/common/RLEv1.h"
+#include "velox/dwio/dwrf/reader/SelectiveFlatMapColumnReader.h"
 #include "velox/dwio/dwrf/utils/ProtoUtils.h"
 #include "velox/vector/ConstantVector.h"
 #include "velox/vector/DictionaryVector.h"
@@ -59,6 +61,70 @@ struct Filters {
   static common::AlwaysTrue alwaysTrue;
 };
 
+// Returns true if 'filter' passes only values from a short list that can be
+// looked up in a bloom filter.
+bool mayTestBloomFilter(const common::Filter& filter) {
+  if (filter.testNull()) {
+    // Nulls are not in the bloom filter.
+    return false;
+  }
+  switch (filter.kind()) {
+    case common::FilterKind::kBigintRange:
+      return static_cast<const common::BigintRange&>(filter).isSingleValue();
+    case common::FilterKind::kBytesRange:
+      return static_cast<const common::BytesRange&>(filter).isSingleValue();
+    case common::FilterKind::kBigintValuesUsingHashTable:
+    case common::FilterKind::kBigintValuesUsingBitmask:
+    case common::FilterKind::kBytesValues:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Returns false if none of the values passing 'filter' is in 'bloomFilter'.
+bool testBloomFilter(
+    const common::Filter& filter,
+    const BloomFilter& bloomFilter) {
+  auto testValues = [&](const auto& values) {
+    for (auto value : values) {
+      if (bloomFilter.testInt64(value)) {
+        return true;
+      }
+    }
+    return false;
+  };
+  switch (filter.kind()) {
+    case common::FilterKind::kBigintRange: {
+      auto& range = static_cast<const common::BigintRange&>(filter);
+      return !range.isSingleValue() || bloomFilter.testInt64(range.lower());
+    }
+    case common::FilterKind::kBigintValuesUsingHashTable:
+      return testValues(
+          static_cast<const common::BigintValuesUsingHashTable&>(filter)
+              .values());
+    case common::FilterKind::kBigintValuesUsingBitmask:
+      return testValues(
+          static_cast<const common::BigintValuesUsingBitmask&>(filter)
+              .values());
+    case common::FilterKind::kBytesRange: {
+      auto& range = static_cast<const common::BytesRange&>(filter);
+      return !range.isSingleValue() ||
+          bloomFilter.testBytes(range.lower().data(), range.lower().size());
+    }
+    case common::FilterKind::kBytesValues:
+      for (const auto& value :
+           static_cast<const common::BytesValues&>(filter).values()) {
+        if (bloomFilter.testBytes(value.data(), value.size())) {
+          return true;
+        }
+      }
+      return false;
+    default:
+      return true;
+  }
+}
+
 inline RleVersion convertRleVersion(proto::ColumnEncoding_Kind kind) {
   switch (static_cast<int64_t>(kind)) {
     case proto::ColumnEncoding_Kind_DIRECT:
@@ -84,6 +150,10 @@ SelectiveColumnReader::SelectiveColumnReader(
     indexStream_ =
         stripe.getStream(ek.forKind(proto::Stream_Kind_ROW_INDEX), false);
   }
+  if (scanSpec->filter() && mayTestBloomFilter(*scanSpec->filter())) {
+    bloomFilterStream_ = stripe.getStream(
+        ek.forKind(proto::Stream_Kind_BLOOM_FILTER_UTF8), false);
+  }
 }
 
 std::vector<uint32_t> SelectiveColumnReader::filterRowGroups(
@@ -101,6 +171,10 @@ std::vector<uint32_t> SelectiveColumnReader::filterRowGroups(
     auto columnStats = ColumnStatistics::fromProto(entry.statistics(), context);
     if (!testFilter(filter, columnStats.get(), rowGroupSize, type_)) {
       stridesToSkip.push_back(i); // Skipping stride based on column stats.
+    } else if (
+        bloomFilters_ && i < bloomFilters_->bloomfilter_size() &&
+        !testBloomFilter(*filter, BloomFilter(bloomFilters_->bloomfilter(i)))) {
+      stridesToSkip.push_back(i); // No value passing the filter is present.
     }
   }
   return stridesToSkip;
@@ -2483,6 +2557,374 @@ void SelectiveFloatingPointColumnReader<TData, TRequested>::read(
   }
 }
 
+// Converts the DWRF representation of a timestamp to Timestamp. 'seconds' are
+// relative to the DWRF epoch and the low 3 bits of 'nanos' encode the number
+// of trailing decimal zeros dropped from the nanos.
+inline Timestamp decodeTimestamp(int64_t seconds, uint64_t nanos) {
+  auto zeros = nanos & 0x7;
+  nanos >>= 3;
+  if (zeros != 0) {
+    for (uint64_t i = 0; i <= zeros; ++i) {
+      nanos *= 10;
+    }
+  }
+  seconds += EPOCH_OFFSET;
+  if (seconds < 0 && nanos != 0) {
+    seconds -= 1;
+  }
+  return Timestamp(seconds, nanos);
+}
+
+inline int64_t saturatingAdd(int64_t x, int64_t y) {
+  int64_t result;
+  if (__builtin_add_overflow(x, y, &result)) {
+    return y > 0 ? std::numeric_limits<int64_t>::max()
+                 : std::numeric_limits<int64_t>::min();
+  }
+  return result;
+}
+
+// Reads DWRF timestamps, which are a stream of seconds and a stream of
+// nanos. Filters are first applied to the seconds. The nanos are decoded
+// only for rows that pass on seconds and either are projected out or need
+// the nanos to decide the filter.
+class SelectiveTimestampColumnReader : public SelectiveColumnReader {
+ public:
+  // The seconds are decoded as int64_t and converted to Timestamp at the end
+  // of read().
+  using ValueType = int64_t;
+
+  SelectiveTimestampColumnReader(
+      const EncodingKey& ek,
+      const std::shared_ptr<const TypeWithId>& dataType,
+      StripeStreams& stripe,
+      common::ScanSpec* scanSpec);
+
+  void seekToRowGroup(uint32_t index) override {
+    ensureRowGroupIndex();
+
+    auto positions = toPositions(index_->entry(index));
+    PositionProvider positionsProvider(positions);
+
+    if (notNullDecoder) {
+      notNullDecoder->seekToRowGroup(positionsProvider);
+    }
+
+    seconds_->seekToRowGroup(positionsProvider);
+    nanos_->seekToRowGroup(positionsProvider);
+
+    VELOX_CHECK(!positionsProvider.hasNext());
+  }
+
+  uint64_t skip(uint64_t numValues) override;
+
+  void read(vector_size_t offset, RowSet rows, const uint64_t* incomingNulls)
+      override;
+
+  void getValues(RowSet rows, VectorPtr* result) override {
+    getFlatValues<Timestamp, Timestamp>(rows, result, type_);
+  }
+
+ private:
+  // Decodes the seconds of 'rows' into 'values_', applying 'filter' to the
+  // encoded seconds.
+  template <typename TFilter, bool isDense>
+  void readSeconds(common::Filter* filter, RowSet rows);
+
+  template <typename TFilter>
+  void readSeconds(common::Filter* filter, RowSet rows) {
+    if (rows.back() == rows.size() - 1) {
+      readSeconds<TFilter, true>(filter, rows);
+    } else {
+      readSeconds<TFilter, false>(filter, rows);
+    }
+  }
+
+  // Decodes the nanos at positions 'nanoPositions_' of the non-null values
+  // of the read range into 'nanosBuffer_' and skips the nanos stream to the
+  // end of the range. 'numNonNulls' is the number of non-null values in the
+  // read range.
+  void readNanos(int32_t numNonNulls);
+
+  // Converts the seconds decoded by readSeconds() to Timestamps and applies
+  // 'filter' to the values for which the seconds did not decide the
+  // filter. 'prefiltered' is true if readSeconds() produced 'outputRows_'.
+  void makeTimestamps(
+      RowSet rows,
+      common::Filter* filter,
+      bool prefiltered,
+      int32_t numNonNulls);
+
+  // Passes the values produced by makeTimestamps() to 'hook'.
+  void addValuesToHook(RowSet rows, ValueHook* hook);
+
+  std::unique_ptr<IntDecoder</*isSigned*/ true>> seconds_;
+  std::unique_ptr<IntDecoder</*isSigned*/ false>> nanos_;
+
+  // Range of encoded seconds that may pass a TimestampRange filter.
+  std::optional<common::BigintRange> secondsFilter_;
+
+  // Seconds of the current read while 'values_' is filled with Timestamps.
+  BufferPtr secondsValues_;
+  BufferPtr nanosBuffer_;
+  // Positions in the nanos stream of the values that need their nanos and
+  // the indices of the values.
+  raw_vector<int32_t> nanoPositions_;
+  raw_vector<int32_t> nanoValueIndices_;
+};
+
+SelectiveTimestampColumnReader::SelectiveTimestampColumnReader(
+    const EncodingKey& ek,
+    const std::shared_ptr<const TypeWithId>& dataType,
+    StripeStreams& stripe,
+    common::ScanSpec* scanSpec)
+    : SelectiveColumnReader(ek, stripe, scanSpec, dataType->type, true) {
+  RleVersion vers = convertRleVersion(stripe.getEncoding(ek).kind());
+  auto data = ek.forKind(proto::Stream_Kind_DATA);
+  bool vints = stripe.getUseVInts(data);
+  seconds_ = IntDecoder</*isSigned*/ true>::createRle(
+      stripe.getStream(data, true), vers, memoryPool, vints, LONG_BYTE_SIZE);
+  auto nanoData = ek.forKind(proto::Stream_Kind_NANO_DATA);
+  bool nanoVInts = stripe.getUseVInts(nanoData);
+  nanos_ = IntDecoder</*isSigned*/ false>::createRle(
+      stripe.getStream(nanoData, true),
+      vers,
+      memoryPool,
+      nanoVInts,
+      LONG_BYTE_SIZE);
+}
+
+uint64_t SelectiveTimestampColumnReader::skip(uint64_t numValues) {
+  numValues = ColumnReader::skip(numValues);
+  seconds_->skip(numValues);
+  nanos_->skip(numValues);
+  return numValues;
+}
+
+template <typename TFilter, bool isDense>
+void SelectiveTimestampColumnReader::readSeconds(
+    common::Filter* filter,
+    RowSet rows) {
+  // DWRF timestamps are always RLE v1, see convertRleVersion().
+  auto reader = reinterpret_cast<RleDecoderV1<true>*>(seconds_.get());
+  ColumnVisitor<
+      int64_t,
+      TFilter,
+      ExtractToReader<SelectiveTimestampColumnReader>,
+      isDense>
+      visitor(
+          *reinterpret_cast<TFilter*>(filter),
+          this,
+          rows,
+          ExtractToReader(this));
+  if (nullsInReadRange_) {
+    reader->readWithVisitor<true>(nullsInReadRange_->as<uint64_t>(), visitor);
+  } else {
+    reader->readWithVisitor<false>(nullptr, visitor);
+  }
+  readOffset_ += rows.back() + 1;
+}
+
+void SelectiveTimestampColumnReader::readNanos(int32_t numNonNulls) {
+  int32_t numNanos = nanoPositions_.size();
+  ensureCapacity<int64_t>(nanosBuffer_, numNanos, &memoryPool);
+  auto rawNanos = nanosBuffer_->asMutable<int64_t>();
+  int32_t position = 0;
+  int32_t i = 0;
+  while (i < numNanos) {
+    // Decodes runs of consecutive positions with one call and skips the
+    // gaps between runs.
+    auto first = nanoPositions_[i];
+    auto end = i + 1;
+    while (end < numNanos && nanoPositions_[end] == first + (end - i)) {
+      ++end;
+    }
+    if (first > position) {
+      nanos_->skip(first - position);
+    }
+    nanos_->next(rawNanos + i, end - i, nullptr);
+    position = first + (end - i);
+    i = end;
+  }
+  if (numNonNulls > position) {
+    nanos_->skip(numNonNulls - position);
+  }
+}
+
+void SelectiveTimestampColumnReader::makeTimestamps(
+    RowSet rows,
+    common::Filter* filter,
+    bool prefiltered,
+    int32_t numNonNulls) {
+  auto kind = filter ? filter->kind() : FilterKind::kAlwaysTrue;
+  bool keepValues = scanSpec_->keepValues();
+  // False if nulls and seconds alone decide the filter.
+  bool testTimestamps = kind != FilterKind::kAlwaysTrue &&
+      kind != FilterKind::kIsNull && kind != FilterKind::kIsNotNull;
+  auto needsNanos = [&](int64_t seconds) {
+    if (keepValues) {
+      return true;
+    }
+    if (!testTimestamps) {
+      return false;
+    }
+    if (kind != FilterKind::kTimestampRange) {
+      return true;
+    }
+    // The adjustment for negative seconds in decodeTimestamp() can move the
+    // seconds down by one. Values whose seconds are inside the range either
+    // way pass without looking at the nanos.
+    auto lower = secondsFilter_->lower();
+    auto upper = secondsFilter_->upper();
+    return !(
+        seconds > lower && seconds - 1 > lower && seconds < upper &&
+        seconds + 1 < upper);
+  };
+
+  const vector_size_t* valueRows =
+      prefiltered ? outputRows_.data() : rows.data();
+  auto rawNulls =
+      nullsInReadRange_ ? nullsInReadRange_->as<uint64_t>() : nullptr;
+  auto rawSeconds = reinterpret_cast<const int64_t*>(rawValues_);
+  nanoPositions_.clear();
+  nanoValueIndices_.clear();
+  int32_t position = 0;
+  vector_size_t previousRow = 0;
+  for (auto i = 0; i < numValues_; ++i) {
+    auto row = valueRows[i];
+    if (rawNulls) {
+      position += bits::countNonNulls(rawNulls, previousRow, row);
+      previousRow = row;
+      if (bits::isBitNull(rawNulls, row)) {
+        continue;
+      }
+    } else {
+      position = row;
+    }
+    if (needsNanos(rawSeconds[i])) {
+      nanoPositions_.push_back(position);
+      nanoValueIndices_.push_back(i);
+    }
+  }
+  readNanos(numNonNulls);
+
+  // Move the seconds aside and fill 'values_' with Timestamps.
+  std::swap(values_, secondsValues_);
+  ensureValuesCapacity<Timestamp>(rows.size());
+  rawValues_ = values_->asMutable<char>();
+  valueSize_ = sizeof(Timestamp);
+  rawSeconds = secondsValues_->as<int64_t>();
+  auto rawTimestamps = reinterpret_cast<Timestamp*>(rawValues_);
+  auto rawNanos = nanosBuffer_->as<int64_t>();
+  bool compactNulls = anyNulls_ && !returnReaderNulls_;
+  if (filter && !prefiltered) {
+    outputRows_.resize(numValues_);
+  }
+  vector_size_t numPassed = 0;
+  int32_t nanoIndex = 0;
+  for (auto i = 0; i < numValues_; ++i) {
+    auto row = valueRows[i];
+    bool isNull = rawNulls && bits::isBitNull(rawNulls, row);
+    Timestamp value;
+    if (nanoIndex < nanoValueIndices_.size() &&
+        nanoValueIndices_[nanoIndex] == i) {
+      value = decodeTimestamp(rawSeconds[i], rawNanos[nanoIndex++]);
+      if (testTimestamps && !filter->testTimestamp(value)) {
+        continue;
+      }
+    } else if (isNull && filter && !filter->testNull()) {
+      continue;
+    }
+    if (keepValues) {
+      rawTimestamps[numPassed] = value;
+      if (compactNulls) {
+        bits::setNull(rawResultNulls_, numPassed, isNull);
+      }
+    }
+    if (filter) {
+      outputRows_[numPassed] = row;
+    }
+    ++numPassed;
+  }
+  numValues_ = numPassed;
+  if (filter) {
+    outputRows_.resize(numPassed);
+  }
+}
+
+void SelectiveTimestampColumnReader::addValuesToHook(
+    RowSet rows,
+    ValueHook* hook) {
+  const vector_size_t* valueRows =
+      scanSpec_->filter() ? outputRows_.data() : rows.data();
+  auto rawNulls =
+      nullsInReadRange_ ? nullsInReadRange_->as<uint64_t>() : nullptr;
+  auto rawTimestamps = reinterpret_cast<const Timestamp*>(rawValues_);
+  // Hooks take the index of the row in 'rows'.
+  vector_size_t rowIndex = 0;
+  for (auto i = 0; i < numValues_; ++i) {
+    while (rows[rowIndex] < valueRows[i]) {
+      ++rowIndex;
+    }
+    if (rawNulls && bits::isBitNull(rawNulls, valueRows[i])) {
+      if (hook->acceptsNulls()) {
+        hook->addNull(rowIndex);
+      }
+    } else {
+      hook->addValue(rowIndex, &rawTimestamps[i]);
+    }
+  }
+}
+
+void SelectiveTimestampColumnReader::read(
+    vector_size_t offset,
+    RowSet rows,
+    const uint64_t* incomingNulls) {
+  prepareRead<int64_t>(offset, rows, incomingNulls);
+  vector_size_t numRows = rows.back() + 1;
+  int32_t numNonNulls = nullsInReadRange_
+      ? bits::countNonNulls(nullsInReadRange_->as<uint64_t>(), 0, numRows)
+      : numRows;
+  auto hook = scanSpec_->valueHook();
+  if (!scanSpec_->keepValues() || hook) {
+    // The seconds are needed for the filter even if not projected out and
+    // hooks get the values after they are converted to Timestamps.
+    prepareNulls(rows, nullsInReadRange_ != nullptr);
+  }
+  auto filter = scanSpec_->filter();
+  bool prefiltered = true;
+  switch (filter ? filter->kind() : FilterKind::kAlwaysTrue) {
+    case FilterKind::kIsNull:
+      readSeconds<common::IsNull>(filter, rows);
+      break;
+    case FilterKind::kIsNotNull:
+      readSeconds<common::IsNotNull>(filter, rows);
+      break;
+    case FilterKind::kTimestampRange: {
+      // A value passes only if its encoded seconds are in
+      // [lower - EPOCH_OFFSET, upper - EPOCH_OFFSET + 1], see
+      // decodeTimestamp().
+      auto range = static_cast<const common::TimestampRange*>(filter);
+      secondsFilter_.emplace(
+          saturatingAdd(range->lower().getSeconds(), -EPOCH_OFFSET),
+          saturatingAdd(
+              saturatingAdd(range->upper().getSeconds(), -EPOCH_OFFSET), 1),
+          range->testNull());
+      readSeconds<common::BigintRange>(&secondsFilter_.value(), rows);
+      break;
+    }
+    default:
+      // Other filters are applied to the Timestamps in makeTimestamps().
+      readSeconds<common::AlwaysTrue>(&Filters::alwaysTrue, rows);
+      prefiltered = false;
+      break;
+  }
+  makeTimestamps(rows, filter, prefiltered, numNonNulls);
+  if (hook) {
+    addValuesToHook(rows, hook);
+  }
+}
+
 class SelectiveStringDirectColumnReader : public SelectiveColumnReader {
  public:
   using ValueType = StringView;
@@ -3089,9 +3531,9 @@ class SelectiveStringDictionaryColumnReader : public SelectiveColumnReader {
 
   const StrideIndexProvider& provider_;
 
-  // lazy load the dictionary
-  std::unique_ptr<IntDecoder</*isSigned*/ false>> lengthDecoder_;
-  std::unique_ptr<SeekableInputStream> blobStream_;
+  // lazy load the dictionary, shared with other readers of the stripe
+  std::function<std::shared_ptr<StringDictionary>()> dictInit_;
+  std::shared_ptr<StringDictionary> dictionary_;
   raw_vector<uint8_t> filterCache_;
   bool initialized_{false};
 };
@@ -3116,17 +3558,7 @@ SelectiveStringDictionaryColumnReader::SelectiveStringDictionaryColumnReader(
       dictVInts,
       INT_BYTE_SIZE);
 
-  const auto lenId = ek.forKind(proto::Stream_Kind_LENGTH);
-  bool lenVInts = stripe.getUseVInts(lenId);
-  lengthDecoder_ = IntDecoder</*isSigned*/ false>::createRle(
-      stripe.getStream(lenId, false),
-      rleVersion,
-      memoryPool,
-      lenVInts,
-      INT_BYTE_SIZE);
-
-  blobStream_ =
-      stripe.getStream(ek.forKind(proto::Stream_Kind_DICTIONARY_DATA), false);
+  dictInit_ = stripe.getStringDictionaryInitializerForNode(ek);
 
   // handle in dictionary stream
   std::unique_ptr<SeekableInputStream> inDictStream =
@@ -3224,53 +3656,37 @@ void SelectiveStringDictionaryColumnReader::loadStrideDictionary() {
 }
 
 void SelectiveStringDictionaryColumnReader::makeDictionaryBaseVector() {
-  const auto* dictionaryBlob_Ptr = dictionaryBlob_->as<char>();
-  const auto* dictionaryOffset_sPtr = dictionaryOffset_->as<int64_t>();
-  if (strideDictCount_) {
-    // TODO Reuse memory
-    BufferPtr values = AlignedBuffer::allocate<StringView>(
-        dictionaryCount_ + strideDictCount_, &memoryPool);
-    auto* valuesPtr = values->asMutable<StringView>();
-    for (size_t i = 0; i < dictionaryCount_; i++) {
-      valuesPtr[i] = StringView(
-          dictionaryBlob_Ptr + dictionaryOffset_sPtr[i],
-          dictionaryOffset_sPtr[i + 1] - dictionaryOffset_sPtr[i]);
-    }
-
-    const auto* strideDictPtr = strideDict_->as<char>();
-    const auto* strideDictOffset_Ptr = strideDictOffset_->as<int64_t>();
-    for (size_t i = 0; i < strideDictCount_; i++) {
-      valuesPtr[dictionaryCount_ + i] = StringView(
-          strideDictPtr + strideDictOffset_Ptr[i],
-          strideDictOffset_Ptr[i + 1] - strideDictOffset_Ptr[i]);
-    }
-
-    dictionaryValues_ = std::make_shared<FlatVector<StringView>>(
-        &memoryPool,
-        type_,
-        BufferPtr(nullptr), // TODO nulls
-        dictionaryCount_ + strideDictCount_ /*length*/,
-        values,
-        std::vector<BufferPtr>{dictionaryBlob_, strideDict_});
-  } else {
-    // TODO Reuse memory
-    BufferPtr values =
-        AlignedBuffer::allocate<StringView>(dictionaryCount_, &memoryPool);
-    auto* valuesPtr = values->asMutable<StringView>();
-    for (size_t i = 0; i < dictionaryCount_; i++) {
-      valuesPtr[i] = StringView(
-          dictionaryBlob_Ptr + dictionaryOffset_sPtr[i],
-          dictionaryOffset_sPtr[i + 1] - dictionaryOffset_sPtr[i]);
-    }
+  const auto& stripeValues = dictionary_->values(type_, &memoryPool);
+  if (!strideDictCount_) {
+    dictionaryValues_ = stripeValues;
+    return;
+  }
+  // TODO Reuse memory
+  BufferPtr values = AlignedBuffer::allocate<StringView>(
+      dictionaryCount_ + strideDictCount_, &memoryPool);
+  auto* valuesPtr = values->asMutable<StringView>();
+  if (dictionaryCount_ > 0) {
+    memcpy(
+        valuesPtr,
+        stripeValues->rawValues(),
+        dictionaryCount_ * sizeof(StringView));
+  }
 
-    dictionaryValues_ = std::make_shared<FlatVector<StringView>>(
-        &memoryPool,
-        type_,
-        BufferPtr(nullptr), // TODO nulls
-        dictionaryCount_ /*length*/,
-        values,
-        std::vector<BufferPtr>{dictionaryBlob_});
+  const auto* strideDictPtr = strideDict_->as<char>();
+  const auto* strideDictOffset_Ptr = strideDictOffset_->as<int64_t>();
+  for (size_t i = 0; i < strideDictCount_; i++) {
+    valuesPtr[dictionaryCount_ + i] = StringView(
+        strideDictPtr + strideDictOffset_Ptr[i],
+        strideDictOffset_Ptr[i + 1] - strideDictOffset_Ptr[i]);
   }
+
+  dictionaryValues_ = std::make_shared<FlatVector<StringView>>(
+      &memoryPool,
+      type_,
+      BufferPtr(nullptr), // TODO nulls
+      dictionaryCount_ + strideDictCount_ /*length*/,
+      values,
+      std::vector<BufferPtr>{dictionaryBlob_, strideDict_});
 }
 
 template <typename TFilter, typename ExtractValues, bool isDense>
@@ -3765,9 +4181,10 @@ void SelectiveStringDictionaryColumnReader::ensureInitialized() {
 
   Timer timer;
 
-  ensureCapacity<int64_t>(dictionaryOffset_, dictionaryCount_ + 1, &memoryPool);
-  dictionaryBlob_ = loadDictionary(
-      dictionaryCount_, *blobStream_, *lengthDecoder_, dictionaryOffset_);
+  dictionary_ = dictInit_();
+  DWIO_ENSURE_EQ(dictionary_->count(), dictionaryCount_);
+  dictionaryBlob_ = dictionary_->blob();
+  dictionaryOffset_ = dictionary_->offsets();
   dictionaryValues_.reset();
   filterCache_.resize(dictionaryCount_);
   simd::memset(filterCache_.data(), FilterResult::kUnknown, dictionaryCount_);
@@ -4057,7 +4474,9 @@ void SelectiveStructColumnReader::read(
     if (childSpec->isConstant()) {
       continue;
     }
-    if (childSpec->projectOut() && !childSpec->filter() &&
+    // A filter on a nested field, e.g. a map subscript, filters the
+    // enclosing rows like a filter on the field itself.
+    if (childSpec->projectOut() && !childSpec->hasFilter() &&
         !childSpec->extractValues()) {
       // Will make a LazyVector.
       continue;
@@ -4065,7 +4484,7 @@ void SelectiveStructColumnReader::read(
     auto fieldIndex = childSpec->subscript();
     auto reader = children_.at(fieldIndex).get();
     advanceFieldReader(reader, offset);
-    if (childSpec->filter()) {
+    if (childSpec->hasFilter()) {
       hasFilter = true;
       {
         SelectivityTimer timer(childSpec->selectivity(), activeRows.size());
@@ -4126,7 +4545,7 @@ void SelectiveStructColumnReader::getValues(RowSet rows, VectorPtr* result) {
       resultRow->childAt(channel) = BaseVector::wrapInConstant(
           rows.size(), 0, childSpec->constantValue());
     } else {
-      if (!childSpec->extractValues() && !childSpec->filter()) {
+      if (!childSpec->extractValues() && !childSpec->hasFilter()) {
         // LazyVector result.
         if (!lazyPrepared) {
           if (rows.size() != outputRows_.size()) {
@@ -4629,7 +5048,8 @@ std::unique_ptr<SelectiveColumnReader> SelectiveColumnReader::build(
     case TypeKind::MAP:
       if (stripe.getEncoding(ek).kind() ==
           proto::ColumnEncoding_Kind_MAP_FLAT) {
-        VELOX_UNSUPPORTED("SelectiveColumnReader does not support flat maps");
+        return createSelectiveFlatMapColumnReader(
+            ek, requestedType, dataType, stripe, scanSpec);
       }
       return std::make_unique<SelectiveMapColumnReader>(
           ek, requestedType, dataType, stripe, scanSpec);
@@ -4656,6 +5076,9 @@ std::unique_ptr<SelectiveColumnReader> SelectiveColumnReader::build(
     case TypeKind::TINYINT:
       return std::make_unique<SelectiveByteRleColumnReader>(
           ek, requestedType, dataType, stripe, scanSpec, false);
+    case TypeKind::TIMESTAMP:
+      return std::make_unique<SelectiveTimestampColumnReader>(
+          ek, dataType, stripe, scanSpec);
     case TypeKind::VARBINARY:
     case TypeKind::VARCHAR:
       switch (static_cast<int64_t>(stripe.getEncoding(ek).kind())) {
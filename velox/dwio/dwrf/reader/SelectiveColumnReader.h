@@ -281,6 +281,10 @@ class SelectiveColumnReader : public ColumnReader {
     if (indexStream_) {
       index_ = ProtoUtils::readProto<proto::RowIndex>(std::move(indexStream_));
     }
+    if (bloomFilterStream_) {
+      bloomFilters_ = ProtoUtils::readProto<proto::BloomFilterIndex>(
+          std::move(bloomFilterStream_));
+    }
   }
 
   // Specification of filters, value extraction, pruning etc. The
@@ -290,6 +294,10 @@ class SelectiveColumnReader : public ColumnReader {
   TypePtr type_;
   mutable std::unique_ptr<SeekableInputStream> indexStream_;
   mutable std::unique_ptr<proto::RowIndex> index_;
+  // Per row group bloom filters. Present only if the writer was asked for
+  // them and the column has a filter.
+  mutable std::unique_ptr<SeekableInputStream> bloomFilterStream_;
+  mutable std::unique_ptr<proto::BloomFilterIndex> bloomFilters_;
   // Number of rows in a row group. Last row group may have fewer rows.
   uint32_t rowsPerRowGroup_;
   // Row number after last read row, relative to stripe start.
@@ -0,0 +1,540 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/dwrf/reader/SelectiveFlatMapColumnReader.h"
+
+#include "velox/dwio/dwrf/common/ByteRLE.h"
+#include "velox/vector/ComplexVector.h"
+#include "velox/vector/FlatVector.h"
+
+namespace facebook::velox::dwrf {
+
+using dwio::common::TypeWithId;
+
+namespace {
+
+// The children of a map spec named 'keys' and 'elements' describe the
+// map as a whole. The other children are subscripts.
+bool isSubscript(const common::ScanSpec& spec) {
+  return spec.fieldName() != "keys" && spec.fieldName() != "elements";
+}
+
+// Returns the key of a flat map value stream as it appears in a
+// subscript.
+template <typename T>
+std::string keyName(const proto::KeyInfo& info) {
+  return std::to_string(info.intkey());
+}
+
+template <>
+std::string keyName<StringView>(const proto::KeyInfo& info) {
+  return info.byteskey();
+}
+
+template <typename T>
+class SelectiveFlatMapColumnReader : public SelectiveColumnReader {
+ public:
+  SelectiveFlatMapColumnReader(
+      const EncodingKey& ek,
+      const std::shared_ptr<const TypeWithId>& requestedType,
+      const std::shared_ptr<const TypeWithId>& dataType,
+      StripeStreams& stripe,
+      common::ScanSpec* scanSpec);
+
+  bool useBulkPath() const override {
+    return false;
+  }
+
+  void resetFilterCaches() override {
+    for (auto& key : keys_) {
+      key.reader->resetFilterCaches();
+    }
+  }
+
+  // The in-map and value streams of the keys are not positioned from
+  // the row index. Skipped row groups are read past instead.
+  void seekToRowGroup(uint32_t index) override {
+    seekTo(index * rowsPerRowGroup_, false);
+  }
+
+  uint64_t skip(uint64_t numValues) override;
+
+  void read(vector_size_t offset, RowSet rows, const uint64_t* incomingNulls)
+      override;
+
+  void getValues(RowSet rows, VectorPtr* result) override;
+
+ private:
+  struct Key {
+    // The key as it appears in a subscript.
+    std::string name;
+    T value;
+    uint32_t sequence;
+    // Spec of the subscript or the 'elements' spec of the map.
+    common::ScanSpec* spec;
+    std::unique_ptr<SelectiveColumnReader> reader;
+    std::unique_ptr<ByteRleDecoder> inMap;
+    // Bit per row in the range of the last read(). Set if the map is
+    // not null and has the key.
+    BufferPtr inMapBits;
+  };
+
+  // Reads the in-map flags of 'key' for 'numRows' maps into 'bits'
+  // and returns the number of maps that have the key.
+  uint64_t readInMap(
+      Key& key,
+      BufferPtr& bits,
+      vector_size_t numRows,
+      const uint64_t* nulls);
+
+  // Advances the value reader of 'key' to 'end' after reading the
+  // range starting at 'offset'.
+  void skipToEnd(Key& key, vector_size_t offset, vector_size_t end);
+
+  // Returns the nulls of the maps at 'rows' or nullptr if none.
+  BufferPtr compactNulls(RowSet rows);
+
+  void getMapValues(RowSet rows, VectorPtr* result);
+
+  void getStructValues(RowSet rows, VectorPtr* result);
+
+  const TypePtr valueType_;
+  const TypePtr resultType_;
+  // True if the result is a ROW of the projected subscripts.
+  const bool asStruct_;
+  std::vector<Key> keys_;
+  // Indices into 'keys_' of the keys in the result. If 'asStruct_',
+  // there is one per child of 'resultType_' and -1 stands for a key
+  // that this stripe does not have.
+  std::vector<int32_t> outputKeys_;
+  // Filters on subscripts of keys that this stripe does not have.
+  std::vector<common::Filter*> missingKeyFilters_;
+  // Backs the StringViews in 'keys_' if the keys are strings.
+  BufferPtr keyStrings_;
+  // Scratch space for in-map flags in skip().
+  BufferPtr skipBits_;
+};
+
+TypePtr makeResultType(
+    const TypePtr& keyType,
+    const TypePtr& valueType,
+    const std::vector<common::ScanSpec*>& projected,
+    bool asStruct) {
+  if (!asStruct) {
+    return MAP(keyType, valueType);
+  }
+  std::vector<std::string> names;
+  for (auto* spec : projected) {
+    names.push_back(spec->fieldName());
+  }
+  return ROW(
+      std::move(names), std::vector<TypePtr>(projected.size(), valueType));
+}
+
+std::vector<common::ScanSpec*> projectedSubscripts(common::ScanSpec* spec) {
+  std::vector<common::ScanSpec*> projected;
+  for (auto& child : spec->children()) {
+    if (isSubscript(*child) && child->projectOut()) {
+      projected.push_back(child.get());
+    }
+  }
+  return projected;
+}
+
+template <typename T>
+SelectiveFlatMapColumnReader<T>::SelectiveFlatMapColumnReader(
+    const EncodingKey& ek,
+    const std::shared_ptr<const TypeWithId>& requestedType,
+    const std::shared_ptr<const TypeWithId>& dataType,
+    StripeStreams& stripe,
+    common::ScanSpec* scanSpec)
+    : SelectiveColumnReader(ek, stripe, scanSpec, dataType->type),
+      valueType_(requestedType->type->asMap().valueType()),
+      resultType_(makeResultType(
+          dataType->childAt(0)->type,
+          valueType_,
+          projectedSubscripts(scanSpec),
+          stripe.getRowReaderOptions().getMapColumnIdAsStruct().count(
+              requestedType->id) > 0)),
+      asStruct_(resultType_->kind() == TypeKind::ROW) {
+  DWIO_ENSURE_EQ(ek.node, dataType->id, "working on the same node");
+  auto projected = projectedSubscripts(scanSpec);
+  const bool pruned = !projected.empty();
+  VELOX_CHECK(
+      !asStruct_ || pruned,
+      "Reading a flat map as struct requires projected subscripts");
+
+  std::unordered_map<std::string, common::ScanSpec*> subscripts;
+  for (auto& child : scanSpec->children()) {
+    if (isSubscript(*child)) {
+      // Values of keys that are returned or filtered must be kept.
+      if (!pruned || child->projectOut()) {
+        child->setExtractValues(true);
+      }
+      subscripts[child->fieldName()] = child.get();
+    }
+  }
+  common::ScanSpec* elementsSpec = nullptr;
+  if (!pruned) {
+    elementsSpec = scanSpec->getOrCreateChild(common::Subfield("elements"));
+    elementsSpec->setProjectOut(true);
+    elementsSpec->setExtractValues(true);
+  }
+
+  auto& requestedValueType = requestedType->childAt(1);
+  auto& dataValueType = dataType->childAt(1);
+  std::unordered_set<uint32_t> processed;
+  stripe.visitStreamsOfNode(
+      dataValueType->id, [&](const StreamInformation& stream) {
+        auto sequence = stream.getSequence();
+        // Sequence 0 has the streams shared by all keys, e.g. a
+        // dictionary.
+        if (sequence == 0 || !processed.insert(sequence).second) {
+          return;
+        }
+        EncodingKey seqEk(dataValueType->id, sequence);
+        const auto& keyInfo = stripe.getEncoding(seqEk).key();
+        auto name = keyName<T>(keyInfo);
+        auto it = subscripts.find(name);
+        if (pruned && it == subscripts.end()) {
+          return;
+        }
+        Key key;
+        key.name = std::move(name);
+        if constexpr (!std::is_same_v<T, StringView>) {
+          key.value = keyInfo.intkey();
+        }
+        key.sequence = sequence;
+        key.spec = it == subscripts.end() ? elementsSpec : it->second;
+        key.reader = SelectiveColumnReader::build(
+            requestedValueType, dataValueType, stripe, key.spec, sequence);
+        auto inMap =
+            stripe.getStream(seqEk.forKind(proto::Stream_Kind_IN_MAP), true);
+        DWIO_ENSURE_NOT_NULL(inMap, "In map stream is required");
+        key.inMap = createBooleanRleDecoder(std::move(inMap), seqEk);
+        keys_.push_back(std::move(key));
+      });
+
+  // Sort by sequence so that the order of keys in maps is fixed.
+  std::sort(keys_.begin(), keys_.end(), [](auto& left, auto& right) {
+    return left.sequence < right.sequence;
+  });
+
+  if constexpr (std::is_same_v<T, StringView>) {
+    size_t size = 0;
+    for (auto& key : keys_) {
+      size += key.name.size();
+    }
+    keyStrings_ = AlignedBuffer::allocate<char>(size, &memoryPool);
+    auto data = keyStrings_->asMutable<char>();
+    for (auto& key : keys_) {
+      memcpy(data, key.name.data(), key.name.size());
+      key.value = StringView(data, key.name.size());
+      data += key.name.size();
+    }
+  }
+
+  std::unordered_map<std::string, int32_t> keyIndices;
+  for (auto i = 0; i < keys_.size(); ++i) {
+    keyIndices[keys_[i].name] = i;
+    if (!asStruct_ && (!pruned || keys_[i].spec->projectOut())) {
+      outputKeys_.push_back(i);
+    }
+  }
+  for (auto& [name, spec] : subscripts) {
+    if (spec->filter() && !keyIndices.count(name)) {
+      missingKeyFilters_.push_back(spec->filter());
+    }
+  }
+  if (asStruct_) {
+    for (auto* spec : projected) {
+      auto it = keyIndices.find(spec->fieldName());
+      outputKeys_.push_back(it == keyIndices.end() ? -1 : it->second);
+    }
+  }
+  VLOG(1) << "[Flat-Map] Initialized a selective flat-map column reader for "
+          << "node " << dataType->id << ", keys=" << keys_.size();
+}
+
+template <typename T>
+uint64_t SelectiveFlatMapColumnReader<T>::readInMap(
+    Key& key,
+    BufferPtr& bits,
+    vector_size_t numRows,
+    const uint64_t* nulls) {
+  if (!numRows) {
+    return 0;
+  }
+  auto numWords = bits::nwords(numRows);
+  if (!bits || bits->capacity() < numWords * sizeof(uint64_t)) {
+    bits = AlignedBuffer::allocate<uint64_t>(numWords, &memoryPool);
+  }
+  auto rawBits = bits->asMutable<uint64_t>();
+  key.inMap->next(reinterpret_cast<char*>(rawBits), numRows, nulls);
+  return bits::countBits(rawBits, 0, numRows);
+}
+
+template <typename T>
+uint64_t SelectiveFlatMapColumnReader<T>::skip(uint64_t numValues) {
+  auto numNonNulls = ColumnReader::skip(numValues);
+  for (auto& key : keys_) {
+    auto numInMap = readInMap(
+        key, skipBits_, static_cast<vector_size_t>(numNonNulls), nullptr);
+    key.reader->skip(numInMap);
+    key.reader->setReadOffset(key.reader->readOffset() + numValues);
+  }
+  return numValues;
+}
+
+template <typename T>
+void SelectiveFlatMapColumnReader<T>::skipToEnd(
+    Key& key,
+    vector_size_t offset,
+    vector_size_t end) {
+  auto readOffset = key.reader->readOffset();
+  if (readOffset < end) {
+    key.reader->skip(bits::countBits(
+        key.inMapBits->template as<uint64_t>(),
+        readOffset - offset,
+        end - offset));
+    key.reader->setReadOffset(end);
+  }
+}
+
+template <typename T>
+void SelectiveFlatMapColumnReader<T>::read(
+    vector_size_t offset,
+    RowSet rows,
+    const uint64_t* incomingNulls) {
+  // Seek with the value streams even if the map spec only reads nulls.
+  seekTo(offset, false);
+  prepareRead<char>(offset, rows, incomingNulls);
+  vector_size_t numRows = rows.back() + 1;
+  const uint64_t* mapNulls =
+      nullsInReadRange_ ? nullsInReadRange_->as<uint64_t>() : nullptr;
+  for (auto& key : keys_) {
+    readInMap(key, key.inMapBits, numRows, mapNulls);
+  }
+
+  RowSet activeRows = rows;
+  for (auto* filter : missingKeyFilters_) {
+    if (!filter->testNull()) {
+      activeRows = RowSet();
+      break;
+    }
+  }
+  // Filtered keys go first so that the other keys only read the rows
+  // that pass.
+  for (auto& key : keys_) {
+    if (activeRows.empty()) {
+      break;
+    }
+    if (key.spec->filter()) {
+      key.reader->read(
+          offset, activeRows, key.inMapBits->template as<uint64_t>());
+      activeRows = key.reader->outputRows();
+    }
+  }
+  for (auto& key : keys_) {
+    if (activeRows.empty()) {
+      break;
+    }
+    if (!key.spec->filter() && key.spec->keepValues()) {
+      key.reader->read(
+          offset, activeRows, key.inMapBits->template as<uint64_t>());
+    }
+  }
+  for (auto& key : keys_) {
+    skipToEnd(key, offset, offset + numRows);
+  }
+  setOutputRows(activeRows);
+  readOffset_ = offset + numRows;
+}
+
+template <typename T>
+BufferPtr SelectiveFlatMapColumnReader<T>::compactNulls(RowSet rows) {
+  if (!nullsInReadRange_) {
+    return nullptr;
+  }
+  auto readerNulls = nullsInReadRange_->as<uint64_t>();
+  auto nulls = AlignedBuffer::allocate<bool>(rows.size(), &memoryPool);
+  auto rawNulls = nulls->asMutable<uint64_t>();
+  for (auto i = 0; i < rows.size(); ++i) {
+    bits::setBit(rawNulls, i, bits::isBitSet(readerNulls, rows[i]));
+  }
+  return nulls;
+}
+
+template <typename T>
+void SelectiveFlatMapColumnReader<T>::getValues(
+    RowSet rows,
+    VectorPtr* result) {
+  if (rows.empty()) {
+    *result = BaseVector::create(resultType_, 0, &memoryPool);
+    return;
+  }
+  if (asStruct_) {
+    getStructValues(rows, result);
+  } else {
+    getMapValues(rows, result);
+  }
+}
+
+template <typename T>
+void SelectiveFlatMapColumnReader<T>::getMapValues(
+    RowSet rows,
+    VectorPtr* result) {
+  vector_size_t numRows = rows.size();
+  std::vector<VectorPtr> values(outputKeys_.size());
+  std::vector<const uint64_t*> inMapBits(outputKeys_.size());
+  for (auto i = 0; i < outputKeys_.size(); ++i) {
+    auto& key = keys_[outputKeys_[i]];
+    if (valueType_->kind() == TypeKind::ROW) {
+      values[i] = BaseVector::create(valueType_, 0, &memoryPool);
+    }
+    key.reader->getValues(rows, &values[i]);
+    inMapBits[i] = key.inMapBits->template as<uint64_t>();
+  }
+
+  vector_size_t numEntries = 0;
+  for (auto* keyBits : inMapBits) {
+    for (auto row : rows) {
+      numEntries += bits::isBitSet(keyBits, row);
+    }
+  }
+  auto offsets = AlignedBuffer::allocate<vector_size_t>(numRows, &memoryPool);
+  auto sizes = AlignedBuffer::allocate<vector_size_t>(numRows, &memoryPool);
+  auto rawOffsets = offsets->asMutable<vector_size_t>();
+  auto rawSizes = sizes->asMutable<vector_size_t>();
+  auto keyVector = BaseVector::create(
+      resultType_->childAt(0), numEntries, &memoryPool);
+  auto flatKeys = keyVector->template asFlatVector<T>();
+  if constexpr (std::is_same_v<T, StringView>) {
+    flatKeys->setStringBuffers({keyStrings_});
+  }
+  auto rawKeys = flatKeys->mutableRawValues();
+  auto indices =
+      AlignedBuffer::allocate<vector_size_t>(numEntries, &memoryPool);
+  auto rawIndices = indices->asMutable<vector_size_t>();
+  // The values of the i-th output key are at i * 'numRows' in the
+  // concatenation of 'values'.
+  vector_size_t entry = 0;
+  for (auto i = 0; i < numRows; ++i) {
+    rawOffsets[i] = entry;
+    for (auto j = 0; j < inMapBits.size(); ++j) {
+      if (bits::isBitSet(inMapBits[j], rows[i])) {
+        rawKeys[entry] = keys_[outputKeys_[j]].value;
+        rawIndices[entry] = j * numRows + i;
+        ++entry;
+      }
+    }
+    rawSizes[i] = entry - rawOffsets[i];
+  }
+
+  VectorPtr valueVector;
+  if (numEntries == 0) {
+    valueVector = BaseVector::create(valueType_, 0, &memoryPool);
+  } else {
+    VectorPtr allValues;
+    if (values.size() == 1) {
+      allValues = values[0];
+    } else {
+      allValues = BaseVector::create(
+          values[0]->type(), values.size() * numRows, &memoryPool);
+      for (auto i = 0; i < values.size(); ++i) {
+        allValues->copy(values[i].get(), i * numRows, 0, numRows);
+      }
+    }
+    valueVector = BaseVector::wrapInDictionary(
+        BufferPtr(nullptr), indices, numEntries, allValues);
+  }
+  *result = std::make_shared<MapVector>(
+      &memoryPool,
+      MAP(resultType_->childAt(0), valueVector->type()),
+      compactNulls(rows),
+      numRows,
+      offsets,
+      sizes,
+      keyVector,
+      valueVector);
+}
+
+template <typename T>
+void SelectiveFlatMapColumnReader<T>::getStructValues(
+    RowSet rows,
+    VectorPtr* result) {
+  std::vector<VectorPtr> children(outputKeys_.size());
+  for (auto i = 0; i < outputKeys_.size(); ++i) {
+    if (outputKeys_[i] < 0) {
+      children[i] =
+          BaseVector::createNullConstant(valueType_, rows.size(), &memoryPool);
+      continue;
+    }
+    if (valueType_->kind() == TypeKind::ROW) {
+      children[i] = BaseVector::create(valueType_, 0, &memoryPool);
+    }
+    keys_[outputKeys_[i]].reader->getValues(rows, &children[i]);
+  }
+  *result = std::make_shared<RowVector>(
+      &memoryPool,
+      resultType_,
+      compactNulls(rows),
+      rows.size(),
+      std::move(children));
+}
+
+template <typename T>
+std::unique_ptr<SelectiveColumnReader> makeReader(
+    const EncodingKey& ek,
+    const std::shared_ptr<const TypeWithId>& requestedType,
+    const std::shared_ptr<const TypeWithId>& dataType,
+    StripeStreams& stripe,
+    common::ScanSpec* scanSpec) {
+  return std::make_unique<SelectiveFlatMapColumnReader<T>>(
+      ek, requestedType, dataType, stripe, scanSpec);
+}
+
+} // namespace
+
+std::unique_ptr<SelectiveColumnReader> createSelectiveFlatMapColumnReader(
+    const EncodingKey& ek,
+    const std::shared_ptr<const TypeWithId>& requestedType,
+    const std::shared_ptr<const TypeWithId>& dataType,
+    StripeStreams& stripe,
+    common::ScanSpec* scanSpec) {
+  auto kind = dataType->childAt(0)->type->kind();
+  switch (kind) {
+    case TypeKind::TINYINT:
+      return makeReader<int8_t>(ek, requestedType, dataType, stripe, scanSpec);
+    case TypeKind::SMALLINT:
+      return makeReader<int16_t>(
+          ek, requestedType, dataType, stripe, scanSpec);
+    case TypeKind::INTEGER:
+      return makeReader<int32_t>(
+          ek, requestedType, dataType, stripe, scanSpec);
+    case TypeKind::BIGINT:
+      return makeReader<int64_t>(
+          ek, requestedType, dataType, stripe, scanSpec);
+    case TypeKind::VARBINARY:
+    case TypeKind::VARCHAR:
+      return makeReader<StringView>(
+          ek, requestedType, dataType, stripe, scanSpec);
+    default:
+      DWIO_RAISE("Not supported key type: ", kind);
+  }
+}
+
+} // namespace facebook::velox::dwrf
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/dwio/dwrf/reader/SelectiveColumnReader.h"
+
+namespace facebook::velox::dwrf {
+
+// Creates a SelectiveColumnReader for a MAP column with MAP_FLAT
+// encoding. Children of 'scanSpec' that are map subscripts, e.g. the
+// spec for features[123], refer to keys. Filters on subscripts apply
+// to the value of the key, a missing key reads as null. If some
+// subscripts are projected out, only the in-map and value streams of
+// the subscripted keys are opened and the projected keys are
+// returned. Otherwise all keys are read and returned. The result is a
+// MAP or, if the column is listed in
+// RowReaderOptions::getMapColumnIdAsStruct(), a ROW with one child per
+// projected subscript.
+std::unique_ptr<SelectiveColumnReader> createSelectiveFlatMapColumnReader(
+    const EncodingKey& ek,
+    const std::shared_ptr<const dwio::common::TypeWithId>& requestedType,
+    const std::shared_ptr<const dwio::common::TypeWithId>& dataType,
+    StripeStreams& stripe,
+    common::ScanSpec* scanSpec);
+
+} // namespace facebook::velox::dwrf
@@ -17,17 +17,34 @@
 #include "velox/dwio/dwrf/reader/StripeDictionaryCache.h"
 
 namespace facebook::velox::dwrf {
-StripeDictionaryCache::DictionaryEntry::DictionaryEntry(
-    folly::Function<BufferPtr(velox::memory::MemoryPool*)>&& dictGen)
-    : dictGen_{std::move(dictGen)} {}
-
-BufferPtr StripeDictionaryCache::DictionaryEntry::getDictionaryBuffer(
-    velox::memory::MemoryPool* pool) {
-  if (!dictionaryBuffer_) {
-    dictionaryBuffer_ = dictGen_(pool);
-    dictGen_ = nullptr;
+
+const FlatVectorPtr<StringView>& StringDictionary::values(
+    const TypePtr& type,
+    memory::MemoryPool* pool) {
+  if (!values_) {
+    BufferPtr values = AlignedBuffer::allocate<StringView>(count_, pool);
+    auto* valuesPtr = values->asMutable<StringView>();
+    const auto* blobPtr = blob_->as<char>();
+    const auto* offsetsPtr = offsets_->as<int64_t>();
+    for (uint64_t i = 0; i < count_; ++i) {
+      valuesPtr[i] = StringView(
+          blobPtr + offsetsPtr[i], offsetsPtr[i + 1] - offsetsPtr[i]);
+    }
+    values_ = std::make_shared<FlatVector<StringView>>(
+        pool,
+        type,
+        BufferPtr(nullptr),
+        count_,
+        std::move(values),
+        std::vector<BufferPtr>{blob_});
   }
-  return dictionaryBuffer_;
+  DWIO_ENSURE(
+      values_->type()->kindEquals(type),
+      "String dictionary requested as ",
+      type->toString(),
+      " but made as ",
+      values_->type()->toString());
+  return values_;
 }
 
 StripeDictionaryCache::StripeDictionaryCache(velox::memory::MemoryPool* pool)
@@ -38,11 +55,26 @@ void StripeDictionaryCache::registerIntDictionary(
     const EncodingKey& ek,
     folly::Function<BufferPtr(velox::memory::MemoryPool*)>&& dictGen) {
   intDictionaryFactories_.emplace(
-      ek, std::make_unique<DictionaryEntry>(std::move(dictGen)));
+      ek, std::make_unique<DictionaryEntry<BufferPtr>>(std::move(dictGen)));
 }
 
 BufferPtr StripeDictionaryCache::getIntDictionary(const EncodingKey& ek) {
-  return intDictionaryFactories_.at(ek)->getDictionaryBuffer(pool_);
+  return intDictionaryFactories_.at(ek)->getDictionary(pool_);
+}
+
+void StripeDictionaryCache::registerStringDictionary(
+    const EncodingKey& ek,
+    folly::Function<std::shared_ptr<StringDictionary>(
+        velox::memory::MemoryPool*)>&& dictGen) {
+  stringDictionaryFactories_.emplace(
+      ek,
+      std::make_unique<DictionaryEntry<std::shared_ptr<StringDictionary>>>(
+          std::move(dictGen)));
+}
+
+std::shared_ptr<StringDictionary> StripeDictionaryCache::getStringDictionary(
+    const EncodingKey& ek) {
+  return stringDictionaryFactories_.at(ek)->getDictionary(pool_);
 }
 
 } // namespace facebook::velox::dwrf
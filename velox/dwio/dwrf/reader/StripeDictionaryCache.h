@@ -23,22 +23,62 @@
 #include "velox/dwio/dwrf/common/Common.h"
 #include "velox/dwio/dwrf/common/IntDecoder.h"
 #include "velox/vector/BaseVector.h"
+#include "velox/vector/FlatVector.h"
 
 namespace facebook::velox::dwrf {
+
+// Stripe level dictionary of a string column. The entries are stored back to
+// back in 'blob' and delimited by the 'count' + 1 int64_t 'offsets'.
+class StringDictionary {
+ public:
+  StringDictionary(uint64_t count, BufferPtr blob, BufferPtr offsets)
+      : count_{count}, blob_{std::move(blob)}, offsets_{std::move(offsets)} {}
+
+  uint64_t count() const {
+    return count_;
+  }
+
+  const BufferPtr& blob() const {
+    return blob_;
+  }
+
+  const BufferPtr& offsets() const {
+    return offsets_;
+  }
+
+  // Returns the entries as a FlatVector of 'type' over 'blob'. The vector is
+  // made on first use and then shared by all batches and readers of the
+  // stripe, so that dictionary encoded results stay over the same base.
+  const FlatVectorPtr<StringView>& values(
+      const TypePtr& type,
+      memory::MemoryPool* pool);
+
+ private:
+  const uint64_t count_;
+  const BufferPtr blob_;
+  const BufferPtr offsets_;
+  FlatVectorPtr<StringView> values_;
+};
+
 class StripeDictionaryCache {
-  // This could be potentially made an interface to be shared for
-  // string dictionaries. However, we will need a union return type
-  // in that case.
+  template <typename T>
   class DictionaryEntry {
    public:
     explicit DictionaryEntry(
-        folly::Function<BufferPtr(velox::memory::MemoryPool*)>&& dictGen);
+        folly::Function<T(velox::memory::MemoryPool*)>&& dictGen)
+        : dictGen_{std::move(dictGen)} {}
 
-    BufferPtr getDictionaryBuffer(velox::memory::MemoryPool* pool);
+    T getDictionary(velox::memory::MemoryPool* pool) {
+      if (!dictionary_) {
+        dictionary_ = dictGen_(pool);
+        dictGen_ = nullptr;
+      }
+      return dictionary_;
+    }
 
    private:
-    folly::Function<BufferPtr(velox::memory::MemoryPool*)> dictGen_;
-    BufferPtr dictionaryBuffer_;
+    folly::Function<T(velox::memory::MemoryPool*)> dictGen_;
+    T dictionary_;
   };
 
  public:
@@ -50,16 +90,29 @@ class StripeDictionaryCache {
 
   BufferPtr getIntDictionary(const EncodingKey& ek);
 
+  void registerStringDictionary(
+      const EncodingKey& ek,
+      folly::Function<std::shared_ptr<StringDictionary>(
+          velox::memory::MemoryPool*)>&& dictGen);
+
+  std::shared_ptr<StringDictionary> getStringDictionary(const EncodingKey& ek);
+
  private:
   // This is typically the reader's memory pool.
   memory::MemoryPool* pool_;
   std::unordered_map<
       EncodingKey,
-      std::unique_ptr<DictionaryEntry>,
+      std::unique_ptr<DictionaryEntry<BufferPtr>>,
       EncodingKeyHash>
       intDictionaryFactories_;
+  std::unordered_map<
+      EncodingKey,
+      std::unique_ptr<DictionaryEntry<std::shared_ptr<StringDictionary>>>,
+      EncodingKeyHash>
+      stringDictionaryFactories_;
 
   FRIEND_TEST(TestStripeDictionaryCache, RegisterDictionary);
+  FRIEND_TEST(TestStripeDictionaryCache, StringDictionary);
 };
 
 } // namespace facebook::velox::dwrf
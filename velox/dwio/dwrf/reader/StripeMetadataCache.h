@@ -63,6 +63,19 @@ class StripeMetadataCache {
     return {};
   }
 
+  /// Returns a copy of 'this' whose metadata is in a buffer from 'pool'.
+  std::shared_ptr<StripeMetadataCache> copy(memory::MemoryPool& pool) const {
+    auto buffer =
+        std::make_shared<dwio::common::DataBuffer<char>>(pool, buffer_->size());
+    std::memcpy(buffer->data(), buffer_->data(), buffer_->size());
+    return std::make_shared<StripeMetadataCache>(
+        mode_, std::move(buffer), std::vector<uint32_t>(offsets_));
+  }
+
+  uint64_t sizeInBytes() const {
+    return buffer_->capacity() + offsets_.size() * sizeof(uint32_t);
+  }
+
  private:
   proto::StripeCacheMode mode_;
   std::shared_ptr<dwio::common::DataBuffer<char>> buffer_;
@@ -99,6 +99,19 @@ BufferPtr readDict(
   dictReader->bulkRead(dictionarySize, dictionaryBuffer->asMutable<T>());
   return dictionaryBuffer;
 }
+
+RleVersion toRleVersion(proto::ColumnEncoding_Kind kind) {
+  switch (static_cast<int64_t>(kind)) {
+    case proto::ColumnEncoding_Kind_DIRECT:
+    case proto::ColumnEncoding_Kind_DICTIONARY:
+      return RleVersion_1;
+    case proto::ColumnEncoding_Kind_DIRECT_V2:
+    case proto::ColumnEncoding_Kind_DICTIONARY_V2:
+      return RleVersion_2;
+    default:
+      DWIO_RAISE("Unknown encoding in toRleVersion");
+  }
+}
 } // namespace
 
 std::function<BufferPtr()>
@@ -134,6 +147,52 @@ StripeStreamsBase::getIntDictionaryInitializerForNode(
   };
 }
 
+folly::Function<std::shared_ptr<StringDictionary>(memory::MemoryPool*)>
+makeStringDictionaryReader(const StripeStreams& stripe, const EncodingKey& ek) {
+  auto& encoding = stripe.getEncoding(ek);
+  const auto lenId = ek.forKind(proto::Stream_Kind_LENGTH);
+  auto lengthDecoder = IntDecoder</*isSigned*/ false>::createRle(
+      stripe.getStream(lenId, false),
+      toRleVersion(encoding.kind()),
+      stripe.getMemoryPool(),
+      stripe.getUseVInts(lenId),
+      INT_BYTE_SIZE);
+  auto blobStream =
+      stripe.getStream(ek.forKind(proto::Stream_Kind_DICTIONARY_DATA), false);
+  return [count = encoding.dictionarysize(),
+          lengthDecoder = std::move(lengthDecoder),
+          blobStream = std::move(blobStream)](
+             memory::MemoryPool* pool) mutable {
+    auto offsets = AlignedBuffer::allocate<int64_t>(count + 1, pool);
+    auto* offsetsPtr = offsets->asMutable<int64_t>();
+    offsetsPtr[0] = 0;
+    if (count > 0) {
+      lengthDecoder->next(offsetsPtr + 1, count, nullptr);
+      for (uint64_t i = 1; i < count + 1; ++i) {
+        offsetsPtr[i] += offsetsPtr[i - 1];
+      }
+    }
+    auto blobSize = offsetsPtr[count];
+    auto blob = AlignedBuffer::allocate<char>(blobSize, pool);
+    if (blobSize > 0) {
+      DWIO_ENSURE_NOT_NULL(blobStream, "String dictionary data is missing");
+      blobStream->readFully(blob->asMutable<char>(), blobSize);
+    }
+    return std::make_shared<StringDictionary>(
+        count, std::move(blob), std::move(offsets));
+  };
+}
+
+std::function<std::shared_ptr<StringDictionary>()>
+StripeStreamsBase::getStringDictionaryInitializerForNode(
+    const EncodingKey& ek) {
+  stripeDictionaryCache_->registerStringDictionary(
+      ek, makeStringDictionaryReader(*this, ek));
+  return [&dictCache = *stripeDictionaryCache_, ek]() {
+    return dictCache.getStringDictionary(ek);
+  };
+}
+
 void StripeStreamsImpl::loadStreams() {
   auto& footer = reader_.getStripeFooter();
 
@@ -281,8 +340,13 @@ std::unique_ptr<SeekableInputStream> StripeStreamsImpl::getStream(
 
   auto streamDebugInfo =
       fmt::format("Stripe {} Stream {}", stripeIndex_, si.toString());
+  auto& input = reader_.getStripeInput();
   return reader_.getReader().createDecompressedStream(
-      std::move(streamRead), streamDebugInfo, getDecrypter(si.node));
+      std::move(streamRead),
+      streamDebugInfo,
+      getDecrypter(si.node),
+      input.decompressAheadExecutor(),
+      input.maxDecompressAheadBytes());
 }
 
 uint32_t StripeStreamsImpl::visitStreamsOfNode(
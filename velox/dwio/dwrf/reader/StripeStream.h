@@ -127,6 +127,12 @@ class StripeStreams {
       uint64_t elementWidth,
       uint64_t dictionaryWidth = sizeof(int64_t)) = 0;
 
+  /// Get the stripe level dictionary of the string column 'ek'. The
+  /// dictionary is read on the first call of the returned function and is
+  /// then shared by all batches and readers of the stripe.
+  virtual std::function<std::shared_ptr<StringDictionary>()>
+  getStringDictionaryInitializerForNode(const EncodingKey& ek) = 0;
+
   virtual std::shared_ptr<StripeDictionaryCache> getStripeDictionaryCache() = 0;
 
   /**
@@ -159,6 +165,11 @@ class StripeStreams {
   virtual uint32_t rowsPerRowGroup() const = 0;
 };
 
+// Opens the LENGTH and DICTIONARY_DATA streams of the string column 'ek' and
+// returns a function that reads the stripe level dictionary from them.
+folly::Function<std::shared_ptr<StringDictionary>(memory::MemoryPool*)>
+makeStringDictionaryReader(const StripeStreams& stripe, const EncodingKey& ek);
+
 class StripeStreamsBase : public StripeStreams {
  public:
   explicit StripeStreamsBase(velox::memory::MemoryPool* pool)
@@ -176,6 +187,9 @@ class StripeStreamsBase : public StripeStreams {
       uint64_t elementWidth,
       uint64_t dictionaryWidth = sizeof(int64_t)) override;
 
+  std::function<std::shared_ptr<StringDictionary>()>
+  getStringDictionaryInitializerForNode(const EncodingKey& ek) override;
+
   std::shared_ptr<StripeDictionaryCache> getStripeDictionaryCache() override {
     return stripeDictionaryCache_;
   }
@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <limits>
+
+#include "velox/dwio/common/MemoryInputStream.h"
+#include "velox/dwio/dwrf/common/BloomFilter.h"
+#include "velox/dwio/dwrf/reader/DwrfReader.h"
+#include "velox/dwio/dwrf/reader/ScanSpec.h"
+#include "velox/dwio/dwrf/reader/SelectiveColumnReader.h"
+#include "velox/dwio/dwrf/writer/Writer.h"
+#include "velox/type/Filter.h"
+#include "velox/type/Subfield.h"
+#include "velox/vector/ComplexVector.h"
+#include "velox/vector/FlatVector.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::dwrf;
+using namespace facebook::velox::common;
+using facebook::dwio::common::MemoryInputStream;
+using facebook::dwio::common::MemorySink;
+
+TEST(BloomFilterTest, basic) {
+  BloomFilter filter(1'000, 0.05);
+  EXPECT_EQ(0, filter.numBits() % 64);
+  EXPECT_GT(filter.numHashFunctions(), 1);
+  for (int64_t i = 0; i < 1'000; ++i) {
+    filter.addInt64(i * 1'001);
+    auto str = fmt::format("string {}", i);
+    filter.addBytes(str.data(), str.size());
+  }
+  int32_t numFalsePositives = 0;
+  for (int64_t i = 0; i < 1'000; ++i) {
+    EXPECT_TRUE(filter.testInt64(i * 1'001));
+    auto str = fmt::format("string {}", i);
+    EXPECT_TRUE(filter.testBytes(str.data(), str.size()));
+    numFalsePositives += filter.testInt64(i * 1'001 + 1);
+    auto missing = fmt::format("missing {}", i);
+    numFalsePositives += filter.testBytes(missing.data(), missing.size());
+  }
+  // 2000 entries in a filter sized for 1000 at 5%. Allow some slack over
+  // the expected false positive rate.
+  EXPECT_LT(numFalsePositives, 2'000 * 0.3);
+
+  filter.reset();
+  EXPECT_FALSE(filter.testInt64(0));
+}
+
+TEST(BloomFilterTest, hashInt64MatchesOrc) {
+  // Values of getLongHash() in ORC's BloomFilter, which uses arithmetic right
+  // shifts.
+  EXPECT_EQ(BloomFilter::hashInt64(0), 0ULL);
+  EXPECT_EQ(BloomFilter::hashInt64(1), 0x5bca7c69b794f8ceULL);
+  EXPECT_EQ(BloomFilter::hashInt64(-1), 0x5bca868437950d03ULL);
+  EXPECT_EQ(BloomFilter::hashInt64(-12345), 0x6a4882d9d48fffa6ULL);
+  EXPECT_EQ(
+      BloomFilter::hashInt64(std::numeric_limits<int64_t>::min()),
+      0x3be7d0f7780de548ULL);
+  EXPECT_EQ(
+      BloomFilter::hashInt64(std::numeric_limits<int64_t>::max()),
+      0x81ad52718398e837ULL);
+}
+
+TEST(BloomFilterTest, serialize) {
+  BloomFilter filter(100, 0.01);
+  for (int64_t i = 0; i < 100; ++i) {
+    filter.addInt64(i);
+  }
+  proto::BloomFilter proto;
+  filter.serialize(proto);
+  EXPECT_EQ(filter.numHashFunctions(), proto.numhashfunctions());
+  EXPECT_EQ(0, proto.bitset_size());
+  EXPECT_EQ(filter.numBits(), proto.utf8bitset().size() * 8);
+
+  BloomFilter copy(proto);
+  EXPECT_EQ(filter.numBits(), copy.numBits());
+  for (int64_t i = -1'000; i < 1'000; ++i) {
+    EXPECT_EQ(filter.testInt64(i), copy.testInt64(i));
+  }
+
+  // Readers must also accept the bitset as words.
+  proto::BloomFilter wordsProto;
+  wordsProto.set_numhashfunctions(proto.numhashfunctions());
+  const auto& bytes = proto.utf8bitset();
+  for (auto i = 0; i < bytes.size(); i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, bytes.data() + i, sizeof(word));
+    wordsProto.add_bitset(word);
+  }
+  BloomFilter fromWords(wordsProto);
+  for (int64_t i = 0; i < 100; ++i) {
+    EXPECT_TRUE(fromWords.testInt64(i));
+  }
+}
+
+namespace {
+constexpr int32_t kRowsPerRowGroup = 1'000;
+constexpr int32_t kNumRowGroups = 10;
+constexpr int32_t kNumRows = kRowsPerRowGroup * kNumRowGroups;
+
+// A permutation of [0, kNumRows) so that min/max stats of every row group
+// cover almost the whole range.
+int64_t idAt(int32_t row) {
+  return (row * 7'919L) % kNumRows;
+}
+
+std::string nameAt(int32_t row) {
+  return fmt::format("name {}", idAt(row));
+}
+} // namespace
+
+class BloomFilterRowGroupTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    pool_ = memory::getDefaultScopedMemoryPool();
+    rowType_ = ROW({"id", "name"}, {BIGINT(), VARCHAR()});
+  }
+
+  void write(bool withBloomFilters) {
+    auto config = std::make_shared<Config>();
+    config->set(Config::ROW_INDEX_STRIDE, (uint32_t)kRowsPerRowGroup);
+    if (withBloomFilters) {
+      config->set(Config::BLOOM_FILTER_COLUMNS, {0, 1});
+      config->set(Config::BLOOM_FILTER_FPP, 0.001);
+    }
+    WriterOptions options;
+    options.config = config;
+    options.schema = rowType_;
+    auto sink = std::make_unique<MemorySink>(*pool_, 10 * 1024 * 1024);
+    sink_ = sink.get();
+    Writer writer(options, std::move(sink), *pool_);
+
+    auto ids = BaseVector::create(BIGINT(), kNumRows, pool_.get());
+    auto names = BaseVector::create(VARCHAR(), kNumRows, pool_.get());
+    for (auto i = 0; i < kNumRows; ++i) {
+      ids->asFlatVector<int64_t>()->set(i, idAt(i));
+      auto name = nameAt(i);
+      names->asFlatVector<StringView>()->set(i, StringView(name));
+    }
+    writer.write(std::make_shared<RowVector>(
+        pool_.get(),
+        rowType_,
+        BufferPtr(nullptr),
+        kNumRows,
+        std::vector<VectorPtr>{ids, names}));
+    writer.close();
+  }
+
+  // Reads the file with 'filter' on 'column' and returns the ids of the
+  // result rows. Sets 'skippedStrides' to the number of row groups skipped.
+  std::vector<int64_t> read(
+      const std::string& column,
+      std::unique_ptr<Filter> filter,
+      int64_t& skippedStrides) {
+    ScanSpec spec("root");
+    for (auto i = 0; i < rowType_->size(); ++i) {
+      auto child = spec.getOrCreateChild(Subfield(rowType_->nameOf(i)));
+      child->setProjectOut(true);
+      child->setExtractValues(true);
+      child->setChannel(i);
+    }
+    spec.getOrCreateChild(Subfield(column))->setFilter(std::move(filter));
+
+    facebook::dwio::common::ReaderOptions readerOpts;
+    facebook::dwio::common::RowReaderOptions rowReaderOpts;
+    auto reader = std::make_unique<DwrfReader>(
+        readerOpts,
+        std::make_unique<MemoryInputStream>(sink_->getData(), sink_->size()));
+    SelectiveColumnReaderFactory factory(&spec);
+    rowReaderOpts.setColumnReaderFactory(&factory);
+    auto rowReader = reader->createRowReader(rowReaderOpts);
+    std::vector<int64_t> result;
+    VectorPtr batch = BaseVector::create(rowType_, 1, pool_.get());
+    while (rowReader->next(kRowsPerRowGroup, batch)) {
+      auto rowVector = batch->as<RowVector>();
+      auto ids = rowVector->loadedChildAt(0)->as<SimpleVector<int64_t>>();
+      for (auto i = 0; i < batch->size(); ++i) {
+        result.push_back(ids->valueAt(i));
+      }
+    }
+    skippedStrides = rowReader->skippedStrides();
+    return result;
+  }
+
+  std::unique_ptr<memory::ScopedMemoryPool> pool_;
+  std::shared_ptr<const RowType> rowType_;
+  MemorySink* sink_;
+};
+
+TEST_F(BloomFilterRowGroupTest, bigintValues) {
+  // One value in row group 2 and one in row group 7.
+  std::vector<int64_t> values = {idAt(2'500), idAt(7'500)};
+  int64_t skippedStrides;
+
+  write(false);
+  auto result =
+      read("id", createBigintValues(values, false), skippedStrides);
+  EXPECT_EQ(values, result);
+  EXPECT_EQ(0, skippedStrides);
+
+  write(true);
+  result = read("id", createBigintValues(values, false), skippedStrides);
+  EXPECT_EQ(values, result);
+  // 8 row groups have none of the values. Allow for a false positive.
+  EXPECT_GE(skippedStrides, kNumRowGroups - 3);
+
+  // A single value range is a point lookup too.
+  result = read(
+      "id",
+      std::make_unique<BigintRange>(values[0], values[0], false),
+      skippedStrides);
+  EXPECT_EQ(std::vector<int64_t>{values[0]}, result);
+  EXPECT_GE(skippedStrides, kNumRowGroups - 2);
+}
+
+TEST_F(BloomFilterRowGroupTest, bytesValues) {
+  write(true);
+  int64_t skippedStrides;
+  auto result = read(
+      "name",
+      std::make_unique<BytesValues>(
+          std::vector<std::string>{nameAt(4'321), "not present"}, false),
+      skippedStrides);
+  EXPECT_EQ(std::vector<int64_t>{idAt(4'321)}, result);
+  EXPECT_GE(skippedStrides, kNumRowGroups - 2);
+
+  // Nulls are not in the bloom filter, so a filter that passes nulls must
+  // not skip row groups.
+  result = read(
+      "name",
+      std::make_unique<BytesValues>(
+          std::vector<std::string>{nameAt(4'321)}, true),
+      skippedStrides);
+  EXPECT_EQ(std::vector<int64_t>{idAt(4'321)}, result);
+  EXPECT_EQ(0, skippedStrides);
+}
@@ -299,6 +299,19 @@ std::unique_ptr<Filter> ColumnStats<StringView>::makeRangeFilter(
       selectPct > 25);
 }
 
+template <>
+std::unique_ptr<Filter> ColumnStats<Timestamp>::makeRangeFilter(
+    float startPct,
+    float selectPct) {
+  if (values_.empty()) {
+    return std::make_unique<velox::common::IsNull>();
+  }
+  Timestamp lower = valueAtPct(startPct);
+  Timestamp upper = valueAtPct(startPct + selectPct);
+  return std::make_unique<velox::common::TimestampRange>(
+      lower, upper, selectPct > 25);
+}
+
 template <TypeKind Kind>
 std::unique_ptr<AbstractColumnStats> makeStats(TypePtr type) {
   using T = typename TypeTraits<Kind>::NativeType;
@@ -411,6 +424,9 @@ class E2EFilterTest : public testing::Test {
         case TypeKind::DOUBLE:
           stats = makeStats<TypeKind::DOUBLE>(vector->type());
           break;
+        case TypeKind::TIMESTAMP:
+          stats = makeStats<TypeKind::TIMESTAMP>(vector->type());
+          break;
         default:
           VELOX_CHECK(false, "Type not supported");
       }
@@ -984,6 +1000,19 @@ TEST_F(E2EFilterTest, floatAndDouble) {
       false);
 }
 
+TEST_F(E2EFilterTest, timestamp) {
+  testWithTypes(
+      "timestamp_val:timestamp,"
+      "long_val:bigint,"
+      "timestamp_null:timestamp",
+      [&]() { makeAllNulls("timestamp_null"); },
+      true,
+      {"timestamp_val", "long_val", "timestamp_null"},
+      20,
+      true,
+      true);
+}
+
 TEST_F(E2EFilterTest, stringDirect) {
   testWithTypes(
       "string_val:string,"
@@ -1022,4 +1051,55 @@ TEST_F(E2EFilterTest, listAndMap) {
       10);
 }
 
+TEST_F(E2EFilterTest, filterChangeSkipsStripesAndStrides) {
+  // 4 stripes of 25000 rows with ascending values, so that each stride of
+  // 10000 rows covers a distinct range.
+  makeDataset(
+      "long_val:bigint",
+      [&]() {
+        int64_t value = 0;
+        for (auto& batch : batches_) {
+          auto values = batch->childAt(0)->asFlatVector<int64_t>();
+          for (auto i = 0; i < batch->size(); ++i) {
+            values->set(i, value++);
+          }
+        }
+      },
+      false);
+  auto spec = makeScanSpec(SubfieldFilters{});
+  auto reader = std::make_unique<DwrfReader>(
+      dwio::common::ReaderOptions{},
+      std::make_unique<MemoryInputStream>(
+          sinkPtr_->getData(), sinkPtr_->size()));
+  auto factory = std::make_unique<SelectiveColumnReaderFactory>(spec.get());
+  dwio::common::RowReaderOptions rowReaderOpts;
+  rowReaderOpts.setColumnReaderFactory(factory.get());
+  auto rowReader = reader->createRowReader(rowReaderOpts);
+
+  auto batch = BaseVector::create(rowType_, 1, pool_.get());
+  ASSERT_EQ(1000, rowReader->next(1000, batch));
+  ASSERT_EQ(1000, batch->size());
+
+  // Add a filter in the middle of the first stripe, as a dynamic filter
+  // would be. Only the second stride of the third stripe has hits.
+  spec->childByName("long_val")
+      ->setFilter(std::make_unique<BigintRange>(60'000, 61'000, false));
+  spec->resetCachedValues();
+  rowReader->resetFilterCaches();
+
+  int64_t expected = 60'000;
+  while (rowReader->next(1000, batch)) {
+    auto values =
+        batch->as<RowVector>()->loadedChildAt(0)->as<SimpleVector<int64_t>>();
+    for (auto i = 0; i < batch->size(); ++i) {
+      ASSERT_EQ(expected++, values->valueAt(i));
+    }
+  }
+  EXPECT_EQ(61'001, expected);
+  // The rest of the first stripe, the second and fourth stripes and the
+  // first and last strides of the third stripe.
+  EXPECT_EQ(10, rowReader->skippedStrides());
+  EXPECT_EQ(2, rowReader->skippedStripes());
+}
+
 } // namespace facebook::dwio::dwrf
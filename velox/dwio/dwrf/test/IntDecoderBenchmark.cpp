@@ -24,6 +24,7 @@
 #include "folly/init/Init.h"
 #include "folly/lang/Bits.h"
 #include "velox/dwio/common/exception/Exception.h"
+#include "velox/dwio/dwrf/common/BitUnpack.h"
 #include "velox/dwio/dwrf/common/IntCodecCommon.h"
 #include "velox/dwio/dwrf/common/IntDecoder.h"
 
@@ -873,6 +874,104 @@ BENCHMARK_RELATIVE(decodeNew_64) {
       randomInts_u64.size(), buffer_u64.data(), randomInts_u64_result.data());
 }
 
+// Bit packed inputs for RLEv2 DIRECT runs, indexed by bit width.
+const size_t kNumPacked = 100000;
+std::vector<std::vector<char>> packed(65);
+std::vector<int64_t> unpacked(kNumPacked);
+
+void packRandom(uint32_t width) {
+  auto& bytes = packed[width];
+  uint32_t bitsInByte = 0;
+  for (size_t i = 0; i < kNumPacked; ++i) {
+    auto value = folly::Random::rand64();
+    for (int32_t bit = width - 1; bit >= 0; --bit) {
+      if (bitsInByte == 0) {
+        bytes.push_back(0);
+      }
+      bytes.back() |= ((value >> bit) & 1) << (7 - bitsInByte);
+      bitsInByte = (bitsInByte + 1) % 8;
+    }
+  }
+  // Slack for the 8 byte loads past the last value.
+  bytes.resize(bytes.size() + sizeof(uint64_t));
+}
+
+// One value at a time, as RleDecoderV2::readLongs without unpackBitPacked.
+void unpackScalar(uint32_t iters, uint32_t width) {
+  for (uint32_t iter = 0; iter < iters; ++iter) {
+    const char* input = packed[width].data();
+    uint32_t bitsLeft = 0;
+    uint32_t curByte = 0;
+    for (size_t i = 0; i < kNumPacked; ++i) {
+      uint64_t result = 0;
+      uint64_t bitsLeftToRead = width;
+      while (bitsLeftToRead > bitsLeft) {
+        result <<= bitsLeft;
+        result |= curByte & ((1 << bitsLeft) - 1);
+        bitsLeftToRead -= bitsLeft;
+        curByte = static_cast<unsigned char>(*input++);
+        bitsLeft = 8;
+      }
+      if (bitsLeftToRead > 0) {
+        result <<= bitsLeftToRead;
+        bitsLeft -= static_cast<uint32_t>(bitsLeftToRead);
+        result |= (curByte >> bitsLeft) & ((1 << bitsLeftToRead) - 1);
+      }
+      unpacked[i] = static_cast<int64_t>(result);
+    }
+    folly::doNotOptimizeAway(unpacked[kNumPacked - 1]);
+  }
+}
+
+void unpackFast(uint32_t iters, uint32_t width) {
+  for (uint32_t iter = 0; iter < iters; ++iter) {
+    auto numUnpacked = unpackBitPacked(
+        packed[width].data(),
+        packed[width].size(),
+        width,
+        kNumPacked,
+        unpacked.data());
+    folly::doNotOptimizeAway(numUnpacked);
+  }
+}
+
+#define UNPACK_BENCHMARKS(width)     \
+  BENCHMARK_PARAM(unpackScalar, width) \
+  BENCHMARK_RELATIVE_PARAM(unpackFast, width)
+
+UNPACK_BENCHMARKS(1)
+UNPACK_BENCHMARKS(2)
+UNPACK_BENCHMARKS(3)
+UNPACK_BENCHMARKS(4)
+UNPACK_BENCHMARKS(5)
+UNPACK_BENCHMARKS(6)
+UNPACK_BENCHMARKS(7)
+UNPACK_BENCHMARKS(8)
+UNPACK_BENCHMARKS(9)
+UNPACK_BENCHMARKS(10)
+UNPACK_BENCHMARKS(11)
+UNPACK_BENCHMARKS(12)
+UNPACK_BENCHMARKS(13)
+UNPACK_BENCHMARKS(14)
+UNPACK_BENCHMARKS(15)
+UNPACK_BENCHMARKS(16)
+UNPACK_BENCHMARKS(17)
+UNPACK_BENCHMARKS(18)
+UNPACK_BENCHMARKS(19)
+UNPACK_BENCHMARKS(20)
+UNPACK_BENCHMARKS(21)
+UNPACK_BENCHMARKS(22)
+UNPACK_BENCHMARKS(23)
+UNPACK_BENCHMARKS(24)
+UNPACK_BENCHMARKS(26)
+UNPACK_BENCHMARKS(28)
+UNPACK_BENCHMARKS(30)
+UNPACK_BENCHMARKS(32)
+UNPACK_BENCHMARKS(40)
+UNPACK_BENCHMARKS(48)
+UNPACK_BENCHMARKS(56)
+UNPACK_BENCHMARKS(64)
+
 int32_t main(int32_t argc, char* argv[]) {
   folly::init(&argc, &argv);
 
@@ -909,6 +1008,10 @@ int32_t main(int32_t argc, char* argv[]) {
   randomInts_u64_result.resize(randomInts_u64.size());
   len_u64 = pos;
 
+  for (uint32_t width = 1; width <= 64; ++width) {
+    packRandom(width);
+  }
+
   folly::runBenchmarks();
   return 0;
 }
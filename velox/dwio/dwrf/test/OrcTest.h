@@ -59,6 +59,14 @@ class MockStripeStreams : public StripeStreams {
     };
   }
 
+  std::function<std::shared_ptr<StringDictionary>()>
+  getStringDictionaryInitializerForNode(const EncodingKey& ek) override {
+    auto reader = std::make_shared<
+        folly::Function<std::shared_ptr<StringDictionary>(MemoryPool*)>>(
+        makeStringDictionaryReader(*this, ek));
+    return [this, reader]() { return (*reader)(&getMemoryPool()); };
+  }
+
   const proto::ColumnEncoding& getEncoding(
       const EncodingKey& ek) const override {
     return *getEncodingProxy(ek.node);
@@ -0,0 +1,273 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <numeric>
+
+#include "velox/dwio/common/MemoryInputStream.h"
+#include "velox/dwio/dwrf/reader/DwrfReader.h"
+#include "velox/dwio/dwrf/reader/ScanSpec.h"
+#include "velox/dwio/dwrf/reader/SelectiveColumnReader.h"
+#include "velox/dwio/dwrf/writer/Writer.h"
+#include "velox/type/Filter.h"
+#include "velox/type/Subfield.h"
+#include "velox/vector/ComplexVector.h"
+#include "velox/vector/FlatVector.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::dwrf;
+using namespace facebook::velox::common;
+using facebook::dwio::common::MemoryInputStream;
+using facebook::dwio::common::MemorySink;
+
+namespace {
+constexpr int32_t kNumKeys = 10;
+constexpr int32_t kBatchSize = 1'000;
+constexpr int32_t kNumBatches = 2;
+
+bool isNullMap(int64_t id) {
+  return id % 17 == 0;
+}
+
+bool hasKey(int64_t id, int32_t key) {
+  return !isNullMap(id) && (id + key) % 3 != 0;
+}
+
+int64_t valueOf(int64_t id, int32_t key) {
+  return id * 10 + key;
+}
+} // namespace
+
+class SelectiveFlatMapTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    pool_ = memory::getDefaultScopedMemoryPool();
+    rowType_ = ROW({"id", "features"}, {BIGINT(), MAP(INTEGER(), BIGINT())});
+    write();
+  }
+
+  // Writes kNumBatches stripes where row 'id' has the keys for which
+  // hasKey() is true.
+  void write() {
+    auto config = std::make_shared<Config>();
+    config->set(Config::FLATTEN_MAP, true);
+    config->set(Config::MAP_FLAT_COLS, {1});
+    WriterOptions options;
+    options.config = config;
+    options.schema = rowType_;
+    options.flushPolicy = [](auto /* unused */, auto& /* unused */) {
+      return true;
+    };
+    auto sink = std::make_unique<MemorySink>(*pool_, 10 * 1024 * 1024);
+    sink_ = sink.get();
+    Writer writer(options, std::move(sink), *pool_);
+    for (auto i = 0; i < kNumBatches; ++i) {
+      writer.write(makeBatch(i * kBatchSize));
+    }
+    writer.close();
+  }
+
+  RowVectorPtr makeBatch(int64_t firstId) {
+    auto ids = BaseVector::create(BIGINT(), kBatchSize, pool_.get());
+    auto nulls = AlignedBuffer::allocate<bool>(kBatchSize, pool_.get());
+    auto offsets =
+        AlignedBuffer::allocate<vector_size_t>(kBatchSize, pool_.get());
+    auto sizes =
+        AlignedBuffer::allocate<vector_size_t>(kBatchSize, pool_.get());
+    auto maxEntries = kBatchSize * kNumKeys;
+    auto keys = BaseVector::create(INTEGER(), maxEntries, pool_.get());
+    auto values = BaseVector::create(BIGINT(), maxEntries, pool_.get());
+    vector_size_t numEntries = 0;
+    for (auto i = 0; i < kBatchSize; ++i) {
+      int64_t id = firstId + i;
+      ids->asFlatVector<int64_t>()->set(i, id);
+      bits::setNull(nulls->asMutable<uint64_t>(), i, isNullMap(id));
+      offsets->asMutable<vector_size_t>()[i] = numEntries;
+      for (int32_t key = 0; key < kNumKeys; ++key) {
+        if (hasKey(id, key)) {
+          keys->asFlatVector<int32_t>()->set(numEntries, key);
+          values->asFlatVector<int64_t>()->set(numEntries, valueOf(id, key));
+          ++numEntries;
+        }
+      }
+      sizes->asMutable<vector_size_t>()[i] =
+          numEntries - offsets->as<vector_size_t>()[i];
+    }
+    keys->resize(numEntries);
+    values->resize(numEntries);
+    auto map = std::make_shared<MapVector>(
+        pool_.get(),
+        rowType_->childAt(1),
+        nulls,
+        kBatchSize,
+        offsets,
+        sizes,
+        keys,
+        values);
+    return std::make_shared<RowVector>(
+        pool_.get(),
+        rowType_,
+        BufferPtr(nullptr),
+        kBatchSize,
+        std::vector<VectorPtr>{ids, map});
+  }
+
+  std::unique_ptr<ScanSpec> makeScanSpec() {
+    auto spec = std::make_unique<ScanSpec>("root");
+    for (auto i = 0; i < rowType_->size(); ++i) {
+      auto child = spec->getOrCreateChild(Subfield(rowType_->nameOf(i)));
+      child->setProjectOut(true);
+      child->setChannel(i);
+    }
+    return spec;
+  }
+
+  struct ResultRow {
+    int64_t id;
+    // The 'features' column of the batch and the index of the row in it.
+    VectorPtr features;
+    vector_size_t index;
+  };
+
+  // Reads the file with 'spec' and returns the result rows.
+  std::vector<ResultRow> read(
+      ScanSpec* spec,
+      const std::unordered_set<uint32_t>& asStruct = {}) {
+    facebook::dwio::common::ReaderOptions readerOpts;
+    facebook::dwio::common::RowReaderOptions rowReaderOpts;
+    auto reader = std::make_unique<DwrfReader>(
+        readerOpts,
+        std::make_unique<MemoryInputStream>(sink_->getData(), sink_->size()));
+    SelectiveColumnReaderFactory factory(spec);
+    rowReaderOpts.setColumnReaderFactory(&factory);
+    rowReaderOpts.setFlatmapNodeIdsAsStruct(asStruct);
+    auto rowReader = reader->createRowReader(rowReaderOpts);
+    std::vector<ResultRow> result;
+    VectorPtr batch = BaseVector::create(rowType_, 1, pool_.get());
+    while (rowReader->next(300, batch)) {
+      auto rowVector = batch->as<RowVector>();
+      auto ids = rowVector->loadedChildAt(0)->as<SimpleVector<int64_t>>();
+      auto features = rowVector->loadedChildAt(1);
+      for (auto i = 0; i < batch->size(); ++i) {
+        result.push_back({ids->valueAt(i), features, i});
+      }
+    }
+    return result;
+  }
+
+  static std::map<int32_t, int64_t> toStdMap(const ResultRow& row) {
+    std::map<int32_t, int64_t> map;
+    auto mapVector = row.features->as<MapVector>();
+    auto keys = mapVector->mapKeys()->as<SimpleVector<int32_t>>();
+    auto values = mapVector->mapValues()->as<SimpleVector<int64_t>>();
+    auto offset = mapVector->offsetAt(row.index);
+    for (auto i = 0; i < mapVector->sizeAt(row.index); ++i) {
+      map[keys->valueAt(offset + i)] = values->valueAt(offset + i);
+    }
+    return map;
+  }
+
+  static std::map<int32_t, int64_t> expectedMap(
+      int64_t id,
+      const std::vector<int32_t>& keys) {
+    std::map<int32_t, int64_t> map;
+    for (auto key : keys) {
+      if (hasKey(id, key)) {
+        map[key] = valueOf(id, key);
+      }
+    }
+    return map;
+  }
+
+  std::unique_ptr<memory::ScopedMemoryPool> pool_;
+  std::shared_ptr<const RowType> rowType_;
+  MemorySink* sink_;
+};
+
+TEST_F(SelectiveFlatMapTest, allKeys) {
+  auto spec = makeScanSpec();
+  auto rows = read(spec.get());
+  ASSERT_EQ(kNumBatches * kBatchSize, rows.size());
+  std::vector<int32_t> allKeys(kNumKeys);
+  std::iota(allKeys.begin(), allKeys.end(), 0);
+  for (auto i = 0; i < rows.size(); ++i) {
+    auto id = rows[i].id;
+    ASSERT_EQ(i, id);
+    ASSERT_EQ(isNullMap(id), rows[i].features->isNullAt(rows[i].index));
+    if (!isNullMap(id)) {
+      EXPECT_EQ(expectedMap(id, allKeys), toStdMap(rows[i])) << id;
+    }
+  }
+}
+
+TEST_F(SelectiveFlatMapTest, prunedKeysWithFilter) {
+  auto spec = makeScanSpec();
+  auto projected = spec->getOrCreateChild(Subfield("features[3]"));
+  projected->setProjectOut(true);
+  projected->setExtractValues(true);
+  spec->getOrCreateChild(Subfield("features[5]"))
+      ->setFilter(std::make_unique<BigintRange>(0, 5'000, false));
+
+  auto rows = read(spec.get());
+  size_t numExpected = 0;
+  for (int64_t id = 0; id < kNumBatches * kBatchSize; ++id) {
+    // A missing key reads as null and does not pass the filter.
+    if (hasKey(id, 5) && valueOf(id, 5) <= 5'000) {
+      ASSERT_LT(numExpected, rows.size());
+      auto& row = rows[numExpected++];
+      ASSERT_EQ(id, row.id);
+      EXPECT_EQ(expectedMap(id, {3}), toStdMap(row)) << id;
+    }
+  }
+  EXPECT_EQ(numExpected, rows.size());
+}
+
+TEST_F(SelectiveFlatMapTest, missingKeyFilter) {
+  auto spec = makeScanSpec();
+  spec->getOrCreateChild(Subfield("features[100]"))
+      ->setFilter(std::make_unique<BigintRange>(0, 10, false));
+  EXPECT_TRUE(read(spec.get()).empty());
+}
+
+TEST_F(SelectiveFlatMapTest, asStruct) {
+  auto spec = makeScanSpec();
+  for (auto key : {"features[2]", "features[100]"}) {
+    auto child = spec->getOrCreateChild(Subfield(key));
+    child->setProjectOut(true);
+    child->setExtractValues(true);
+  }
+  // Node 2 is 'features'.
+  auto rows = read(spec.get(), {2});
+  ASSERT_EQ(kNumBatches * kBatchSize, rows.size());
+  for (auto& row : rows) {
+    auto id = row.id;
+    ASSERT_EQ(TypeKind::ROW, row.features->typeKind());
+    auto rowVector = row.features->as<RowVector>();
+    ASSERT_EQ(isNullMap(id), rowVector->isNullAt(row.index)) << id;
+    if (isNullMap(id)) {
+      continue;
+    }
+    auto key2 = rowVector->childAt(0);
+    ASSERT_EQ(!hasKey(id, 2), key2->isNullAt(row.index)) << id;
+    if (hasKey(id, 2)) {
+      EXPECT_EQ(
+          valueOf(id, 2),
+          key2->as<SimpleVector<int64_t>>()->valueAt(row.index));
+    }
+    EXPECT_TRUE(rowVector->childAt(1)->isNullAt(row.index));
+  }
+}
@@ -911,6 +911,60 @@ TEST_P(StringReaderTests, testDictionaryWithNulls) {
   }
 }
 
+TEST_P(StringReaderTests, testDictionarySharedAcrossBatches) {
+  if (returnFlatVector_) {
+    return;
+  }
+  proto::ColumnEncoding directEncoding;
+  directEncoding.set_kind(proto::ColumnEncoding_Kind_DIRECT);
+  EXPECT_CALL(streams, getEncodingProxy(0))
+      .WillRepeatedly(Return(&directEncoding));
+  proto::ColumnEncoding dictionaryEncoding;
+  dictionaryEncoding.set_kind(proto::ColumnEncoding_Kind_DICTIONARY);
+  dictionaryEncoding.set_dictionarysize(2);
+  EXPECT_CALL(streams, getEncodingProxy(1))
+      .WillRepeatedly(Return(&dictionaryEncoding));
+
+  EXPECT_CALL(streams, getStreamProxy(0, proto::Stream_Kind_PRESENT, false))
+      .WillRepeatedly(Return(nullptr));
+  EXPECT_CALL(streams, getStreamProxy(1, _, _)).WillRepeatedly(Return(nullptr));
+  // 100 x 0 followed by 100 x 1.
+  const unsigned char data[] = {0x61, 0x00, 0x00, 0x61, 0x00, 0x01};
+  EXPECT_CALL(streams, getStreamProxy(1, proto::Stream_Kind_DATA, true))
+      .WillRepeatedly(
+          Return(new SeekableArrayInputStream(data, VELOX_ARRAY_SIZE(data))));
+  const unsigned char blob[] = {0x4f, 0x52, 0x43, 0x4f, 0x77, 0x65, 0x6e};
+  EXPECT_CALL(
+      streams, getStreamProxy(1, proto::Stream_Kind_DICTIONARY_DATA, false))
+      .WillRepeatedly(
+          Return(new SeekableArrayInputStream(blob, VELOX_ARRAY_SIZE(blob))));
+  const unsigned char lengths[] = {0x02, 0x01, 0x03};
+  EXPECT_CALL(streams, getStreamProxy(1, proto::Stream_Kind_LENGTH, false))
+      .WillRepeatedly(Return(
+          new SeekableArrayInputStream(lengths, VELOX_ARRAY_SIZE(lengths))));
+
+  TestStrideIndexProvider provider(10000);
+  EXPECT_CALL(streams, getStrideIndexProviderProxy())
+      .WillRepeatedly(Return(&provider));
+
+  auto rowType = HiveTypeParser().parse("struct<myString:string>");
+  auto reader = buildReader(rowType, streams, {});
+
+  // Both batches wrap the same stripe dictionary, so a consumer can compute
+  // per distinct value once.
+  std::vector<std::shared_ptr<DictionaryVector<StringView>>> results;
+  for (auto i = 0; i < 2; ++i) {
+    VectorPtr batch = newBatch(rowType);
+    reader->next(100, batch);
+    results.push_back(getOnlyChild<DictionaryVector<StringView>>(batch));
+    ASSERT_EQ(100, results.back()->size());
+  }
+  EXPECT_EQ(results[0]->valueVector(), results[1]->valueVector());
+  EXPECT_EQ(2, results[0]->valueVector()->size());
+  EXPECT_EQ("ORC", results[0]->valueAt(0).str());
+  EXPECT_EQ("Owen", results[1]->valueAt(99).str());
+}
+
 TEST_P(StringReaderTests, testStringDictSkipNoNulls) {
   // set getEncoding
   proto::ColumnEncoding directEncoding;
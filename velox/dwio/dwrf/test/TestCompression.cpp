@@ -21,6 +21,8 @@
 #include "velox/dwio/dwrf/test/OrcTest.h"
 
 #include <folly/Random.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/executors/ManualExecutor.h>
 #include <gtest/gtest.h>
 
 #include <algorithm>
@@ -220,6 +222,107 @@ TEST_P(CompressionTest, compressRandomLetters) {
       memSink, kind_, block, testData, dataSize, pool, decrypter_);
 }
 
+TEST_P(CompressionTest, decompressAhead) {
+  if (kind_ == CompressionKind_NONE && !decrypter_) {
+    // The stream is read as is and has no compression blocks.
+    return;
+  }
+  auto scopedPool = getDefaultScopedMemoryPool();
+  auto& pool = scopedPool->getPool();
+  MemorySink memSink(pool, DEFAULT_MEM_STREAM_SIZE);
+  folly::CPUThreadPoolExecutor executor(4);
+
+  uint64_t block = 1024;
+  constexpr size_t dataSize = 256 * 1024;
+  std::vector<char> testData(dataSize);
+  generateRandomData(testData.data(), dataSize, true);
+  // Mix in runs that compress well and blocks left uncompressed.
+  std::memset(testData.data() + 10000, 'a', 5000);
+  generateRandomData(testData.data() + 50000, 5000, false);
+  compressAndVerify(
+      kind_, memSink, block, pool, testData.data(), dataSize, encrypter_);
+
+  for (uint64_t maxAheadBytes : {1, 4 * 1024, 1 << 20}) {
+    auto stream = createDecompressor(
+        kind_,
+        std::make_unique<SeekableArrayInputStream>(
+            memSink.getData(), memSink.size()),
+        block,
+        pool,
+        "Test Decompress Ahead",
+        decrypter_,
+        &executor,
+        maxAheadBytes);
+    auto expectRead = [&](size_t begin, size_t end) {
+      const char* buffer;
+      int32_t size;
+      for (auto pos = begin; pos < end; pos += size) {
+        ASSERT_TRUE(stream->Next(
+            reinterpret_cast<const void**>(&buffer), &size));
+        ASSERT_LE(pos + size, dataSize);
+        ASSERT_EQ(0, memcmp(buffer, testData.data() + pos, size));
+      }
+      if (end == dataSize) {
+        ASSERT_FALSE(
+            stream->Next(reinterpret_cast<const void**>(&buffer), &size));
+      }
+    };
+    expectRead(0, dataSize / 2);
+    // Seeking drops the blocks read ahead and restarts from the new position.
+    std::vector<uint64_t> positions = {0, 100};
+    PositionProvider provider(positions);
+    stream->seekToRowGroup(provider);
+    ASSERT_TRUE(stream->Skip(block - 100));
+    expectRead(block, dataSize);
+  }
+}
+
+TEST_P(CompressionTest, decompressAheadStalledExecutor) {
+  if (kind_ == CompressionKind_NONE || decrypter_) {
+    // Nothing is decompressed ahead.
+    return;
+  }
+  auto scopedPool = getDefaultScopedMemoryPool();
+  auto& pool = scopedPool->getPool();
+  MemorySink memSink(pool, DEFAULT_MEM_STREAM_SIZE);
+  // Runs nothing until drained, like an executor that is busy elsewhere.
+  folly::ManualExecutor executor;
+
+  uint64_t block = 1024;
+  constexpr size_t dataSize = 64 * 1024;
+  std::vector<char> testData(dataSize);
+  generateRandomData(testData.data(), dataSize, true);
+  compressAndVerify(
+      kind_, memSink, block, pool, testData.data(), dataSize, encrypter_);
+
+  auto stream = createDecompressor(
+      kind_,
+      std::make_unique<SeekableArrayInputStream>(
+          memSink.getData(), memSink.size()),
+      block,
+      pool,
+      "Test Decompress Ahead",
+      decrypter_,
+      &executor,
+      4 * 1024);
+  // The reading thread decompresses every block itself instead of waiting.
+  const char* buffer;
+  int32_t size;
+  for (size_t pos = 0; pos < dataSize / 2; pos += size) {
+    ASSERT_TRUE(stream->Next(reinterpret_cast<const void**>(&buffer), &size));
+    ASSERT_EQ(0, memcmp(buffer, testData.data() + pos, size));
+  }
+  EXPECT_LT(0, executor.numPendingTasks());
+
+  // Neither seeking nor destruction waits for the queued work, which later
+  // finds nothing to do.
+  std::vector<uint64_t> positions = {0, 0};
+  PositionProvider provider(positions);
+  stream->seekToRowGroup(provider);
+  stream.reset();
+  executor.drain();
+}
+
 TEST_P(CompressionTest, compressRandomBytes) {
   auto scopedPool = getDefaultScopedMemoryPool();
   auto& pool = scopedPool->getPool();
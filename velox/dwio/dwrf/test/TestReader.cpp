@@ -21,6 +21,7 @@
 #include "velox/dwio/common/MemoryInputStream.h"
 #include "velox/dwio/dwrf/common/Common.h"
 #include "velox/dwio/dwrf/reader/DwrfReader.h"
+#include "velox/dwio/dwrf/reader/FileMetadataCache.h"
 #include "velox/dwio/dwrf/test/OrcTest.h"
 #include "velox/dwio/type/fbhive/HiveTypeParser.h"
 #include "velox/type/Type.h"
@@ -28,9 +29,18 @@
 #include "velox/vector/FlatVector.h"
 
 #include <fmt/core.h>
+#include <unistd.h>
 #include <array>
 #include <numeric>
 
+#if __has_include("filesystem")
+#include <filesystem>
+namespace fs = std::filesystem;
+#else
+#include <experimental/filesystem>
+namespace fs = std::experimental::filesystem;
+#endif
+
 using namespace ::testing;
 using namespace facebook::dwio::common;
 using namespace facebook::dwio::type::fbhive;
@@ -592,6 +602,102 @@ TEST(TestReader, testMismatchSchemaMoreFields) {
   }
 }
 
+TEST(TestReader, reuseFileMetadata) {
+  auto scopedPool = memory::getDefaultScopedMemoryPool();
+  ReaderOptions readerOpts;
+  RowReaderOptions rowReaderOpts;
+  auto reader = DwrfReader::create(
+      std::make_unique<FileInputStream>(structFile), readerOpts);
+  VectorPtr expected;
+  reader->createRowReader(rowReaderOpts)->next(10, expected);
+
+  auto metadata = reader->makeFileMetadata(*scopedPool);
+  ASSERT_TRUE(metadata);
+  EXPECT_EQ(reader->getFileLength(), metadata->fileLength);
+  EXPECT_LT(0, metadata->memoryUsage());
+
+  // The first reader going away must not invalidate the metadata.
+  reader.reset();
+  readerOpts.setFileMetadata(metadata);
+  reader = DwrfReader::create(
+      std::make_unique<FileInputStream>(structFile), readerOpts);
+  EXPECT_EQ(metadata, reader->makeFileMetadata(*scopedPool));
+  EXPECT_EQ(metadata->footer, &reader->getFooter());
+  EXPECT_EQ(*metadata->schema, *reader->getType());
+
+  VectorPtr batch;
+  reader->createRowReader(rowReaderOpts)->next(10, batch);
+  ASSERT_EQ(expected->size(), batch->size());
+  for (auto i = 0; i < batch->size(); ++i) {
+    EXPECT_TRUE(expected->equalValueAt(batch.get(), i, i));
+  }
+}
+
+TEST(TestReader, fileMetadataCache) {
+  FileMetadataCache cache(1 << 20);
+  ReaderOptions readerOpts;
+  auto reader = DwrfReader::create(
+      std::make_unique<FileInputStream>(structFile), readerOpts);
+  auto fileLength = reader->getFileLength();
+
+  EXPECT_FALSE(cache.get(structFile, fileLength));
+  cache.put(structFile, *reader);
+  EXPECT_LT(0, cache.currentSize());
+  auto metadata = cache.get(structFile, fileLength);
+  ASSERT_TRUE(metadata);
+  EXPECT_EQ(metadata, cache.get(structFile, fileLength));
+
+  // A file of different length under the same path is a miss.
+  EXPECT_FALSE(cache.get(structFile, fileLength + 1));
+  EXPECT_EQ(2, cache.numHits());
+  EXPECT_EQ(2, cache.numMisses());
+
+  // A tail that does not fit is not cached.
+  FileMetadataCache tinyCache(1);
+  tinyCache.put(structFile, *reader);
+  EXPECT_FALSE(tinyCache.get(structFile, fileLength));
+}
+
+TEST(TestReader, fileMetadataCacheRewrittenFile) {
+  auto path = (fs::temp_directory_path() /
+               fmt::format("velox_file_metadata_cache_{}.orc", getpid()))
+                  .string();
+  auto openReader = [&](const std::string& source) {
+    fs::copy_file(source, path, fs::copy_options::overwrite_existing);
+    ReaderOptions readerOpts;
+    return DwrfReader::create(
+        std::make_unique<FileInputStream>(path), readerOpts);
+  };
+
+  FileMetadataCache cache(1 << 24);
+  auto reader = openReader(structFile);
+  cache.put(path, *reader);
+  auto oldLength = reader->getFileLength();
+  ASSERT_TRUE(cache.get(path, oldLength));
+
+  // The file is rewritten under the same path. The stale entry is dropped
+  // and the new tail can be cached in its place.
+  reader = openReader(getExampleFilePath("fm_small.orc"));
+  auto newLength = reader->getFileLength();
+  ASSERT_NE(oldLength, newLength);
+  EXPECT_FALSE(cache.get(path, newLength));
+  EXPECT_FALSE(cache.get(path, oldLength));
+  cache.put(path, *reader);
+  auto metadata = cache.get(path, newLength);
+  ASSERT_TRUE(metadata);
+  EXPECT_EQ(newLength, metadata->fileLength);
+
+  // Putting the tail of a rewritten file replaces the entry also without a
+  // preceding get.
+  reader = openReader(structFile);
+  cache.put(path, *reader);
+  metadata = cache.get(path, oldLength);
+  ASSERT_TRUE(metadata);
+  EXPECT_EQ(oldLength, metadata->fileLength);
+
+  fs::remove(path);
+}
+
 TEST(TestReader, testMismatchSchemaFewerFields) {
   // file has schema: a int, b struct<a:int, b:float, c:string>, c float
   ReaderOptions readerOpts;
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <folly/Random.h>
 #include "velox/common/base/Nulls.h"
 #include "velox/dwio/dwrf/common/Compression.h"
 #include "velox/dwio/dwrf/common/IntDecoder.h"
@@ -662,6 +663,72 @@ TEST(RLEv2, bitsLeftByPreviousStream) {
   }
 };
 
+TEST(RLEv2, directAllBitWidths) {
+  auto scopedPool = memory::getDefaultScopedMemoryPool();
+  // Encoded width code and bit width of each fixed width.
+  std::vector<std::pair<uint32_t, uint32_t>> widths;
+  for (uint32_t width = 1; width <= 24; ++width) {
+    widths.emplace_back(width - 1, width);
+  }
+  uint32_t code = 24;
+  for (uint32_t width : {26, 28, 30, 32, 40, 48, 56, 64}) {
+    widths.emplace_back(code++, width);
+  }
+
+  const uint32_t runLength = 300;
+  const uint32_t numRuns = 2;
+  for (auto [widthCode, width] : widths) {
+    std::vector<int64_t> values;
+    std::vector<unsigned char> bytes;
+    for (uint32_t run = 0; run < numRuns; ++run) {
+      bytes.push_back(0x40 | (widthCode << 1) | ((runLength - 1) >> 8));
+      bytes.push_back((runLength - 1) & 0xff);
+      // Packs MSB first.
+      uint32_t bitsInByte = 0;
+      for (uint32_t i = 0; i < runLength; ++i) {
+        uint64_t value = folly::Random::rand64();
+        if (width < 64) {
+          value &= (uint64_t{1} << width) - 1;
+        }
+        values.push_back(static_cast<int64_t>(value));
+        for (int32_t bit = width - 1; bit >= 0; --bit) {
+          if (bitsInByte == 0) {
+            bytes.push_back(0);
+          }
+          bytes.back() |= ((value >> bit) & 1) << (7 - bitsInByte);
+          bitsInByte = (bitsInByte + 1) % 8;
+        }
+      }
+    }
+
+    // Small blocks and odd batch sizes make values straddle input buffers
+    // and start off byte boundaries.
+    for (uint64_t blockSize : {0, 17}) {
+      for (uint64_t batchSize : {1, 13, 64, 600}) {
+        auto rle = IntDecoder<false>::createRle(
+            std::make_unique<SeekableArrayInputStream>(
+                bytes.data(), bytes.size(), blockSize),
+            RleVersion_2,
+            *scopedPool,
+            true /* doesn't matter */,
+            INT_BYTE_SIZE /* doesn't matter */);
+        std::vector<int64_t> data(values.size());
+        for (uint64_t i = 0; i < values.size(); i += batchSize) {
+          rle->next(
+              data.data() + i,
+              std::min<uint64_t>(batchSize, values.size() - i),
+              nullptr);
+        }
+        for (size_t i = 0; i < values.size(); ++i) {
+          ASSERT_EQ(values[i], data[i])
+              << "width " << width << " block size " << blockSize
+              << " batch size " << batchSize << " at " << i;
+        }
+      }
+    }
+  }
+}
+
 TEST(RLEv1, simpleTest) {
   auto scopedPool = memory::getDefaultScopedMemoryPool();
   const unsigned char buffer[] = {
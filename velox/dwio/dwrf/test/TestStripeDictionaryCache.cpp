@@ -125,4 +125,44 @@ TEST(TestStripeDictionaryCache, GetDictionaryBuffer) {
     EXPECT_ANY_THROW(cache.getIntDictionary({2, 0}));
   }
 }
+
+TEST(TestStripeDictionaryCache, StringDictionary) {
+  auto& pool = memory::getProcessDefaultMemoryManager().getRoot();
+  int32_t numLoads = 0;
+  auto genStrings = [&numLoads](memory::MemoryPool* pool) {
+    ++numLoads;
+    std::string data = "abcdef";
+    auto blob = AlignedBuffer::allocate<char>(data.size(), pool);
+    memcpy(blob->asMutable<char>(), data.data(), data.size());
+    auto offsets = AlignedBuffer::allocate<int64_t>(4, pool);
+    auto* offsetsPtr = offsets->asMutable<int64_t>();
+    offsetsPtr[0] = 0;
+    offsetsPtr[1] = 1;
+    offsetsPtr[2] = 3;
+    offsetsPtr[3] = 6;
+    return std::make_shared<StringDictionary>(3, blob, offsets);
+  };
+
+  StripeDictionaryCache cache{&pool};
+  cache.registerStringDictionary({3, 0}, genStrings);
+  cache.registerStringDictionary({3, 0}, genStrings);
+  EXPECT_EQ(1, cache.stringDictionaryFactories_.size());
+  EXPECT_EQ(0, numLoads);
+
+  auto dictionary = cache.getStringDictionary({3, 0});
+  EXPECT_EQ(1, numLoads);
+  EXPECT_EQ(dictionary, cache.getStringDictionary({3, 0}));
+  EXPECT_EQ(1, numLoads);
+  EXPECT_ANY_THROW(cache.getStringDictionary({4, 0}));
+
+  auto values = dictionary->values(VARCHAR(), &pool);
+  ASSERT_EQ(3, values->size());
+  EXPECT_EQ("a", values->valueAt(0).str());
+  EXPECT_EQ("bc", values->valueAt(1).str());
+  EXPECT_EQ("def", values->valueAt(2).str());
+  // All readers of the stripe get the same base vector.
+  EXPECT_EQ(
+      values.get(),
+      cache.getStringDictionary({3, 0})->values(VARCHAR(), &pool).get());
+}
 } // namespace facebook::velox::dwrf
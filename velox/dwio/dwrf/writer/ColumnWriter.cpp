@@ -15,6 +15,10 @@
  */
 
 #include "velox/dwio/dwrf/writer/ColumnWriter.h"
+
+#include <folly/futures/Future.h>
+#include <deque>
+
 #include "velox/dwio/common/ChainedBuffer.h"
 #include "velox/dwio/dwrf/writer/DictionaryEncodingUtils.h"
 #include "velox/dwio/dwrf/writer/EntropyEncodingSelector.h"
@@ -228,6 +232,7 @@ class IntegerColumnWriter : public ColumnWriter {
           StreamKind::StreamKind_DICTIONARY_DATA});
       initStreamWriters(useDictionaryEncoding_);
     }
+    initBloomFilter();
     reset();
   }
 
@@ -326,6 +331,7 @@ class IntegerColumnWriter : public ColumnWriter {
     // Add entry with stats for either case.
     indexBuilder_->addEntry(*indexStatsBuilder_);
     indexStatsBuilder_->reset();
+    addBloomFilterEntry();
     ColumnWriter::recordPosition();
     // TODO: the only way useDictionaryEncoding_ right now is
     // through abandonDictionary, so we already have the stream initialization
@@ -514,6 +520,9 @@ uint64_t IntegerColumnWriter<T>::writeDict(
     T value = decodedVector.valueAt<T>(pos);
     rows_.unsafeAppend(dictEncoder_.addKey(value));
     statsBuilder.addValues(value);
+    if (bloomFilter_) {
+      bloomFilter_->addInt64(value);
+    }
   };
 
   uint64_t nullCount = 0;
@@ -556,6 +565,13 @@ uint64_t IntegerColumnWriter<T>::writeDirect(
       dynamic_cast<IntegerStatisticsBuilder&>(*indexStatsBuilder_),
       slice,
       ranges);
+  if (bloomFilter_) {
+    for (auto& pos : ranges) {
+      if (!nulls || !bits::isBitNull(nulls, pos)) {
+        bloomFilter_->addInt64(vals[pos]);
+      }
+    }
+  }
   auto rawSize = count * sizeof(T) + (ranges.size() - count) * NULL_SIZE;
   indexStatsBuilder_->increaseRawSize(rawSize);
   return rawSize;
@@ -808,11 +824,15 @@ class StringColumnWriter : public ColumnWriter {
             getConfig(Config::ENTROPY_STRING_THRESHOLD)},
         sort_{getConfig(Config::DICTIONARY_SORT_KEYS)},
         useDictionaryEncoding_{useDictionaryEncoding()},
-        strideOffsets_{getMemoryPool(MemoryUsageCategory::GENERAL)} {
+        strideOffsets_{getMemoryPool(MemoryUsageCategory::GENERAL)},
+        baseCounts_{getMemoryPool(MemoryUsageCategory::GENERAL)},
+        baseIds_{getMemoryPool(MemoryUsageCategory::GENERAL)},
+        baseOrder_{getMemoryPool(MemoryUsageCategory::GENERAL)} {
     DWIO_ENSURE(firstStripe_);
     if (!useDictionaryEncoding_) {
       initStreamWriters(useDictionaryEncoding_);
     }
+    initBloomFilter();
     reset();
   }
 
@@ -908,6 +928,7 @@ class StringColumnWriter : public ColumnWriter {
     // Add entry with stats for either case.
     indexBuilder_->addEntry(*indexStatsBuilder_);
     indexStatsBuilder_->reset();
+    addBloomFilterEntry();
     ColumnWriter::recordPosition();
     // TODO: the only way useDictionaryEncoding_ right now is
     // through abandonDictionary, so we already have the stream initialization
@@ -963,6 +984,13 @@ class StringColumnWriter : public ColumnWriter {
  private:
   uint64_t writeDict(DecodedVector& decodedVector, const Ranges& ranges);
 
+  // Dictionary encodes rows of a dictionary or constant input by adding each
+  // distinct base value to 'dictEncoder_' once, with its count, instead of
+  // hashing it once per row.
+  uint64_t writeDictFromBase(
+      DecodedVector& decodedVector,
+      const Ranges& ranges);
+
   uint64_t writeDirect(DecodedVector& decodedVector, const Ranges& ranges);
 
   void ensureValidStreamWriters(bool dictEncoding) {
@@ -1082,6 +1110,11 @@ class StringColumnWriter : public ColumnWriter {
   bool useDictionaryEncoding_;
   bool firstStripe_{true};
   DataBuffer<size_t> strideOffsets_;
+  // Scratch for writeDictFromBase: per base row count and dictionary id, and
+  // the base rows in the order they are first referenced.
+  DataBuffer<uint32_t> baseCounts_;
+  DataBuffer<uint32_t> baseIds_;
+  DataBuffer<vector_size_t> baseOrder_;
 };
 
 uint64_t StringColumnWriter::write(
@@ -1100,6 +1133,10 @@ uint64_t StringColumnWriter::write(
 uint64_t StringColumnWriter::writeDict(
     DecodedVector& decodedVector,
     const Ranges& ranges) {
+  if (!decodedVector.isIdentityMapping() &&
+      decodedVector.base()->size() <= ranges.size()) {
+    return writeDictFromBase(decodedVector, ranges);
+  }
   auto& statsBuilder =
       dynamic_cast<StringStatisticsBuilder&>(*indexStatsBuilder_);
   ColumnWriter::write(decodedVector, ranges);
@@ -1111,6 +1148,9 @@ uint64_t StringColumnWriter::writeDict(
     auto sp = decodedVector.valueAt<StringView>(pos);
     rows_.unsafeAppend(dictEncoder_.addKey(sp, strideIndex));
     statsBuilder.addValues(sp);
+    if (bloomFilter_) {
+      bloomFilter_->addBytes(sp.data(), sp.size());
+    }
     rawSize += sp.size();
   };
 
@@ -1137,6 +1177,73 @@ uint64_t StringColumnWriter::writeDict(
   return rawSize;
 }
 
+uint64_t StringColumnWriter::writeDictFromBase(
+    DecodedVector& decodedVector,
+    const Ranges& ranges) {
+  auto& statsBuilder =
+      dynamic_cast<StringStatisticsBuilder&>(*indexStatsBuilder_);
+  ColumnWriter::write(decodedVector, ranges);
+
+  auto baseSize = decodedVector.base()->size();
+  baseCounts_.resize(baseSize);
+  std::fill(baseCounts_.data(), baseCounts_.data() + baseSize, 0);
+  baseIds_.resize(baseSize);
+  baseOrder_.resize(0);
+  baseOrder_.reserve(baseSize);
+
+  uint64_t nullCount = 0;
+  auto countRow = [&](size_t pos) {
+    auto baseIndex = decodedVector.index(pos);
+    if (baseCounts_[baseIndex]++ == 0) {
+      baseOrder_.unsafeAppend(baseIndex);
+    }
+  };
+  if (decodedVector.mayHaveNulls()) {
+    for (auto& pos : ranges) {
+      if (decodedVector.isNullAt(pos)) {
+        ++nullCount;
+      } else {
+        countRow(pos);
+      }
+    }
+  } else {
+    for (auto& pos : ranges) {
+      countRow(pos);
+    }
+  }
+
+  // Adding the distinct values in the order of their first reference assigns
+  // the same ids as adding them row by row.
+  const auto* values = decodedVector.data<StringView>();
+  size_t strideIndex = strideOffsets_.size() - 1;
+  uint64_t rawSize = 0;
+  for (size_t i = 0; i < baseOrder_.size(); ++i) {
+    auto baseIndex = baseOrder_[i];
+    auto count = baseCounts_[baseIndex];
+    auto sp = values[baseIndex];
+    baseIds_[baseIndex] = dictEncoder_.addKey(sp, strideIndex, count);
+    statsBuilder.addValues(sp, count);
+    if (bloomFilter_) {
+      bloomFilter_->addBytes(sp.data(), sp.size());
+    }
+    rawSize += sp.size() * count;
+  }
+
+  rows_.reserve(rows_.size() + ranges.size() - nullCount);
+  for (auto& pos : ranges) {
+    if (!decodedVector.isNullAt(pos)) {
+      rows_.unsafeAppend(baseIds_[decodedVector.index(pos)]);
+    }
+  }
+
+  if (nullCount > 0) {
+    statsBuilder.setHasNull();
+    rawSize += nullCount * NULL_SIZE;
+  }
+  statsBuilder.increaseRawSize(rawSize);
+  return rawSize;
+}
+
 uint64_t StringColumnWriter::writeDirect(
     DecodedVector& decodedVector,
     const Ranges& ranges) {
@@ -1156,6 +1263,9 @@ uint64_t StringColumnWriter::writeDirect(
     auto size = sp.size();
     dataDirect_->write(sp.data(), size);
     statsBuilder.addValues(sp);
+    if (bloomFilter_) {
+      bloomFilter_->addBytes(sp.data(), size);
+    }
     rawSize += size;
     lengths.unsafeAppend(size);
   };
@@ -1551,28 +1661,89 @@ class StructColumnWriter : public ColumnWriter {
 
   void flush(
       std::function<proto::ColumnEncoding&(uint32_t)> encodingFactory,
-      std::function<void(proto::ColumnEncoding&)> encodingOverride) override {
-    ColumnWriter::flush(encodingFactory, encodingOverride);
-    for (auto& c : children_) {
-      c->flush(encodingFactory);
-    }
-  }
+      std::function<void(proto::ColumnEncoding&)> encodingOverride) override;
 
  private:
+  // Returns true if the children are written on the executor of the writer.
+  // Only the children of the root run in parallel. They share no state other
+  // than the WriterContext.
+  bool isParallel() const {
+    return isRoot() && context_.executor() && children_.size() > 1;
+  }
+
+  // Calls 'func' with each child index, in parallel if isParallel(). Returns
+  // after all calls are done and rethrows the first error.
+  void forEachChild(const std::function<void(size_t)>& func);
+
   uint64_t writeChildrenAndStats(
       const RowVector* rowSlice,
       const Ranges& ranges,
       uint64_t nullCount);
 };
 
+void StructColumnWriter::forEachChild(
+    const std::function<void(size_t)>& func) {
+  if (!isParallel()) {
+    for (size_t i = 0; i < children_.size(); ++i) {
+      func(i);
+    }
+    return;
+  }
+  std::vector<folly::SemiFuture<folly::Unit>> futures;
+  futures.reserve(children_.size() - 1);
+  for (size_t i = 1; i < children_.size(); ++i) {
+    futures.push_back(
+        folly::via(context_.executor(), [&func, i]() { func(i); }).semi());
+  }
+  // The first child runs on the calling thread, which would otherwise idle.
+  auto first = folly::makeTryWith([&]() { func(0); });
+  // Wait for all tasks before rethrowing, they reference 'func'.
+  auto results = folly::collectAll(std::move(futures)).get();
+  first.throwIfFailed();
+  for (auto& result : results) {
+    result.throwIfFailed();
+  }
+}
+
+void StructColumnWriter::flush(
+    std::function<proto::ColumnEncoding&(uint32_t)> encodingFactory,
+    std::function<void(proto::ColumnEncoding&)> encodingOverride) {
+  ColumnWriter::flush(encodingFactory, encodingOverride);
+  if (!isParallel()) {
+    for (auto& c : children_) {
+      c->flush(encodingFactory);
+    }
+    return;
+  }
+  // The encodings must be added in the same order as in the serial case.
+  // Each child collects its encodings, which are then added child by child.
+  // A deque keeps the references given out by the factory stable.
+  std::vector<std::deque<std::pair<uint32_t, proto::ColumnEncoding>>>
+      encodings(children_.size());
+  forEachChild([&](size_t i) {
+    children_[i]->flush([&encodings, i](uint32_t nodeId) -> auto& {
+      return encodings[i].emplace_back(nodeId, proto::ColumnEncoding{}).second;
+    });
+  });
+  for (auto& childEncodings : encodings) {
+    for (auto& [nodeId, encoding] : childEncodings) {
+      encodingFactory(nodeId).Swap(&encoding);
+    }
+  }
+}
+
 uint64_t StructColumnWriter::writeChildrenAndStats(
     const RowVector* rowSlice,
     const Ranges& ranges,
     uint64_t nullCount) {
   uint64_t rawSize = 0;
   if (ranges.size() > 0) {
-    for (size_t i = 0; i < children_.size(); ++i) {
-      rawSize += children_.at(i)->write(rowSlice->childAt(i), ranges);
+    std::vector<uint64_t> childRawSizes(children_.size());
+    forEachChild([&](size_t i) {
+      childRawSizes[i] = children_.at(i)->write(rowSlice->childAt(i), ranges);
+    });
+    for (auto childRawSize : childRawSizes) {
+      rawSize += childRawSize;
     }
   }
   if (nullCount) {
@@ -18,6 +18,7 @@
 
 #include "gtest/gtest_prod.h"
 
+#include "velox/dwio/dwrf/common/BloomFilter.h"
 #include "velox/dwio/dwrf/common/ByteRLE.h"
 #include "velox/dwio/dwrf/common/Common.h"
 #include "velox/dwio/dwrf/common/IntEncoder.h"
@@ -72,6 +73,7 @@ class ColumnWriter {
     fileStatsBuilder_->merge(*indexStatsBuilder_);
     indexBuilder_->addEntry(*indexStatsBuilder_);
     indexStatsBuilder_->reset();
+    addBloomFilterEntry();
     recordPosition();
     for (auto& child : children_) {
       child->createIndexEntry();
@@ -105,6 +107,11 @@ class ColumnWriter {
     setEncoding(encoding);
     encodingOverride(encoding);
     indexBuilder_->flush();
+    if (bloomFilter_) {
+      bloomFilterIndex_.SerializeToZeroCopyStream(bloomFilterStream_.get());
+      bloomFilterStream_->flush();
+      bloomFilterIndex_.Clear();
+    }
   }
 
   virtual uint64_t writeFileStats(
@@ -163,6 +170,32 @@ class ColumnWriter {
     }
   }
 
+  // Creates the row group bloom filter if this is a top level column listed
+  // in Config::BLOOM_FILTER_COLUMNS. Called by the writers that populate it.
+  void initBloomFilter() {
+    if (!isIndexEnabled() || sequence_ != 0 || !type_.parent ||
+        type_.parent->id != 0) {
+      return;
+    }
+    const auto& columns = getConfig(Config::BLOOM_FILTER_COLUMNS);
+    if (std::find(columns.begin(), columns.end(), type_.column) ==
+        columns.end()) {
+      return;
+    }
+    bloomFilter_ = std::make_unique<BloomFilter>(
+        context_.indexStride, getConfig(Config::BLOOM_FILTER_FPP));
+    bloomFilterStream_ = newStream(StreamKind::StreamKind_BLOOM_FILTER_UTF8);
+  }
+
+  // Moves the bloom filter of the finished row group into the stripe's bloom
+  // filter index.
+  void addBloomFilterEntry() {
+    if (bloomFilter_) {
+      bloomFilter_->serialize(*bloomFilterIndex_.add_bloomfilter());
+      bloomFilter_->reset();
+    }
+  }
+
   virtual void setEncoding(proto::ColumnEncoding& encoding) const {
     encoding.set_kind(proto::ColumnEncoding_Kind::ColumnEncoding_Kind_DIRECT);
     encoding.set_dictionarysize(0);
@@ -212,6 +245,10 @@ class ColumnWriter {
 
   std::unique_ptr<ByteRleEncoder> present_;
   bool hasNull_ = false;
+  // Row group bloom filter. Set only for columns with bloom filters enabled.
+  std::unique_ptr<BloomFilter> bloomFilter_;
+  std::unique_ptr<BufferedOutputStream> bloomFilterStream_;
+  proto::BloomFilterIndex bloomFilterIndex_;
   // callback used to inject the logic that captures positions for flat map
   // in_map stream
   const std::function<void(IndexBuilder&)> onRecordPosition_;
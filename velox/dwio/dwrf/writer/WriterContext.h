@@ -16,7 +16,9 @@
 
 #pragma once
 
+#include <folly/Executor.h>
 #include <gtest/gtest_prod.h>
+#include <mutex>
 
 #include "velox/dwio/dwrf/common/Compression.h"
 #include "velox/dwio/dwrf/common/wrap/dwrf-proto-wrapper.h"
@@ -68,11 +70,13 @@ class WriterContext : public CompressionBufferPool {
       handler_ = std::make_unique<encryption::EncryptionHandler>();
     }
     validateConfigs();
-    compressionBuffer_ = std::make_unique<dwio::common::DataBuffer<char>>(
-        generalPool_, compressionBlockSize + PAGE_HEADER_SIZE);
+    compressionBuffers_.push_back(
+        std::make_unique<dwio::common::DataBuffer<char>>(
+            generalPool_, compressionBlockSize + PAGE_HEADER_SIZE));
   }
 
   bool hasStream(const StreamIdentifier& stream) const {
+    std::lock_guard<std::mutex> l(mutex_);
     return streams_.find(stream) != streams_.end();
   }
 
@@ -94,21 +98,8 @@ class WriterContext : public CompressionBufferPool {
   // flush policy evaluation and would be more accurate after flush.
   std::unique_ptr<BufferedOutputStream> newStream(
       const StreamIdentifier& stream) {
-    DWIO_ENSURE(
-        !hasStream(stream), "Stream already exists ", stream.toString());
-    streams_.emplace(
-        std::piecewise_construct,
-        std::forward_as_tuple(stream),
-        std::forward_as_tuple(
-            getMemoryPool(MemoryUsageCategory::OUTPUT_STREAM),
-            compressionBlockSize,
-            getConfig(Config::COMPRESSION_BLOCK_SIZE_MIN),
-            getConfig(Config::COMPRESSION_BLOCK_SIZE_EXTEND_RATIO)));
-    auto& holder = streams_.at(stream);
-    auto encrypter = handler_->isEncrypted(stream.node)
-        ? std::addressof(handler_->getEncryptionProvider(stream.node))
-        : nullptr;
-    return newStream(compression, holder, encrypter);
+    std::lock_guard<std::mutex> l(mutex_);
+    return newStreamLocked(stream);
   }
 
   std::unique_ptr<DataBufferHolder> newDataBufferHolder(
@@ -133,6 +124,7 @@ class WriterContext : public CompressionBufferPool {
       const EncodingKey& ek,
       velox::memory::MemoryPool& dictionaryPool,
       velox::memory::MemoryPool& generalPool) {
+    std::lock_guard<std::mutex> l(mutex_);
     auto result = dictEncoders_.find(ek);
     if (result == dictEncoders_.end()) {
       auto emplaceResult = dictEncoders_.emplace(
@@ -142,7 +134,7 @@ class WriterContext : public CompressionBufferPool {
               generalPool,
               getConfig(Config::DICTIONARY_SORT_KEYS),
               IntEncoder</* isSigned = */ true>::createDirect(
-                  newStream(
+                  newStreamLocked(
                       {ek.node,
                        ek.sequence,
                        0,
@@ -164,8 +156,10 @@ class WriterContext : public CompressionBufferPool {
   }
 
   void suppressStream(const StreamIdentifier& stream) {
-    DWIO_ENSURE(hasStream(stream));
-    auto& collector = streams_.at(stream);
+    std::lock_guard<std::mutex> l(mutex_);
+    auto it = streams_.find(stream);
+    DWIO_ENSURE(it != streams_.end());
+    auto& collector = it->second;
     collector.suppress();
   }
 
@@ -259,6 +253,7 @@ class WriterContext : public CompressionBufferPool {
   // cleans up its value writer streams upon reset().
   void removeAllIntDictionaryEncodersOnNode(
       std::function<bool(uint32_t)> predicate) {
+    std::lock_guard<std::mutex> l(mutex_);
     auto iter = dictEncoders_.begin();
     while (iter != dictEncoders_.end()) {
       if (predicate(iter->first.node)) {
@@ -271,6 +266,7 @@ class WriterContext : public CompressionBufferPool {
 
   virtual void removeStreams(
       std::function<bool(const StreamIdentifier&)> predicate) {
+    std::lock_guard<std::mutex> l(mutex_);
     auto it = streams_.begin();
     while (it != streams_.end()) {
       if (predicate(it->first)) {
@@ -281,18 +277,37 @@ class WriterContext : public CompressionBufferPool {
     }
   }
 
+  // Streams compressed concurrently each take a buffer. Extra buffers are
+  // only allocated when streams are flushed on an executor.
   std::unique_ptr<dwio::common::DataBuffer<char>> getBuffer(
       uint64_t size) override {
-    DWIO_ENSURE_NOT_NULL(compressionBuffer_);
-    DWIO_ENSURE_GE(compressionBuffer_->size(), size);
-    return std::move(compressionBuffer_);
+    std::lock_guard<std::mutex> l(mutex_);
+    if (compressionBuffers_.empty()) {
+      compressionBuffers_.push_back(
+          std::make_unique<dwio::common::DataBuffer<char>>(
+              generalPool_, compressionBlockSize + PAGE_HEADER_SIZE));
+    }
+    auto buffer = std::move(compressionBuffers_.back());
+    compressionBuffers_.pop_back();
+    DWIO_ENSURE_GE(buffer->size(), size);
+    return buffer;
   }
 
   void returnBuffer(
       std::unique_ptr<dwio::common::DataBuffer<char>> buffer) override {
     DWIO_ENSURE_NOT_NULL(buffer);
-    DWIO_ENSURE(!compressionBuffer_);
-    compressionBuffer_ = std::move(buffer);
+    std::lock_guard<std::mutex> l(mutex_);
+    compressionBuffers_.push_back(std::move(buffer));
+  }
+
+  // Executor for encoding and flushing top level columns in parallel. Null
+  // if columns are written on the calling thread.
+  folly::Executor* FOLLY_NULLABLE executor() const {
+    return executor_;
+  }
+
+  void setExecutor(folly::Executor* FOLLY_NULLABLE executor) {
+    executor_ = executor;
   }
 
   void incrementNodeSize(uint32_t node, uint64_t size) {
@@ -424,8 +439,30 @@ class WriterContext : public CompressionBufferPool {
  private:
   void validateConfigs() const;
 
+  std::unique_ptr<BufferedOutputStream> newStreamLocked(
+      const StreamIdentifier& stream) {
+    DWIO_ENSURE(
+        streams_.find(stream) == streams_.end(),
+        "Stream already exists ",
+        stream.toString());
+    streams_.emplace(
+        std::piecewise_construct,
+        std::forward_as_tuple(stream),
+        std::forward_as_tuple(
+            getMemoryPool(MemoryUsageCategory::OUTPUT_STREAM),
+            compressionBlockSize,
+            getConfig(Config::COMPRESSION_BLOCK_SIZE_MIN),
+            getConfig(Config::COMPRESSION_BLOCK_SIZE_EXTEND_RATIO)));
+    auto& holder = streams_.at(stream);
+    auto encrypter = handler_->isEncrypted(stream.node)
+        ? std::addressof(handler_->getEncryptionProvider(stream.node))
+        : nullptr;
+    return newStream(compression, holder, encrypter);
+  }
+
   std::unique_ptr<velox::SelectivityVector> getSelectivityVector(
       velox::vector_size_t size) {
+    std::lock_guard<std::mutex> l(mutex_);
     if (selectivityVectorPool_.empty()) {
       return std::make_unique<velox::SelectivityVector>(size);
     }
@@ -437,10 +474,12 @@ class WriterContext : public CompressionBufferPool {
 
   void releaseSelectivityVector(
       std::unique_ptr<velox::SelectivityVector>&& vector) {
+    std::lock_guard<std::mutex> l(mutex_);
     selectivityVectorPool_.push_back(std::move(vector));
   }
 
   std::unique_ptr<velox::DecodedVector> getDecodedVector() {
+    std::lock_guard<std::mutex> l(mutex_);
     if (decodedVectorPool_.empty()) {
       return std::make_unique<velox::DecodedVector>();
     }
@@ -450,6 +489,7 @@ class WriterContext : public CompressionBufferPool {
   }
 
   void releaseDecodedVector(std::unique_ptr<velox::DecodedVector>&& vector) {
+    std::lock_guard<std::mutex> l(mutex_);
     decodedVectorPool_.push_back(std::move(vector));
   }
 
@@ -471,7 +511,8 @@ class WriterContext : public CompressionBufferPool {
   std::function<std::unique_ptr<IndexBuilder>(
       std::unique_ptr<BufferedOutputStream>)>
       indexBuilderFactory_;
-  std::unique_ptr<dwio::common::DataBuffer<char>> compressionBuffer_;
+  std::vector<std::unique_ptr<dwio::common::DataBuffer<char>>>
+      compressionBuffers_;
   // A pool of reusable DecodedVectors.
   std::vector<std::unique_ptr<velox::DecodedVector>> decodedVectorPool_;
   // A pool of reusable SelectivityVectors.
@@ -486,6 +527,10 @@ class WriterContext : public CompressionBufferPool {
   AverageRowSizeTracker rowSizeTracker_;
   bool checkLowMemoryMode_;
   bool lowMemoryMode_{false};
+  folly::Executor* FOLLY_NULLABLE executor_{nullptr};
+  // Serializes the stream, dictionary encoder and buffer pool bookkeeping
+  // that column writers reach when they run on 'executor_'.
+  mutable std::mutex mutex_;
 
  public:
   // stats
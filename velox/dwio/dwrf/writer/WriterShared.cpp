@@ -221,9 +221,8 @@ void WriterShared::flushStripe(bool close) {
   sink.setMode(WriterSink::Mode::Index);
   LayoutPlanner planner(context);
   planner.iterateIndexStreams([&](auto& streamId, auto& content) {
-    DWIO_ENSURE_EQ(
-        streamId.kind,
-        StreamKind::StreamKind_ROW_INDEX,
+    DWIO_ENSURE(
+        isIndexStream(streamId.kind),
         "unexpected stream kind ",
         streamId.kind);
     indexLength += content.size();
@@ -234,9 +233,8 @@ void WriterShared::flushStripe(bool close) {
   uint64_t dataLength = 0;
   sink.setMode(WriterSink::Mode::Data);
   planner.iterateDataStreams([&](auto& streamId, auto& content) {
-    DWIO_ENSURE_NE(
-        streamId.kind,
-        StreamKind::StreamKind_ROW_INDEX,
+    DWIO_ENSURE(
+        !isIndexStream(streamId.kind),
         "unexpected stream kind ",
         streamId.kind);
     dataLength += content.size();
@@ -30,6 +30,12 @@ struct WriterOptionsShared {
   std::shared_ptr<encryption::EncryptionSpecification> encryptionSpec;
   std::shared_ptr<dwio::common::encryption::EncrypterFactory> encrypterFactory;
   int64_t memoryBudget = std::numeric_limits<int64_t>::max();
+  // If set, top level columns are encoded and their streams compressed in
+  // parallel on this executor. The file is identical to the one written
+  // without an executor. The calling thread blocks until the columns are
+  // done, so this must not be an executor whose threads may all be waiting on
+  // writers.
+  folly::Executor* FOLLY_NULLABLE executor = nullptr;
 };
 
 class WriterShared : public WriterBase {
@@ -55,6 +61,7 @@ class WriterShared : public WriterBase {
                 folly::to<std::string>(folly::Random::rand64())),
             std::min(options.memoryBudget, parentPool.getCap())),
         std::move(handler));
+    getContext().setExecutor(options.executor);
     if (!flushPolicy_) {
       auto& context = getContext();
       flushPolicy_ = DefaultFlushPolicy(
@@ -0,0 +1,379 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/PageReader.h"
+#include "velox/dwio/parquet/reader/RleBpDecoder.h"
+
+#include <snappy.h>
+#include <zlib.h>
+#include <zstd.h>
+
+namespace facebook::velox::parquet {
+
+namespace {
+
+void decompress(
+    thrift::CompressionCodec::type codec,
+    const char* input,
+    uint64_t inputSize,
+    char* output,
+    uint64_t outputSize) {
+  switch (codec) {
+    case thrift::CompressionCodec::SNAPPY: {
+      size_t length;
+      VELOX_CHECK(
+          snappy::GetUncompressedLength(input, inputSize, &length) &&
+              length == outputSize,
+          "Bad Snappy compressed Parquet page");
+      VELOX_CHECK(
+          snappy::RawUncompress(input, inputSize, output),
+          "Snappy decompression of Parquet page failed");
+      return;
+    }
+    case thrift::CompressionCodec::ZSTD: {
+      auto result = ZSTD_decompress(output, outputSize, input, inputSize);
+      VELOX_CHECK(
+          !ZSTD_isError(result),
+          "ZSTD decompression of Parquet page failed: {}",
+          ZSTD_getErrorName(result));
+      VELOX_CHECK_EQ(result, outputSize, "Bad ZSTD compressed Parquet page");
+      return;
+    }
+    case thrift::CompressionCodec::GZIP: {
+      z_stream zstream;
+      memset(&zstream, 0, sizeof(zstream));
+      // 16 selects the gzip format instead of raw deflate.
+      VELOX_CHECK_EQ(inflateInit2(&zstream, 16 + MAX_WBITS), Z_OK);
+      zstream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input));
+      zstream.avail_in = inputSize;
+      zstream.next_out = reinterpret_cast<Bytef*>(output);
+      zstream.avail_out = outputSize;
+      auto result = inflate(&zstream, Z_FINISH);
+      auto numOut = zstream.total_out;
+      inflateEnd(&zstream);
+      VELOX_CHECK(
+          result == Z_STREAM_END && numOut == outputSize,
+          "GZIP decompression of Parquet page failed");
+      return;
+    }
+    default:
+      VELOX_UNSUPPORTED(
+          "Unsupported Parquet compression codec: {}",
+          static_cast<int32_t>(codec));
+  }
+}
+
+} // namespace
+
+// static
+StatisticsRange StatisticsRange::fromStatistics(
+    const thrift::Statistics& statistics,
+    int64_t numValues) {
+  StatisticsRange range;
+  range.numValues = numValues;
+  if (statistics.__isset.null_count) {
+    range.numNulls = statistics.null_count;
+  }
+  if (statistics.__isset.min_value && statistics.__isset.max_value) {
+    range.min = &statistics.min_value;
+    range.max = &statistics.max_value;
+  } else if (statistics.__isset.min && statistics.__isset.max) {
+    range.min = &statistics.min;
+    range.max = &statistics.max;
+    range.isDeprecated = true;
+  }
+  return range;
+}
+
+PageReader::PageReader(
+    std::unique_ptr<dwrf::SeekableInputStream> stream,
+    memory::MemoryPool& pool,
+    thrift::CompressionCodec::type codec,
+    int64_t numRows,
+    bool isOptional,
+    std::unique_ptr<thrift::ColumnIndex> columnIndex)
+    : stream_(std::move(stream)),
+      pool_(pool),
+      codec_(codec),
+      numRows_(numRows),
+      isOptional_(isOptional),
+      columnIndex_(std::move(columnIndex)) {}
+
+bool PageReader::loadDictionary() {
+  if (!started_) {
+    readPageHeader();
+    headerPending_ = true;
+    if (header_.type == thrift::PageType::DICTIONARY_PAGE) {
+      headerPending_ = false;
+      readDictionaryPage();
+    }
+  }
+  return dictionary_ != nullptr;
+}
+
+void PageReader::seekToRow(int64_t row) {
+  if (row < nextPageFirstRow_) {
+    VELOX_CHECK_GE(row, pageFirstRow_, "Parquet pages are read in order");
+    return;
+  }
+  VELOX_CHECK_LT(row, numRows_, "Reading past the end of a column chunk");
+  for (;;) {
+    if (!headerPending_) {
+      readPageHeader();
+    }
+    headerPending_ = false;
+    switch (header_.type) {
+      case thrift::PageType::DICTIONARY_PAGE:
+        readDictionaryPage();
+        break;
+      case thrift::PageType::DATA_PAGE:
+      case thrift::PageType::DATA_PAGE_V2: {
+        auto numPageRows = header_.type == thrift::PageType::DATA_PAGE
+            ? header_.data_page_header.num_values
+            : header_.data_page_header_v2.num_rows;
+        ++pageIndex_;
+        pageFirstRow_ = nextPageFirstRow_;
+        pageNumRows_ = numPageRows;
+        nextPageFirstRow_ += numPageRows;
+        if (row >= nextPageFirstRow_) {
+          skipBytes(header_.compressed_page_size);
+          break;
+        }
+        pageFiltered_ = pageFilter_ && !testPageFilter();
+        if (pageFiltered_) {
+          ++numFilteredPages_;
+          skipBytes(header_.compressed_page_size);
+        } else {
+          readDataPage();
+        }
+        return;
+      }
+      default:
+        skipBytes(header_.compressed_page_size);
+        break;
+    }
+  }
+}
+
+bool PageReader::testPageFilter() const {
+  if (columnIndex_ && pageIndex_ < columnIndex_->null_pages.size()) {
+    StatisticsRange range;
+    range.numValues = pageNumRows_;
+    if (columnIndex_->null_pages[pageIndex_]) {
+      range.numNulls = pageNumRows_;
+    } else {
+      range.min = &columnIndex_->min_values[pageIndex_];
+      range.max = &columnIndex_->max_values[pageIndex_];
+      if (columnIndex_->__isset.null_counts) {
+        range.numNulls = columnIndex_->null_counts[pageIndex_];
+      }
+    }
+    return pageFilter_(range);
+  }
+  if (header_.type == thrift::PageType::DATA_PAGE) {
+    auto& pageHeader = header_.data_page_header;
+    if (pageHeader.__isset.statistics) {
+      return pageFilter_(StatisticsRange::fromStatistics(
+          pageHeader.statistics, pageNumRows_));
+    }
+  } else {
+    auto& pageHeader = header_.data_page_header_v2;
+    if (pageHeader.__isset.statistics) {
+      auto range = StatisticsRange::fromStatistics(
+          pageHeader.statistics, pageNumRows_);
+      range.numNulls = pageHeader.num_nulls;
+      return pageFilter_(range);
+    }
+  }
+  return true;
+}
+
+void PageReader::readPageHeader() {
+  started_ = true;
+  header_ = thrift::PageHeader();
+  ensureBuffer();
+  try {
+    bufferStart_ +=
+        deserializeThrift(bufferStart_, bufferEnd_ - bufferStart_, &header_);
+    return;
+  } catch (const duckdb_apache::thrift::transport::TTransportException&) {
+    // The header continues in the next buffer.
+  }
+  std::string copy(bufferStart_, bufferEnd_);
+  for (;;) {
+    bufferStart_ = bufferEnd_;
+    ensureBuffer();
+    auto previousSize = copy.size();
+    copy.append(bufferStart_, bufferEnd_);
+    try {
+      header_ = thrift::PageHeader();
+      auto size = deserializeThrift(copy.data(), copy.size(), &header_);
+      bufferStart_ += size - previousSize;
+      return;
+    } catch (const duckdb_apache::thrift::transport::TTransportException&) {
+    }
+  }
+}
+
+void PageReader::readDictionaryPage() {
+  VELOX_CHECK(!dictionary_, "Parquet column chunk with two dictionaries");
+  auto encoding = header_.dictionary_page_header.encoding;
+  VELOX_CHECK(
+      encoding == thrift::Encoding::PLAIN ||
+          encoding == thrift::Encoding::PLAIN_DICTIONARY,
+      "Unsupported Parquet dictionary page encoding: {}",
+      static_cast<int32_t>(encoding));
+  dictionary_ = readPageData(codec_ != thrift::CompressionCodec::UNCOMPRESSED);
+  dictionarySize_ = header_.dictionary_page_header.num_values;
+}
+
+void PageReader::readDataPage() {
+  const char* data;
+  const char* end;
+  if (header_.type == thrift::PageType::DATA_PAGE) {
+    auto& pageHeader = header_.data_page_header;
+    pageBuffer_ =
+        readPageData(codec_ != thrift::CompressionCodec::UNCOMPRESSED);
+    data = pageBuffer_->as<char>();
+    end = data + pageBuffer_->size();
+    encoding_ = pageHeader.encoding;
+    if (isOptional_) {
+      VELOX_CHECK_EQ(
+          pageHeader.definition_level_encoding,
+          thrift::Encoding::RLE,
+          "Unsupported Parquet definition level encoding");
+      VELOX_CHECK_LE(data + sizeof(int32_t), end);
+      auto length = folly::loadUnaligned<int32_t>(data);
+      data += sizeof(int32_t);
+      VELOX_CHECK_LE(data + length, end);
+      decodeDefinitionLevels(data, data + length);
+      data += length;
+    }
+  } else {
+    auto& pageHeader = header_.data_page_header_v2;
+    VELOX_CHECK_EQ(
+        pageHeader.repetition_levels_byte_length,
+        0,
+        "Repeated Parquet columns are not supported");
+    auto levelsLength = pageHeader.definition_levels_byte_length;
+    pageBuffer_ = readPageData(
+        pageHeader.is_compressed &&
+            codec_ != thrift::CompressionCodec::UNCOMPRESSED,
+        levelsLength);
+    data = pageBuffer_->as<char>();
+    end = data + pageBuffer_->size();
+    encoding_ = pageHeader.encoding;
+    if (isOptional_) {
+      decodeDefinitionLevels(data, data + levelsLength);
+    }
+    data += levelsLength;
+  }
+  if (!isOptional_) {
+    hasNulls_ = false;
+    numValues_ = pageNumRows_;
+  }
+  values_ = data;
+  valuesEnd_ = end;
+}
+
+void PageReader::decodeDefinitionLevels(const char* begin, const char* end) {
+  nonNullIndex_.resize(pageNumRows_);
+  auto indices = nonNullIndex_.data();
+  RleBpDecoder(begin, end, 1).next(indices, pageNumRows_);
+  // Levels are 0 for null and 1 for non-null. Turn these into positions
+  // among the non-null values in place.
+  int32_t numNonNull = 0;
+  for (auto i = 0; i < pageNumRows_; ++i) {
+    indices[i] = indices[i] ? numNonNull++ : -1;
+  }
+  numValues_ = numNonNull;
+  hasNulls_ = numNonNull < pageNumRows_;
+}
+
+BufferPtr PageReader::readPageData(
+    bool isCompressed,
+    int32_t uncompressedPrefix) {
+  auto compressedSize = header_.compressed_page_size;
+  auto uncompressedSize = header_.uncompressed_page_size;
+  VELOX_CHECK_LE(uncompressedPrefix, compressedSize);
+  auto buffer = AlignedBuffer::allocate<char>(uncompressedSize, &pool_);
+  auto data = buffer->asMutable<char>();
+  readBytes(data, uncompressedPrefix);
+  if (!isCompressed) {
+    VELOX_CHECK_EQ(compressedSize, uncompressedSize);
+    readBytes(
+        data + uncompressedPrefix, uncompressedSize - uncompressedPrefix);
+    return buffer;
+  }
+  std::string copy;
+  auto size = compressedSize - uncompressedPrefix;
+  auto input = contiguousBytes(size, copy);
+  decompress(
+      codec_,
+      input,
+      size,
+      data + uncompressedPrefix,
+      uncompressedSize - uncompressedPrefix);
+  return buffer;
+}
+
+void PageReader::ensureBuffer() {
+  while (bufferStart_ == bufferEnd_) {
+    const void* buffer;
+    int32_t size;
+    VELOX_CHECK(
+        stream_->Next(&buffer, &size), "Reading past end of column chunk");
+    bufferStart_ = reinterpret_cast<const char*>(buffer);
+    bufferEnd_ = bufferStart_ + size;
+  }
+}
+
+void PageReader::readBytes(char* destination, int64_t size) {
+  while (size > 0) {
+    ensureBuffer();
+    auto numBytes = std::min<int64_t>(size, bufferEnd_ - bufferStart_);
+    memcpy(destination, bufferStart_, numBytes);
+    bufferStart_ += numBytes;
+    destination += numBytes;
+    size -= numBytes;
+  }
+}
+
+const char* PageReader::contiguousBytes(int64_t size, std::string& copy) {
+  if (size > 0) {
+    ensureBuffer();
+  }
+  if (bufferEnd_ - bufferStart_ >= size) {
+    auto result = bufferStart_;
+    bufferStart_ += size;
+    return result;
+  }
+  copy.resize(size);
+  readBytes(copy.data(), size);
+  return copy.data();
+}
+
+void PageReader::skipBytes(int64_t size) {
+  auto numInBuffer = std::min<int64_t>(size, bufferEnd_ - bufferStart_);
+  bufferStart_ += numInBuffer;
+  size -= numInBuffer;
+  if (size > 0) {
+    VELOX_CHECK(
+        stream_->Skip(size), "Skipping past end of Parquet column chunk");
+  }
+}
+
+} // namespace facebook::velox::parquet
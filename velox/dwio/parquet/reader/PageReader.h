@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/buffer/Buffer.h"
+#include "velox/common/base/RawVector.h"
+#include "velox/dwio/dwrf/common/InputStream.h"
+#include "velox/dwio/parquet/reader/ThriftUtils.h"
+
+namespace facebook::velox::parquet {
+
+// Min, max and null count of a column chunk or a page as recorded in the
+// file. 'min' and 'max' are PLAIN encoded values and are nullptr if not
+// recorded. 'isDeprecated' is true if these come from the deprecated
+// 'min' and 'max' fields of Statistics, which use a signed byte order for
+// byte arrays.
+struct StatisticsRange {
+  const std::string* min{nullptr};
+  const std::string* max{nullptr};
+  bool isDeprecated{false};
+  std::optional<int64_t> numNulls;
+  int64_t numValues{0};
+
+  static StatisticsRange fromStatistics(
+      const thrift::Statistics& statistics,
+      int64_t numValues);
+};
+
+// Returns false if no row of a page with the given statistics can pass the
+// filter of the column being read.
+using PageFilter = std::function<bool(const StatisticsRange&)>;
+
+// Reads the pages of one column chunk of a flat column. Data pages are
+// visited in row order. Pages that hold no requested rows are skipped
+// without decompressing them. The definition levels of the current data
+// page are decoded into a mapping from row to non-null value. Decoding
+// the values is left to the column reader.
+class PageReader {
+ public:
+  PageReader(
+      std::unique_ptr<dwrf::SeekableInputStream> stream,
+      memory::MemoryPool& pool,
+      thrift::CompressionCodec::type codec,
+      int64_t numRows,
+      bool isOptional,
+      std::unique_ptr<thrift::ColumnIndex> columnIndex);
+
+  // Sets a check that is made against the statistics of each data page
+  // before decompressing it. The statistics come from the column index if
+  // there is one, else from the page header.
+  void setPageFilter(PageFilter pageFilter) {
+    pageFilter_ = std::move(pageFilter);
+  }
+
+  // Reads the dictionary page if the column chunk starts with one and no
+  // page has been read yet. Returns true if the chunk has a dictionary.
+  bool loadDictionary();
+
+  // The PLAIN encoded dictionary values of the column chunk, nullptr if
+  // none has been read.
+  const BufferPtr& dictionary() const {
+    return dictionary_;
+  }
+
+  int32_t dictionarySize() const {
+    return dictionarySize_;
+  }
+
+  // Positions 'this' on the data page that contains 'row'. 'row' must be
+  // at or after the first row of the current page.
+  void seekToRow(int64_t row);
+
+  int64_t pageFirstRow() const {
+    return pageFirstRow_;
+  }
+
+  int32_t pageNumRows() const {
+    return pageNumRows_;
+  }
+
+  // Ordinal of the current data page in the column chunk.
+  int32_t pageIndex() const {
+    return pageIndex_;
+  }
+
+  // True if the page filter showed that no row of the current page can
+  // pass. The page is then not decoded.
+  bool pageFiltered() const {
+    return pageFiltered_;
+  }
+
+  bool isDictionaryEncoded() const {
+    return encoding_ == thrift::Encoding::PLAIN_DICTIONARY ||
+        encoding_ == thrift::Encoding::RLE_DICTIONARY;
+  }
+
+  thrift::Encoding::type encoding() const {
+    return encoding_;
+  }
+
+  // Number of non-null values in the current page.
+  int32_t numValues() const {
+    return numValues_;
+  }
+
+  // The encoded values of the current page.
+  const char* values() const {
+    return values_;
+  }
+
+  const char* valuesEnd() const {
+    return valuesEnd_;
+  }
+
+  // The decompressed current page. 'values()' points into this.
+  const BufferPtr& pageBuffer() const {
+    return pageBuffer_;
+  }
+
+  // Returns the position of the value of 'rowInPage' among the non-null
+  // values of the current page, -1 if the row is null.
+  int32_t valueIndex(int32_t rowInPage) const {
+    return hasNulls_ ? nonNullIndex_[rowInPage] : rowInPage;
+  }
+
+  bool pageHasNulls() const {
+    return hasNulls_;
+  }
+
+  // Number of data pages skipped because of the page filter.
+  uint64_t numFilteredPages() const {
+    return numFilteredPages_;
+  }
+
+ private:
+  // Reads the next page header into 'header_'.
+  void readPageHeader();
+
+  void readDictionaryPage();
+
+  void readDataPage();
+
+  bool testPageFilter() const;
+
+  // Returns the contents of the current page, decompressed if
+  // 'isCompressed'. The first 'uncompressedPrefix' bytes are not compressed
+  // even if the rest is.
+  BufferPtr readPageData(bool isCompressed, int32_t uncompressedPrefix = 0);
+
+  // Decodes the definition levels in [begin, end) into 'nonNullIndex_'.
+  void decodeDefinitionLevels(const char* begin, const char* end);
+
+  // Makes sure that 'bufferStart_' is not at the end of a buffer. Throws if
+  // there is no more data.
+  void ensureBuffer();
+
+  // Copies the next 'size' bytes of the stream to 'destination'.
+  void readBytes(char* destination, int64_t size);
+
+  // Returns a pointer to the next 'size' bytes of the stream. Copies these
+  // to 'copy' if they span buffers.
+  const char* contiguousBytes(int64_t size, std::string& copy);
+
+  void skipBytes(int64_t size);
+
+  std::unique_ptr<dwrf::SeekableInputStream> stream_;
+  memory::MemoryPool& pool_;
+  const thrift::CompressionCodec::type codec_;
+  // Rows in the column chunk.
+  const int64_t numRows_;
+  // True if the column has definition levels.
+  const bool isOptional_;
+  std::unique_ptr<thrift::ColumnIndex> columnIndex_;
+  PageFilter pageFilter_;
+
+  // Unconsumed part of the last buffer returned by 'stream_'.
+  const char* bufferStart_{nullptr};
+  const char* bufferEnd_{nullptr};
+
+  thrift::PageHeader header_;
+  // True if 'header_' has been read but its page has not been consumed.
+  bool headerPending_{false};
+  // True if a page header has been read.
+  bool started_{false};
+
+  BufferPtr dictionary_;
+  int32_t dictionarySize_{0};
+
+  // First row of the page after the current one.
+  int64_t nextPageFirstRow_{0};
+  int64_t pageFirstRow_{0};
+  int32_t pageNumRows_{0};
+  int32_t pageIndex_{-1};
+  bool pageFiltered_{false};
+  thrift::Encoding::type encoding_{thrift::Encoding::PLAIN};
+  BufferPtr pageBuffer_;
+  const char* values_{nullptr};
+  const char* valuesEnd_{nullptr};
+  int32_t numValues_{0};
+  bool hasNulls_{false};
+  // Index of the value of each row among the non-null values of the page,
+  // -1 for a null row. Set if 'hasNulls_'.
+  raw_vector<int32_t> nonNullIndex_;
+  uint64_t numFilteredPages_{0};
+};
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,644 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/ParquetColumnReader.h"
+#include "velox/common/base/Nulls.h"
+#include "velox/dwio/parquet/reader/RleBpDecoder.h"
+#include "velox/vector/FlatVector.h"
+
+namespace facebook::velox::parquet {
+
+namespace {
+
+// Julian day number of 1970-01-01.
+constexpr int64_t kJulianEpochDay = 2'440'588;
+constexpr int64_t kSecondsPerDay = 86'400;
+constexpr int64_t kNanosPerSecond = 1'000'000'000;
+// Bytes in an INT96 timestamp: 8 bytes of nanos in day, 4 bytes of
+// Julian day.
+constexpr int32_t kInt96Size = 12;
+
+bool isDictionaryEncoding(thrift::Encoding::type encoding) {
+  return encoding == thrift::Encoding::PLAIN_DICTIONARY ||
+      encoding == thrift::Encoding::RLE_DICTIONARY;
+}
+
+bool allDataPagesUseDictionary(const thrift::ColumnMetaData& metaData) {
+  if (metaData.__isset.encoding_stats) {
+    for (auto& stats : metaData.encoding_stats) {
+      if ((stats.page_type == thrift::PageType::DATA_PAGE ||
+           stats.page_type == thrift::PageType::DATA_PAGE_V2) &&
+          stats.count > 0 && !isDictionaryEncoding(stats.encoding)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  // Without encoding stats, a chunk that lists no value encoding other than
+  // the dictionary ones has only dictionary encoded data pages. RLE and
+  // BIT_PACKED are the level encodings.
+  bool hasDictionary = false;
+  for (auto encoding : metaData.encodings) {
+    if (isDictionaryEncoding(encoding)) {
+      hasDictionary = true;
+    } else if (
+        encoding != thrift::Encoding::RLE &&
+        encoding != thrift::Encoding::BIT_PACKED) {
+      return false;
+    }
+  }
+  return hasDictionary;
+}
+
+template <typename TPhysical, typename T>
+void decodeIntegers(
+    const char* data,
+    const char* end,
+    int32_t numValues,
+    T* values) {
+  VELOX_CHECK_LE(numValues * sizeof(TPhysical), end - data);
+  for (auto i = 0; i < numValues; ++i) {
+    values[i] = folly::loadUnaligned<TPhysical>(data + i * sizeof(TPhysical));
+  }
+}
+
+// Decodes 'numValues' PLAIN encoded values from [data, end) into 'values'.
+// StringViews point into the encoded data.
+template <typename T>
+void decodePlain(
+    thrift::Type::type physicalType,
+    const char* data,
+    const char* end,
+    int32_t numValues,
+    T* values) {
+  if constexpr (std::is_same_v<T, bool>) {
+    VELOX_CHECK_LE(bits::nbytes(numValues), end - data);
+    auto bytes = reinterpret_cast<const uint8_t*>(data);
+    for (auto i = 0; i < numValues; ++i) {
+      values[i] = bits::isBitSet(bytes, i);
+    }
+  } else if constexpr (std::is_same_v<T, StringView>) {
+    for (auto i = 0; i < numValues; ++i) {
+      VELOX_CHECK_LE(sizeof(uint32_t), end - data);
+      auto length = folly::loadUnaligned<uint32_t>(data);
+      data += sizeof(uint32_t);
+      VELOX_CHECK_LE(length, end - data);
+      values[i] = StringView(data, length);
+      data += length;
+    }
+  } else if constexpr (std::is_same_v<T, Timestamp>) {
+    VELOX_CHECK_LE(numValues * kInt96Size, end - data);
+    for (auto i = 0; i < numValues; ++i) {
+      auto nanos = folly::loadUnaligned<int64_t>(data);
+      auto days = folly::loadUnaligned<int32_t>(data + sizeof(int64_t));
+      data += kInt96Size;
+      values[i] = Timestamp(
+          (days - kJulianEpochDay) * kSecondsPerDay + nanos / kNanosPerSecond,
+          nanos % kNanosPerSecond);
+    }
+  } else if constexpr (std::is_integral_v<T>) {
+    if (physicalType == thrift::Type::INT32) {
+      decodeIntegers<int32_t>(data, end, numValues, values);
+    } else {
+      decodeIntegers<int64_t>(data, end, numValues, values);
+    }
+  } else {
+    VELOX_CHECK_LE(numValues * sizeof(T), end - data);
+    memcpy(values, data, numValues * sizeof(T));
+  }
+}
+
+// Decodes a PLAIN encoded min or max value from column statistics.
+template <typename T>
+bool decodeStatisticsValue(
+    thrift::Type::type physicalType,
+    const std::string& encoded,
+    T& value) {
+  int32_t size;
+  if constexpr (std::is_integral_v<T>) {
+    size = physicalType == thrift::Type::INT32 ? sizeof(int32_t)
+                                               : sizeof(int64_t);
+  } else {
+    size = sizeof(T);
+  }
+  if (encoded.size() != size) {
+    return false;
+  }
+  decodePlain(
+      physicalType, encoded.data(), encoded.data() + size, 1, &value);
+  return true;
+}
+
+template <typename T>
+bool testRangeOfType(
+    const common::Filter& filter,
+    thrift::Type::type physicalType,
+    const StatisticsRange& range,
+    bool mayHaveNull) {
+  T min;
+  T max;
+  if (!decodeStatisticsValue(physicalType, *range.min, min) ||
+      !decodeStatisticsValue(physicalType, *range.max, max)) {
+    return true;
+  }
+  if constexpr (std::is_same_v<T, bool>) {
+    return filter.testBool(min) || filter.testBool(max);
+  } else if constexpr (std::is_integral_v<T>) {
+    return filter.testInt64Range(min, max, mayHaveNull);
+  } else {
+    return filter.testDoubleRange(min, max, mayHaveNull);
+  }
+}
+
+template <typename T>
+class FlatColumnReader : public ParquetColumnReader {
+ public:
+  FlatColumnReader(
+      const TypePtr& type,
+      const thrift::SchemaElement& schema,
+      common::ScanSpec* scanSpec,
+      memory::MemoryPool& pool)
+      : ParquetColumnReader(type, schema, scanSpec, pool) {}
+
+  bool testDictionary() override;
+
+  void read(int64_t offset, RowSet rows) override;
+
+  void getValues(RowSet rows, VectorPtr* result) override;
+
+  void resetFilterCaches() override {
+    std::fill(filterCache_.begin(), filterCache_.end(), kUnknown);
+  }
+
+ protected:
+  void resetColumnChunk() override {
+    dictionary_.clear();
+    filterCache_.clear();
+    decodedPageIndex_ = -1;
+  }
+
+ private:
+  static constexpr uint8_t kUnknown = 0;
+  static constexpr uint8_t kPass = 1;
+  static constexpr uint8_t kFail = 2;
+
+  void decodeDictionary();
+
+  // Decodes the values of the current page unless already done.
+  void decodePage();
+
+  // Reads rows[begin] to rows[end - 1] from the current page. 'rowBias' is
+  // added to a row number to get the row number in the page.
+  template <bool kHasFilter>
+  void readPage(
+      RowSet rows,
+      int32_t begin,
+      int32_t end,
+      int64_t rowBias,
+      bool keepValues);
+
+  bool testDictionaryEntry(int32_t index) {
+    auto cached = filterCache_[index];
+    if (cached != kUnknown) {
+      return cached == kPass;
+    }
+    bool pass = common::applyFilter(*scanSpec_->filter(), dictionary_[index]);
+    filterCache_[index] = pass ? kPass : kFail;
+    return pass;
+  }
+
+  void addValue(vector_size_t row, T value, bool keepValues) {
+    if (keepValues) {
+      if constexpr (std::is_same_v<T, bool>) {
+        bits::setBit(rawValues_, numOutputRows_, value);
+      } else {
+        reinterpret_cast<T*>(rawValues_)[numOutputRows_] = value;
+      }
+    }
+    outputRows_[numOutputRows_++] = row;
+  }
+
+  void addNull(vector_size_t row, bool keepValues) {
+    if (keepValues) {
+      if (!anyNulls_) {
+        nulls_ = AlignedBuffer::allocate<bool>(
+            outputRows_.size(), &pool_, bits::kNotNull);
+        anyNulls_ = true;
+      }
+      bits::setNull(nulls_->asMutable<uint64_t>(), numOutputRows_);
+      addValue(row, T(), true);
+      return;
+    }
+    outputRows_[numOutputRows_++] = row;
+  }
+
+  void addStringBuffer(const BufferPtr& buffer) {
+    if (stringBuffers_.empty() || stringBuffers_.back() != buffer) {
+      stringBuffers_.push_back(buffer);
+    }
+  }
+
+  // Decoded dictionary of the current column chunk.
+  raw_vector<T> dictionary_;
+  // Filter result for each entry of 'dictionary_', one of kUnknown, kPass
+  // and kFail.
+  raw_vector<uint8_t> filterCache_;
+  // Ordinal of the data page decoded into 'indices_' or 'pageValues_'.
+  int32_t decodedPageIndex_{-1};
+  // Dictionary indices of the non-null values of a dictionary encoded page.
+  raw_vector<int32_t> indices_;
+  // The non-null values of a page that is not dictionary encoded.
+  raw_vector<T> pageValues_;
+
+  // Values, nulls and string buffers of the rows that passed the last
+  // read().
+  BufferPtr values_;
+  void* rawValues_{nullptr};
+  BufferPtr nulls_;
+  bool anyNulls_{false};
+  std::vector<BufferPtr> stringBuffers_;
+};
+
+template <typename T>
+void FlatColumnReader<T>::decodeDictionary() {
+  auto& dictionary = pageReader_->dictionary();
+  auto size = pageReader_->dictionarySize();
+  dictionary_.resize(size);
+  decodePlain(
+      physicalType_,
+      dictionary->as<char>(),
+      dictionary->as<char>() + dictionary->size(),
+      size,
+      dictionary_.data());
+  filterCache_.resize(size);
+  std::fill(filterCache_.begin(), filterCache_.end(), kUnknown);
+}
+
+template <typename T>
+bool FlatColumnReader<T>::testDictionary() {
+  auto filter = scanSpec_->filter();
+  if (!filter || !allPagesDictionaryEncoded_ ||
+      !pageReader_->loadDictionary()) {
+    return true;
+  }
+  if (dictionary_.empty()) {
+    decodeDictionary();
+  }
+  bool mayHaveNull =
+      isOptional_ && (!chunkNumNulls_.has_value() || chunkNumNulls_.value());
+  if (mayHaveNull && filter->testNull()) {
+    return true;
+  }
+  for (auto i = 0; i < dictionary_.size(); ++i) {
+    if (testDictionaryEntry(i)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename T>
+void FlatColumnReader<T>::decodePage() {
+  if (pageReader_->pageIndex() == decodedPageIndex_) {
+    return;
+  }
+  decodedPageIndex_ = pageReader_->pageIndex();
+  auto numValues = pageReader_->numValues();
+  auto data = pageReader_->values();
+  auto end = pageReader_->valuesEnd();
+  if (pageReader_->isDictionaryEncoded()) {
+    VELOX_CHECK(
+        pageReader_->dictionary(),
+        "Dictionary encoded Parquet page without dictionary");
+    if (dictionary_.empty()) {
+      decodeDictionary();
+    }
+    indices_.resize(numValues);
+    if (numValues) {
+      VELOX_CHECK_LT(data, end);
+      uint8_t bitWidth = *data++;
+      RleBpDecoder(data, end, bitWidth).next(indices_.data(), numValues);
+    }
+    auto dictionarySize = dictionary_.size();
+    for (auto i = 0; i < numValues; ++i) {
+      VELOX_CHECK(
+          static_cast<uint32_t>(indices_[i]) < dictionarySize,
+          "Parquet dictionary index out of range");
+    }
+    return;
+  }
+  pageValues_.resize(numValues);
+  switch (pageReader_->encoding()) {
+    case thrift::Encoding::PLAIN:
+      decodePlain(physicalType_, data, end, numValues, pageValues_.data());
+      break;
+    case thrift::Encoding::RLE:
+      if constexpr (std::is_same_v<T, bool>) {
+        // RLE encoded booleans start with the byte length of the runs.
+        VELOX_CHECK_LE(sizeof(int32_t), end - data);
+        data += sizeof(int32_t);
+        raw_vector<int32_t> bools(numValues);
+        RleBpDecoder(data, end, 1).next(bools.data(), numValues);
+        for (auto i = 0; i < numValues; ++i) {
+          pageValues_[i] = bools[i];
+        }
+        break;
+      }
+      [[fallthrough]];
+    default:
+      VELOX_UNSUPPORTED(
+          "Unsupported Parquet encoding: {}",
+          static_cast<int32_t>(pageReader_->encoding()));
+  }
+}
+
+template <typename T>
+void FlatColumnReader<T>::read(int64_t offset, RowSet rows) {
+  auto keepValues = scanSpec_->keepValues();
+  prepareRead(rows.size());
+  anyNulls_ = false;
+  stringBuffers_.clear();
+  if (keepValues) {
+    values_ = AlignedBuffer::allocate<T>(rows.size(), &pool_);
+    rawValues_ = values_->asMutable<char>();
+  }
+  auto hasFilter = scanSpec_->filter() != nullptr;
+  int32_t numRows = rows.size();
+  int32_t begin = 0;
+  while (begin < numRows) {
+    pageReader_->seekToRow(offset + rows[begin]);
+    auto pageEnd = pageReader_->pageFirstRow() + pageReader_->pageNumRows();
+    int32_t end =
+        std::lower_bound(rows.begin() + begin, rows.end(), pageEnd - offset) -
+        rows.begin();
+    if (!pageReader_->pageFiltered()) {
+      decodePage();
+      if constexpr (std::is_same_v<T, StringView>) {
+        if (keepValues) {
+          addStringBuffer(
+              pageReader_->isDictionaryEncoded() ? pageReader_->dictionary()
+                                                 : pageReader_->pageBuffer());
+        }
+      }
+      auto rowBias = offset - pageReader_->pageFirstRow();
+      if (hasFilter) {
+        readPage<true>(rows, begin, end, rowBias, keepValues);
+      } else {
+        readPage<false>(rows, begin, end, rowBias, keepValues);
+      }
+    }
+    begin = end;
+  }
+}
+
+template <typename T>
+template <bool kHasFilter>
+void FlatColumnReader<T>::readPage(
+    RowSet rows,
+    int32_t begin,
+    int32_t end,
+    int64_t rowBias,
+    bool keepValues) {
+  auto filter = scanSpec_->filter();
+  bool isDictionary = pageReader_->isDictionaryEncoded();
+  if constexpr (!kHasFilter && !std::is_same_v<T, bool>) {
+    // Copy dense runs of non-null plain values in one go.
+    if (!isDictionary && !pageReader_->pageHasNulls() &&
+        rows[end - 1] - rows[begin] == end - 1 - begin) {
+      auto numRows = end - begin;
+      memcpy(
+          reinterpret_cast<T*>(rawValues_) + numOutputRows_,
+          pageValues_.data() + rows[begin] + rowBias,
+          numRows * sizeof(T));
+      std::copy(
+          rows.begin() + begin,
+          rows.begin() + end,
+          outputRows_.data() + numOutputRows_);
+      numOutputRows_ += numRows;
+      return;
+    }
+  }
+  for (auto i = begin; i < end; ++i) {
+    auto row = rows[i];
+    auto valueIndex = pageReader_->valueIndex(row + rowBias);
+    if (valueIndex < 0) {
+      if (!kHasFilter || filter->testNull()) {
+        addNull(row, keepValues);
+      }
+      continue;
+    }
+    if (isDictionary) {
+      auto index = indices_[valueIndex];
+      if (!kHasFilter || testDictionaryEntry(index)) {
+        addValue(row, dictionary_[index], keepValues);
+      }
+    } else {
+      auto value = pageValues_[valueIndex];
+      if (!kHasFilter || common::applyFilter(*filter, value)) {
+        addValue(row, value, keepValues);
+      }
+    }
+  }
+}
+
+template <typename T>
+void FlatColumnReader<T>::getValues(RowSet rows, VectorPtr* result) {
+  VELOX_CHECK(values_, "getValues() without read() of values");
+  VELOX_CHECK_LE(rows.size(), numOutputRows_);
+  if (rows.size() < numOutputRows_) {
+    // Move the values of 'rows' to the front.
+    auto nulls = anyNulls_ ? nulls_->asMutable<uint64_t>() : nullptr;
+    int32_t numMoved = 0;
+    for (auto i = 0; i < numOutputRows_ && numMoved < rows.size(); ++i) {
+      if (outputRows_[i] != rows[numMoved]) {
+        continue;
+      }
+      if (i != numMoved) {
+        if constexpr (std::is_same_v<T, bool>) {
+          bits::setBit(
+              reinterpret_cast<uint64_t*>(rawValues_),
+              numMoved,
+              bits::isBitSet(reinterpret_cast<uint64_t*>(rawValues_), i));
+        } else {
+          reinterpret_cast<T*>(rawValues_)[numMoved] =
+              reinterpret_cast<T*>(rawValues_)[i];
+        }
+        if (nulls) {
+          bits::setNull(nulls, numMoved, bits::isBitNull(nulls, i));
+        }
+      }
+      ++numMoved;
+    }
+    VELOX_CHECK_EQ(numMoved, rows.size(), "Rows not in the read result");
+  }
+  values_->setSize(
+      std::is_same_v<T, bool> ? bits::nbytes(rows.size())
+                              : rows.size() * sizeof(T));
+  *result = std::make_shared<FlatVector<T>>(
+      &pool_,
+      type_,
+      anyNulls_ ? std::move(nulls_) : nullptr,
+      rows.size(),
+      std::move(values_),
+      std::move(stringBuffers_));
+  nulls_ = nullptr;
+  values_ = nullptr;
+  rawValues_ = nullptr;
+}
+
+} // namespace
+
+ParquetColumnReader::ParquetColumnReader(
+    const TypePtr& type,
+    const thrift::SchemaElement& schema,
+    common::ScanSpec* scanSpec,
+    memory::MemoryPool& pool)
+    : type_(type),
+      physicalType_(schema.type),
+      isOptional_(
+          schema.repetition_type != thrift::FieldRepetitionType::REQUIRED),
+      scanSpec_(scanSpec),
+      pool_(pool) {}
+
+// static
+std::unique_ptr<ParquetColumnReader> ParquetColumnReader::create(
+    const TypePtr& type,
+    const thrift::SchemaElement& schema,
+    common::ScanSpec* scanSpec,
+    memory::MemoryPool& pool) {
+  switch (type->kind()) {
+    case TypeKind::BOOLEAN:
+      return std::make_unique<FlatColumnReader<bool>>(
+          type, schema, scanSpec, pool);
+    case TypeKind::TINYINT:
+      return std::make_unique<FlatColumnReader<int8_t>>(
+          type, schema, scanSpec, pool);
+    case TypeKind::SMALLINT:
+      return std::make_unique<FlatColumnReader<int16_t>>(
+          type, schema, scanSpec, pool);
+    case TypeKind::INTEGER:
+      return std::make_unique<FlatColumnReader<int32_t>>(
+          type, schema, scanSpec, pool);
+    case TypeKind::BIGINT:
+      return std::make_unique<FlatColumnReader<int64_t>>(
+          type, schema, scanSpec, pool);
+    case TypeKind::REAL:
+      return std::make_unique<FlatColumnReader<float>>(
+          type, schema, scanSpec, pool);
+    case TypeKind::DOUBLE:
+      return std::make_unique<FlatColumnReader<double>>(
+          type, schema, scanSpec, pool);
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return std::make_unique<FlatColumnReader<StringView>>(
+          type, schema, scanSpec, pool);
+    case TypeKind::TIMESTAMP:
+      return std::make_unique<FlatColumnReader<Timestamp>>(
+          type, schema, scanSpec, pool);
+    default:
+      VELOX_UNSUPPORTED(
+          "Unsupported type in Parquet reader: {}", type->toString());
+  }
+}
+
+bool ParquetColumnReader::testStatistics(
+    const thrift::ColumnChunk& chunk,
+    int64_t numRows) const {
+  auto& metaData = chunk.meta_data;
+  if (!scanSpec_->filter() || !metaData.__isset.statistics) {
+    return true;
+  }
+  return testRange(
+      StatisticsRange::fromStatistics(metaData.statistics, numRows));
+}
+
+void ParquetColumnReader::startColumnChunk(
+    const thrift::ColumnChunk& chunk,
+    int64_t numRows,
+    std::unique_ptr<dwrf::SeekableInputStream> stream,
+    std::unique_ptr<thrift::ColumnIndex> columnIndex) {
+  auto& metaData = chunk.meta_data;
+  if (pageReader_) {
+    numFilteredPages_ += pageReader_->numFilteredPages();
+  }
+  pageReader_ = std::make_unique<PageReader>(
+      std::move(stream),
+      pool_,
+      metaData.codec,
+      numRows,
+      isOptional_,
+      std::move(columnIndex));
+  // The filter is looked up on each page since dynamic filters may be
+  // added while reading.
+  pageReader_->setPageFilter(
+      [this](const StatisticsRange& range) { return testRange(range); });
+  chunkNumNulls_.reset();
+  if (metaData.__isset.statistics &&
+      metaData.statistics.__isset.null_count) {
+    chunkNumNulls_ = metaData.statistics.null_count;
+  }
+  allPagesDictionaryEncoded_ = allDataPagesUseDictionary(metaData);
+  resetColumnChunk();
+}
+
+bool ParquetColumnReader::testRange(const StatisticsRange& range) const {
+  auto filter = scanSpec_->filter();
+  if (!filter) {
+    return true;
+  }
+  if (range.numNulls.has_value() &&
+      range.numNulls.value() >= range.numValues) {
+    // All null.
+    return filter->testNull();
+  }
+  bool mayHaveNull = isOptional_ &&
+      (!range.numNulls.has_value() || range.numNulls.value() > 0);
+  if (mayHaveNull && filter->testNull()) {
+    return true;
+  }
+  if (!mayHaveNull && filter->kind() == common::FilterKind::kIsNull) {
+    return false;
+  }
+  if (!range.min || !range.max) {
+    return true;
+  }
+  switch (type_->kind()) {
+    case TypeKind::BOOLEAN:
+      return testRangeOfType<bool>(*filter, physicalType_, range, mayHaveNull);
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+      return testRangeOfType<int64_t>(
+          *filter, physicalType_, range, mayHaveNull);
+    case TypeKind::REAL:
+      return testRangeOfType<float>(*filter, physicalType_, range, mayHaveNull);
+    case TypeKind::DOUBLE:
+      return testRangeOfType<double>(
+          *filter, physicalType_, range, mayHaveNull);
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      // The deprecated min and max compare bytes as signed.
+      if (range.isDeprecated) {
+        return true;
+      }
+      return filter->testBytesRange(*range.min, *range.max, mayHaveNull);
+    default:
+      return true;
+  }
+}
+
+} // namespace facebook::velox::parquet
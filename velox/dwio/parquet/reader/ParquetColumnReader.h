@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/dwio/dwrf/reader/ScanSpec.h"
+#include "velox/dwio/parquet/reader/PageReader.h"
+#include "velox/vector/LazyVector.h"
+
+namespace facebook::velox::parquet {
+
+// Reads a flat column of a Parquet file, one column chunk per row group.
+// Like a selective DWRF column reader, read() applies the filter in the
+// column's ScanSpec while decoding and getValues() makes a flat vector of
+// the values of a subset of the rows that passed. Filter results on
+// dictionary encoded pages are cached per dictionary entry.
+class ParquetColumnReader {
+ public:
+  ParquetColumnReader(
+      const TypePtr& type,
+      const thrift::SchemaElement& schema,
+      common::ScanSpec* scanSpec,
+      memory::MemoryPool& pool);
+
+  virtual ~ParquetColumnReader() = default;
+
+  // Makes a reader for a column of 'type' that is stored as described by
+  // 'schema'.
+  static std::unique_ptr<ParquetColumnReader> create(
+      const TypePtr& type,
+      const thrift::SchemaElement& schema,
+      common::ScanSpec* scanSpec,
+      memory::MemoryPool& pool);
+
+  common::ScanSpec* scanSpec() const {
+    return scanSpec_;
+  }
+
+  // Returns false if the statistics of 'chunk' show that none of its
+  // 'numRows' rows passes the filter.
+  bool testStatistics(const thrift::ColumnChunk& chunk, int64_t numRows) const;
+
+  // Starts reading 'chunk' of the next row group from 'stream'.
+  // 'columnIndex' is the page index of the chunk if the file has one.
+  void startColumnChunk(
+      const thrift::ColumnChunk& chunk,
+      int64_t numRows,
+      std::unique_ptr<dwrf::SeekableInputStream> stream,
+      std::unique_ptr<thrift::ColumnIndex> columnIndex);
+
+  // Returns false if all data pages of the current column chunk are
+  // dictionary encoded and no dictionary entry and no null passes the
+  // filter. Reads the dictionary page.
+  virtual bool testDictionary() = 0;
+
+  // Reads 'rows', which are relative to 'offset' in the current column
+  // chunk. The rows that pass the filter are in outputRows()
+  // afterwards. Rows must be read in ascending order.
+  virtual void read(int64_t offset, RowSet rows) = 0;
+
+  RowSet outputRows() const {
+    return RowSet(outputRows_.data(), numOutputRows_);
+  }
+
+  // Sets 'result' to the values of 'rows', which must be a subset of the
+  // rows passed to the last read() and of outputRows().
+  virtual void getValues(RowSet rows, VectorPtr* result) = 0;
+
+  // Discards cached filter results. Called when the filter changes.
+  virtual void resetFilterCaches() = 0;
+
+  // Number of pages skipped because their statistics showed that no row
+  // passes the filter.
+  uint64_t numFilteredPages() const {
+    return numFilteredPages_ +
+        (pageReader_ ? pageReader_->numFilteredPages() : 0);
+  }
+
+ protected:
+  // Called by startColumnChunk() to reset state that is specific to a
+  // column chunk.
+  virtual void resetColumnChunk() = 0;
+
+  // Returns false if the filter cannot pass any value of a chunk or page
+  // with statistics 'range'.
+  bool testRange(const StatisticsRange& range) const;
+
+  // Sets up 'outputRows_' for reading up to 'numRows' rows.
+  void prepareRead(int32_t numRows) {
+    outputRows_.resize(numRows);
+    numOutputRows_ = 0;
+  }
+
+  const TypePtr type_;
+  const thrift::Type::type physicalType_;
+  // True if the column has definition levels.
+  const bool isOptional_;
+  common::ScanSpec* const scanSpec_;
+  memory::MemoryPool& pool_;
+  std::unique_ptr<PageReader> pageReader_;
+  // True if all data pages of the current column chunk use the dictionary.
+  bool allPagesDictionaryEncoded_{false};
+  // Null count of the current column chunk if recorded.
+  std::optional<int64_t> chunkNumNulls_;
+  raw_vector<vector_size_t> outputRows_;
+  int32_t numOutputRows_{0};
+  // Filtered pages of column chunks before the current one.
+  uint64_t numFilteredPages_{0};
+};
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,406 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/ParquetReader.h"
+#include "velox/dwio/parquet/reader/ParquetColumnReader.h"
+
+#include <numeric>
+
+namespace facebook::velox::parquet {
+
+namespace {
+
+// Bytes read from the end of the file to get the footer in one read in
+// most cases.
+constexpr uint64_t kFooterReadSize = 64 << 10;
+constexpr char kMagic[] = "PAR1";
+constexpr int32_t kMagicSize = 4;
+
+TypePtr toVeloxType(const thrift::SchemaElement& element) {
+  VELOX_USER_CHECK(
+      element.__isset.type && element.num_children == 0,
+      "Nested Parquet columns are not supported: {}",
+      element.name);
+  VELOX_USER_CHECK_NE(
+      element.repetition_type,
+      thrift::FieldRepetitionType::REPEATED,
+      "Repeated Parquet columns are not supported: {}",
+      element.name);
+  std::optional<thrift::ConvertedType::type> convertedType;
+  if (element.__isset.converted_type) {
+    convertedType = element.converted_type;
+  }
+  switch (element.type) {
+    case thrift::Type::BOOLEAN:
+      return BOOLEAN();
+    case thrift::Type::INT32:
+      if (!convertedType.has_value()) {
+        return INTEGER();
+      }
+      switch (convertedType.value()) {
+        case thrift::ConvertedType::INT_8:
+          return TINYINT();
+        case thrift::ConvertedType::INT_16:
+          return SMALLINT();
+        case thrift::ConvertedType::INT_32:
+          return INTEGER();
+        default:
+          break;
+      }
+      break;
+    case thrift::Type::INT64:
+      if (!convertedType.has_value() ||
+          convertedType.value() == thrift::ConvertedType::INT_64) {
+        return BIGINT();
+      }
+      break;
+    case thrift::Type::INT96:
+      return TIMESTAMP();
+    case thrift::Type::FLOAT:
+      return REAL();
+    case thrift::Type::DOUBLE:
+      return DOUBLE();
+    case thrift::Type::BYTE_ARRAY:
+      if (!convertedType.has_value()) {
+        return VARBINARY();
+      }
+      switch (convertedType.value()) {
+        case thrift::ConvertedType::UTF8:
+        case thrift::ConvertedType::ENUM:
+        case thrift::ConvertedType::JSON:
+          return VARCHAR();
+        default:
+          break;
+      }
+      break;
+    default:
+      break;
+  }
+  VELOX_UNSUPPORTED(
+      "Unsupported Parquet column type {} with converted type {}: {}",
+      static_cast<int32_t>(element.type),
+      convertedType.has_value() ? static_cast<int32_t>(convertedType.value())
+                                : -1,
+      element.name);
+}
+
+// Returns the offset of the first page of a column chunk.
+int64_t chunkStart(const thrift::ColumnMetaData& metaData) {
+  if (metaData.__isset.dictionary_page_offset &&
+      metaData.dictionary_page_offset > 0) {
+    return std::min(metaData.dictionary_page_offset, metaData.data_page_offset);
+  }
+  return metaData.data_page_offset;
+}
+
+} // namespace
+
+ParquetReader::ParquetReader(
+    std::unique_ptr<dwio::common::InputStream> stream,
+    const dwio::common::ReaderOptions& options)
+    : pool_(options.getMemoryPool()),
+      stream_(std::move(stream)),
+      bufferedInputFactory_(
+          options.getBufferedInputFactory()
+              ? options.getBufferedInputFactory()
+              : dwrf::BufferedInputFactory::baseFactory()),
+      dataCacheConfig_(options.getDataCacheConfig()) {
+  readFooter();
+  auto& schema = fileMetaData_->schema;
+  VELOX_CHECK(!schema.empty(), "Parquet file has no schema");
+  std::vector<std::string> names;
+  std::vector<TypePtr> types;
+  for (auto i = 1; i < schema.size(); ++i) {
+    names.push_back(schema[i].name);
+    types.push_back(toVeloxType(schema[i]));
+  }
+  VELOX_USER_CHECK_EQ(
+      names.size(),
+      static_cast<size_t>(schema[0].num_children),
+      "Nested Parquet columns are not supported");
+  rowType_ = ROW(std::move(names), std::move(types));
+}
+
+ParquetReader::~ParquetReader() = default;
+
+void ParquetReader::readFooter() {
+  auto fileLength = stream_->getLength();
+  VELOX_CHECK_GE(
+      fileLength, 2 * kMagicSize + sizeof(uint32_t), "Parquet file too short");
+  auto readSize = std::min(fileLength, kFooterReadSize);
+  std::string tail(readSize, '\0');
+  stream_->read(
+      tail.data(),
+      readSize,
+      fileLength - readSize,
+      dwio::common::LogType::FOOTER);
+  VELOX_CHECK_EQ(
+      tail.substr(readSize - kMagicSize),
+      kMagic,
+      "No Parquet magic number at end of file");
+  uint64_t metadataLength = folly::loadUnaligned<uint32_t>(
+      tail.data() + readSize - kMagicSize - sizeof(uint32_t));
+  auto footerLength = metadataLength + kMagicSize + sizeof(uint32_t);
+  VELOX_CHECK_LE(
+      footerLength + kMagicSize, fileLength, "Bad Parquet footer length");
+  std::string copy;
+  const char* metadata;
+  if (footerLength <= readSize) {
+    metadata = tail.data() + readSize - footerLength;
+  } else {
+    copy.resize(metadataLength);
+    stream_->read(
+        copy.data(),
+        metadataLength,
+        fileLength - footerLength,
+        dwio::common::LogType::FOOTER);
+    metadata = copy.data();
+  }
+  fileMetaData_ = std::make_unique<thrift::FileMetaData>();
+  deserializeThrift(metadata, metadataLength, fileMetaData_.get());
+}
+
+uint64_t ParquetReader::numberOfRows() const {
+  return fileMetaData_->num_rows;
+}
+
+std::unique_ptr<ParquetRowReader> ParquetReader::createRowReader(
+    const dwio::common::RowReaderOptions& options,
+    common::ScanSpec* scanSpec) const {
+  return std::make_unique<ParquetRowReader>(*this, options, scanSpec);
+}
+
+std::unique_ptr<dwrf::BufferedInput> ParquetReader::makeBufferedInput() const {
+  return bufferedInputFactory_->create(*stream_, pool_, dataCacheConfig_.get());
+}
+
+ParquetRowReader::ParquetRowReader(
+    const ParquetReader& reader,
+    const dwio::common::RowReaderOptions& options,
+    common::ScanSpec* scanSpec)
+    : reader_(reader), scanSpec_(scanSpec) {
+  auto& fileMetaData = reader_.fileMetaData();
+  auto& rowType = reader_.rowType();
+  for (auto i = 0; i < fileMetaData.row_groups.size(); ++i) {
+    auto& rowGroup = fileMetaData.row_groups[i];
+    if (rowGroup.columns.empty()) {
+      continue;
+    }
+    // A row group belongs to the split in which its first page starts.
+    uint64_t start = chunkStart(rowGroup.columns[0].meta_data);
+    if (start >= options.getOffset() &&
+        start - options.getOffset() < options.getLength()) {
+      rowGroups_.push_back(i);
+    }
+  }
+  columnReaders_.resize(rowType->size());
+  for (auto& childSpec : scanSpec_->children()) {
+    if (childSpec->isConstant()) {
+      continue;
+    }
+    auto index = rowType->getChildIdx(childSpec->fieldName());
+    childSpec->setSubscript(index);
+    columnReaders_[index] = ParquetColumnReader::create(
+        rowType->childAt(index),
+        fileMetaData.schema[index + 1],
+        childSpec.get(),
+        reader_.memoryPool());
+  }
+}
+
+ParquetRowReader::~ParquetRowReader() = default;
+
+uint64_t ParquetRowReader::next(uint64_t size, VectorPtr& result) {
+  if (filtersChanged_) {
+    filtersChanged_ = false;
+    if (rowGroupOffset_ < rowsInRowGroup_ && !testCurrentRowGroup()) {
+      rowGroupOffset_ = rowsInRowGroup_;
+      ++skippedRowGroups_;
+    }
+  }
+  if (!advanceToRowGroup()) {
+    return 0;
+  }
+  auto numRows = std::min<int64_t>(size, rowsInRowGroup_ - rowGroupOffset_);
+  readRows(numRows, result);
+  rowGroupOffset_ += numRows;
+  return numRows;
+}
+
+void ParquetRowReader::resetFilterCaches() {
+  for (auto& reader : columnReaders_) {
+    if (reader) {
+      reader->resetFilterCaches();
+    }
+  }
+  filtersChanged_ = true;
+}
+
+uint64_t ParquetRowReader::skippedPages() const {
+  uint64_t numPages = 0;
+  for (auto& reader : columnReaders_) {
+    if (reader) {
+      numPages += reader->numFilteredPages();
+    }
+  }
+  return numPages;
+}
+
+bool ParquetRowReader::advanceToRowGroup() {
+  while (rowGroupOffset_ >= rowsInRowGroup_) {
+    if (nextRowGroup_ >= rowGroups_.size()) {
+      return false;
+    }
+    auto& rowGroup =
+        reader_.fileMetaData().row_groups[rowGroups_[nextRowGroup_++]];
+    rowGroupOffset_ = 0;
+    rowsInRowGroup_ = 0;
+    if (!testStatistics(rowGroup) || !loadRowGroup(rowGroup)) {
+      ++skippedRowGroups_;
+      continue;
+    }
+    rowsInRowGroup_ = rowGroup.num_rows;
+  }
+  return true;
+}
+
+bool ParquetRowReader::testStatistics(const thrift::RowGroup& rowGroup) const {
+  for (auto& childSpec : scanSpec_->children()) {
+    if (childSpec->isConstant() || !childSpec->filter()) {
+      continue;
+    }
+    auto index = childSpec->subscript();
+    if (!columnReaders_[index]->testStatistics(
+            rowGroup.columns[index], rowGroup.num_rows)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ParquetRowReader::loadRowGroup(const thrift::RowGroup& rowGroup) {
+  // Drop the streams of the previous row group before loading new ones.
+  input_.reset();
+  input_ = reader_.makeBufferedInput();
+  std::vector<std::unique_ptr<dwrf::SeekableInputStream>> streams(
+      columnReaders_.size());
+  std::vector<std::unique_ptr<dwrf::SeekableInputStream>> indexStreams(
+      columnReaders_.size());
+  for (auto i = 0; i < columnReaders_.size(); ++i) {
+    if (!columnReaders_[i]) {
+      continue;
+    }
+    auto& chunk = rowGroup.columns[i];
+    VELOX_USER_CHECK(
+        !chunk.__isset.file_path, "External Parquet column chunks");
+    auto start = chunkStart(chunk.meta_data);
+    streams[i] =
+        input_->enqueue({static_cast<uint64_t>(start),
+                         static_cast<uint64_t>(
+                             chunk.meta_data.total_compressed_size)});
+    if (columnReaders_[i]->scanSpec()->filter() &&
+        chunk.__isset.column_index_offset) {
+      indexStreams[i] =
+          input_->enqueue({static_cast<uint64_t>(chunk.column_index_offset),
+                           static_cast<uint64_t>(chunk.column_index_length)});
+    }
+  }
+  input_->load(dwio::common::LogType::STREAM);
+  bool passed = true;
+  for (auto i = 0; i < columnReaders_.size(); ++i) {
+    if (!columnReaders_[i]) {
+      continue;
+    }
+    std::unique_ptr<thrift::ColumnIndex> columnIndex;
+    if (indexStreams[i]) {
+      std::string data;
+      const void* buffer;
+      int32_t size;
+      while (indexStreams[i]->Next(&buffer, &size)) {
+        data.append(reinterpret_cast<const char*>(buffer), size);
+      }
+      columnIndex = std::make_unique<thrift::ColumnIndex>();
+      deserializeThrift(data.data(), data.size(), columnIndex.get());
+    }
+    columnReaders_[i]->startColumnChunk(
+        rowGroup.columns[i],
+        rowGroup.num_rows,
+        std::move(streams[i]),
+        std::move(columnIndex));
+    passed = passed && columnReaders_[i]->testDictionary();
+  }
+  return passed;
+}
+
+bool ParquetRowReader::testCurrentRowGroup() {
+  if (!testStatistics(
+          reader_.fileMetaData().row_groups[rowGroups_[nextRowGroup_ - 1]])) {
+    return false;
+  }
+  for (auto& reader : columnReaders_) {
+    if (reader && !reader->testDictionary()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ParquetRowReader::readRows(int32_t numRows, VectorPtr& result) {
+  rows_.resize(numRows);
+  std::iota(rows_.data(), rows_.data() + numRows, 0);
+  scanSpec_->newRead();
+  RowSet activeRows = rows_;
+  auto& childSpecs = scanSpec_->children();
+  for (auto& childSpec : childSpecs) {
+    if (childSpec->isConstant() || !childSpec->hasFilter()) {
+      continue;
+    }
+    auto reader = columnReaders_[childSpec->subscript()].get();
+    {
+      SelectivityTimer timer(childSpec->selectivity(), activeRows.size());
+      reader->read(rowGroupOffset_, activeRows);
+      activeRows = reader->outputRows();
+      childSpec->selectivity().addOutput(activeRows.size());
+    }
+    if (activeRows.empty()) {
+      break;
+    }
+  }
+  auto resultRow = result->as<RowVector>();
+  VELOX_CHECK(resultRow, "Parquet reader expects a result of type ROW");
+  resultRow->resize(activeRows.size());
+  if (activeRows.empty()) {
+    return;
+  }
+  for (auto& childSpec : childSpecs) {
+    if (!childSpec->projectOut()) {
+      continue;
+    }
+    auto channel = childSpec->channel();
+    if (childSpec->isConstant()) {
+      resultRow->childAt(channel) = BaseVector::wrapInConstant(
+          activeRows.size(), 0, childSpec->constantValue());
+      continue;
+    }
+    auto reader = columnReaders_[childSpec->subscript()].get();
+    if (!childSpec->hasFilter()) {
+      reader->read(rowGroupOffset_, activeRows);
+    }
+    reader->getValues(activeRows, &resultRow->childAt(channel));
+  }
+}
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/common/base/RawVector.h"
+#include "velox/dwio/common/InputStream.h"
+#include "velox/dwio/common/Options.h"
+#include "velox/dwio/dwrf/common/BufferedInput.h"
+#include "velox/dwio/dwrf/reader/ScanSpec.h"
+#include "velox/vector/ComplexVector.h"
+
+namespace duckdb_parquet::format {
+class FileMetaData;
+class RowGroup;
+} // namespace duckdb_parquet::format
+
+namespace facebook::velox::parquet {
+
+class ParquetColumnReader;
+class ParquetReader;
+
+// Reads the row groups of a Parquet file that start in the range given by
+// RowReaderOptions. The columns to read, their filters and their output
+// channels are given by a ScanSpec, as for the selective DWRF reader. Row
+// groups are skipped if the column statistics or, for fully dictionary
+// encoded columns, the dictionaries show that no row passes the
+// filters. Pages are skipped based on the page index or page statistics.
+class ParquetRowReader {
+ public:
+  // 'reader' and 'scanSpec' must outlive 'this'.
+  ParquetRowReader(
+      const ParquetReader& reader,
+      const dwio::common::RowReaderOptions& options,
+      common::ScanSpec* scanSpec);
+
+  ~ParquetRowReader();
+
+  // Reads up to 'size' rows of the current row group into 'result', which
+  // must be a RowVector. Returns the number of rows scanned, which may be
+  // more than the size of 'result' if there are filters. Returns 0 at end.
+  uint64_t next(uint64_t size, VectorPtr& result);
+
+  // Discards filter results cached by the column readers and checks the
+  // statistics and dictionaries of the current row group again before the
+  // next batch. Called after a filter in the ScanSpec changes.
+  void resetFilterCaches();
+
+  // Number of row groups skipped because of statistics or dictionaries.
+  uint64_t skippedRowGroups() const {
+    return skippedRowGroups_;
+  }
+
+  // Number of data pages skipped because of page statistics.
+  uint64_t skippedPages() const;
+
+ private:
+  // Positions 'this' on the next row group that has rows left to read and
+  // is not excluded by the filters. Returns false at end.
+  bool advanceToRowGroup();
+
+  // Returns false if the statistics of 'rowGroup' show that no row passes
+  // the filters.
+  bool testStatistics(const duckdb_parquet::format::RowGroup& rowGroup) const;
+
+  // Loads the column chunks of 'rowGroup' that are read. Returns false if
+  // a filter rejects all entries of a dictionary.
+  bool loadRowGroup(const duckdb_parquet::format::RowGroup& rowGroup);
+
+  // Returns false if the filters reject the rest of the current row group
+  // based on its statistics or dictionaries.
+  bool testCurrentRowGroup();
+
+  void readRows(int32_t numRows, VectorPtr& result);
+
+  const ParquetReader& reader_;
+  common::ScanSpec* const scanSpec_;
+  // Row groups in the range, in file order.
+  std::vector<int32_t> rowGroups_;
+  int32_t nextRowGroup_{0};
+  // Rows in the current row group and the number of rows read from it.
+  int64_t rowsInRowGroup_{0};
+  int64_t rowGroupOffset_{0};
+  std::unique_ptr<dwrf::BufferedInput> input_;
+  // Reader for each column of the file. nullptr for columns that are not
+  // read.
+  std::vector<std::unique_ptr<ParquetColumnReader>> columnReaders_;
+  raw_vector<vector_size_t> rows_;
+  // True if filters changed since the current row group was loaded.
+  bool filtersChanged_{false};
+  uint64_t skippedRowGroups_{0};
+};
+
+// Reader for Parquet files with flat schemas.
+class ParquetReader {
+ public:
+  ParquetReader(
+      std::unique_ptr<dwio::common::InputStream> stream,
+      const dwio::common::ReaderOptions& options);
+
+  ~ParquetReader();
+
+  const RowTypePtr& rowType() const {
+    return rowType_;
+  }
+
+  uint64_t numberOfRows() const;
+
+  const duckdb_parquet::format::FileMetaData& fileMetaData() const {
+    return *fileMetaData_;
+  }
+
+  std::unique_ptr<ParquetRowReader> createRowReader(
+      const dwio::common::RowReaderOptions& options,
+      common::ScanSpec* scanSpec) const;
+
+  // Returns a BufferedInput for loading the column chunks of a row group.
+  std::unique_ptr<dwrf::BufferedInput> makeBufferedInput() const;
+
+  memory::MemoryPool& memoryPool() const {
+    return pool_;
+  }
+
+ private:
+  void readFooter();
+
+  memory::MemoryPool& pool_;
+  std::unique_ptr<dwio::common::InputStream> stream_;
+  dwrf::BufferedInputFactory* const bufferedInputFactory_;
+  const std::shared_ptr<dwio::common::DataCacheConfig> dataCacheConfig_;
+  std::unique_ptr<duckdb_parquet::format::FileMetaData> fileMetaData_;
+  RowTypePtr rowType_;
+};
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <folly/lang/Bits.h>
+#include "velox/common/base/Exceptions.h"
+
+namespace facebook::velox::parquet {
+
+// Decoder for the RLE / bit-packing hybrid encoding used for Parquet
+// definition levels and dictionary indices. A run is either a value
+// repeated a number of times or a sequence of groups of 8 values of
+// 'bitWidth' bits each, packed least significant bit first.
+class RleBpDecoder {
+ public:
+  RleBpDecoder(const char* begin, const char* end, uint8_t bitWidth)
+      : current_(begin),
+        end_(end),
+        bitWidth_(bitWidth),
+        bytesPerRepeat_((bitWidth + 7) / 8),
+        mask_(bitWidth == 32 ? ~0U : (1U << bitWidth) - 1) {
+    VELOX_CHECK_LE(bitWidth, 32, "Bad RLE/bit packing bit width");
+  }
+
+  // Decodes the next 'numValues' values into 'values'.
+  void next(int32_t* values, int32_t numValues) {
+    int32_t numDone = 0;
+    while (numDone < numValues) {
+      if (!remainingValues_) {
+        readHeader();
+      }
+      auto numRun = std::min<int32_t>(remainingValues_, numValues - numDone);
+      if (repeating_) {
+        std::fill(values + numDone, values + numDone + numRun, value_);
+      } else {
+        for (auto i = 0; i < numRun; ++i) {
+          values[numDone + i] = unpack(bitOffset_);
+          bitOffset_ += bitWidth_;
+        }
+      }
+      numDone += numRun;
+      remainingValues_ -= numRun;
+    }
+  }
+
+  // Skips the next 'numValues' values.
+  void skip(int32_t numValues) {
+    while (numValues > 0) {
+      if (!remainingValues_) {
+        readHeader();
+      }
+      auto numRun = std::min<int32_t>(remainingValues_, numValues);
+      if (!repeating_) {
+        bitOffset_ += static_cast<uint64_t>(numRun) * bitWidth_;
+      }
+      numValues -= numRun;
+      remainingValues_ -= numRun;
+    }
+  }
+
+ private:
+  void readHeader() {
+    uint64_t header = 0;
+    int32_t shift = 0;
+    for (;;) {
+      VELOX_CHECK_LT(current_, end_, "RLE/bit packed run header past end");
+      VELOX_CHECK_LT(shift, 64, "Bad RLE/bit packed run header");
+      auto byte = static_cast<uint8_t>(*current_++);
+      header |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) {
+        break;
+      }
+      shift += 7;
+    }
+    repeating_ = !(header & 1);
+    if (repeating_) {
+      remainingValues_ = header >> 1;
+      VELOX_CHECK_LE(current_ + bytesPerRepeat_, end_);
+      value_ = 0;
+      memcpy(&value_, current_, bytesPerRepeat_);
+      current_ += bytesPerRepeat_;
+    } else {
+      auto numGroups = header >> 1;
+      remainingValues_ = numGroups * 8;
+      literalStart_ = current_;
+      bitOffset_ = 0;
+      // The last group may be truncated if the values end before it.
+      current_ += std::min<uint64_t>(end_ - current_, numGroups * bitWidth_);
+    }
+    VELOX_CHECK_GT(remainingValues_, 0, "Empty RLE/bit packed run");
+  }
+
+  // Returns the 'bitWidth_' bits starting 'bit' bits after the start of the
+  // current bit packed run.
+  int32_t unpack(uint64_t bit) const {
+    // A truncated or malformed run can have fewer bytes than values.
+    VELOX_CHECK_LT(
+        bit >> 3,
+        static_cast<uint64_t>(end_ - literalStart_),
+        "Bit packed run past end of RLE/bit packed data");
+    auto byte = literalStart_ + (bit >> 3);
+    uint64_t word;
+    if (byte + sizeof(uint64_t) <= end_) {
+      word = folly::loadUnaligned<uint64_t>(byte);
+    } else {
+      word = 0;
+      memcpy(&word, byte, end_ - byte);
+    }
+    return (word >> (bit & 7)) & mask_;
+  }
+
+  const char* current_;
+  const char* const end_;
+  const uint8_t bitWidth_;
+  const uint8_t bytesPerRepeat_;
+  const uint32_t mask_;
+  // Values left in the current run.
+  uint64_t remainingValues_{0};
+  bool repeating_{false};
+  // The value of a repeated run.
+  int32_t value_{0};
+  // First byte of a bit packed run and the bit offset of the next value.
+  const char* literalStart_{nullptr};
+  uint64_t bitOffset_{0};
+};
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/external/duckdb/parquet-amalgamation.hpp"
+
+namespace facebook::velox::parquet {
+
+namespace thrift = duckdb_parquet::format;
+
+// Deserializes a Thrift compact protocol encoded 'object' from the 'size'
+// bytes at 'data'. Returns the number of bytes consumed. Throws
+// duckdb_apache::thrift::transport::TTransportException if the object
+// extends past the end of the data.
+template <typename T>
+uint32_t deserializeThrift(const char* data, uint64_t size, T* object) {
+  using Transport = duckdb_apache::thrift::transport::TMemoryBuffer;
+  auto transport = std::make_shared<Transport>(
+      reinterpret_cast<uint8_t*>(const_cast<char*>(data)),
+      static_cast<uint32_t>(size));
+  duckdb_apache::thrift::protocol::TCompactProtocolT<Transport> protocol(
+      transport);
+  return object->read(&protocol);
+}
+
+} // namespace facebook::velox::parquet
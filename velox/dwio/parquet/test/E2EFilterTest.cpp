@@ -0,0 +1,398 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Random.h>
+#include <gtest/gtest.h>
+
+#include "velox/dwio/common/MemoryInputStream.h"
+#include "velox/dwio/dwrf/test/utils/BatchMaker.h"
+#include "velox/dwio/parquet/reader/ParquetReader.h"
+#include "velox/dwio/parquet/test/ParquetTestWriter.h"
+#include "velox/type/Filter.h"
+#include "velox/vector/FlatVector.h"
+
+namespace facebook::velox::parquet::test {
+
+using namespace facebook::velox::common;
+using dwio::common::MemoryInputStream;
+using velox::test::BatchMaker;
+
+// Identifies a row of the test data by batch and row in batch.
+using RowId = std::pair<int32_t, vector_size_t>;
+
+template <TypeKind Kind>
+bool testValue(const Filter& filter, const BaseVector& vector, int32_t row) {
+  using T = typename TypeTraits<Kind>::NativeType;
+  return applyFilter(filter, vector.as<SimpleVector<T>>()->valueAt(row));
+}
+
+template <TypeKind Kind>
+std::unique_ptr<Filter> makeRangeFilter(
+    const std::vector<RowVectorPtr>& batches,
+    int32_t column,
+    float startPct,
+    float selectPct) {
+  using T = typename TypeTraits<Kind>::NativeType;
+  std::vector<T> values;
+  for (auto& batch : batches) {
+    auto vector = batch->childAt(column)->as<SimpleVector<T>>();
+    for (auto i = 0; i < vector->size(); i += 7) {
+      if (!vector->isNullAt(i)) {
+        values.push_back(vector->valueAt(i));
+      }
+    }
+  }
+  if (values.empty()) {
+    return std::make_unique<IsNull>();
+  }
+  std::sort(values.begin(), values.end());
+  auto valueAtPct = [&](float pct) {
+    return values[std::min<int32_t>(
+        values.size() - 1, values.size() * pct / 100)];
+  };
+  T lower = valueAtPct(startPct);
+  T upper = valueAtPct(startPct + selectPct);
+  bool nullAllowed = selectPct > 25;
+  if constexpr (std::is_same_v<T, bool>) {
+    return std::make_unique<BoolValue>(upper, nullAllowed);
+  } else if constexpr (std::is_integral_v<T>) {
+    return std::make_unique<BigintRange>(lower, upper, nullAllowed);
+  } else if constexpr (std::is_same_v<T, float>) {
+    return std::make_unique<FloatRange>(
+        lower, false, false, upper, false, false, nullAllowed);
+  } else if constexpr (std::is_same_v<T, double>) {
+    return std::make_unique<DoubleRange>(
+        lower, false, false, upper, false, false, nullAllowed);
+  } else if constexpr (std::is_same_v<T, StringView>) {
+    return std::make_unique<BytesRange>(
+        std::string(lower),
+        false,
+        false,
+        std::string(upper),
+        false,
+        false,
+        nullAllowed);
+  } else {
+    return std::make_unique<TimestampRange>(lower, upper, nullAllowed);
+  }
+}
+
+class E2EFilterTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    pool_ = memory::getDefaultScopedMemoryPool();
+    rng_.seed(1);
+  }
+
+  void makeDataset(const RowTypePtr& rowType, int32_t batchSize = 10'000) {
+    rowType_ = rowType;
+    batches_.clear();
+    for (auto i = 0; i < 4; ++i) {
+      batches_.push_back(std::static_pointer_cast<RowVector>(
+          BatchMaker::createBatch(rowType_, batchSize, *pool_, rng_)));
+    }
+  }
+
+  // Sets column 'name' to ascending integers starting at 0.
+  void makeSequence(const std::string& name) {
+    auto column = rowType_->getChildIdx(name);
+    int64_t counter = 0;
+    for (auto& batch : batches_) {
+      auto values = batch->childAt(column)->asFlatVector<int64_t>();
+      for (auto i = 0; i < batch->size(); ++i) {
+        values->set(i, counter++);
+      }
+    }
+  }
+
+  // Replaces non-null values of string column 'name' with a few distinct
+  // values so that dictionaries are small.
+  void makeLowCardinality(
+      const std::string& name,
+      const std::vector<std::string>& values) {
+    auto column = rowType_->getChildIdx(name);
+    for (auto& batch : batches_) {
+      auto strings = batch->childAt(column)->asFlatVector<StringView>();
+      for (auto i = 0; i < batch->size(); ++i) {
+        if (!strings->isNullAt(i)) {
+          strings->set(i, StringView(values[i % values.size()]));
+        }
+      }
+    }
+  }
+
+  void write(const WriterOptions& options) {
+    data_ = writeParquet(batches_, options);
+  }
+
+  std::unique_ptr<ScanSpec> makeScanSpec(
+      std::unordered_map<std::string, std::unique_ptr<Filter>> filters) {
+    auto spec = std::make_unique<ScanSpec>("root");
+    for (auto i = 0; i < rowType_->size(); ++i) {
+      auto fieldSpec =
+          spec->getOrCreateChild(Subfield(rowType_->nameOf(i)));
+      fieldSpec->setProjectOut(true);
+      fieldSpec->setExtractValues(true);
+      fieldSpec->setChannel(i);
+    }
+    for (auto& [name, filter] : filters) {
+      spec->getOrCreateChild(Subfield(name))->setFilter(std::move(filter));
+    }
+    return spec;
+  }
+
+  // Returns the rows that pass the filters in 'spec'.
+  std::vector<RowId> expectedHits(ScanSpec& spec) {
+    std::vector<RowId> hits;
+    for (auto i = 0; i < batches_.size(); ++i) {
+      auto& batch = batches_[i];
+      for (auto row = 0; row < batch->size(); ++row) {
+        bool pass = true;
+        for (auto column = 0; column < rowType_->size() && pass; ++column) {
+          auto filter =
+              spec.childByName(rowType_->nameOf(column))->filter();
+          if (!filter) {
+            continue;
+          }
+          auto& vector = *batch->childAt(column);
+          pass = vector.isNullAt(row)
+              ? filter->testNull()
+              : VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH(
+                    testValue, vector.typeKind(), *filter, vector, row);
+        }
+        if (pass) {
+          hits.emplace_back(i, row);
+        }
+      }
+    }
+    return hits;
+  }
+
+  // Reads the file with 'spec' in batches of 1000 rows and checks that the
+  // result consists of 'hits'. Returns the row reader for checking its
+  // stats.
+  std::unique_ptr<ParquetRowReader> readAndCheck(
+      ScanSpec* spec,
+      const std::vector<RowId>& hits) {
+    dwio::common::ReaderOptions readerOpts;
+    reader_ = std::make_unique<ParquetReader>(
+        std::make_unique<MemoryInputStream>(data_.data(), data_.size()),
+        readerOpts);
+    EXPECT_EQ(*reader_->rowType(), *rowType_);
+    auto rowReader =
+        reader_->createRowReader(dwio::common::RowReaderOptions(), spec);
+    auto batch = BaseVector::create(rowType_, 1, pool_.get());
+    size_t numHits = 0;
+    while (rowReader->next(1000, batch)) {
+      for (auto i = 0; i < batch->size(); ++i) {
+        EXPECT_LT(numHits, hits.size());
+        if (numHits >= hits.size()) {
+          return rowReader;
+        }
+        auto [batchIndex, row] = hits[numHits++];
+        EXPECT_TRUE(batch->equalValueAt(batches_[batchIndex].get(), i, row))
+            << "Content mismatch at " << numHits - 1 << ": expected "
+            << batches_[batchIndex]->toString(row) << " actual "
+            << batch->toString(i);
+      }
+    }
+    EXPECT_EQ(numHits, hits.size());
+    return rowReader;
+  }
+
+  void testRandomFilters(int32_t numCombinations) {
+    for (auto i = 0; i < numCombinations; ++i) {
+      std::unordered_map<std::string, std::unique_ptr<Filter>> filters;
+      std::string description;
+      for (auto column = 0; column < rowType_->size(); ++column) {
+        if (folly::Random::rand32(rng_) % 3) {
+          continue;
+        }
+        auto& name = rowType_->nameOf(column);
+        auto kind = rowType_->childAt(column)->kind();
+        auto category = folly::Random::rand32(rng_) % 10;
+        if (category == 0) {
+          filters[name] = std::make_unique<IsNull>();
+        } else if (category == 1) {
+          filters[name] = std::make_unique<IsNotNull>();
+        } else {
+          float selectPct = category * 10;
+          float startPct = folly::Random::rand32(rng_) % (100 - category * 10);
+          filters[name] = VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH(
+              makeRangeFilter, kind, batches_, column, startPct, selectPct);
+        }
+        description += fmt::format(" {}: {}", name, filters[name]->toString());
+      }
+      SCOPED_TRACE(description);
+      auto spec = makeScanSpec(std::move(filters));
+      readAndCheck(spec.get(), expectedHits(*spec));
+    }
+  }
+
+  std::unique_ptr<memory::ScopedMemoryPool> pool_;
+  std::mt19937 rng_;
+  RowTypePtr rowType_;
+  std::vector<RowVectorPtr> batches_;
+  std::string data_;
+  std::unique_ptr<ParquetReader> reader_;
+};
+
+TEST_F(E2EFilterTest, allTypes) {
+  makeDataset(
+      ROW({"b", "ti", "si", "i", "bi", "r", "d", "s", "ts"},
+          {BOOLEAN(),
+           TINYINT(),
+           SMALLINT(),
+           INTEGER(),
+           BIGINT(),
+           REAL(),
+           DOUBLE(),
+           VARCHAR(),
+           TIMESTAMP()}));
+  makeLowCardinality("s", {"apple", "banana", "a somewhat longer cherry"});
+  for (auto useDictionary : {true, false}) {
+    for (auto useDataPageV2 : {false, true}) {
+      for (auto compression :
+           {WriterOptions::Compression::kNone,
+            WriterOptions::Compression::kSnappy,
+            WriterOptions::Compression::kZstd}) {
+        SCOPED_TRACE(fmt::format(
+            "dictionary {} V2 {} compression {}",
+            useDictionary,
+            useDataPageV2,
+            static_cast<int32_t>(compression)));
+        WriterOptions options;
+        options.useDictionary = useDictionary;
+        options.useDataPageV2 = useDataPageV2;
+        options.compression = compression;
+        write(options);
+        auto spec = makeScanSpec({});
+        readAndCheck(spec.get(), expectedHits(*spec));
+        testRandomFilters(10);
+      }
+    }
+  }
+}
+
+TEST_F(E2EFilterTest, rowGroupStatistics) {
+  makeDataset(ROW({"id", "s"}, {BIGINT(), VARCHAR()}));
+  makeSequence("id");
+  WriterOptions options;
+  options.rowsInRowGroup = 10'000;
+  write(options);
+  std::unordered_map<std::string, std::unique_ptr<Filter>> filters;
+  filters["id"] = std::make_unique<BigintRange>(25'000, 25'100, false);
+  auto spec = makeScanSpec(std::move(filters));
+  auto rowReader = readAndCheck(spec.get(), expectedHits(*spec));
+  EXPECT_EQ(3, rowReader->skippedRowGroups());
+}
+
+TEST_F(E2EFilterTest, filterChange) {
+  makeDataset(ROW({"id", "s"}, {BIGINT(), VARCHAR()}));
+  makeSequence("id");
+  WriterOptions options;
+  options.rowsInRowGroup = 10'000;
+  write(options);
+  auto spec = makeScanSpec({});
+  reader_ = std::make_unique<ParquetReader>(
+      std::make_unique<MemoryInputStream>(data_.data(), data_.size()),
+      dwio::common::ReaderOptions());
+  auto rowReader =
+      reader_->createRowReader(dwio::common::RowReaderOptions(), spec.get());
+  auto batch = BaseVector::create(rowType_, 1, pool_.get());
+  ASSERT_EQ(1000, rowReader->next(1000, batch));
+
+  // A filter added in the middle of the first row group, as a dynamic filter
+  // would be, skips the rest of it.
+  spec->childByName("id")->setFilter(
+      std::make_unique<BigintRange>(25'000, 25'100, false));
+  rowReader->resetFilterCaches();
+  int64_t expected = 25'000;
+  while (rowReader->next(1000, batch)) {
+    auto ids = batch->as<RowVector>()->childAt(0)->as<SimpleVector<int64_t>>();
+    for (auto i = 0; i < batch->size(); ++i) {
+      ASSERT_EQ(expected++, ids->valueAt(i));
+    }
+  }
+  EXPECT_EQ(25'101, expected);
+  EXPECT_EQ(3, rowReader->skippedRowGroups());
+}
+
+TEST_F(E2EFilterTest, dictionary) {
+  makeDataset(ROW({"id", "s"}, {BIGINT(), VARCHAR()}));
+  makeLowCardinality("s", {"a", "c"});
+  WriterOptions options;
+  options.rowsInRowGroup = 10'000;
+  write(options);
+
+  // "b" is between the min and max of every row group but in no dictionary.
+  std::unordered_map<std::string, std::unique_ptr<Filter>> filters;
+  filters["s"] =
+      std::make_unique<BytesValues>(std::vector<std::string>{"b"}, false);
+  auto spec = makeScanSpec(std::move(filters));
+  auto rowReader = readAndCheck(spec.get(), expectedHits(*spec));
+  EXPECT_EQ(4, rowReader->skippedRowGroups());
+
+  filters["s"] =
+      std::make_unique<BytesValues>(std::vector<std::string>{"c"}, false);
+  spec = makeScanSpec(std::move(filters));
+  rowReader = readAndCheck(spec.get(), expectedHits(*spec));
+  EXPECT_EQ(0, rowReader->skippedRowGroups());
+
+  // Changing the filter between batches discards the cached results.
+  auto hits = expectedHits(*spec);
+  reader_ = std::make_unique<ParquetReader>(
+      std::make_unique<MemoryInputStream>(data_.data(), data_.size()),
+      dwio::common::ReaderOptions());
+  rowReader =
+      reader_->createRowReader(dwio::common::RowReaderOptions(), spec.get());
+  auto batch = BaseVector::create(rowType_, 1, pool_.get());
+  rowReader->next(1000, batch);
+  EXPECT_LT(0, batch->size());
+  spec->childByName("s")->setFilter(
+      std::make_unique<BytesValues>(std::vector<std::string>{"a"}, false));
+  rowReader->resetFilterCaches();
+  while (rowReader->next(1000, batch)) {
+    auto strings =
+        batch->as<RowVector>()->childAt(1)->asFlatVector<StringView>();
+    for (auto i = 0; i < batch->size(); ++i) {
+      EXPECT_EQ(StringView("a"), strings->valueAt(i));
+    }
+  }
+}
+
+TEST_F(E2EFilterTest, pageStatistics) {
+  makeDataset(ROW({"id", "d"}, {BIGINT(), DOUBLE()}));
+  makeSequence("id");
+  for (auto columnIndex : {false, true}) {
+    WriterOptions options;
+    options.rowsInRowGroup = 40'000;
+    options.rowsInPage = 1'000;
+    options.chunkStatistics = false;
+    options.pageStatistics = !columnIndex;
+    options.columnIndex = columnIndex;
+    write(options);
+    std::unordered_map<std::string, std::unique_ptr<Filter>> filters;
+    filters["id"] = std::make_unique<BigintRange>(5'500, 5'600, false);
+    auto spec = makeScanSpec(std::move(filters));
+    auto rowReader = readAndCheck(spec.get(), expectedHits(*spec));
+    EXPECT_EQ(0, rowReader->skippedRowGroups());
+    // Only the page with rows 5000-5999 of 'id' is decoded.
+    EXPECT_EQ(39, rowReader->skippedPages());
+  }
+}
+
+} // namespace facebook::velox::parquet::test
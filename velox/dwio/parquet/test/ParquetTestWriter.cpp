@@ -0,0 +1,541 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/test/ParquetTestWriter.h"
+#include "velox/dwio/parquet/reader/ThriftUtils.h"
+
+#include <folly/compression/Compression.h>
+
+namespace facebook::velox::parquet::test {
+
+namespace {
+
+using Transport = duckdb_apache::thrift::transport::TMemoryBuffer;
+
+template <typename T>
+std::string serialize(const T& object) {
+  auto transport = std::make_shared<Transport>();
+  duckdb_apache::thrift::protocol::TCompactProtocolT<Transport> protocol(
+      transport);
+  object.write(&protocol);
+  return transport->getBufferAsString();
+}
+
+template <typename T>
+void appendRaw(std::string& out, T value) {
+  out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void appendVarint(std::string& out, uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+// Encodes 'values' with the RLE / bit packing hybrid encoding. Runs of 8
+// or more equal values become RLE runs, the rest is bit packed.
+std::string encodeRleBp(const std::vector<int32_t>& values, int32_t bitWidth) {
+  std::string out;
+  std::vector<int32_t> literals;
+  auto flushLiterals = [&]() {
+    if (literals.empty()) {
+      return;
+    }
+    auto numGroups = (literals.size() + 7) / 8;
+    literals.resize(numGroups * 8, 0);
+    appendVarint(out, numGroups << 1 | 1);
+    uint64_t word = 0;
+    int32_t numBits = 0;
+    for (auto value : literals) {
+      word |= static_cast<uint64_t>(value) << numBits;
+      numBits += bitWidth;
+      while (numBits >= 8) {
+        out.push_back(static_cast<char>(word));
+        word >>= 8;
+        numBits -= 8;
+      }
+    }
+    literals.clear();
+  };
+  size_t i = 0;
+  while (i < values.size()) {
+    size_t run = 1;
+    while (i + run < values.size() && values[i + run] == values[i]) {
+      ++run;
+    }
+    // A repeat can start only after a whole number of bit packed groups.
+    size_t numPad = (8 - literals.size() % 8) % 8;
+    if (run >= numPad + 8) {
+      literals.insert(literals.end(), numPad, values[i]);
+      flushLiterals();
+      appendVarint(out, (run - numPad) << 1);
+      int32_t value = values[i];
+      out.append(reinterpret_cast<const char*>(&value), (bitWidth + 7) / 8);
+    } else {
+      literals.insert(literals.end(), run, values[i]);
+    }
+    i += run;
+  }
+  flushLiterals();
+  return out;
+}
+
+int32_t bitWidth(int32_t maxValue) {
+  int32_t width = 1;
+  while (width < 32 && (1L << width) <= maxValue) {
+    ++width;
+  }
+  return width;
+}
+
+thrift::Type::type physicalType(TypeKind kind) {
+  switch (kind) {
+    case TypeKind::BOOLEAN:
+      return thrift::Type::BOOLEAN;
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+      return thrift::Type::INT32;
+    case TypeKind::BIGINT:
+      return thrift::Type::INT64;
+    case TypeKind::REAL:
+      return thrift::Type::FLOAT;
+    case TypeKind::DOUBLE:
+      return thrift::Type::DOUBLE;
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return thrift::Type::BYTE_ARRAY;
+    case TypeKind::TIMESTAMP:
+      return thrift::Type::INT96;
+    default:
+      VELOX_UNSUPPORTED("Type not supported by test writer");
+  }
+}
+
+thrift::SchemaElement schemaElement(const std::string& name, TypeKind kind) {
+  thrift::SchemaElement element;
+  element.__set_name(name);
+  element.__set_type(physicalType(kind));
+  element.__set_repetition_type(thrift::FieldRepetitionType::OPTIONAL);
+  switch (kind) {
+    case TypeKind::TINYINT:
+      element.__set_converted_type(thrift::ConvertedType::INT_8);
+      break;
+    case TypeKind::SMALLINT:
+      element.__set_converted_type(thrift::ConvertedType::INT_16);
+      break;
+    case TypeKind::VARCHAR:
+      element.__set_converted_type(thrift::ConvertedType::UTF8);
+      break;
+    default:
+      break;
+  }
+  return element;
+}
+
+// Returns the PLAIN encoding of 'value'. Booleans take one byte here.
+template <typename T>
+std::string plain(T value) {
+  std::string out;
+  if constexpr (std::is_same_v<T, StringView>) {
+    appendRaw<uint32_t>(out, value.size());
+    out.append(value.data(), value.size());
+  } else if constexpr (std::is_same_v<T, Timestamp>) {
+    constexpr int64_t kSecondsPerDay = 86'400;
+    auto seconds = value.getSeconds();
+    auto days = seconds / kSecondsPerDay - (seconds % kSecondsPerDay < 0);
+    auto secondsInDay = seconds - days * kSecondsPerDay;
+    appendRaw<int64_t>(out, secondsInDay * 1'000'000'000 + value.getNanos());
+    appendRaw<int32_t>(out, days + 2'440'588);
+  } else if constexpr (std::is_same_v<T, bool>) {
+    appendRaw<uint8_t>(out, value);
+  } else if constexpr (std::is_integral_v<T> && sizeof(T) < sizeof(int32_t)) {
+    appendRaw<int32_t>(out, value);
+  } else {
+    appendRaw<T>(out, value);
+  }
+  return out;
+}
+
+// Min, max and null count of a page or column chunk.
+template <typename T>
+struct Stats {
+  std::optional<T> min;
+  std::optional<T> max;
+  int64_t numNulls{0};
+
+  void add(const std::optional<T>& value) {
+    if (!value.has_value()) {
+      ++numNulls;
+      return;
+    }
+    if (!min.has_value() || value.value() < min.value()) {
+      min = value;
+    }
+    if (!max.has_value() || max.value() < value.value()) {
+      max = value;
+    }
+  }
+
+  thrift::Statistics toThrift() const {
+    thrift::Statistics statistics;
+    statistics.__set_null_count(numNulls);
+    if (min.has_value() && !std::is_same_v<T, Timestamp>) {
+      auto minValue = plain(min.value());
+      auto maxValue = plain(max.value());
+      if constexpr (std::is_same_v<T, StringView>) {
+        // Strip the length.
+        minValue = minValue.substr(sizeof(uint32_t));
+        maxValue = maxValue.substr(sizeof(uint32_t));
+      }
+      statistics.__set_min_value(minValue);
+      statistics.__set_max_value(maxValue);
+    }
+    return statistics;
+  }
+};
+
+class ChunkWriter {
+ public:
+  ChunkWriter(const WriterOptions& options, std::string& file)
+      : options_(options), file_(file) {}
+
+  // Appends the column chunk with 'values' to the file and returns its
+  // metadata. Sets 'columnIndex' if pages have min and max.
+  template <typename T>
+  thrift::ColumnChunk write(
+      const std::string& name,
+      TypeKind kind,
+      const std::vector<std::optional<T>>& values,
+      thrift::ColumnIndex& columnIndex);
+
+ private:
+  std::string compress(const std::string& data) const {
+    switch (options_.compression) {
+      case WriterOptions::Compression::kNone:
+        return data;
+      case WriterOptions::Compression::kSnappy:
+        return folly::io::getCodec(folly::io::CodecType::SNAPPY)
+            ->compress(data);
+      case WriterOptions::Compression::kZstd:
+        return folly::io::getCodec(folly::io::CodecType::ZSTD)->compress(data);
+    }
+    VELOX_UNREACHABLE();
+  }
+
+  thrift::CompressionCodec::type codec() const {
+    switch (options_.compression) {
+      case WriterOptions::Compression::kNone:
+        return thrift::CompressionCodec::UNCOMPRESSED;
+      case WriterOptions::Compression::kSnappy:
+        return thrift::CompressionCodec::SNAPPY;
+      case WriterOptions::Compression::kZstd:
+        return thrift::CompressionCodec::ZSTD;
+    }
+    VELOX_UNREACHABLE();
+  }
+
+  // Appends a page with 'header' and uncompressed 'levels' followed by
+  // 'values', which are compressed. Returns the size of the page.
+  int64_t writePage(
+      thrift::PageHeader& header,
+      const std::string& levels,
+      const std::string& values);
+
+  const WriterOptions& options_;
+  std::string& file_;
+};
+
+int64_t ChunkWriter::writePage(
+    thrift::PageHeader& header,
+    const std::string& levels,
+    const std::string& values) {
+  auto data = header.type == thrift::PageType::DATA_PAGE_V2
+      ? levels + compress(values)
+      : compress(levels + values);
+  header.__set_uncompressed_page_size(levels.size() + values.size());
+  header.__set_compressed_page_size(data.size());
+  auto serialized = serialize(header);
+  file_ += serialized;
+  file_ += data;
+  return serialized.size() + data.size();
+}
+
+template <typename T>
+thrift::ColumnChunk ChunkWriter::write(
+    const std::string& name,
+    TypeKind kind,
+    const std::vector<std::optional<T>>& values,
+    thrift::ColumnIndex& columnIndex) {
+  constexpr bool kIsBool = std::is_same_v<T, bool>;
+  auto start = file_.size();
+  thrift::ColumnMetaData metaData;
+  metaData.__set_type(physicalType(kind));
+  metaData.__set_path_in_schema({name});
+  metaData.__set_codec(codec());
+  metaData.__set_num_values(values.size());
+
+  std::vector<thrift::PageEncodingStats> encodingStats;
+  auto addEncodingStats = [&](thrift::PageType::type pageType,
+                              thrift::Encoding::type encoding) {
+    thrift::PageEncodingStats stats;
+    stats.__set_page_type(pageType);
+    stats.__set_encoding(encoding);
+    stats.__set_count(1);
+    encodingStats.push_back(stats);
+  };
+
+  // Dictionary indices by PLAIN encoded value.
+  std::unordered_map<std::string, int32_t> dictionary;
+  bool useDictionary = options_.useDictionary && !kIsBool;
+  int64_t uncompressedSize = 0;
+  if (useDictionary) {
+    std::string dictionaryPage;
+    for (auto& value : values) {
+      if (value.has_value()) {
+        auto encoded = plain(value.value());
+        if (dictionary.emplace(encoded, dictionary.size()).second) {
+          dictionaryPage += encoded;
+        }
+      }
+    }
+    thrift::DictionaryPageHeader dictionaryHeader;
+    dictionaryHeader.__set_num_values(dictionary.size());
+    dictionaryHeader.__set_encoding(thrift::Encoding::PLAIN);
+    thrift::PageHeader header;
+    header.__set_type(thrift::PageType::DICTIONARY_PAGE);
+    header.__set_dictionary_page_header(dictionaryHeader);
+    metaData.__set_dictionary_page_offset(start);
+    uncompressedSize += writePage(header, "", dictionaryPage);
+    addEncodingStats(
+        thrift::PageType::DICTIONARY_PAGE, thrift::Encoding::PLAIN);
+  }
+  metaData.__set_data_page_offset(file_.size());
+  auto valueEncoding = useDictionary ? thrift::Encoding::RLE_DICTIONARY
+                                     : thrift::Encoding::PLAIN;
+  metaData.__set_encodings({valueEncoding, thrift::Encoding::RLE});
+
+  Stats<T> chunkStats;
+  std::vector<bool> nullPages;
+  std::vector<std::string> minValues;
+  std::vector<std::string> maxValues;
+  std::vector<int64_t> nullCounts;
+  bool allPagesHaveMinMax = true;
+  for (size_t begin = 0; begin < values.size();
+       begin += options_.rowsInPage) {
+    auto end = std::min<size_t>(begin + options_.rowsInPage, values.size());
+    Stats<T> pageStats;
+    std::vector<int32_t> levels;
+    std::vector<int32_t> indices;
+    std::string encodedValues;
+    std::vector<bool> bools;
+    for (auto i = begin; i < end; ++i) {
+      pageStats.add(values[i]);
+      chunkStats.add(values[i]);
+      levels.push_back(values[i].has_value());
+      if (!values[i].has_value()) {
+        continue;
+      }
+      if (useDictionary) {
+        indices.push_back(dictionary[plain(values[i].value())]);
+      } else if constexpr (kIsBool) {
+        bools.push_back(values[i].value());
+      } else {
+        encodedValues += plain(values[i].value());
+      }
+    }
+    if (useDictionary) {
+      auto width = bitWidth(dictionary.size() - 1);
+      encodedValues.push_back(static_cast<char>(width));
+      encodedValues += encodeRleBp(indices, width);
+    } else if constexpr (kIsBool) {
+      encodedValues.resize(bits::nbytes(bools.size()));
+      for (auto i = 0; i < bools.size(); ++i) {
+        bits::setBit(
+            reinterpret_cast<uint8_t*>(encodedValues.data()), i, bools[i]);
+      }
+    }
+    auto encodedLevels = encodeRleBp(levels, 1);
+    auto statistics = pageStats.toThrift();
+    allPagesHaveMinMax = allPagesHaveMinMax &&
+        (statistics.__isset.min_value || pageStats.numNulls == end - begin);
+    nullPages.push_back(pageStats.numNulls == end - begin);
+    minValues.push_back(statistics.min_value);
+    maxValues.push_back(statistics.max_value);
+    nullCounts.push_back(pageStats.numNulls);
+
+    thrift::PageHeader header;
+    if (options_.useDataPageV2) {
+      thrift::DataPageHeaderV2 pageHeader;
+      pageHeader.__set_num_values(end - begin);
+      pageHeader.__set_num_nulls(pageStats.numNulls);
+      pageHeader.__set_num_rows(end - begin);
+      pageHeader.__set_encoding(valueEncoding);
+      pageHeader.__set_definition_levels_byte_length(encodedLevels.size());
+      pageHeader.__set_repetition_levels_byte_length(0);
+      pageHeader.__set_is_compressed(
+          options_.compression != WriterOptions::Compression::kNone);
+      if (options_.pageStatistics) {
+        pageHeader.__set_statistics(statistics);
+      }
+      header.__set_type(thrift::PageType::DATA_PAGE_V2);
+      header.__set_data_page_header_v2(pageHeader);
+      uncompressedSize += writePage(header, encodedLevels, encodedValues);
+    } else {
+      thrift::DataPageHeader pageHeader;
+      pageHeader.__set_num_values(end - begin);
+      pageHeader.__set_encoding(valueEncoding);
+      pageHeader.__set_definition_level_encoding(thrift::Encoding::RLE);
+      pageHeader.__set_repetition_level_encoding(thrift::Encoding::RLE);
+      if (options_.pageStatistics) {
+        pageHeader.__set_statistics(statistics);
+      }
+      header.__set_type(thrift::PageType::DATA_PAGE);
+      header.__set_data_page_header(pageHeader);
+      std::string levelsWithLength;
+      appendRaw<int32_t>(levelsWithLength, encodedLevels.size());
+      levelsWithLength += encodedLevels;
+      uncompressedSize += writePage(header, levelsWithLength, encodedValues);
+    }
+    addEncodingStats(
+        options_.useDataPageV2 ? thrift::PageType::DATA_PAGE_V2
+                               : thrift::PageType::DATA_PAGE,
+        valueEncoding);
+  }
+  metaData.__set_encoding_stats(encodingStats);
+  metaData.__set_total_uncompressed_size(uncompressedSize);
+  metaData.__set_total_compressed_size(file_.size() - start);
+  if (options_.chunkStatistics) {
+    metaData.__set_statistics(chunkStats.toThrift());
+  }
+  if (options_.columnIndex && allPagesHaveMinMax) {
+    columnIndex.__set_null_pages(nullPages);
+    columnIndex.__set_min_values(minValues);
+    columnIndex.__set_max_values(maxValues);
+    columnIndex.__set_boundary_order(thrift::BoundaryOrder::UNORDERED);
+    columnIndex.__set_null_counts(nullCounts);
+  }
+  thrift::ColumnChunk chunk;
+  chunk.__set_file_offset(start);
+  chunk.__set_meta_data(metaData);
+  return chunk;
+}
+
+template <TypeKind Kind>
+thrift::ColumnChunk writeColumnChunk(
+    ChunkWriter& writer,
+    const std::string& name,
+    const std::vector<RowVectorPtr>& batches,
+    int32_t column,
+    const std::vector<std::pair<int32_t, vector_size_t>>& rows,
+    thrift::ColumnIndex& columnIndex) {
+  using T = typename TypeTraits<Kind>::NativeType;
+  std::vector<std::optional<T>> values;
+  for (auto& [batch, row] : rows) {
+    auto vector = batches[batch]->childAt(column)->as<SimpleVector<T>>();
+    if (vector->isNullAt(row)) {
+      values.push_back(std::nullopt);
+    } else {
+      values.push_back(vector->valueAt(row));
+    }
+  }
+  return writer.write<T>(name, Kind, values, columnIndex);
+}
+
+} // namespace
+
+std::string writeParquet(
+    const std::vector<RowVectorPtr>& batches,
+    const WriterOptions& options) {
+  VELOX_CHECK(!batches.empty());
+  auto& rowType = batches[0]->type()->asRow();
+  std::string file = "PAR1";
+  ChunkWriter writer(options, file);
+
+  thrift::FileMetaData fileMetaData;
+  std::vector<thrift::SchemaElement> schema(1);
+  schema[0].__set_name("schema");
+  schema[0].__set_num_children(rowType.size());
+  for (auto i = 0; i < rowType.size(); ++i) {
+    schema.push_back(
+        schemaElement(rowType.nameOf(i), rowType.childAt(i)->kind()));
+  }
+
+  std::vector<std::pair<int32_t, vector_size_t>> allRows;
+  for (auto i = 0; i < batches.size(); ++i) {
+    for (auto j = 0; j < batches[i]->size(); ++j) {
+      allRows.emplace_back(i, j);
+    }
+  }
+  std::vector<thrift::RowGroup> rowGroups;
+  std::vector<std::vector<thrift::ColumnIndex>> columnIndices;
+  for (size_t begin = 0; begin < allRows.size();
+       begin += options.rowsInRowGroup) {
+    auto end =
+        std::min<size_t>(begin + options.rowsInRowGroup, allRows.size());
+    std::vector<std::pair<int32_t, vector_size_t>> rows(
+        allRows.begin() + begin, allRows.begin() + end);
+    thrift::RowGroup rowGroup;
+    std::vector<thrift::ColumnChunk> columns;
+    columnIndices.emplace_back(rowType.size());
+    for (auto i = 0; i < rowType.size(); ++i) {
+      columns.push_back(VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH(
+          writeColumnChunk,
+          rowType.childAt(i)->kind(),
+          writer,
+          rowType.nameOf(i),
+          batches,
+          i,
+          rows,
+          columnIndices.back()[i]));
+    }
+    int64_t totalSize = 0;
+    for (auto& column : columns) {
+      totalSize += column.meta_data.total_uncompressed_size;
+    }
+    rowGroup.__set_columns(columns);
+    rowGroup.__set_num_rows(end - begin);
+    rowGroup.__set_total_byte_size(totalSize);
+    rowGroups.push_back(rowGroup);
+  }
+  // Column indices go between the row groups and the footer.
+  for (auto i = 0; i < rowGroups.size(); ++i) {
+    for (auto j = 0; j < rowGroups[i].columns.size(); ++j) {
+      auto& columnIndex = columnIndices[i][j];
+      if (!columnIndex.__isset.null_counts) {
+        continue;
+      }
+      auto serialized = serialize(columnIndex);
+      rowGroups[i].columns[j].__set_column_index_offset(file.size());
+      rowGroups[i].columns[j].__set_column_index_length(serialized.size());
+      file += serialized;
+    }
+  }
+  fileMetaData.__set_version(1);
+  fileMetaData.__set_schema(schema);
+  fileMetaData.__set_num_rows(allRows.size());
+  fileMetaData.__set_row_groups(rowGroups);
+  fileMetaData.__set_created_by("velox parquet test writer");
+  auto footer = serialize(fileMetaData);
+  file += footer;
+  appendRaw<uint32_t>(file, footer.size());
+  file += "PAR1";
+  return file;
+}
+
+} // namespace facebook::velox::parquet::test
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/vector/ComplexVector.h"
+
+namespace facebook::velox::parquet::test {
+
+struct WriterOptions {
+  enum class Compression { kNone, kSnappy, kZstd };
+
+  int32_t rowsInRowGroup{10'000};
+  int32_t rowsInPage{1'000};
+  // Dictionary encodes all columns except booleans.
+  bool useDictionary{true};
+  bool useDataPageV2{false};
+  Compression compression{Compression::kNone};
+  bool chunkStatistics{true};
+  bool pageStatistics{true};
+  // Writes a ColumnIndex for each column chunk.
+  bool columnIndex{false};
+};
+
+// Writes 'batches' as a Parquet file with one column per child of the
+// batches and returns the file contents. Supports the types that
+// ParquetReader reads. This is a minimal writer for testing the reader.
+std::string writeParquet(
+    const std::vector<RowVectorPtr>& batches,
+    const WriterOptions& options);
+
+} // namespace facebook::velox::parquet::test
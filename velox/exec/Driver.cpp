@@ -142,6 +142,24 @@ void BlockingState::setResume(
 
 namespace {
 
+// The Driver running on this thread. See Driver::current().
+thread_local Driver* currentDriver = nullptr;
+
+// Makes a Driver the current Driver of the thread for the scope.
+class CurrentDriverGuard {
+ public:
+  explicit CurrentDriverGuard(Driver* driver) : previous_(currentDriver) {
+    currentDriver = driver;
+  }
+
+  ~CurrentDriverGuard() {
+    currentDriver = previous_;
+  }
+
+ private:
+  Driver* const previous_;
+};
+
 // Ensures that the thread is removed from a CancelPool on exit.
 class CancelPoolGuard {
  public:
@@ -183,6 +201,11 @@ class CancelPoolGuard {
 };
 } // namespace
 
+// static
+Driver* FOLLY_NULLABLE Driver::current() {
+  return currentDriver;
+}
+
 static std::unique_ptr<folly::CPUThreadPoolExecutor>& getExecutor() {
   static std::unique_ptr<folly::CPUThreadPoolExecutor> executor;
   return executor;
@@ -318,6 +341,7 @@ core::StopReason Driver::runInternal(
     }
     return stop;
   }
+  CurrentDriverGuard currentDriverGuard(this);
   CancelPoolGuard guard(
       cancelPool_.get(), &state_, [this](core::StopReason reason) {
         auto task = task_.get();
@@ -492,6 +516,13 @@ void Driver::initializeOperatorStats(std::vector<OperatorStats>& stats) {
 }
 
 void Driver::addStatsToTask() {
+  if (!operators_.empty()) {
+    // The vector pool is per Driver. Its stats go with the first Operator.
+    auto& vectorPoolStats = ctx_->execCtx->vectorPoolStats();
+    auto& stats = operators_[0]->stats();
+    stats.addRuntimeStat("vectorPoolGets", vectorPoolStats.numGets);
+    stats.addRuntimeStat("vectorPoolHits", vectorPoolStats.numHits);
+  }
   for (auto& op : operators_) {
     auto& stats = op->stats();
     stats.memoryStats.update(op->pool()->getMemoryUsageTracker());
@@ -521,6 +552,20 @@ bool Driver::terminate() {
   return false;
 }
 
+void Driver::reclaim() {
+  VELOX_CHECK(!isOnThread(), "Cannot reclaim memory from a running Driver");
+  for (auto& op : operators_) {
+    if (op->canReclaim()) {
+      op->reclaim();
+    }
+  }
+  // Memory freed by the Operators stays in the reservation chunks of the
+  // Driver unless returned.
+  if (auto& tracker = ctx_->execCtx->pool()->getMemoryUsageTracker()) {
+    tracker->releaseAvailableChunks();
+  }
+}
+
 bool Driver::mayPushdownAggregation(Operator* aggregation) const {
   for (auto i = 1; i < operators_.size(); ++i) {
     auto op = operators_[i].get();
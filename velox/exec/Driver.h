@@ -113,6 +113,11 @@ class Driver {
       std::shared_ptr<Driver> instance,
       folly::Executor* FOLLY_NULLABLE executor = nullptr);
 
+  // Returns the Driver running on the calling thread or nullptr if the
+  // thread is not running a Driver. Does not take locks, so that it can
+  // be called from inside memory allocation.
+  static Driver* FOLLY_NULLABLE current();
+
   // Waits for activity on 'executor_' to finish and then makes a new
   // executor. Testing uses this to ensure that there are no live
   // references to memory pools before deleting the pools.
@@ -147,6 +152,10 @@ class Driver {
 
   void addStatsToTask();
 
+  // Calls Operator::reclaim() on the Operators that support it. 'this'
+  // must be off thread and its Task must be paused.
+  void reclaim();
+
   // Returns true if all operators between the source and 'aggregation' are
   // order-preserving and do not increase cardinality.
   bool mayPushdownAggregation(Operator* FOLLY_NONNULL aggregation) const;
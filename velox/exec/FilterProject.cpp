@@ -50,6 +50,7 @@ FilterProject::FilterProject(
           "FilterProject"),
       hasFilter_(filter != nullptr) {
   std::vector<std::shared_ptr<const core::ITypedExpr>> allExprs;
+  std::unordered_set<std::string> identityFields;
   if (hasFilter_) {
     allExprs.push_back(filter->filter());
   }
@@ -64,6 +65,9 @@ FilterProject::FilterProject(
         resultProjections_.emplace_back(allExprs.size() - 1, i);
       }
     }
+    for (const auto& projection : identityProjections_) {
+      identityFields.insert(inputType->nameOf(projection.inputChannel));
+    }
   } else {
     for (ChannelIndex i = 0; i < outputType_->size(); ++i) {
       identityProjections_.emplace_back(i, i);
@@ -72,6 +76,11 @@ FilterProject::FilterProject(
   }
   numExprs_ = allExprs.size();
   exprs_ = makeExprSetFromFlag(std::move(allExprs), operatorCtx_->execCtx());
+  if (!isIdentityProjection_) {
+    // The identity projections are returned for all the rows that pass the
+    // filter. Other columns are loaded only for the rows that read them.
+    exprs_->markSoleFieldReferences(identityFields);
+  }
 }
 
 void FilterProject::addInput(RowVectorPtr input) {
@@ -177,6 +186,17 @@ void FilterProject::clearNonReusableOutput() {
   }
 }
 
+void FilterProject::reclaim() {
+  if (input_) {
+    // 'results_' and 'output_' are needed for finishing 'input_'.
+    return;
+  }
+  output_ = nullptr;
+  for (auto& result : results_) {
+    result = nullptr;
+  }
+}
+
 void FilterProject::project(const SelectivityVector& rows, EvalCtx* evalCtx) {
   // Make sure LazyVectors are loaded for all the "rows".
   //
@@ -185,9 +205,9 @@ void FilterProject::project(const SelectivityVector& rows, EvalCtx* evalCtx) {
   // will load b only for rows where f(a) is true. However, h(b) projection
   // needs all rows for "b".
   //
-  // This works, but may load more rows than necessary. E.g. if we only have
-  // f(a) AND g(b) expression and b is not used anywhere else, it is sufficient
-  // to load b for a subset of rows where f(a) is true.
+  // A column referenced only once, e.g. b in f(a) AND g(b) without h(b), is
+  // loaded only for the rows where f(a) is true. See
+  // ExprSet::markSoleFieldReferences().
   *evalCtx->mutableIsFinalSelection() = false;
   *evalCtx->mutableFinalSelection() = &rows;
 
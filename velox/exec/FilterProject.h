@@ -54,6 +54,13 @@ class FilterProject : public Operator {
     exprs_->clear();
   }
 
+  bool canReclaim() const override {
+    return true;
+  }
+
+  // Drops the vectors kept for reuse between batches.
+  void reclaim() override;
+
  private:
   // Tests if 'numProcessedRows_' equals to the length of input_ and clears
   // outstanding references to input_ if done. Returns true if getOutput
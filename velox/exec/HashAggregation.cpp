@@ -137,6 +137,13 @@ void HashAggregation::addInput(RowVectorPtr input) {
 }
 
 RowVectorPtr HashAggregation::getOutput() {
+  if (!reclaimedOutput_.empty()) {
+    input_ = nullptr;
+    auto output = std::move(reclaimedOutput_.back());
+    reclaimedOutput_.pop_back();
+    return output;
+  }
+
   if (finished_ || (!isFinishing_ && !partialFull_ && !newDistincts_)) {
     input_ = nullptr;
     return nullptr;
@@ -194,4 +201,35 @@ RowVectorPtr HashAggregation::getOutput() {
   return result;
 }
 
+void HashAggregation::reclaim() {
+  // A flush in progress frees the groups once the Driver runs again.
+  if (isFinishing_ || finished_ || partialFull_) {
+    return;
+  }
+  std::vector<RowVectorPtr> outputs;
+  RowContainerIterator iterator;
+  try {
+    for (;;) {
+      auto result = std::static_pointer_cast<RowVector>(BaseVector::create(
+          outputType_, kOutputBatchSize, operatorCtx_->pool()));
+      if (!groupingSet_->getOutput(
+              kOutputBatchSize, isPartialOutput_, &iterator, result)) {
+        break;
+      }
+      outputs.push_back(std::move(result));
+    }
+  } catch (const VeloxRuntimeError& e) {
+    if (e.errorCode() != error_code::kMemCapExceeded) {
+      throw;
+    }
+    // There is no room for the output. The groups are kept and the
+    // partial output made so far is freed.
+    return;
+  }
+  groupingSet_->resetPartial();
+  for (auto& output : outputs) {
+    reclaimedOutput_.push_back(std::move(output));
+  }
+}
+
 } // namespace facebook::velox::exec
@@ -46,8 +46,17 @@ class HashAggregation : public Operator {
   void close() override {
     Operator::close();
     groupingSet_.reset();
+    reclaimedOutput_.clear();
   }
 
+  bool canReclaim() const override {
+    return isPartialOutput_ && !isDistinct_ && !isGlobal_;
+  }
+
+  // Moves the groups of a partial aggregation into output vectors, which
+  // getOutput() returns before any other output, and frees the groups.
+  void reclaim() override;
+
  private:
   static constexpr int32_t kOutputBatchSize = 10'000;
 
@@ -62,6 +71,8 @@ class HashAggregation : public Operator {
   RowContainerIterator resultIterator_;
   bool pushdownChecked_ = false;
   bool mayPushdown_ = false;
+  // Output produced by reclaim(), in no particular order.
+  std::vector<RowVectorPtr> reclaimedOutput_;
 };
 
 } // namespace facebook::velox::exec
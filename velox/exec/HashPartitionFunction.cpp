@@ -17,6 +17,17 @@
 #include <velox/exec/VectorHasher.h>
 
 namespace facebook::velox::exec {
+namespace {
+// Maps 'hash' to [0, numPartitions) without a division. The multiplication
+// carries all bits of 'hash' into the upper 32 bits, which then select the
+// partition as in Lemire's fast range reduction. Unlike taking the high bits
+// of 'hash' directly, this also spreads hashes that only use the low bits.
+inline uint32_t reduceToPartition(uint64_t hash, uint32_t numPartitions) {
+  constexpr uint64_t kMul = 0x9e3779b97f4a7c15ULL;
+  return ((hash * kMul) >> 32) * numPartitions >> 32;
+}
+} // namespace
+
 HashPartitionFunction::HashPartitionFunction(
     int numPartitions,
     RowTypePtr inputType,
@@ -44,7 +55,7 @@ void HashPartitionFunction::partition(
 
   partitions.resize(size);
   for (auto i = 0; i < size; ++i) {
-    partitions[i] = hashes_[i] % numPartitions_;
+    partitions[i] = reduceToPartition(hashes_[i], numPartitions_);
   }
 }
 } // namespace facebook::velox::exec
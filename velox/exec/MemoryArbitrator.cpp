@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/MemoryArbitrator.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+#include <folly/executors/QueuedImmediateExecutor.h>
+#include <glog/logging.h>
+
+#include "velox/exec/Task.h"
+
+namespace facebook::velox::exec {
+
+namespace {
+int64_t memoryUsage(const Task& task) {
+  auto& tracker = task.pool()->getMemoryUsageTracker();
+  return tracker ? tracker->getCurrentTotalBytes() : 0;
+}
+
+// Requests a pause of 'task' and waits until all its Drivers are off
+// thread or suspended.
+void pause(Task& task) {
+  task.cancelPool()->requestPause(true);
+  auto& executor = folly::QueuedImmediateExecutor::instance();
+  task.cancelPool()->finishFuture().via(&executor).wait();
+}
+
+// Returns the query whose running Tasks in 'tasks' use the most memory.
+// Returns nullptr if no Task in 'tasks' is running.
+const core::QueryCtx* FOLLY_NULLABLE
+largestQuery(const std::vector<std::shared_ptr<Task>>& tasks) {
+  std::unordered_map<const core::QueryCtx*, int64_t> queryUsage;
+  for (auto& task : tasks) {
+    if (task->state() == kRunning) {
+      queryUsage[task->queryCtx().get()] += memoryUsage(*task);
+    }
+  }
+  const core::QueryCtx* largest = nullptr;
+  int64_t largestUsage = -1;
+  for (auto& [query, usage] : queryUsage) {
+    if (usage > largestUsage) {
+      largest = query;
+      largestUsage = usage;
+    }
+  }
+  return largest;
+}
+} // namespace
+
+// static
+MemoryArbitrator& MemoryArbitrator::getInstance() {
+  static MemoryArbitrator instance;
+  return instance;
+}
+
+void MemoryArbitrator::addTask(const std::shared_ptr<Task>& task) {
+  auto& tracker = task->pool()->getMemoryUsageTracker();
+  if (!tracker) {
+    return;
+  }
+  tracker->setGrowCallback(
+      [this, weakTask = std::weak_ptr<Task>(task)](
+          memory::MemoryUsageTracker& exceeded, int64_t size) {
+        auto task = weakTask.lock();
+        return task && growMemory(*task, exceeded, size);
+      });
+
+  std::lock_guard<std::mutex> l(tasksMutex_);
+  tasks_.erase(
+      std::remove_if(
+          tasks_.begin(),
+          tasks_.end(),
+          [](const auto& task) { return task.expired(); }),
+      tasks_.end());
+  tasks_.push_back(task);
+}
+
+bool MemoryArbitrator::growMemory(
+    Task& task,
+    memory::MemoryUsageTracker& exceeded,
+    int64_t size) {
+  auto* driver = task.thisDriver();
+  if (!driver || driver->state().isSuspended) {
+    // Reservations from threads that are not running a Driver, e.g. IO
+    // threads, cannot wait in a suspended section.
+    return false;
+  }
+  ++numRequests_;
+  // Not a SuspendedSection since leaving the section throws if the
+  // Task was aborted while waiting, which must not happen in a
+  // destructor.
+  auto* cancelPool = driver->cancelPool();
+  if (cancelPool->enterSuspended(driver->state()) != core::StopReason::kNone) {
+    return false;
+  }
+  bool success;
+  try {
+    success = reclaim(&task, exceeded, size);
+  } catch (const std::exception&) {
+    cancelPool->leaveSuspended(driver->state());
+    throw;
+  }
+  if (cancelPool->leaveSuspended(driver->state()) != core::StopReason::kNone) {
+    VELOX_FAIL("Terminate detected when leaving memory arbitration");
+  }
+  return success;
+}
+
+bool MemoryArbitrator::reclaim(
+    const Task* requester,
+    memory::MemoryUsageTracker& exceeded,
+    int64_t size) {
+  const auto initialUsage = exceeded.getCurrentTotalBytes();
+  auto freed = [&]() {
+    return initialUsage - exceeded.getCurrentTotalBytes();
+  };
+
+  std::vector<std::shared_ptr<Task>> victims;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    auto tasks = candidates(exceeded);
+    for (auto& task : tasks) {
+      if (freed() >= size) {
+        break;
+      }
+      if (task.get() == requester || task->state() != kRunning) {
+        continue;
+      }
+      pause(*task);
+      task->reclaim();
+      if (!task->error()) {
+        Task::resume(task);
+      }
+    }
+
+    if (freed() >= size) {
+      ++numReclaims_;
+      reclaimedBytes_ += freed();
+      return true;
+    }
+
+    // Reclaiming was not enough. Abort the query that uses the most
+    // memory unless this is the query of the requester, which then fails
+    // its reservation.
+    auto largest = largestQuery(tasks);
+    if (!largest ||
+        (requester && largest == requester->queryCtx().get())) {
+      return false;
+    }
+    // Also the Tasks of the query that are not under 'exceeded'.
+    victims = queryTasks(largest);
+    int64_t victimUsage = 0;
+    for (auto& victim : victims) {
+      victimUsage += memoryUsage(*victim);
+    }
+    LOG(WARNING) << "Aborting the query of task " << victims.front()->taskId()
+                 << " using " << victimUsage << " bytes in " << victims.size()
+                 << " tasks to free memory for "
+                 << (requester ? requester->taskId() : "<unknown>");
+    auto message = fmt::format(
+        "Aborted to free memory for another query: using {} bytes, {} more "
+        "bytes needed under a shared memory limit",
+        victimUsage,
+        size);
+    for (auto& victim : victims) {
+      victim->setError(message);
+    }
+    ++numAborts_;
+  }
+
+  // The victims free their memory as their Drivers go off thread. This
+  // is waited for outside of 'mutex_' so that other arbitrations are not
+  // held up by the victims.
+  auto& executor = folly::QueuedImmediateExecutor::instance();
+  for (auto& victim : victims) {
+    victim->cancelPool()->finishFuture().via(&executor).wait();
+  }
+  return freed() >= size;
+}
+
+std::vector<std::shared_ptr<Task>> MemoryArbitrator::queryTasks(
+    const core::QueryCtx* query) {
+  std::vector<std::shared_ptr<Task>> tasks;
+  std::lock_guard<std::mutex> l(tasksMutex_);
+  for (auto& weakTask : tasks_) {
+    auto task = weakTask.lock();
+    if (task && task->queryCtx().get() == query &&
+        task->state() == kRunning) {
+      tasks.push_back(std::move(task));
+    }
+  }
+  return tasks;
+}
+
+std::vector<std::shared_ptr<Task>> MemoryArbitrator::candidates(
+    const memory::MemoryUsageTracker& exceeded) {
+  std::vector<std::pair<int64_t, std::shared_ptr<Task>>> usageAndTasks;
+  {
+    std::lock_guard<std::mutex> l(tasksMutex_);
+    for (auto& weakTask : tasks_) {
+      auto task = weakTask.lock();
+      if (!task) {
+        continue;
+      }
+      auto& tracker = task->pool()->getMemoryUsageTracker();
+      if (tracker && tracker->isDescendantOf(&exceeded)) {
+        usageAndTasks.emplace_back(memoryUsage(*task), std::move(task));
+      }
+    }
+  }
+  std::sort(
+      usageAndTasks.begin(),
+      usageAndTasks.end(),
+      [](const auto& left, const auto& right) {
+        return left.first > right.first;
+      });
+  std::vector<std::shared_ptr<Task>> tasks;
+  tasks.reserve(usageAndTasks.size());
+  for (auto& [usage, task] : usageAndTasks) {
+    tasks.push_back(std::move(task));
+  }
+  return tasks;
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <folly/CPortability.h>
+
+#include "velox/common/memory/MemoryUsageTracker.h"
+
+namespace facebook::velox::core {
+class QueryCtx;
+} // namespace facebook::velox::core
+
+namespace facebook::velox::exec {
+
+class Task;
+
+// Arbitrates memory between the Tasks of a process. When a memory
+// reservation fails because a limit shared by several Tasks is
+// exceeded, e.g. the limit of a worker-wide MemoryUsageTracker, the
+// Driver making the reservation asks the Operators of the other
+// Tasks under that limit to give memory back. If this does not free
+// enough, all the Tasks of the query using the most memory under the
+// limit are aborted. If this is the query of the requesting Task, the
+// reservation fails as it would without arbitration.
+//
+// Only Tasks of queries with QueryCtx::kMemoryArbitrationEnabled take
+// part in arbitration.
+//
+// Arbitration is serialized. The requesting Driver waits in a
+// suspended section so that its own Task can be paused by another
+// arbitration while it waits.
+class MemoryArbitrator {
+ public:
+  struct Stats {
+    // Number of failed reservations that were arbitrated.
+    int64_t numRequests{0};
+    // Number of arbitrations that freed enough memory by reclaiming.
+    int64_t numReclaims{0};
+    int64_t reclaimedBytes{0};
+    // Number of queries aborted to free memory.
+    int64_t numAborts{0};
+  };
+
+  static MemoryArbitrator& getInstance();
+
+  // Makes 'task' subject to arbitration. Installs a GrowCallback on
+  // the MemoryUsageTracker of the pool of 'task'. Does nothing if the
+  // pool has no tracker.
+  void addTask(const std::shared_ptr<Task>& task);
+
+  // Called when a reservation of 'size' bytes on behalf of 'task'
+  // exceeds the limit of 'exceeded'. Returns true if memory was freed
+  // and the reservation should be retried. Only reservations made on
+  // the thread of a Driver of 'task' are arbitrated.
+  bool growMemory(
+      Task& task,
+      memory::MemoryUsageTracker& exceeded,
+      int64_t size);
+
+  // Tries to free 'size' bytes under 'exceeded' from Tasks other
+  // than 'requester'. Returns true if at least 'size' bytes were
+  // freed, also when this took aborting a query. This is the part of
+  // growMemory() that runs after the requesting Driver is suspended.
+  bool reclaim(
+      const Task* FOLLY_NULLABLE requester,
+      memory::MemoryUsageTracker& exceeded,
+      int64_t size);
+
+  Stats stats() const {
+    Stats stats;
+    stats.numRequests = numRequests_;
+    stats.numReclaims = numReclaims_;
+    stats.reclaimedBytes = reclaimedBytes_;
+    stats.numAborts = numAborts_;
+    return stats;
+  }
+
+ private:
+  // Returns the live Tasks whose memory counts towards 'exceeded',
+  // largest first.
+  std::vector<std::shared_ptr<Task>> candidates(
+      const memory::MemoryUsageTracker& exceeded);
+
+  // Returns the running Tasks of 'query'.
+  std::vector<std::shared_ptr<Task>> queryTasks(const core::QueryCtx* query);
+
+  // Serializes arbitration.
+  std::mutex mutex_;
+
+  // Serializes access to 'tasks_'.
+  std::mutex tasksMutex_;
+  std::vector<std::weak_ptr<Task>> tasks_;
+
+  std::atomic<int64_t> numRequests_{0};
+  std::atomic<int64_t> numReclaims_{0};
+  std::atomic<int64_t> reclaimedBytes_{0};
+  std::atomic<int64_t> numAborts_{0};
+};
+
+} // namespace facebook::velox::exec
@@ -140,15 +140,20 @@ RowVectorPtr Operator::fillOutput(vector_size_t size, BufferPtr mapping) {
 }
 
 void Operator::inputProcessed() {
-  input_ = nullptr;
   if (!output_.unique()) {
     output_ = nullptr;
-    return;
+  } else {
+    auto& columns = output_->children();
+    for (auto& projection : identityProjections_) {
+      columns[projection.outputChannel] = nullptr;
+    }
   }
-  auto& columns = output_->children();
-  for (auto& projection : identityProjections_) {
-    columns[projection.outputChannel] = nullptr;
+  // Columns of 'input_' that are no longer referenced from 'output_' or
+  // elsewhere can be reused by this Driver.
+  if (input_.unique()) {
+    operatorCtx_->execCtx()->releaseVectors(input_->children());
   }
+  input_ = nullptr;
 }
 
 void Operator::clearIdentityProjectedOutput() {
@@ -298,6 +298,20 @@ class Operator {
     results_.clear();
   }
 
+  // Returns true if 'this' can give back memory on request of the
+  // MemoryArbitrator. See reclaim().
+  virtual bool canReclaim() const {
+    return false;
+  }
+
+  // Frees memory that 'this' holds but does not need for producing
+  // correct results, e.g. vectors kept for reuse. The memory must be
+  // freed by the time this returns since the MemoryArbitrator
+  // measures what was freed right after. Called by the
+  // MemoryArbitrator only while the Task is paused and the Driver of
+  // 'this' is off thread. Called only if canReclaim() returns true.
+  virtual void reclaim() {}
+
   // Returns true if 'this' never has more output rows than input rows.
   virtual bool isFilter() const {
     return false;
@@ -363,7 +377,8 @@ class Operator {
 
   // Drops references to identity projected columns from 'output_' and
   // clears 'input_'. The producer will see its vectors as singly
-  // referenced.
+  // referenced. Columns of 'input_' that are referenced only from
+  // 'input_' go to the vector pool of the ExecCtx.
   void inputProcessed();
 
   std::unique_ptr<OperatorCtx> operatorCtx_;
@@ -33,7 +33,10 @@ TableScan::TableScan(
       tableHandle_(tableScanNode->tableHandle()),
       columnHandles_(tableScanNode->assignments()),
       driverCtx_(driverCtx),
-      blockingFuture_(false) {}
+      blockingFuture_(false),
+      maxPreloadedSplits_(std::max<int32_t>(
+          0,
+          driverCtx->execCtx->queryCtx()->maxSplitPreloadPerDriver())) {}
 
 RowVectorPtr TableScan::getOutput() {
   if (noMoreSplits_) {
@@ -43,11 +46,16 @@ RowVectorPtr TableScan::getOutput() {
   for (;;) {
     if (needNewSplit_) {
       exec::Split split;
-      auto reason = driverCtx_->task->getSplitOrFuture(
-          planNodeId_, split, blockingFuture_);
-      if (reason != BlockingReason::kNotBlocked) {
-        hasBlockingFuture_ = true;
-        return nullptr;
+      if (!preloadedSplits_.empty()) {
+        split = std::move(preloadedSplits_.front());
+        preloadedSplits_.pop_front();
+      } else {
+        auto reason = driverCtx_->task->getSplitOrFuture(
+            planNodeId_, split, blockingFuture_);
+        if (reason != BlockingReason::kNotBlocked) {
+          hasBlockingFuture_ = true;
+          return nullptr;
+        }
       }
 
       if (!split.hasConnectorSplit()) {
@@ -87,6 +95,7 @@ RowVectorPtr TableScan::getOutput() {
 
       dataSource_->addSplit(connectorSplit);
       ++stats_.numSplits;
+      preloadSplits();
     }
 
     auto data = dataSource_->next(kDefaultBatchSize);
@@ -107,6 +116,31 @@ RowVectorPtr TableScan::getOutput() {
   }
 }
 
+void TableScan::preloadSplits() {
+  if (!dataSource_->canPreloadSplits()) {
+    return;
+  }
+  // Only splits in excess of one per driver of the pipeline are taken, so
+  // that preloading does not starve the other drivers of the scan.
+  while (preloadedSplits_.size() < maxPreloadedSplits_) {
+    exec::Split split;
+    if (!driverCtx_->task->getSplitIfAvailable(
+            planNodeId_, driverCtx_->numDrivers, split)) {
+      return;
+    }
+    if (!split.hasConnectorSplit()) {
+      // Processed in order by getOutput(), which ends the scan on it.
+      preloadedSplits_.push_back(std::move(split));
+      return;
+    }
+    VELOX_CHECK(
+        connector_->connectorId() == split.connectorSplit->connectorId,
+        "Got splits with different connector IDs");
+    dataSource_->preloadSplit(split.connectorSplit);
+    preloadedSplits_.push_back(std::move(split));
+  }
+}
+
 void TableScan::addDynamicFilter(
     ChannelIndex outputChannel,
     const std::shared_ptr<common::Filter>& filter) {
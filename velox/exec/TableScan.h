@@ -58,6 +58,10 @@ class TableScan : public SourceOperator {
  private:
   static constexpr int32_t kDefaultBatchSize = 1024;
 
+  // Takes queued splits up to 'maxPreloadedSplits_' ahead of the current one
+  // and hands them to 'dataSource_' for opening in the background.
+  void preloadSplits();
+
   const core::PlanNodeId planNodeId_;
   const std::shared_ptr<connector::ConnectorTableHandle> tableHandle_;
   const std::
@@ -73,6 +77,11 @@ class TableScan : public SourceOperator {
   bool noMoreSplits_ = false;
   // The bucketed group id we are in the middle of processing.
   int32_t currentSplitGroupId_{-1};
+  // Maximum number of splits taken from the task ahead of the current split.
+  const size_t maxPreloadedSplits_;
+  // Splits taken from the task and passed to DataSource::preloadSplit(), in
+  // the order they are to be added.
+  std::deque<exec::Split> preloadedSplits_;
   // Dynamic filters to add to the data source when it gets created.
   std::unordered_map<ChannelIndex, std::shared_ptr<common::Filter>>
       pendingDynamicFilters_;
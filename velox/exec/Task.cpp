@@ -20,6 +20,7 @@
 #include "velox/exec/Exchange.h"
 #include "velox/exec/HashBuild.h"
 #include "velox/exec/LocalPlanner.h"
+#include "velox/exec/MemoryArbitrator.h"
 #include "velox/exec/Merge.h"
 #include "velox/exec/PartitionedOutputBufferManager.h"
 #if CODEGEN_ENABLED == 1
@@ -72,7 +73,9 @@ void Task::start(std::shared_ptr<Task> self, uint32_t maxDrivers) {
     auto codegen = codegen::Codegen(codegenLogger);
     auto lazyLoading = self->queryCtx()->codegenLazyLoading();
     codegen.initializeFromFile(
-        self->queryCtx()->codegenConfigurationFilePath(), lazyLoading);
+        self->queryCtx()->codegenConfigurationFilePath(),
+        lazyLoading,
+        self->queryCtx()->codegenBackgroundCompilation());
     auto newPlanNode = codegen.compile(*(self->planNode_));
     self->planNode_ = newPlanNode != nullptr ? newPlanNode : self->planNode_;
   }
@@ -90,6 +93,9 @@ void Task::start(std::shared_ptr<Task> self, uint32_t maxDrivers) {
   // Drivers. 'drivers_' can be read by memory recovery or
   // cancellation while Drivers are being made, so the array should
   // have final size from the start.
+  if (self->queryCtx()->memoryArbitrationEnabled()) {
+    MemoryArbitrator::getInstance().addTask(self);
+  }
 
   auto bufferManager = self->bufferManager_.lock();
   VELOX_CHECK_NOT_NULL(
@@ -189,6 +195,21 @@ void Task::resume(std::shared_ptr<Task> self) {
   }
 }
 
+Driver* FOLLY_NULLABLE Task::thisDriver() const {
+  auto* driver = Driver::current();
+  return driver && driver->driverCtx()->task.get() == this ? driver : nullptr;
+}
+
+void Task::reclaim() {
+  VELOX_CHECK(cancelPool_->pauseRequested(), "Task must be paused to reclaim");
+  std::lock_guard<std::mutex> l(*cancelPool_->mutex());
+  for (auto& driver : drivers_) {
+    if (driver && !driver->isOnThread() && !driver->isTerminated()) {
+      driver->reclaim();
+    }
+  }
+}
+
 // static
 void Task::removeDriver(std::shared_ptr<Task> self, Driver* driver) {
   std::lock_guard<std::mutex> cancelPoolLock(*self->cancelPool()->mutex());
@@ -311,6 +332,25 @@ BlockingReason Task::getSplitOrFuture(
     return BlockingReason::kWaitForSplit;
   }
 
+  takeSplitLocked(splitsState, split);
+  return BlockingReason::kNotBlocked;
+}
+
+bool Task::getSplitIfAvailable(
+    const core::PlanNodeId& planNodeId,
+    int32_t numToLeave,
+    exec::Split& split) {
+  std::lock_guard<std::mutex> l(mutex_);
+
+  auto& splitsState = splitsStates_[planNodeId];
+  if (splitsState.splits.size() <= numToLeave) {
+    return false;
+  }
+  takeSplitLocked(splitsState, split);
+  return true;
+}
+
+void Task::takeSplitLocked(SplitsState& splitsState, exec::Split& split) {
   split = std::move(splitsState.splits.front());
   splitsState.splits.pop_front();
 
@@ -321,8 +361,6 @@ BlockingReason Task::getSplitOrFuture(
     taskStats_.firstSplitStartTimeMs = getCurrentTimeMs();
   }
   taskStats_.lastSplitStartTimeMs = getCurrentTimeMs();
-
-  return BlockingReason::kNotBlocked;
 }
 
 void Task::splitFinished(
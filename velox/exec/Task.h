@@ -103,7 +103,12 @@ class Task {
     auto* driverPool = childPools_.back().get();
     auto parentTracker = pool_->getMemoryUsageTracker();
     if (parentTracker) {
-      driverPool->setMemoryUsageTracker(parentTracker->addChild());
+      driverPool->setMemoryUsageTracker(parentTracker->addChild(
+          false,
+          memory::MemoryUsageConfigBuilder()
+              .reservationChunkBytes(
+                  queryCtx_->driverMemoryReservationChunk())
+              .build()));
     }
 
     return driverPool;
@@ -171,6 +176,15 @@ class Task {
       exec::Split& split,
       ContinueFuture& future);
 
+  // Returns true and sets 'split' if more than 'numToLeave' splits for the
+  // source operator corresponding to plan node with specified ID are
+  // queued. Never blocks. Used by table scans to take splits ahead of
+  // processing them so that these can be opened in the background.
+  bool getSplitIfAvailable(
+      const core::PlanNodeId& planNodeId,
+      int32_t numToLeave,
+      exec::Split& split);
+
   void splitFinished(const core::PlanNodeId& planNodeId, int32_t splitGroupId);
 
   void multipleSplitsFinished(int32_t numSplits);
@@ -359,6 +373,11 @@ class Task {
   // thread is not running a Driver of 'this'.
   Driver* FOLLY_NULLABLE thisDriver() const;
 
+  // Gives back memory held by Operators of Drivers that are off
+  // thread. 'this' must be paused so that no Driver goes on thread
+  // while memory is being reclaimed.
+  void reclaim();
+
  private:
   struct BarrierState {
     int32_t numRequested;
@@ -412,6 +431,10 @@ class Task {
 
   void addSplitLocked(SplitsState& splitsState, exec::Split&& split);
 
+  // Moves the first queued split of 'splitsState' into 'split' and updates
+  // the split counts.
+  void takeSplitLocked(SplitsState& splitsState, exec::Split& split);
+
   const std::string taskId_;
   std::shared_ptr<const core::PlanNode> planNode_;
   const int destination_;
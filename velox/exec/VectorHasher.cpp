@@ -32,6 +32,17 @@ uint64_t hashOne(DecodedVector& decoded, vector_size_t index) {
   using T = typename KindToFlatVector<Kind>::HashRowType;
   return folly::hasher<T>()(decoded.valueAt<T>(index));
 }
+
+// Hashes the first 'numRows' of 'values'. The loop has no per row branches
+// and no indirections, so that the compiler can unroll and pipeline it.
+template <typename T, bool mix>
+void hashFlat(const T* values, vector_size_t numRows, uint64_t* result) {
+  folly::hasher<T> hasher;
+  for (auto row = 0; row < numRows; ++row) {
+    auto hash = hasher(values[row]);
+    result[row] = mix ? bits::hashMix(result[row], hash) : hash;
+  }
+}
 } // namespace
 
 template <TypeKind Kind>
@@ -48,6 +59,20 @@ void VectorHasher::hashValues(
       result[row] = mix ? bits::hashMix(result[row], hash) : hash;
     });
   } else if (decoded_.isIdentityMapping()) {
+    // Booleans are bits and are not hashed from a flat array of values.
+    if constexpr (
+        TypeTraits<Kind>::isPrimitiveType && Kind != TypeKind::BOOLEAN) {
+      if (!decoded_.mayHaveNulls() && rows.isAllSelected()) {
+        using HashRowType = typename KindToFlatVector<Kind>::HashRowType;
+        auto values = decoded_.data<HashRowType>();
+        if (mix) {
+          hashFlat<HashRowType, true>(values, rows.end(), result);
+        } else {
+          hashFlat<HashRowType, false>(values, rows.end(), result);
+        }
+        return;
+      }
+    }
     rows.applyToSelected([&](vector_size_t row) {
       if (decoded_.isNullAt(row)) {
         result[row] = mix ? bits::hashMix(result[row], kNullHash) : kNullHash;
@@ -310,3 +310,26 @@ TEST_F(FilterProjectTest, filterProjectFused) {
       plan,
       "SELECT c0, c1, c0 %100 + c1 % 50, c0 % 100 FROM tmp WHERE c0 % 10 < 5");
 }
+
+TEST_F(FilterProjectTest, recycleVectors) {
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 10; ++i) {
+    auto vector = std::dynamic_pointer_cast<RowVector>(
+        BatchMaker::createBatch(rowType_, 100, *pool_));
+    vectors.push_back(vector);
+  }
+  createDuckDbTable(vectors);
+
+  // The result of c3 + c3 is an intermediate vector that is reused for the
+  // next batch.
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .project(std::vector<std::string>{"c3 + c3 > 0.0"})
+                  .planNode();
+  auto task = assertQuery(plan, "SELECT c3 + c3 > 0.0 FROM tmp");
+  auto taskStats = task->taskStats();
+  auto& runtimeStats = taskStats.pipelineStats[0].operatorStats[0].runtimeStats;
+  EXPECT_LT(0, runtimeStats["vectorPoolHits"].sum);
+  EXPECT_LE(
+      runtimeStats["vectorPoolHits"].sum, runtimeStats["vectorPoolGets"].sum);
+}
@@ -0,0 +1,402 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/MemoryArbitrator.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include "velox/exec/Task.h"
+#include "velox/exec/tests/Cursor.h"
+#include "velox/exec/tests/PlanBuilder.h"
+#include "velox/vector/tests/VectorMaker.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+using facebook::velox::test::VectorMaker;
+
+namespace {
+// A PlanNode that passes its input to its output. See TestingReclaimer.
+class TestingReclaimerNode : public core::PlanNode {
+ public:
+  TestingReclaimerNode(
+      const core::PlanNodeId& id,
+      std::shared_ptr<const core::PlanNode> input)
+      : PlanNode(id), sources_{input} {}
+
+  const std::shared_ptr<const RowType>& outputType() const override {
+    return sources_[0]->outputType();
+  }
+
+  const std::vector<std::shared_ptr<const PlanNode>>& sources() const override {
+    return sources_;
+  }
+
+  std::string_view name() const override {
+    return "TestingReclaimer";
+  }
+
+ private:
+  std::vector<std::shared_ptr<const core::PlanNode>> sources_;
+};
+
+// Holds 'kBytes' of memory from its first input until reclaimed or
+// closed. Blocks after its first output until 'continuePromise' is
+// fulfilled, so that the test can arbitrate while the Driver is off
+// thread.
+class TestingReclaimer : public Operator {
+ public:
+  static constexpr int64_t kBytes = 1 << 19;
+
+  static std::optional<VeloxPromise<bool>> continuePromise;
+
+  // Set when the Driver is about to go off thread after the first output.
+  static std::atomic<bool> blocked;
+
+  TestingReclaimer(
+      DriverCtx* ctx,
+      int32_t id,
+      const std::shared_ptr<const TestingReclaimerNode>& node)
+      : Operator(ctx, node->outputType(), id, node->id(), "TestingReclaimer") {
+  }
+
+  bool needsInput() const override {
+    return !isFinishing_ && !input_;
+  }
+
+  void addInput(RowVectorPtr input) override {
+    if (!memory_ && !reclaimed_) {
+      memory_ = pool()->allocate(kBytes);
+    }
+    input_ = std::move(input);
+  }
+
+  RowVectorPtr getOutput() override {
+    if (input_ && !blocked_) {
+      auto [promise, future] = makeVeloxPromiseContract<bool>("reclaimer");
+      continuePromise = std::move(promise);
+      future_ = std::move(future);
+      blocked_ = true;
+    }
+    return std::move(input_);
+  }
+
+  BlockingReason isBlocked(ContinueFuture* future) override {
+    if (future_.valid()) {
+      *future = std::move(future_);
+      blocked = true;
+      return BlockingReason::kWaitForConsumer;
+    }
+    return BlockingReason::kNotBlocked;
+  }
+
+  bool canReclaim() const override {
+    return true;
+  }
+
+  void reclaim() override {
+    if (memory_) {
+      pool()->free(memory_, kBytes);
+      memory_ = nullptr;
+      reclaimed_ = true;
+    }
+  }
+
+  void close() override {
+    reclaim();
+    Operator::close();
+  }
+
+ private:
+  void* memory_{nullptr};
+  bool reclaimed_{false};
+  bool blocked_{false};
+  ContinueFuture future_;
+};
+
+std::optional<VeloxPromise<bool>> TestingReclaimer::continuePromise;
+std::atomic<bool> TestingReclaimer::blocked{false};
+
+void registerTestingReclaimer() {
+  static bool registered = false;
+  if (registered) {
+    return;
+  }
+  registered = true;
+  Operator::registerOperator(
+      [](DriverCtx* ctx,
+         int32_t id,
+         const std::shared_ptr<const core::PlanNode>& node)
+          -> std::unique_ptr<Operator> {
+        if (auto reclaimer =
+                std::dynamic_pointer_cast<const TestingReclaimerNode>(node)) {
+          return std::make_unique<TestingReclaimer>(ctx, id, reclaimer);
+        }
+        return nullptr;
+      });
+}
+} // namespace
+
+class MemoryArbitratorTest : public testing::Test {
+ protected:
+  static constexpr int64_t kLimit = 1 << 20;
+
+  void SetUp() override {
+    root_ = memory::MemoryUsageTracker::create(
+        memory::MemoryUsageConfigBuilder().maxTotalMemory(kLimit).build());
+  }
+
+  void TearDown() override {
+    for (auto& [pool, buffer, size] : allocations_) {
+      pool->free(buffer, size);
+    }
+  }
+
+  std::shared_ptr<core::QueryCtx> makeQueryCtx() {
+    auto queryCtx = std::make_shared<core::QueryCtx>();
+    queryCtx->pool()->setMemoryUsageTracker(root_->addChild());
+    return queryCtx;
+  }
+
+  // Makes a Task of a new query unless 'queryCtx' is given.
+  std::shared_ptr<Task> makeTask(
+      const std::string& taskId,
+      std::shared_ptr<core::QueryCtx> queryCtx = nullptr) {
+    if (!queryCtx) {
+      queryCtx = makeQueryCtx();
+    }
+    auto task = std::make_shared<Task>(taskId, nullptr, 0, queryCtx);
+    arbitrator_.addTask(task);
+    // Kept alive until 'allocations_' are freed from their pools.
+    tasks_.push_back(task);
+    return task;
+  }
+
+  void allocate(Task& task, int64_t size) {
+    auto* pool = task.pool();
+    allocations_.emplace_back(pool, pool->allocate(size), size);
+  }
+
+  std::shared_ptr<memory::MemoryUsageTracker> root_;
+  MemoryArbitrator arbitrator_;
+  std::vector<std::shared_ptr<Task>> tasks_;
+  std::vector<std::tuple<memory::MemoryPool*, void*, int64_t>> allocations_;
+};
+
+TEST_F(MemoryArbitratorTest, abortLargest) {
+  auto large = makeTask("large");
+  auto small = makeTask("small");
+  allocate(*large, kLimit / 2);
+  allocate(*small, kLimit / 4);
+
+  // 'large' has no reclaimable memory and is aborted in favor of
+  // 'small'. The memory of 'large' is held by the test and is not freed
+  // by the abort, so the reclaim still fails.
+  EXPECT_FALSE(arbitrator_.reclaim(small.get(), *root_, kLimit / 2));
+  EXPECT_EQ(kFailed, large->state());
+  EXPECT_EQ(kRunning, small->state());
+  EXPECT_NE(
+      std::string::npos,
+      large->errorMessage().find("Aborted to free memory for another query"));
+
+  auto stats = arbitrator_.stats();
+  EXPECT_EQ(0, stats.numReclaims);
+  EXPECT_EQ(1, stats.numAborts);
+}
+
+TEST_F(MemoryArbitratorTest, abortWholeQuery) {
+  auto queryCtx = makeQueryCtx();
+  auto first = makeTask("first", queryCtx);
+  auto second = makeTask("second", queryCtx);
+  auto single = makeTask("single");
+  auto requester = makeTask("requester");
+  allocate(*first, kLimit / 4);
+  allocate(*second, kLimit / 4);
+  allocate(*single, kLimit * 3 / 8);
+  allocate(*requester, kLimit / 16);
+
+  // The query of 'first' and 'second' uses the most memory although
+  // 'single' is the largest Task. All its Tasks are aborted.
+  EXPECT_FALSE(arbitrator_.reclaim(requester.get(), *root_, kLimit / 4));
+  EXPECT_EQ(kFailed, first->state());
+  EXPECT_EQ(kFailed, second->state());
+  EXPECT_EQ(kRunning, single->state());
+  EXPECT_EQ(kRunning, requester->state());
+  EXPECT_EQ(1, arbitrator_.stats().numAborts);
+}
+
+TEST_F(MemoryArbitratorTest, requesterQueryIsLargest) {
+  auto queryCtx = makeQueryCtx();
+  auto requester = makeTask("requester", queryCtx);
+  auto sibling = makeTask("sibling", queryCtx);
+  auto other = makeTask("other");
+  allocate(*requester, kLimit / 8);
+  allocate(*sibling, kLimit / 2);
+  allocate(*other, kLimit / 4);
+
+  // Neither another query nor a Task of the requester's own query is
+  // aborted. The requester fails its reservation.
+  EXPECT_FALSE(arbitrator_.reclaim(requester.get(), *root_, kLimit / 2));
+  EXPECT_EQ(kRunning, sibling->state());
+  EXPECT_EQ(kRunning, other->state());
+  EXPECT_EQ(0, arbitrator_.stats().numAborts);
+}
+
+TEST_F(MemoryArbitratorTest, requesterIsLargest) {
+  auto large = makeTask("large");
+  auto small = makeTask("small");
+  allocate(*large, kLimit / 2);
+  allocate(*small, kLimit / 4);
+
+  // The requester fails its reservation rather than aborting others.
+  EXPECT_FALSE(arbitrator_.reclaim(large.get(), *root_, kLimit / 2));
+  EXPECT_EQ(kRunning, large->state());
+  EXPECT_EQ(kRunning, small->state());
+  EXPECT_EQ(0, arbitrator_.stats().numAborts);
+}
+
+TEST_F(MemoryArbitratorTest, ownLimit) {
+  auto first = makeTask("first");
+  auto second = makeTask("second");
+  allocate(*first, kLimit / 2);
+  allocate(*second, kLimit / 4);
+
+  // Exceeding a limit that covers only the requester does not touch
+  // other Tasks.
+  auto& tracker = *second->pool()->getMemoryUsageTracker();
+  EXPECT_FALSE(arbitrator_.reclaim(second.get(), tracker, kLimit / 2));
+  EXPECT_EQ(kRunning, first->state());
+  EXPECT_EQ(0, arbitrator_.stats().numAborts);
+}
+
+TEST_F(MemoryArbitratorTest, notOnDriverThread) {
+  auto task = makeTask("task");
+  allocate(*task, kLimit / 2);
+
+  // Reservations outside of Driver threads are not arbitrated.
+  EXPECT_THROW(allocate(*task, kLimit), VeloxRuntimeError);
+  EXPECT_EQ(0, arbitrator_.stats().numRequests);
+}
+
+TEST_F(MemoryArbitratorTest, reclaimWithoutAbort) {
+  registerTestingReclaimer();
+
+  // The requester allocates first so that the reclaimer cannot take a
+  // whole reservation chunk and holds exactly what it allocates.
+  auto requester = makeTask("requester");
+  allocate(*requester, kLimit / 4);
+
+  auto pool = memory::getDefaultScopedMemoryPool();
+  VectorMaker vectorMaker(pool.get());
+  auto data = vectorMaker.rowVector(
+      {vectorMaker.flatVector<int64_t>({1, 2, 3})});
+  CursorParameters params;
+  params.planNode =
+      PlanBuilder()
+          .values({data})
+          .addNode(
+              [](std::string id, std::shared_ptr<const core::PlanNode> input) {
+                return std::make_shared<TestingReclaimerNode>(id, input);
+              })
+          .planNode();
+  params.queryCtx = core::QueryCtx::create();
+  params.queryCtx->pool()->setMemoryUsageTracker(root_->addChild());
+
+  // The first batch comes out once the reclaimer holds its memory. Its
+  // Driver is then blocked and off thread.
+  TaskCursor cursor(params);
+  ASSERT_TRUE(cursor.moveNext());
+  auto reclaimerTask = cursor.task();
+  arbitrator_.addTask(reclaimerTask);
+  ASSERT_LE(
+      TestingReclaimer::kBytes + kLimit / 4, root_->getCurrentTotalBytes());
+
+  EXPECT_TRUE(arbitrator_.reclaim(requester.get(), *root_, kLimit / 4));
+  EXPECT_EQ(kRunning, reclaimerTask->state());
+  auto stats = arbitrator_.stats();
+  EXPECT_EQ(1, stats.numReclaims);
+  EXPECT_LE(TestingReclaimer::kBytes, stats.reclaimedBytes);
+  EXPECT_EQ(0, stats.numAborts);
+
+  // The reclaimed Task runs to completion.
+  TestingReclaimer::continuePromise->setValue(true);
+  while (cursor.moveNext()) {
+  }
+  EXPECT_FALSE(reclaimerTask->error());
+}
+
+TEST_F(MemoryArbitratorTest, reclaimPartialAggregation) {
+  registerTestingReclaimer();
+  TestingReclaimer::blocked = false;
+
+  auto requester = makeTask("requester");
+  allocate(*requester, kLimit / 4);
+
+  auto pool = memory::getDefaultScopedMemoryPool();
+  VectorMaker vectorMaker(pool.get());
+  auto data = vectorMaker.rowVector(
+      {vectorMaker.flatVector<int64_t>({1, 2, 3, 1, 2, 3}),
+       vectorMaker.flatVector<int64_t>({1, 2, 3, 4, 5, 6})});
+  CursorParameters params;
+  params.planNode =
+      PlanBuilder()
+          .values({data, data})
+          .addNode(
+              [](std::string id, std::shared_ptr<const core::PlanNode> input) {
+                return std::make_shared<TestingReclaimerNode>(id, input);
+              })
+          .partialAggregation({0}, {"sum(c1)"})
+          .planNode();
+  params.queryCtx = core::QueryCtx::create();
+  params.queryCtx->pool()->setMemoryUsageTracker(root_->addChild());
+
+  // The partial aggregation produces no output before its input ends, so
+  // the results are read on another thread.
+  TaskCursor cursor(params);
+  std::vector<RowVectorPtr> results;
+  std::thread consumer([&]() {
+    while (cursor.moveNext()) {
+      results.push_back(cursor.current());
+    }
+  });
+  while (!TestingReclaimer::blocked) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  // The aggregation holds the groups of the first batch. Reclaiming moves
+  // them to its output.
+  auto aggregationTask = cursor.task();
+  arbitrator_.addTask(aggregationTask);
+  EXPECT_TRUE(arbitrator_.reclaim(requester.get(), *root_, kLimit / 4));
+  EXPECT_EQ(kRunning, aggregationTask->state());
+
+  TestingReclaimer::continuePromise->setValue(true);
+  consumer.join();
+  EXPECT_FALSE(aggregationTask->error());
+
+  // The groups of the first batch come out when reclaimed and the groups
+  // of the second batch at the end, so each key is in the output twice.
+  int32_t numRows = 0;
+  int64_t total = 0;
+  for (auto& result : results) {
+    numRows += result->size();
+    auto sums = result->childAt(1)->asFlatVector<int64_t>();
+    for (auto i = 0; i < result->size(); ++i) {
+      total += sums->valueAt(i);
+    }
+  }
+  EXPECT_EQ(6, numRows);
+  EXPECT_EQ(2 * 21, total);
+}
@@ -473,6 +473,36 @@ TEST_P(TableScanTest, multipleSplits) {
   assertQuery(tableScanNode(), filePaths, "SELECT * FROM tmp");
 }
 
+TEST_P(TableScanTest, preloadSplits) {
+  auto filePaths = makeFilePaths(10);
+  auto vectors = makeVectors(10, 1'000);
+  for (int32_t i = 0; i < vectors.size(); i++) {
+    writeToFile(filePaths[i]->path, kTableScanTest, vectors[i]);
+  }
+  createDuckDbTable(vectors);
+
+  auto task = assertQuery(tableScanNode(), filePaths, "SELECT * FROM tmp");
+  auto numPreloaded =
+      getTableScanStats(task).runtimeStats["numPreloadedSplits"].sum;
+  // Splits are opened in the background only if the connector has an
+  // executor.
+  if (GetParam()) {
+    EXPECT_LT(0, numPreloaded);
+  } else {
+    EXPECT_EQ(0, numPreloaded);
+  }
+
+  // Preloaded splits are opened with the table filters applied.
+  auto tableHandle =
+      makeTableHandle(singleSubfieldFilter("c1", lessThanOrEqual(-1)));
+  assertQuery(
+      PlanBuilder()
+          .tableScan(rowType_, tableHandle, allRegularColumns(rowType_))
+          .planNode(),
+      filePaths,
+      "SELECT * FROM tmp WHERE c1 <= -1");
+}
+
 TEST_P(TableScanTest, waitForSplit) {
   auto filePaths = makeFilePaths(10);
   auto vectors = makeVectors(10, 1'000);
@@ -32,13 +32,15 @@ namespace codegen {
 
 bool Codegen::initialize(
     const std::string_view& codegenOptionsJson,
-    bool lazyLoading) {
+    bool lazyLoading,
+    bool backgroundCompilation) {
   try {
     codegenLogger_->onInitialize(lazyLoading);
     auto codegenOptionsProto = proto::proto_utils::ProtoUtils<
         proto::CodegenOptionsProto>::loadProtoFromJson(codegenOptionsJson);
 
     useSymbolsForArithmetic_ = codegenOptionsProto.usesymbolsforarithmetic();
+    backgroundCompilation_ = backgroundCompilation;
     initializeCodeManager(codegenOptionsProto.compileroptions());
     initializeUDFManager();
     initializeTransform();
@@ -55,11 +57,13 @@ bool Codegen::initialize(
 
 bool Codegen::initializeFromFile(
     const std::filesystem::path& codegenOptionsJsonFile,
-    bool lazyLoading) {
+    bool lazyLoading,
+    bool backgroundCompilation) {
   codegenLogger_->onInitializeFromFile(codegenOptionsJsonFile, lazyLoading);
   return initialize(
       proto::proto_utils::readFromFile(codegenOptionsJsonFile).str(),
-      lazyLoading);
+      lazyLoading,
+      backgroundCompilation);
 }
 
 std::shared_ptr<const core::PlanNode> Codegen::compile(
@@ -94,12 +98,15 @@ bool Codegen::initializeUDFManager() {
 
 bool Codegen::initializeTransform() {
   LOG(INFO) << "Codegen: initializing Transform";
+  auto flags = CodegenCompiledExpressionTransform::defaultFlags;
+  flags.backgroundCompilation = backgroundCompilation_;
   transform_ = std::make_shared<CodegenCompiledExpressionTransform>(
       CodegenCompiledExpressionTransform(
           codeManager_->compiler().compilerOptions(),
           *udfManager_,
           useSymbolsForArithmetic_,
-          *std::static_pointer_cast<DefaultEventSequence>(eventSequence_)));
+          *std::static_pointer_cast<DefaultEventSequence>(eventSequence_),
+          flags));
   return true;
 }
 
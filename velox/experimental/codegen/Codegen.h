@@ -38,13 +38,18 @@ class Codegen {
   explicit Codegen(std::shared_ptr<ICodegenLogger> codegenLogger)
       : codegenLogger_(codegenLogger) {}
 
+  /// If 'backgroundCompilation' is true and the compiler options have a
+  /// library cache directory, compile() returns the plan with the expressions
+  /// missing from the cache interpreted and compiles them in the background.
   bool initialize(
       const std::string_view& codegenOptionsJson,
-      bool lazyLoading = true);
+      bool lazyLoading = true,
+      bool backgroundCompilation = false);
 
   bool initializeFromFile(
       const std::filesystem::path& codegenOptionsJsonFile,
-      bool lazyLoading = true);
+      bool lazyLoading = true,
+      bool backgroundCompilation = false);
 
   std::shared_ptr<const core::PlanNode> compile(const core::PlanNode& planNode);
 
@@ -62,6 +67,8 @@ class Codegen {
   // Follows Velox, defaults to false
   bool useSymbolsForArithmetic_ = false;
 
+  bool backgroundCompilation_ = false;
+
   bool initializeCodeManager(
       const proto::CompilerOptionsProto& compilerOptionsProto);
 
@@ -24,6 +24,7 @@
 #include "velox/experimental/codegen/CompiledExpressionAnalysis.h"
 #include "velox/experimental/codegen/code_generator/ExprCodeGenerator.h"
 #include "velox/experimental/codegen/compiler_utils/CodeManager.h"
+#include "velox/experimental/codegen/compiler_utils/CompiledLibraryCache.h"
 #include "velox/experimental/codegen/compiler_utils/ICompiledCall.h"
 #include "velox/experimental/codegen/transform/PlanNodeTransform.h"
 #include "velox/experimental/codegen/transform/utils/ranges_utils.h"
@@ -44,11 +45,16 @@ class CompiledExpressionTransformVisitor {
       const CompilerOptions& options,
       DefaultScopedTimer::EventSequence& eventSequence,
       bool compileFilter = true,
-      bool mergeFilter = true)
+      bool mergeFilter = true,
+      std::shared_ptr<compiler_utils::CompiledLibraryCache> libraryCache =
+          nullptr,
+      bool backgroundCompilation = false)
       : codeManager_(options, eventSequence),
         compiledExprAnalysisResult_(compiledExprAnalysisResult),
         compileFilter_(compileFilter),
-        mergeFilter_(mergeFilter) {}
+        mergeFilter_(mergeFilter),
+        libraryCache_(std::move(libraryCache)),
+        backgroundCompilation_(backgroundCompilation) {}
 
   template <typename Children>
   std::shared_ptr<core::PlanNode> visit(
@@ -109,6 +115,29 @@ class CompiledExpressionTransformVisitor {
   bool compileFilter_;
   bool mergeFilter_;
 
+  // Compiled libraries kept across processes. If null, every library is
+  // compiled.
+  std::shared_ptr<compiler_utils::CompiledLibraryCache> libraryCache_;
+
+  // If true, libraries missing from 'libraryCache_' are compiled in the
+  // background and the expressions are interpreted meanwhile.
+  bool backgroundCompilation_;
+
+  /// Returns the shared library compiled from 'fileString', or std::nullopt
+  /// if it is being compiled in the background.
+  std::optional<std::filesystem::path> compileLibrary(
+      const std::string& fileString) {
+    if (!libraryCache_) {
+      auto compiledObject =
+          codeManager_.compiler().compileString({}, fileString);
+      return codeManager_.compiler().link({}, {compiledObject});
+    }
+    if (backgroundCompilation_) {
+      return libraryCache_->getOrCompileAsync(fileString);
+    }
+    return libraryCache_->getOrCompile(fileString);
+  }
+
   std::optional<std::reference_wrapper<const GeneratedExpressionStruct>>
   getGeneratedCode(const std::shared_ptr<const ITypedExpr>& expression) {
     auto it = compiledExprAnalysisResult_.generatedCode_.find(expression);
@@ -486,14 +515,21 @@ class CompiledExpressionTransformVisitor {
             "isDefaultNullStrict",
             isDefaultNullStrict(filter.id()) ? "true" : "false"));
 
-    auto compiledObject = codeManager_.compiler().compileString({}, fileString);
-    auto dynamicObject = codeManager_.compiler().link({}, {compiledObject});
+    auto dynamicObject = compileLibrary(fileString);
+    if (!dynamicObject) {
+      // Interpret the filter until the library is compiled.
+      return utils::adapter::FilterCopy::copyWith(
+          filter,
+          std::placeholders::_1,
+          std::placeholders::_1,
+          *ranges::begin(children));
+    }
 
     // Extract the row input expression from the current filter
     const auto inputType = filter.sources()[0]->outputType();
 
     std::shared_ptr<const ITypedExpr> newFilter = buildCompiledCallExpr(
-        dynamicObject, concatOutputType, concatInputType, inputType)[0];
+        *dynamicObject, concatOutputType, concatInputType, inputType)[0];
 
     // Build new filter node with newly generated expressions
     return utils::adapter::FilterCopy::copyWith(
@@ -583,8 +619,16 @@ class CompiledExpressionTransformVisitor {
         fmt::arg(
             "isDefaultNullStrict", isDefaultNullStrict ? "true" : "false"));
 
-    auto compiledObject = codeManager_.compiler().compileString({}, fileString);
-    auto dynamicObject = codeManager_.compiler().link({}, {compiledObject});
+    auto dynamicObject = compileLibrary(fileString);
+    if (!dynamicObject) {
+      // Interpret the projection until the library is compiled.
+      return utils::adapter::ProjectCopy::copyWith(
+          projection,
+          std::placeholders::_1,
+          std::placeholders::_1,
+          std::placeholders::_1,
+          *ranges::begin(children));
+    }
     std::vector<std::shared_ptr<const ITypedExpr>> newProjections;
 
     // Extract the row input expression from the current projection
@@ -592,7 +636,7 @@ class CompiledExpressionTransformVisitor {
 
     std::vector<std::shared_ptr<const ITypedExpr>> newExpressions =
         buildCompiledCallExpr(
-            dynamicObject, concatOutputType, concatInputType, inputType);
+            *dynamicObject, concatOutputType, concatInputType, inputType);
 
     // oldToNewExpressionColumnMap[Index] in the new projection list maps to
     // projection.projections()[Index] in the old;
@@ -642,6 +686,11 @@ union TransformFlags {
     // invalid if enableDefaultNullOpt not set
     bool enableFilterDefaultNull : 1;
 
+    // compile the libraries missing from the library cache in the background
+    // and interpret the plan meanwhile
+    // invalid if CompilerOptions::libraryCacheDirectory not set
+    bool backgroundCompilation : 1;
+
     // up for more flags in the future
   };
 
@@ -678,12 +727,20 @@ class CodegenCompiledExpressionTransform final : PlanNodeTransform {
 
     expressionAnalysis.run(plan);
 
+    std::shared_ptr<compiler_utils::CompiledLibraryCache> libraryCache;
+    if (compilerOptions_.libraryCacheDirectory.has_value()) {
+      libraryCache =
+          compiler_utils::CompiledLibraryCache::get(compilerOptions_);
+    }
+
     CompiledExpressionTransformVisitor visitor(
         expressionAnalysis.results(),
         compilerOptions_,
         eventSequence_,
         flags_.compileFilter,
-        flags_.mergeFilter);
+        flags_.mergeFilter,
+        std::move(libraryCache),
+        flags_.backgroundCompilation);
 
     auto nodeTransformer = [&visitor](
                                auto& node, const auto& transformedChildren) {
@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <folly/Synchronized.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/hash/SpookyHashV2.h>
+#include <link.h>
+#include <cstring>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include "glog/logging.h"
+#include "velox/experimental/codegen/compiler_utils/Compiler.h"
+#include "velox/experimental/codegen/compiler_utils/CompilerOptions.h"
+#include "velox/experimental/codegen/external_process/Filesystem.h"
+#include "velox/experimental/codegen/utils/timer/NestedScopedTimer.h"
+
+namespace facebook::velox::codegen::compiler_utils {
+
+/// Keeps the shared libraries compiled from generated code in a directory, so
+/// that a process restart does not pay the compilation again. A library is
+/// keyed by a hash of its source, of the compiler options and of the build id
+/// of the running executable. The generated source is a function of the
+/// compiled expressions and their input types. The build id identifies the
+/// Velox build whose headers the source includes.
+/// Libraries are linked into a temporary file and renamed into place, so
+/// several processes can share a directory.
+class CompiledLibraryCache {
+ public:
+  CompiledLibraryCache(
+      const CompilerOptions& options,
+      std::filesystem::path directory)
+      : options_(options),
+        directory_(std::move(directory)),
+        optionsHash_(hashOptions(options)),
+        // Compilations run one at a time so that they do not take the cores
+        // of running queries.
+        executor_(std::make_unique<folly::CPUThreadPoolExecutor>(1)) {
+    std::filesystem::create_directories(directory_);
+  }
+
+  /// Waits for the background compilations to finish.
+  ~CompiledLibraryCache() {
+    executor_->join();
+  }
+
+  /// Returns the cache for 'options.libraryCacheDirectory'. The cache is
+  /// shared by all users in the process with the same options.
+  static std::shared_ptr<CompiledLibraryCache> get(
+      const CompilerOptions& options) {
+    VELOX_CHECK(options.libraryCacheDirectory.has_value());
+    static folly::Synchronized<
+        std::unordered_map<std::string, std::shared_ptr<CompiledLibraryCache>>>
+        caches;
+    auto locked = caches.wlock();
+    auto& cache = (*locked)[CompilerOptions::formatAsJson(options)];
+    if (!cache) {
+      cache = std::make_shared<CompiledLibraryCache>(
+          options, options.libraryCacheDirectory.value());
+    }
+    return cache;
+  }
+
+  /// Returns the key of the library compiled from 'cppContent'.
+  std::string key(const std::string& cppContent) const {
+    uint64_t hash1 = optionsHash_;
+    uint64_t hash2 = optionsHash_;
+    folly::hash::SpookyHashV2::Hash128(
+        cppContent.data(), cppContent.size(), &hash1, &hash2);
+    return fmt::format("{:016x}{:016x}", hash1, hash2);
+  }
+
+  /// Returns the library compiled from 'cppContent' if it is in the cache.
+  std::optional<std::filesystem::path> find(
+      const std::string& cppContent) const {
+    auto path = libraryPath(key(cppContent));
+    if (std::filesystem::exists(path)) {
+      return path;
+    }
+    return std::nullopt;
+  }
+
+  /// Returns the library compiled from 'cppContent'. Compiles it if it is not
+  /// in the cache.
+  std::filesystem::path getOrCompile(const std::string& cppContent) {
+    auto path = libraryPath(key(cppContent));
+    if (!std::filesystem::exists(path)) {
+      compile(cppContent, path);
+    }
+    return path;
+  }
+
+  /// Returns the library compiled from 'cppContent' if it is in the cache.
+  /// Otherwise starts compiling it in the background and returns
+  /// std::nullopt. The caller is expected to interpret the code meanwhile.
+  std::optional<std::filesystem::path> getOrCompileAsync(
+      const std::string& cppContent) {
+    auto libraryKey = key(cppContent);
+    auto path = libraryPath(libraryKey);
+    if (std::filesystem::exists(path)) {
+      return path;
+    }
+    if (started_.wlock()->insert(libraryKey).second) {
+      executor_->add([this, libraryKey, path, cppContent]() {
+        try {
+          compile(cppContent, path);
+        } catch (const std::exception& e) {
+          // The key stays in 'started_', so that the library is not retried
+          // by this process.
+          LOG(ERROR) << "Background compilation of " << path
+                     << " failed: " << e.what();
+          return;
+        }
+        started_.wlock()->erase(libraryKey);
+      });
+    }
+    return std::nullopt;
+  }
+
+  const std::filesystem::path& directory() const {
+    return directory_;
+  }
+
+ private:
+  // Hashes the options that affect the compiled code and the build id.
+  static uint64_t hashOptions(const CompilerOptions& options) {
+    auto keyOptions = options;
+    keyOptions.tempDirectory.clear();
+    keyOptions.libraryCacheDirectory.reset();
+    auto json = CompilerOptions::formatAsJson(keyOptions);
+    return folly::hash::SpookyHashV2::Hash64(
+        json.data(), json.size(), buildId());
+  }
+
+  // Returns a hash of the GNU build id of the running executable. A library
+  // compiled against the headers of one Velox build must not be loaded by
+  // another. Falls back to the path, size and modification time of the
+  // executable if it was linked without a build id.
+  static uint64_t buildId() {
+    static const uint64_t id = [] {
+      std::string buildIdNote;
+      dl_iterate_phdr(
+          [](struct dl_phdr_info* info, size_t /*size*/, void* data) {
+            // The executable is the first object. Returning non-zero stops
+            // the iteration.
+            auto* buildIdNote = static_cast<std::string*>(data);
+            for (auto i = 0; i < info->dlpi_phnum; ++i) {
+              const auto& header = info->dlpi_phdr[i];
+              if (header.p_type != PT_NOTE) {
+                continue;
+              }
+              auto* note = reinterpret_cast<const char*>(
+                  info->dlpi_addr + header.p_vaddr);
+              auto* end = note + header.p_memsz;
+              while (note + sizeof(ElfW(Nhdr)) <= end) {
+                auto* noteHeader = reinterpret_cast<const ElfW(Nhdr)*>(note);
+                auto* name = note + sizeof(ElfW(Nhdr));
+                auto* desc = name + alignNote(noteHeader->n_namesz);
+                if (noteHeader->n_type == NT_GNU_BUILD_ID &&
+                    noteHeader->n_namesz == sizeof(ELF_NOTE_GNU) &&
+                    memcmp(name, ELF_NOTE_GNU, sizeof(ELF_NOTE_GNU)) == 0) {
+                  buildIdNote->assign(desc, noteHeader->n_descsz);
+                  return 1;
+                }
+                note = desc + alignNote(noteHeader->n_descsz);
+              }
+            }
+            return 1;
+          },
+          &buildIdNote);
+      if (buildIdNote.empty()) {
+        auto path = std::filesystem::read_symlink("/proc/self/exe");
+        buildIdNote = fmt::format(
+            "{}:{}:{}",
+            path.string(),
+            std::filesystem::file_size(path),
+            std::filesystem::last_write_time(path).time_since_epoch().count());
+      }
+      return folly::hash::SpookyHashV2::Hash64(
+          buildIdNote.data(), buildIdNote.size(), 0);
+    }();
+    return id;
+  }
+
+  // Returns the size of a field of an ELF note padded to 4 bytes.
+  static size_t alignNote(size_t size) {
+    return (size + 3) & ~size_t{3};
+  }
+
+  std::filesystem::path libraryPath(const std::string& libraryKey) const {
+    return directory_ / (libraryKey + ".so");
+  }
+
+  void compile(
+      const std::string& cppContent,
+      const std::filesystem::path& path) const {
+    // Compiler is not thread safe. Each compilation uses its own.
+    DefaultScopedTimer::EventSequence eventSequence;
+    Compiler compiler(options_, eventSequence);
+    auto object = compiler.compileString({}, cppContent);
+    filesystem::PathGenerator pathGenerator;
+    auto tempPath =
+        pathGenerator.tempPath(directory_, path.stem().string(), ".tmp");
+    try {
+      compiler.link({}, {object}, tempPath);
+      std::filesystem::rename(tempPath, path);
+    } catch (const std::exception&) {
+      std::error_code ec;
+      std::filesystem::remove(tempPath, ec);
+      std::filesystem::remove(object, ec);
+      throw;
+    }
+    std::filesystem::remove(object);
+  }
+
+  const CompilerOptions options_;
+  const std::filesystem::path directory_;
+  const uint64_t optionsHash_;
+  // Keys of the libraries compiling in the background.
+  folly::Synchronized<std::unordered_set<std::string>> started_;
+  std::unique_ptr<folly::CPUThreadPoolExecutor> executor_;
+};
+} // namespace facebook::velox::codegen::compiler_utils
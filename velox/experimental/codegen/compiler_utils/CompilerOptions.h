@@ -38,6 +38,9 @@ struct CompilerOptions {
   std::optional<std::filesystem::path> linker;
   std::optional<std::filesystem::path> formatterPath;
   std::filesystem::path tempDirectory;
+  /// Directory of the compiled libraries kept across process restarts. See
+  /// CompiledLibraryCache.
+  std::optional<std::filesystem::path> libraryCacheDirectory;
 
   /// Converts a CompilerOptionsProto to a CompilerOptions
   static CompilerOptions fromProto(
@@ -73,6 +76,10 @@ struct CompilerOptions {
     if (!compilerOptionsProto.formatterpath().empty()) {
       compilerOptions.withFormatterPath(compilerOptionsProto.formatterpath());
     }
+    if (!compilerOptionsProto.librarycachedirectory().empty()) {
+      compilerOptions.withLibraryCacheDirectory(
+          compilerOptionsProto.librarycachedirectory());
+    }
     return compilerOptions;
   }
 
@@ -134,6 +141,8 @@ struct CompilerOptions {
     compilerOptionsProto.set_formatterpath(
         compilerOptions.formatterPath.value_or(""));
     compilerOptionsProto.set_tempdirectory(compilerOptions.tempDirectory);
+    compilerOptionsProto.set_librarycachedirectory(
+        compilerOptions.libraryCacheDirectory.value_or(""));
 
     return compilerOptionsProto;
   }
@@ -201,5 +210,11 @@ struct CompilerOptions {
     formatterPath = path;
     return *this;
   }
+
+  CompilerOptions& withLibraryCacheDirectory(
+      const std::filesystem::path& path) {
+    libraryCacheDirectory = path;
+    return *this;
+  }
 };
 } // namespace facebook::velox::codegen::compiler_utils
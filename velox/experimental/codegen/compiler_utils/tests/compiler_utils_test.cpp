@@ -20,6 +20,7 @@
 #include <iostream>
 #include <regex>
 #include "boost/filesystem.hpp"
+#include "velox/experimental/codegen/compiler_utils/CompiledLibraryCache.h"
 #include "velox/experimental/codegen/compiler_utils/Compiler.h"
 #include "velox/experimental/codegen/compiler_utils/tests/definitions.h"
 #include "velox/experimental/codegen/external_process/Filesystem.h"
@@ -290,4 +291,79 @@ TEST(Compiler, CompileAndLink) {
   ASSERT_EQ(dlerror(), nullptr);
   ASSERT_EQ(f(), 24);
 };
+
+TEST(CompiledLibraryCache, persistsAcrossInstances) {
+  auto sourceCode1 = R"a(
+  extern "C" {
+  int f() {
+    return 24;
+  };
+  }
+  )a";
+
+  auto sourceCode2 = R"a(
+  extern "C" {
+  int g() {
+    return 32;
+  };
+  }
+  )a";
+
+  auto directory = std::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path("library-cache-%%%%-%%%%").string();
+  auto options = testCompilerOptions();
+
+  std::filesystem::path library1;
+  {
+    CompiledLibraryCache cache(options, directory);
+    ASSERT_FALSE(cache.find(sourceCode1).has_value());
+    library1 = cache.getOrCompile(sourceCode1);
+    ASSERT_EQ(library1, cache.find(sourceCode1));
+    ASSERT_EQ(library1, cache.getOrCompile(sourceCode1));
+
+    // Compiles in the background. The destructor waits for the compilation.
+    ASSERT_FALSE(cache.getOrCompileAsync(sourceCode2).has_value());
+  }
+
+  // A new cache, e.g. after a restart, finds both libraries.
+  CompiledLibraryCache cache(options, directory);
+  ASSERT_EQ(library1, cache.find(sourceCode1));
+  auto library2 = cache.getOrCompileAsync(sourceCode2);
+  ASSERT_TRUE(library2.has_value());
+
+  auto libraryPtr =
+      native_loader::NativeLibraryLoader::loadLibraryInternal(*library2);
+  auto g = (int (*)())dlsym(libraryPtr, "g");
+  ASSERT_EQ(g(), 32);
+
+  // Different compiler options do not share libraries.
+  auto otherOptions = testCompilerOptions();
+  otherOptions.extraCompileOptions.push_back("-g");
+  CompiledLibraryCache otherCache(otherOptions, directory);
+  ASSERT_NE(cache.key(sourceCode1), otherCache.key(sourceCode1));
+  ASSERT_FALSE(otherCache.find(sourceCode1).has_value());
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST(CompiledLibraryCache, failedCompilation) {
+  auto badSourceCode = R"a(
+  extern "C" {
+  int f() {
+    return undefined;
+  };
+  }
+  )a";
+
+  auto directory = std::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path("library-cache-%%%%-%%%%").string();
+  CompiledLibraryCache cache(testCompilerOptions(), directory);
+  ASSERT_ANY_THROW(cache.getOrCompile(badSourceCode));
+
+  // Nothing is left in the cache directory.
+  ASSERT_FALSE(cache.find(badSourceCode).has_value());
+  ASSERT_TRUE(std::filesystem::is_empty(directory));
+
+  std::filesystem::remove_all(directory);
+}
 } // namespace facebook::velox::codegen::compiler_utils::test
@@ -25,6 +25,193 @@ namespace facebook::velox::exec {
 
 namespace {
 
+template <typename T>
+constexpr bool isNumber() {
+  return std::is_arithmetic_v<T> && !std::is_same_v<T, bool>;
+}
+
+/// True if every value of From converts to To exactly, so that the cast is a
+/// plain static_cast that cannot fail.
+template <typename From, typename To>
+constexpr bool isWidening() {
+  if constexpr (!isNumber<From>() || !isNumber<To>()) {
+    return false;
+  } else if constexpr (std::is_integral_v<From>) {
+    // Integers to floating point round like Converter does.
+    return std::is_floating_point_v<To> || sizeof(To) >= sizeof(From);
+  } else {
+    return std::is_floating_point_v<To> && sizeof(To) >= sizeof(From);
+  }
+}
+
+constexpr uint64_t kPowersOfTen[] = {
+    1,
+    10,
+    100,
+    1'000,
+    10'000,
+    100'000,
+    1'000'000,
+    10'000'000,
+    100'000'000};
+
+/// Returns true if all 8 bytes of 'chunk' are ASCII digits.
+inline bool isEightDigits(uint64_t chunk) {
+  return ((chunk & 0xF0F0F0F0F0F0F0F0ULL) |
+          (((chunk + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) ==
+      0x3333333333333333ULL;
+}
+
+/// Returns the value of 8 ASCII digits loaded little endian, so that the
+/// first digit is the lowest byte. Combines adjacent digits, then pairs
+/// and quads with three multiplications instead of one per digit.
+inline uint64_t parseEightDigits(uint64_t chunk) {
+  chunk -= 0x3030303030303030ULL;
+  chunk = (chunk * 10 + (chunk >> 8)) & 0x00FF00FF00FF00FFULL;
+  chunk = (chunk * 100 + (chunk >> 16)) & 0x0000FFFF0000FFFFULL;
+  return (chunk * 10'000 + (chunk >> 32)) & 0xFFFFFFFFULL;
+}
+
+/// Parses up to 18 decimal digits 8 at a time. Returns false if 'data' is
+/// empty, longer than 18 characters or has characters other than digits.
+inline bool parseDigits(const char* data, int32_t size, uint64_t& value) {
+  if (size <= 0 || size > 18) {
+    return false;
+  }
+  value = 0;
+  while (size > 0) {
+    auto chunkSize = std::min(size, 8);
+    // Leading '0' bytes pad a chunk shorter than 8 digits.
+    uint64_t chunk = 0x3030303030303030ULL;
+    memcpy(reinterpret_cast<char*>(&chunk) + 8 - chunkSize, data, chunkSize);
+    if (!isEightDigits(chunk)) {
+      return false;
+    }
+    value = value * kPowersOfTen[chunkSize] + parseEightDigits(chunk);
+    data += chunkSize;
+    size -= chunkSize;
+  }
+  return true;
+}
+
+/// Fast path for casting a string to an integer. Handles an optional minus
+/// sign followed by up to 18 digits. Returns false for anything else, e.g.
+/// whitespace, a plus sign, more digits or values out of range for T, so
+/// that the general conversion produces the result or the error.
+template <typename T>
+bool tryParseInteger(StringView input, T& result) {
+  auto data = input.data();
+  int32_t size = input.size();
+  bool negative = size > 0 && data[0] == '-';
+  uint64_t value;
+  if (!parseDigits(data + negative, size - negative, value)) {
+    return false;
+  }
+  if (negative) {
+    if (value > static_cast<uint64_t>(std::numeric_limits<T>::max()) + 1) {
+      return false;
+    }
+    result = static_cast<T>(-static_cast<int64_t>(value));
+  } else {
+    if (value > static_cast<uint64_t>(std::numeric_limits<T>::max())) {
+      return false;
+    }
+    result = static_cast<T>(value);
+  }
+  return true;
+}
+
+/// Fast path for casting a string to a double. Handles an optional minus
+/// sign and digits with an optional decimal point between digits, when
+/// there are at most 15 digits. The digits then form an integer that is
+/// exact as a double and dividing it by an exact power of ten rounds
+/// correctly, so the result matches the general conversion. Returns false
+/// for anything else.
+inline bool tryParseDouble(StringView input, double& result) {
+  static constexpr double kDoublePowersOfTen[] = {
+      1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12,
+      1e13, 1e14, 1e15};
+  auto data = input.data();
+  int32_t size = input.size();
+  bool negative = size > 0 && data[0] == '-';
+  data += negative;
+  size -= negative;
+  auto point = static_cast<const char*>(memchr(data, '.', size));
+  uint64_t value;
+  int32_t numFractionDigits = 0;
+  if (!point) {
+    if (size > 15 || !parseDigits(data, size, value)) {
+      return false;
+    }
+  } else {
+    int32_t numIntegerDigits = point - data;
+    numFractionDigits = size - numIntegerDigits - 1;
+    uint64_t fraction;
+    if (numIntegerDigits + numFractionDigits > 15 ||
+        !parseDigits(data, numIntegerDigits, value) ||
+        !parseDigits(point + 1, numFractionDigits, fraction)) {
+      return false;
+    }
+    for (auto i = 0; i < numFractionDigits; ++i) {
+      value *= 10;
+    }
+    value += fraction;
+  }
+  result = static_cast<double>(value) / kDoublePowersOfTen[numFractionDigits];
+  if (negative) {
+    result = -result;
+  }
+  return true;
+}
+
+/// Casts numbers to strings, writing the characters of all rows into one
+/// string buffer instead of making a std::string per row. Produces the same
+/// text as folly::to<std::string>.
+template <typename From>
+void castNumberToVarchar(
+    const SelectivityVector& rows,
+    const DecodedVector& input,
+    FlatVector<StringView>* result) {
+  // Longest integer is 20 characters, longest shortest round trip double
+  // is 24.
+  constexpr int32_t kMaxSize = std::is_integral_v<From> ? 20 : 32;
+  auto buffer = result->getBufferWithSpace(rows.countSelected() * kMaxSize);
+  char* start = buffer->asMutable<char>() + buffer->size();
+  char* position = start;
+  std::string scratch;
+  rows.applyToSelected([&](auto row) {
+    auto value = input.valueAt<From>(row);
+    int32_t size;
+    if constexpr (std::is_integral_v<From>) {
+      char digits[kMaxSize];
+      auto end = digits + kMaxSize;
+      auto first = end;
+      uint64_t magnitude = value < 0 ? -static_cast<uint64_t>(value) : value;
+      do {
+        *--first = '0' + magnitude % 10;
+        magnitude /= 10;
+      } while (magnitude);
+      if (value < 0) {
+        *--first = '-';
+      }
+      size = end - first;
+      memcpy(position, first, size);
+    } else {
+      scratch.clear();
+      folly::toAppend(value, &scratch);
+      size = scratch.size();
+      VELOX_DCHECK_LE(size, kMaxSize);
+      memcpy(position, scratch.data(), size);
+    }
+    result->setNoCopy(row, StringView(position, size));
+    // Strings of up to 12 characters are copied into the StringView.
+    if (!StringView::isInline(size)) {
+      position += size;
+    }
+  });
+  buffer->setSize(buffer->size() + (position - start));
+}
+
 /// The per-row level Kernel
 /// @tparam To The cast target type
 /// @tparam From The expression type
@@ -51,6 +238,21 @@ void applyCastKernel(
     }
     proxy.finalize();
   } else {
+    if constexpr (std::is_same_v<From, StringView>) {
+      if constexpr (std::is_same_v<To, double>) {
+        To value;
+        if (tryParseDouble(input.valueAt<StringView>(row), value)) {
+          resultFlatVector->set(row, value);
+          return;
+        }
+      } else if constexpr (isNumber<To>() && std::is_integral_v<To>) {
+        To value;
+        if (tryParseInteger(input.valueAt<StringView>(row), value)) {
+          resultFlatVector->set(row, value);
+          return;
+        }
+      }
+    }
     auto result =
         util::Converter<CppToType<To>::typeKind, void, Truncate>::cast(
             input.valueAt<From>(row));
@@ -79,6 +281,23 @@ void CastExpr::applyCastWithTry(
     exec::EvalCtx* context,
     const DecodedVector& input,
     FlatVector<To>* resultFlatVector) {
+  // Casts that cannot fail run without per-row exception handling.
+  if constexpr (std::is_same_v<To, StringView> && isNumber<From>()) {
+    castNumberToVarchar<From>(rows, input, resultFlatVector);
+    return;
+  } else if constexpr (isWidening<From, To>()) {
+    if (input.isIdentityMapping()) {
+      auto rawInput = input.data<From>();
+      rows.applyToSelected(
+          [&](auto row) { resultFlatVector->set(row, rawInput[row]); });
+    } else {
+      rows.applyToSelected([&](auto row) {
+        resultFlatVector->set(row, input.valueAt<From>(row));
+      });
+    }
+    return;
+  }
+
   const auto& queryCtx = context->execCtx()->queryCtx();
   auto isCastIntByTruncate = queryCtx->isCastIntByTruncate();
 
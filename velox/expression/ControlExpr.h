@@ -111,6 +111,17 @@ class FieldReference : public SpecialForm {
     return index_;
   }
 
+  // True if 'this' is the only reference to its column in the ExprSet. The
+  // column is then loaded only for the rows 'this' is evaluated on. See
+  // ExprSet::markSoleFieldReferences().
+  bool isSoleReference() const {
+    return soleReference_;
+  }
+
+  void setSoleReference() {
+    soleReference_ = true;
+  }
+
   void evalSpecialForm(
       const SelectivityVector& rows,
       EvalCtx* context,
@@ -135,6 +146,7 @@ class FieldReference : public SpecialForm {
  private:
   const std::string field_;
   int32_t index_ = -1;
+  bool soleReference_ = false;
 };
 
 /// CASE expression:
@@ -260,6 +272,10 @@ class LambdaExpr : public SpecialForm {
     return false;
   }
 
+  const std::vector<std::shared_ptr<FieldReference>>& capture() const {
+    return capture_;
+  }
+
   void evalSpecialForm(
       const SelectivityVector& rows,
       EvalCtx* context,
@@ -227,10 +227,14 @@ BaseVector* EvalCtx::getRawField(int32_t index) const {
   return field;
 }
 
-void EvalCtx::ensureFieldLoaded(int32_t index, const SelectivityVector& rows) {
+void EvalCtx::ensureFieldLoaded(
+    int32_t index,
+    const SelectivityVector& rows,
+    bool rowsAreFinal) {
   auto field = getRawField(index);
   if (isLazyNotLoaded(*field)) {
-    const auto& rowsToLoad = isFinalSelection_ ? rows : *finalSelection_;
+    const auto& rowsToLoad =
+        isFinalSelection_ || rowsAreFinal ? rows : *finalSelection_;
 
     LocalDecodedVector holder(this);
     auto decoded = holder.get();
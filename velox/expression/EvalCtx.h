@@ -47,7 +47,13 @@ class EvalCtx {
 
   BaseVector* getRawField(int32_t index) const;
 
-  void ensureFieldLoaded(int32_t index, const SelectivityVector& rows);
+  // Loads the index-th column for 'rows' if it is lazy. Under a conditional,
+  // loads the rows of the final selection instead, since other references to
+  // the column may need them, unless 'rowsAreFinal' is true.
+  void ensureFieldLoaded(
+      int32_t index,
+      const SelectivityVector& rows,
+      bool rowsAreFinal = false);
 
   void setPeeled(int32_t index, const VectorPtr& vector) {
     if (peeledFields_.size() <= index) {
@@ -173,6 +179,25 @@ class EvalCtx {
     wrapNulls_ = std::move(wrapNulls);
   }
 
+  // Makes '*result' writable for 'rows' like BaseVector::ensureWritable().
+  // If '*result' is null, takes a recycled vector from the ExecCtx if
+  // possible.
+  void ensureWritable(
+      const SelectivityVector& rows,
+      const TypePtr& type,
+      VectorPtr* result) const {
+    if (!*result) {
+      *result = execCtx_->getVector(type, rows.size());
+      return;
+    }
+    BaseVector::ensureWritable(rows, type, pool(), result);
+  }
+
+  // Gives singly referenced vectors in 'vectors' to the ExecCtx for reuse.
+  void releaseVectors(std::vector<VectorPtr>& vectors) const {
+    execCtx_->releaseVectors(vectors);
+  }
+
   // Copy "rows" of localResult into results if "result" is partially populated
   // and must be preserved. Copy localResult pointer into result otherwise.
   void moveOrCopyResult(
@@ -15,6 +15,7 @@
  */
 
 #include "velox/expression/Expr.h"
+#include <folly/container/F14Set.h>
 #include "velox/core/Expressions.h"
 #include "velox/expression/ControlExpr.h"
 #include "velox/expression/ExprCompiler.h"
@@ -233,13 +234,24 @@ void Expr::eval(
   // wrapping in the sub-nodes.
   //
   // TODO: Re-work the logic of deciding when to load which field.
+  bool loadedOnRows = false;
   if (!hasConditionals_ || distinctFields_.size() == 1) {
     // Load lazy vectors if any.
     for (const auto& field : distinctFields_) {
-      context->ensureFieldLoaded(field->index(context), rows);
+      context->ensureFieldLoaded(
+          field->index(context), rows, field->isSoleReference());
+      loadedOnRows |= field->isSoleReference();
     }
   }
 
+  // A column referenced only once is loaded only for 'rows'. Reduce
+  // finalSelection to 'rows' so that peeling does not decode the rows that
+  // were not loaded.
+  VarSetter finalSelection(
+      context->mutableFinalSelection(),
+      &rows,
+      loadedOnRows && !context->isFinalSelection());
+
   if (inputs_.empty()) {
     evalAll(rows, context, result);
     return;
@@ -748,6 +760,256 @@ void Expr::evalWithMemo(
   deselectErrors(context, *cachedDictionaryIndices_);
 }
 
+namespace {
+// Rows of a batch sampled to count the distinct values of the argument of an
+// expensive function.
+constexpr int32_t kResultCacheSampleSize = 256;
+
+// The result cache is enabled if a sample has at least this many rows per
+// distinct value.
+constexpr int32_t kResultCacheMinRowsPerValue = 4;
+
+// Batches sampled before the result cache is given up on.
+constexpr int32_t kResultCacheMaxSampledBatches = 4;
+
+// Copies 'source' at 'row' to 'target' at 'index'. Copies strings into the
+// buffers of 'target' so that the cache does not keep whole batches alive.
+void copyToCache(
+    BaseVector& target,
+    vector_size_t index,
+    const BaseVector& source,
+    vector_size_t row) {
+  if (source.isNullAt(row)) {
+    target.setNull(index, true);
+    return;
+  }
+  switch (source.typeKind()) {
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      target.asFlatVector<StringView>()->set(
+          index, source.asUnchecked<SimpleVector<StringView>>()->valueAt(row));
+      break;
+    default:
+      target.copy(&source, index, row, 1);
+  }
+}
+} // namespace
+
+struct Expr::ResultCache {
+  enum class State { kSampling, kEnabled, kDisabled };
+
+  int64_t bytes() const {
+    return keys->retainedSize() + values->retainedSize() +
+        positions.size() * sizeof(std::pair<uint64_t, vector_size_t>);
+  }
+
+  // Adds the arguments in 'input' and results in 'output' at 'rows' while
+  // within 'maxBytes'. Returns false if the cache is full.
+  bool add(
+      const BaseVector& input,
+      const BaseVector& output,
+      const SelectivityVector& rows,
+      int64_t maxBytes) {
+    return rows.testSelected([&](auto row) {
+      auto hash = input.hashValueAt(row);
+      if (positions.count(hash)) {
+        // Equal value or collision. Either way the row is not cached.
+        return true;
+      }
+      if (size == keys->size()) {
+        auto used = bytes();
+        int64_t capacity = std::max<vector_size_t>(64, 2 * size);
+        if (size > 0) {
+          // Grows by no more than the remaining budget holds at the current
+          // size of an entry.
+          auto entryBytes = std::max<int64_t>(1, used / size);
+          capacity = std::min(capacity, size + (maxBytes - used) / entryBytes);
+        }
+        if (capacity <= size) {
+          return false;
+        }
+        keys->resize(capacity);
+        values->resize(capacity);
+        if (bytes() > maxBytes) {
+          // Entries would not fit. Growing is tried again on the next add.
+          keys->resize(size);
+          values->resize(size);
+          return false;
+        }
+      }
+      copyToCache(*keys, size, input, row);
+      copyToCache(*values, size, output, row);
+      positions[hash] = size++;
+      return true;
+    });
+  }
+
+  void clear() {
+    keys = nullptr;
+    values = nullptr;
+    size = 0;
+    positions = {};
+  }
+
+  State state{State::kSampling};
+  int32_t numSampledBatches{0};
+  // Argument values and results. Positions [0, size) are used.
+  VectorPtr keys;
+  VectorPtr values;
+  vector_size_t size{0};
+  // Hash of an argument value to its position in 'keys'.
+  folly::F14FastMap<uint64_t, vector_size_t> positions;
+  ExprResultCacheStats stats;
+};
+
+Expr::~Expr() = default;
+
+ExprResultCacheStats Expr::resultCacheStats() const {
+  return resultCache_ ? resultCache_->stats : ExprResultCacheStats{};
+}
+
+bool Expr::applyFunctionWithResultCache(
+    const SelectivityVector& rows,
+    EvalCtx* context,
+    VectorPtr* result) {
+  if (!deterministic_ || !vectorFunction_->isExpensive() ||
+      !vectorFunction_->isDefaultNullBehavior() ||
+      !type()->isPrimitiveType()) {
+    return false;
+  }
+  if (resultCache_ && resultCache_->state == ResultCache::State::kDisabled) {
+    return false;
+  }
+  auto* queryCtx = context->execCtx()->queryCtx();
+  const int64_t maxBytes = queryCtx ? queryCtx->exprResultCacheMaxBytes() : 0;
+  if (maxBytes <= 0) {
+    return false;
+  }
+
+  // The result must depend on one flat argument. The other arguments must be
+  // literals, so that they are the same in all batches.
+  int32_t argIndex = -1;
+  for (auto i = 0; i < inputValues_.size(); ++i) {
+    if (dynamic_cast<const ConstantExpr*>(inputs_[i].get())) {
+      continue;
+    }
+    if (argIndex >= 0 ||
+        inputValues_[i]->encoding() != VectorEncoding::Simple::FLAT ||
+        !inputValues_[i]->type()->isPrimitiveType()) {
+      return false;
+    }
+    argIndex = i;
+  }
+  if (argIndex < 0) {
+    return false;
+  }
+
+  if (!resultCache_) {
+    resultCache_ = std::make_unique<ResultCache>();
+    context->exprSet()->addToResultCache(this);
+  }
+  auto& cache = *resultCache_;
+  // Holding a reference keeps the function from reusing the argument for its
+  // result.
+  auto input = inputValues_[argIndex];
+
+  if (cache.state == ResultCache::State::kSampling) {
+    folly::F14FastSet<uint64_t> distinct;
+    int32_t numSampled = 0;
+    rows.testSelected([&](auto row) {
+      distinct.insert(input->hashValueAt(row));
+      return ++numSampled < kResultCacheSampleSize;
+    });
+    ++cache.stats.sampledBatches;
+    if (distinct.size() * kResultCacheMinRowsPerValue > numSampled) {
+      if (++cache.numSampledBatches >= kResultCacheMaxSampledBatches) {
+        cache.state = ResultCache::State::kDisabled;
+      }
+      return false;
+    }
+    cache.state = ResultCache::State::kEnabled;
+    cache.keys = BaseVector::create(input->type(), 0, context->pool());
+    cache.values = BaseVector::create(type(), 0, context->pool());
+  }
+
+  // Splits 'rows' into rows found in the cache, rows equal to an earlier
+  // uncached row and rows to evaluate. 'sources' is the position in the
+  // cache or the earlier row.
+  LocalSelectivityVector hitHolder(context, rows.end());
+  LocalSelectivityVector duplicateHolder(context, rows.end());
+  LocalSelectivityVector missHolder(context, rows.end());
+  auto* hits = hitHolder.get();
+  auto* duplicates = duplicateHolder.get();
+  auto* misses = missHolder.get();
+  hits->clearAll();
+  duplicates->clearAll();
+  misses->clearAll();
+  std::vector<vector_size_t> sources(rows.end());
+  folly::F14FastMap<uint64_t, vector_size_t> firstMisses;
+  rows.applyToSelected([&](auto row) {
+    auto hash = input->hashValueAt(row);
+    auto it = cache.positions.find(hash);
+    if (it != cache.positions.end() &&
+        cache.keys->equalValueAt(input.get(), it->second, row)) {
+      hits->setValid(row, true);
+      sources[row] = it->second;
+      return;
+    }
+    auto [first, inserted] = firstMisses.emplace(hash, row);
+    if (!inserted && input->equalValueAt(input.get(), row, first->second)) {
+      duplicates->setValid(row, true);
+      sources[row] = first->second;
+      return;
+    }
+    misses->setValid(row, true);
+  });
+  hits->updateBounds();
+  duplicates->updateBounds();
+  misses->updateBounds();
+
+  VectorPtr missResult;
+  if (misses->hasSelections()) {
+    applyFunction(*misses, context, &missResult);
+  }
+  BaseVector::ensureWritable(rows, type(), context->pool(), result);
+  if (misses->hasSelections()) {
+    (*result)->copy(missResult.get(), *misses, nullptr);
+  }
+  if (duplicates->hasSelections()) {
+    (*result)->copy(missResult.get(), *duplicates, sources.data());
+    // A row is an error if the row it copies from is.
+    if (auto errors = context->errors()) {
+      duplicates->applyToSelected([&](auto row) {
+        auto source = sources[row];
+        if (source < errors->size() && !errors->isNullAt(source)) {
+          context->setError(
+              row,
+              *std::static_pointer_cast<std::exception_ptr>(
+                  errors->valueAt(source)));
+        }
+      });
+    }
+  }
+  if (hits->hasSelections()) {
+    (*result)->copy(cache.values.get(), *hits, sources.data());
+  }
+
+  const auto numHits = hits->countSelected() + duplicates->countSelected();
+  const auto numMisses = misses->countSelected();
+  cache.stats.hits += numHits;
+  cache.stats.misses += numMisses;
+  if (numMisses > 0) {
+    deselectErrors(context, *misses);
+    if (!cache.add(*input, *missResult, *misses, maxBytes) &&
+        numHits < numMisses) {
+      // The cache is full and does not save enough calls.
+      cache.clear();
+      cache.state = ResultCache::State::kDisabled;
+    }
+  }
+  return true;
+}
+
 void Expr::setAllNulls(
     const SelectivityVector& rows,
     EvalCtx* context,
@@ -883,11 +1145,16 @@ void Expr::evalAll(
 
   if (!tryPeelArgs ||
       !applyFunctionWithPeeling(rows, *remainingRows, context, result)) {
-    applyFunction(*remainingRows, context, result);
+    if (!applyFunctionWithResultCache(*remainingRows, context, result)) {
+      applyFunction(*remainingRows, context, result);
+    }
   }
   if (remainingRows != &rows) {
     addNulls(rows, remainingRows->asRange().bits(), context, result);
   }
+  // Intermediate results that are not referenced elsewhere can be reused
+  // for the next batch.
+  context->releaseVectors(inputValues_);
   inputValues_.clear();
 }
 
@@ -1137,6 +1404,56 @@ void ExprSet::clearSharedSubexprs() {
   }
 }
 
+namespace {
+// Adds the top level FieldReferences under 'expr' to 'references' and counts
+// the references per column in 'counts'. A shared subexpression is counted
+// once per parent.
+void collectFieldReferences(
+    Expr* expr,
+    std::vector<FieldReference*>& references,
+    std::unordered_map<std::string, int32_t>& counts) {
+  if (auto field = dynamic_cast<FieldReference*>(expr)) {
+    if (field->inputs().empty()) {
+      references.push_back(field);
+      ++counts[field->field()];
+      return;
+    }
+  }
+  if (auto lambda = dynamic_cast<LambdaExpr*>(expr)) {
+    // A capture is used on the rows of the lambda and on the rows of its body.
+    // Counted so that the captured columns are never loaded per reference.
+    for (const auto& field : lambda->capture()) {
+      counts[field->field()] += 2;
+    }
+  }
+  for (const auto& input : expr->inputs()) {
+    collectFieldReferences(input.get(), references, counts);
+  }
+}
+} // namespace
+
+void ExprSet::markSoleFieldReferences(
+    const std::unordered_set<std::string>& excludedFields) {
+  std::vector<FieldReference*> references;
+  std::unordered_map<std::string, int32_t> counts;
+  for (const auto& expr : exprs_) {
+    collectFieldReferences(expr.get(), references, counts);
+  }
+  for (auto* field : references) {
+    if (counts[field->field()] == 1 && !excludedFields.count(field->field())) {
+      field->setSoleReference();
+    }
+  }
+}
+
+ExprResultCacheStats ExprSet::resultCacheStats() const {
+  ExprResultCacheStats stats;
+  for (auto* expr : resultCachingExprs_) {
+    stats += expr->resultCacheStats();
+  }
+  return stats;
+}
+
 void ExprSet::clear() {
   clearSharedSubexprs();
   for (auto* memo : memoizingExprs_) {
@@ -60,6 +60,25 @@ class ExprSet;
 class FieldReference;
 class VectorFunction;
 
+// Counters of the result cache of an Expr. See
+// core::QueryCtx::kExprResultCacheMaxBytes.
+struct ExprResultCacheStats {
+  // Rows whose result was taken from the cache or from a row with the same
+  // argument earlier in the batch.
+  uint64_t hits{0};
+  // Rows for which the function was called while the cache was enabled.
+  uint64_t misses{0};
+  // Batches on which the number of distinct argument values was sampled.
+  uint64_t sampledBatches{0};
+
+  ExprResultCacheStats& operator+=(const ExprResultCacheStats& other) {
+    hits += other.hits;
+    misses += other.misses;
+    sampledBatches += other.sampledBatches;
+    return *this;
+  }
+};
+
 // An executable expression.
 class Expr {
  public:
@@ -82,7 +101,7 @@ class Expr {
         name_(std::move(name)),
         vectorFunction_(std::move(vectorFunction)) {}
 
-  virtual ~Expr() = default;
+  virtual ~Expr();
 
   void eval(const SelectivityVector& rows, EvalCtx* context, VectorPtr* result);
 
@@ -183,7 +202,11 @@ class Expr {
 
   virtual std::string toString() const;
 
+  // Returns the counters of the result cache. All zero if there is no cache.
+  ExprResultCacheStats resultCacheStats() const;
+
  private:
+  struct ResultCache;
   void setAllNulls(
       const SelectivityVector& rows,
       EvalCtx* context,
@@ -271,6 +294,16 @@ class Expr {
       EvalCtx* context,
       VectorPtr* result);
 
+  // Calls the function of 'this' on the distinct values of its only
+  // non-constant argument and takes results for values seen in previous
+  // batches from 'resultCache_'. Returns false without evaluating if the
+  // function is not expensive, the argument is not flat or sampling shows
+  // that the argument has too many distinct values.
+  bool applyFunctionWithResultCache(
+      const SelectivityVector& rows,
+      EvalCtx* context,
+      VectorPtr* result);
+
   // Returns true if values in 'distinctFields_' have nulls that are
   // worth skipping. If so, the rows in 'rows' with at least one sure
   // null are deselected in 'nullHolder->get()'.
@@ -346,6 +379,10 @@ class Expr {
 
   // Count of times the cacheable vector is seen for a non-first time.
   int32_t numCacheableRepeats_{0};
+
+  // Results of an expensive function by argument value. Created on first
+  // use if enabled in the QueryCtx.
+  std::unique_ptr<ResultCache> resultCache_;
 };
 
 using ExprPtr = std::shared_ptr<Expr>;
@@ -405,6 +442,23 @@ class ExprSet {
     memoizingExprs_.insert(expr);
   }
 
+  // Flags an expression that caches results by argument value.
+  void addToResultCache(Expr* expr) {
+    resultCachingExprs_.insert(expr);
+  }
+
+  // Returns the sum of the result cache counters of all expressions.
+  ExprResultCacheStats resultCacheStats() const;
+
+  // Lets a lazy column that is referenced in one place in 'this' be loaded
+  // only for the rows that place is evaluated on, e.g. the rows of one CASE
+  // branch or the rows passing the preceding conjuncts of an AND. By default,
+  // a column under a conditional is loaded for all the rows of the top level
+  // expression. 'excludedFields' are columns that the caller reads outside of
+  // 'this', e.g. identity projections. These are loaded as before.
+  void markSoleFieldReferences(
+      const std::unordered_set<std::string>& excludedFields);
+
  protected:
   void clearSharedSubexprs();
 
@@ -416,6 +470,9 @@ class ExprSet {
 
   // Exprs which retain memoized state, e.g. from running over dictionaries.
   std::unordered_set<Expr*> memoizingExprs_;
+
+  // Exprs which have a result cache.
+  std::unordered_set<Expr*> resultCachingExprs_;
   core::ExecCtx* const execCtx_;
 };
 
@@ -15,6 +15,8 @@
  */
 
 #include "velox/expression/ExprCompiler.h"
+#include <folly/Synchronized.h>
+#include <map>
 #include "velox/expression/CastExpr.h"
 #include "velox/expression/ControlExpr.h"
 #include "velox/expression/Expr.h"
@@ -71,6 +73,8 @@ struct Scope {
   std::vector<const ITypedExpr*> captureFieldAccesses;
   // Deduplicatable ITypedExprs. Only applies within the one scope.
   ExprDedupMap visited;
+  // ITypedExprs made by rewrites. 'visited' refers to these.
+  std::vector<TypedExprPtr> rewritten;
 
   Scope(std::vector<std::string>&& _locals, Scope* _parent, ExprSet* _exprSet)
       : locals(_locals), parent(_parent), exprSet(_exprSet) {}
@@ -118,6 +122,27 @@ void flattenInput(
   }
 }
 
+folly::Synchronized<std::map<std::string, DisjunctsRewrite>>&
+disjunctsRewrites() {
+  static folly::Synchronized<std::map<std::string, DisjunctsRewrite>> rewrites;
+  return rewrites;
+}
+
+// Applies the registered rewrites to the flattened inputs of an OR. Returns
+// true if any rewrite applied.
+bool rewriteDisjuncts(std::vector<TypedExprPtr>& disjuncts) {
+  return disjunctsRewrites().withRLock([&](const auto& rewrites) {
+    bool applied = false;
+    for (const auto& [_, rewrite] : rewrites) {
+      if (auto rewritten = rewrite(disjuncts)) {
+        disjuncts = std::move(rewritten.value());
+        applied = true;
+      }
+    }
+    return applied;
+  });
+}
+
 ExprPtr getAlreadyCompiled(const ITypedExpr* expr, ExprDedupMap* visited) {
   auto iter = visited->find(expr);
   return iter == visited->end() ? nullptr : iter->second;
@@ -136,23 +161,28 @@ std::vector<ExprPtr> compileInputs(
     bool enableConstantFolding) {
   std::vector<ExprPtr> compiledInputs;
   const std::string* flattenIf = isAndOrOr(expr);
+  if (flattenIf) {
+    std::vector<TypedExprPtr> flat;
+    for (auto& input : expr->inputs()) {
+      flattenInput(input, *flattenIf, flat);
+    }
+    if (*flattenIf == kOr && rewriteDisjuncts(flat)) {
+      scope->rewritten.insert(scope->rewritten.end(), flat.begin(), flat.end());
+    }
+    for (auto& input : flat) {
+      compiledInputs.push_back(
+          compileExpression(input, scope, pool, enableConstantFolding));
+    }
+    return compiledInputs;
+  }
   for (auto& input : expr->inputs()) {
     if (dynamic_cast<const core::InputTypedExpr*>(input.get())) {
       VELOX_CHECK(
           dynamic_cast<const core::FieldAccessTypedExpr*>(expr.get()),
           "An InputReference can only occur under a FieldReference");
     } else {
-      if (flattenIf) {
-        std::vector<TypedExprPtr> flat;
-        flattenInput(input, *flattenIf, flat);
-        for (auto& input : flat) {
-          compiledInputs.push_back(
-              compileExpression(input, scope, pool, enableConstantFolding));
-        }
-      } else {
-        compiledInputs.push_back(
-            compileExpression(input, scope, pool, enableConstantFolding));
-      }
+      compiledInputs.push_back(
+          compileExpression(input, scope, pool, enableConstantFolding));
     }
   }
   return compiledInputs;
@@ -387,6 +417,13 @@ ExprPtr compileExpression(
 
 } // namespace
 
+void registerDisjunctsRewrite(
+    const std::string& name,
+    DisjunctsRewrite rewrite) {
+  disjunctsRewrites().withWLock(
+      [&](auto& rewrites) { rewrites[name] = std::move(rewrite); });
+}
+
 std::vector<std::shared_ptr<Expr>> compileExpressions(
     std::vector<TypedExprPtr>&& sources,
     core::ExecCtx* execCtx,
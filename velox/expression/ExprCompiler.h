@@ -16,7 +16,10 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
+#include <optional>
+#include <string>
 #include "velox/core/Expressions.h"
 #include "velox/core/QueryCtx.h"
 
@@ -31,4 +34,17 @@ std::vector<std::shared_ptr<Expr>> compileExpressions(
     ExprSet* exprSet,
     bool enableConstantFolding = true);
 
+/// Rewrites the inputs of an OR, after nested ORs are flattened, into
+/// equivalent inputs. Returns std::nullopt if there is nothing to rewrite.
+using DisjunctsRewrite =
+    std::function<std::optional<std::vector<core::TypedExprPtr>>(
+        const std::vector<core::TypedExprPtr>& disjuncts)>;
+
+/// Registers a rewrite for the inputs of ORs compiled after this call, e.g.
+/// to evaluate several pattern matches of the same string in one pass.
+/// Replaces a rewrite previously registered under the same name.
+void registerDisjunctsRewrite(
+    const std::string& name,
+    DisjunctsRewrite rewrite);
+
 } // namespace facebook::velox::exec
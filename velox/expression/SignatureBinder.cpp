@@ -69,8 +69,14 @@ bool SignatureBinder::tryBind(
   auto it = bindings_.find(typeSignature.baseType());
   if (it == bindings_.end()) {
     // concrete type
-    if (boost::algorithm::to_upper_copy(typeSignature.baseType()) !=
-        actualType->kindName()) {
+    auto typeName = boost::algorithm::to_upper_copy(typeSignature.baseType());
+    if (typeName != actualType->kindName()) {
+      // Custom types, e.g. TIMESTAMP WITH TIME ZONE, bind only to themselves.
+      if (typeSignature.parameters().empty()) {
+        if (auto customType = getType(typeName, {})) {
+          return *customType == *actualType;
+        }
+      }
       return false;
     }
 
@@ -84,6 +84,14 @@ class VectorFunction {
     return true;
   }
 
+  // Returns true if the function is costly enough per row that remembering
+  // its results for repeated argument values pays off. Such functions may be
+  // called only for the distinct values of their argument if the query sets
+  // QueryCtx::kExprResultCacheMaxBytes.
+  virtual bool isExpensive() const {
+    return false;
+  }
+
   // Returns true if null in any argument always produces null result.
   // In this case, "rows" in "apply" will point only to positions for
   // which all arguments are not null.
@@ -37,6 +37,45 @@ class VectorAdapter : public VectorFunction {
       typename TypeToFlatVector<typename FUNC::return_type>::type;
   std::unique_ptr<FUNC> fn_;
 
+  template <typename U>
+  static constexpr bool isDenseType() {
+    return std::is_arithmetic_v<U> && !std::is_same_v<U, bool>;
+  }
+
+  template <size_t... Is>
+  static constexpr bool hasDenseArgs(std::index_sequence<Is...>) {
+    return (isDenseType<exec_arg_at<Is>>() && ...);
+  }
+
+  // True if the function may run in a tight loop over raw values, see
+  // tryApplyDense(). The function must not throw since errors are recorded
+  // per row only by the row by row path.
+  static constexpr bool supportsDense() {
+    return FUNC::is_default_null_behavior && FUNC::is_no_throw &&
+        isDenseType<T>() && FUNC::num_args > 0 && FUNC::num_args <= 3 &&
+        hasDenseArgs(std::make_index_sequence<FUNC::num_args>{});
+  }
+
+  // Argument of the dense path that is a flat vector.
+  template <typename U>
+  struct FlatArg {
+    const U* values;
+
+    FOLLY_ALWAYS_INLINE U operator[](vector_size_t row) const {
+      return values[row];
+    }
+  };
+
+  // Argument of the dense path that is a constant.
+  template <typename U>
+  struct ConstantArg {
+    U value;
+
+    FOLLY_ALWAYS_INLINE U operator[](vector_size_t /*row*/) const {
+      return value;
+    }
+  };
+
   struct ApplyContext {
     ApplyContext(
         const SelectivityVector* _rows,
@@ -44,8 +83,7 @@ class VectorAdapter : public VectorFunction {
         EvalCtx* _context,
         VectorPtr* _result)
         : rows{_rows}, context{_context} {
-      BaseVector::ensureWritable(
-          *rows, caller->type(), context->pool(), _result);
+      context->ensureWritable(*rows, caller->type(), _result);
       result = reinterpret_cast<result_vector_t*>((*_result).get());
       resultWriter.init(*result);
     }
@@ -68,6 +106,11 @@ class VectorAdapter : public VectorFunction {
       VectorPtr* result) const override {
     ApplyContext applyContext{&rows, caller, context, result};
     DecodedArgs decodedArgs{rows, args, context};
+    if constexpr (supportsDense()) {
+      if (tryApplyDense(applyContext, decodedArgs)) {
+        return;
+      }
+    }
     unpack<0>(applyContext, true, decodedArgs);
   }
 
@@ -100,6 +143,118 @@ class VectorAdapter : public VectorFunction {
         applyContext, nextNonNull, packed, readers..., oneReader);
   }
 
+  // Evaluates the function over the range of 'rows' with flat or constant
+  // arguments in a loop the compiler can vectorize. Null flags of the
+  // arguments are combined a word at a time and the function is called also
+  // on rows with null arguments, whose results are discarded. This is safe
+  // since the function does not throw. Rows with null arguments are usually
+  // deselected before the function is called. These holes in the range are
+  // overwritten with nulls if rows outside of the selection need not be
+  // preserved. Returns false without producing a result if the rows or
+  // arguments do not qualify.
+  bool tryApplyDense(
+      ApplyContext& applyContext,
+      const DecodedArgs& decodedArgs) const {
+    auto& rows = *applyContext.rows;
+    auto begin = rows.begin();
+    auto end = rows.end();
+    if (begin >= end || !fn_->isDeterministic()) {
+      return false;
+    }
+    bool allSelected = bits::isAllSet(rows.asRange().bits(), begin, end, true);
+    if (!allSelected && !applyContext.context->isFinalSelection()) {
+      return false;
+    }
+    for (auto i = 0; i < FUNC::num_args; ++i) {
+      auto decoded = decodedArgs.at(i);
+      if (decoded->isConstantMapping()) {
+        if (decoded->isNullAt(begin)) {
+          return false;
+        }
+      } else if (!decoded->isIdentityMapping()) {
+        return false;
+      }
+    }
+    if (!allSelected && !allHolesNull(rows, decodedArgs)) {
+      return false;
+    }
+
+    auto result = applyContext.result;
+    if (result->rawNulls()) {
+      bits::fillBits(result->mutableRawNulls(), begin, end, bits::kNotNull);
+    }
+    for (auto i = 0; i < FUNC::num_args; ++i) {
+      auto decoded = decodedArgs.at(i);
+      if (!decoded->isConstantMapping() && decoded->mayHaveNulls() &&
+          decoded->nulls()) {
+        bits::andBits(result->mutableRawNulls(), decoded->nulls(), begin, end);
+      }
+    }
+    applyDense<0>(result, decodedArgs, begin, end);
+    return true;
+  }
+
+  // Returns true if all rows in the range of 'rows' that are not selected
+  // have a null argument.
+  bool allHolesNull(
+      const SelectivityVector& rows,
+      const DecodedArgs& decodedArgs) const {
+    auto selected = rows.asRange().bits();
+    auto isNullHole = [&](int32_t idx, uint64_t mask) {
+      auto notNullHoles = ~selected[idx] & mask;
+      for (auto i = 0; i < FUNC::num_args; ++i) {
+        auto decoded = decodedArgs.at(i);
+        if (!decoded->isConstantMapping() && decoded->mayHaveNulls() &&
+            decoded->nulls()) {
+          notNullHoles &= decoded->nulls()[idx];
+        }
+      }
+      return notNullHoles == 0;
+    };
+    return bits::testWords(
+        rows.begin(), rows.end(), isNullHole, [&](int32_t idx) {
+          return isNullHole(idx, bits::kNotNull64);
+        });
+  }
+
+  template <int32_t POSITION, typename... TArg>
+  void applyDense(
+      result_vector_t* result,
+      const DecodedArgs& decodedArgs,
+      vector_size_t begin,
+      vector_size_t end,
+      const TArg&... denseArgs) const {
+    if constexpr (POSITION == FUNC::num_args) {
+      auto& fn = *fn_;
+      auto* data = result->mutableRawValues();
+      for (auto row = begin; row < end; ++row) {
+        if (UNLIKELY(!fn.call(data[row], denseArgs[row]...))) {
+          bits::setNull(result->mutableRawNulls(), row);
+        }
+      }
+    } else {
+      using U = exec_arg_at<POSITION>;
+      auto decoded = decodedArgs.at(POSITION);
+      if (decoded->isConstantMapping()) {
+        applyDense<POSITION + 1>(
+            result,
+            decodedArgs,
+            begin,
+            end,
+            denseArgs...,
+            ConstantArg<U>{decoded->valueAt<U>(begin)});
+      } else {
+        applyDense<POSITION + 1>(
+            result,
+            decodedArgs,
+            begin,
+            end,
+            denseArgs...,
+            FlatArg<U>{decoded->data<U>()});
+      }
+    }
+  }
+
   // unpacking zips like const char* notnull, const T* values
 
   // todo(youknowjack): I don't think this will work with more than 2 arguments
@@ -303,6 +303,67 @@ TEST_F(CastExprTest, errorHandling) {
       "tinyint", {"1", "2", "3", "100", "-100.5"}, {1, 2, 3, 100, -100}, true);
 }
 
+TEST_F(CastExprTest, fastPaths) {
+  // Strings to integers. 19 digits go through the general conversion.
+  testCast<std::string, int64_t>(
+      "bigint",
+      {"0",
+       "-0",
+       "007",
+       "12345678",
+       "123456789",
+       "-99999999999999999",
+       "999999999999999999",
+       "-9223372036854775808",
+       std::nullopt},
+      {0,
+       0,
+       7,
+       12345678,
+       123456789,
+       -99999999999999999,
+       999999999999999999,
+       std::numeric_limits<int64_t>::min(),
+       std::nullopt});
+  testCast<std::string, int8_t>(
+      "tinyint",
+      {"127", "-128", "128", "1a", "", "-"},
+      {127, -128, std::nullopt, std::nullopt, std::nullopt, std::nullopt},
+      false,
+      true);
+  testCast<std::string, int8_t>("tinyint", {"300"}, {0}, true);
+
+  // Strings to doubles.
+  testCast<std::string, double>(
+      "double",
+      {"12.5", "-0.125", "3.14159", "1e3", "123456789012345", std::nullopt},
+      {12.5, -0.125, 3.14159, 1000, 123456789012345, std::nullopt});
+
+  // Numbers to strings. Results longer than 12 characters are written to
+  // the string buffer.
+  testCast<int64_t, std::string>(
+      "string",
+      {0, -7, std::numeric_limits<int64_t>::min(), 1234567890123, std::nullopt},
+      {"0", "-7", "-9223372036854775808", "1234567890123", std::nullopt});
+  testCast<int32_t, std::string>(
+      "string",
+      {std::numeric_limits<int32_t>::max(), -2147483648},
+      {"2147483647", "-2147483648"});
+  testCast<double, std::string>(
+      "string",
+      {0.1, -1234.5678901234, std::nullopt},
+      {"0.1", "-1234.5678901234", std::nullopt});
+
+  // Widening casts.
+  testCast<int8_t, int64_t>(
+      "bigint", {-128, 0, 127, std::nullopt}, {-128, 0, 127, std::nullopt});
+  testCast<int32_t, double>(
+      "double",
+      {std::numeric_limits<int32_t>::min(), 0, 5, std::nullopt},
+      {-2147483648.0, 0, 5, std::nullopt});
+  testCast<float, double>("double", {1.5, -0.25}, {1.5, -0.25});
+}
+
 constexpr vector_size_t kVectorSize = 1'000;
 
 TEST_F(CastExprTest, mapCast) {
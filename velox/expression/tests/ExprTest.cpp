@@ -1541,8 +1541,8 @@ TEST_F(ExprTest, selectiveLazyLoadingOr) {
   const vector_size_t size = 1'000;
 
   // Evaluate OR expression. Columns under OR must be loaded for "all" rows
-  // because the engine currently doesn't know whether a column is used
-  // elsewhere or not.
+  // because the engine doesn't know whether a column is used elsewhere or not
+  // unless ExprSet::markSoleFieldReferences() is called.
   auto valueAt = [](auto row) { return row; };
   auto a = makeLazyFlatVector<int64_t>(
       size, valueAt, nullptr, size, [](auto row) { return row; });
@@ -1563,8 +1563,9 @@ TEST_F(ExprTest, selectiveLazyLoadingIf) {
   const vector_size_t size = 1'000;
 
   // Evaluate IF expression. Columns under IF must be loaded for "all" rows
-  // because the engine currently doesn't know whether a column is used in a
-  // single branch (then or else) or in both.
+  // because the engine doesn't know whether a column is used in a single
+  // branch (then or else) or in both unless
+  // ExprSet::markSoleFieldReferences() is called.
   auto valueAt = [](auto row) { return row; };
 
   auto a = makeLazyFlatVector<int64_t>(
@@ -1581,6 +1582,90 @@ TEST_F(ExprTest, selectiveLazyLoadingIf) {
   assertEqualVectors(expected, result);
 }
 
+TEST_F(ExprTest, selectiveLazyLoadingSoleReferences) {
+  const vector_size_t size = 1'000;
+  auto valueAt = [](auto row) { return row; };
+  auto rowType = ROW({"c0", "c1", "c2"}, {BIGINT(), BIGINT(), BIGINT()});
+
+  // A column referenced once is loaded only for the rows of its branch.
+  auto exprSet = compileExpression("if (c0 % 2 = 0, c1 + 1, c2 / 3)", rowType);
+  exprSet->markSoleFieldReferences({});
+  auto a = makeLazyFlatVector<int64_t>(
+      size, valueAt, nullptr, size, [](auto row) { return row; });
+  auto b = makeLazyFlatVector<int64_t>(
+      size, valueAt, nullptr, size / 2, [](auto row) { return row * 2; });
+  auto c = makeLazyFlatVector<int64_t>(
+      size, valueAt, nullptr, size / 2, [](auto row) { return row * 2 + 1; });
+  auto result = evaluate(exprSet.get(), makeRowVector({a, b, c}));
+  auto expected = makeFlatVector<int64_t>(
+      size, [](auto row) { return row % 2 == 0 ? row + 1 : row / 3; });
+  assertEqualVectors(expected, result);
+
+  // Each disjunct is loaded only for the rows that are not yet true.
+  exprSet = compileExpression(
+      "c0 % 2 <> 0 OR c1 % 4 <> 0 OR c2 % 8 <> 0", rowType);
+  exprSet->markSoleFieldReferences({});
+  a = makeLazyFlatVector<int64_t>(
+      size, valueAt, nullptr, size, [](auto row) { return row; });
+  b = makeLazyFlatVector<int64_t>(
+      size, valueAt, nullptr, size / 2, [](auto row) { return row * 2; });
+  c = makeLazyFlatVector<int64_t>(
+      size, valueAt, nullptr, size / 4, [](auto row) { return row * 4; });
+  result = evaluate(exprSet.get(), makeRowVector({a, b, c}));
+  auto expectedOr = makeFlatVector<bool>(size, [](auto row) {
+    return row % 2 != 0 || row % 4 != 0 || row % 8 != 0;
+  });
+  assertEqualVectors(expectedOr, result);
+
+  // A column referenced in both branches or excluded by the caller is loaded
+  // for all rows.
+  exprSet = compileExpression("if (c0 % 2 = 0, c1 + 1, c1 + c2)", rowType);
+  exprSet->markSoleFieldReferences({"c2"});
+  a = makeLazyFlatVector<int64_t>(
+      size, valueAt, nullptr, size, [](auto row) { return row; });
+  b = makeLazyFlatVector<int64_t>(
+      size, valueAt, nullptr, size, [](auto row) { return row; });
+  c = makeLazyFlatVector<int64_t>(
+      size, valueAt, nullptr, size, [](auto row) { return row; });
+  result = evaluate(exprSet.get(), makeRowVector({a, b, c}));
+  expected = makeFlatVector<int64_t>(
+      size, [](auto row) { return row % 2 == 0 ? row + 1 : row + row; });
+  assertEqualVectors(expected, result);
+}
+
+TEST_F(ExprTest, selectiveLazyLoadingSoleReferenceDictionary) {
+  const vector_size_t size = 1'000;
+  auto rowType = ROW({"c0", "c1", "c2"}, {BIGINT(), BIGINT(), BIGINT()});
+  auto exprSet = compileExpression("if (c0 < 100, c1 + 1, c2)", rowType);
+  exprSet->markSoleFieldReferences({});
+
+  auto a = makeFlatVector<int64_t>(size, [](auto row) { return row; });
+  // Like a table scan, returns a dictionary over the loaded values that ends
+  // at the last loaded row. Peeling must not look past it.
+  auto b = std::make_shared<LazyVector>(
+      execCtx_->pool(),
+      BIGINT(),
+      size,
+      std::make_unique<TestingVectorLoader>([&](RowSet rows) {
+        VELOX_CHECK_EQ(rows.size(), 100);
+        const vector_size_t numRows = rows.size();
+        // The values are in reverse order of the rows.
+        auto values = makeFlatVector<int64_t>(
+            numRows, [&](auto i) { return rows[numRows - 1 - i] * 10; });
+        std::vector<vector_size_t> indices(rows.back() + 1, 0);
+        for (auto i = 0; i < numRows; ++i) {
+          indices[rows[i]] = numRows - 1 - i;
+        }
+        return wrapInDictionary(makeIndices(indices), indices.size(), values);
+      }));
+  auto c = makeFlatVector<int64_t>(size, [](auto row) { return row * 2; });
+
+  auto result = evaluate(exprSet.get(), makeRowVector({a, b, c}));
+  auto expected = makeFlatVector<int64_t>(
+      size, [](auto row) { return row < 100 ? row * 10 + 1 : row * 2; });
+  assertEqualVectors(expected, result);
+}
+
 namespace {
 class StatefulVectorFunction : public exec::VectorFunction {
  public:
@@ -2214,3 +2299,113 @@ TEST_F(ExprTest, memoNulls) {
   expectedResult = BaseVector::createConstant(true, 5, execCtx_->pool());
   assertEqualVectors(expectedResult, result);
 }
+
+namespace {
+// f(n) = n + 1 - an expensive function that counts the rows it is called on.
+class ExpensivePlusOneFunction : public exec::VectorFunction {
+ public:
+  void apply(
+      const SelectivityVector& rows,
+      std::vector<VectorPtr>& args,
+      exec::Expr* /* caller */,
+      exec::EvalCtx* context,
+      VectorPtr* result) const override {
+    exec::DecodedArgs decodedArgs(rows, args, context);
+    auto input = decodedArgs.at(0);
+    BaseVector::ensureWritable(rows, BIGINT(), context->pool(), result);
+    auto flatResult = (*result)->asFlatVector<int64_t>();
+    rows.applyToSelected([&](auto row) {
+      flatResult->set(row, input->valueAt<int64_t>(row) + 1);
+    });
+    numRows += rows.countSelected();
+  }
+
+  bool isExpensive() const override {
+    return true;
+  }
+
+  static std::vector<std::shared_ptr<exec::FunctionSignature>> signatures() {
+    // bigint -> bigint
+    return {exec::FunctionSignatureBuilder()
+                .returnType("bigint")
+                .argumentType("bigint")
+                .build()};
+  }
+
+  static inline vector_size_t numRows{0};
+};
+} // namespace
+
+TEST_F(ExprTest, resultCache) {
+  exec::registerVectorFunction(
+      "expensive_plus_one",
+      ExpensivePlusOneFunction::signatures(),
+      std::make_unique<ExpensivePlusOneFunction>());
+
+  const vector_size_t size = 1'000;
+  auto rowType = ROW({"c0"}, {BIGINT()});
+  auto repeated = makeRowVector(
+      {makeFlatVector<int64_t>(size, [](auto row) { return row % 10; })});
+  auto expected =
+      makeFlatVector<int64_t>(size, [](auto row) { return row % 10 + 1; });
+
+  // The cache is off by default.
+  auto exprSet = compileExpression("expensive_plus_one(c0)", rowType);
+  ExpensivePlusOneFunction::numRows = 0;
+  auto result = evaluate(exprSet.get(), repeated);
+  assertEqualVectors(expected, result);
+  EXPECT_EQ(size, ExpensivePlusOneFunction::numRows);
+  EXPECT_EQ(0, exprSet->resultCacheStats().sampledBatches);
+
+  queryCtx_->setConfigOverridesUnsafe(
+      {{core::QueryCtx::kExprResultCacheMaxBytes, "1000000"}});
+
+  // The function is called once per distinct value.
+  exprSet = compileExpression("expensive_plus_one(c0)", rowType);
+  ExpensivePlusOneFunction::numRows = 0;
+  result = evaluate(exprSet.get(), repeated);
+  assertEqualVectors(expected, result);
+  EXPECT_EQ(10, ExpensivePlusOneFunction::numRows);
+  auto stats = exprSet->resultCacheStats();
+  EXPECT_EQ(990, stats.hits);
+  EXPECT_EQ(10, stats.misses);
+  EXPECT_EQ(1, stats.sampledBatches);
+
+  // The next batch is served from the cache.
+  result = evaluate(exprSet.get(), repeated);
+  assertEqualVectors(expected, result);
+  EXPECT_EQ(10, ExpensivePlusOneFunction::numRows);
+  stats = exprSet->resultCacheStats();
+  EXPECT_EQ(1990, stats.hits);
+  EXPECT_EQ(10, stats.misses);
+
+  // Distinct values do not enable the cache.
+  auto distinct = makeRowVector(
+      {makeFlatVector<int64_t>(size, [](auto row) { return row; })});
+  exprSet = compileExpression("expensive_plus_one(c0)", rowType);
+  ExpensivePlusOneFunction::numRows = 0;
+  result = evaluate(exprSet.get(), distinct);
+  assertEqualVectors(
+      makeFlatVector<int64_t>(size, [](auto row) { return row + 1; }), result);
+  EXPECT_EQ(size, ExpensivePlusOneFunction::numRows);
+  stats = exprSet->resultCacheStats();
+  EXPECT_EQ(0, stats.hits);
+  EXPECT_EQ(1, stats.sampledBatches);
+
+  // An OR of regexp_like calls on the same string is rewritten into one
+  // regexp_like_any call, which is cached as well.
+  std::vector<std::string> strings{"xa", "b1", "c2", "d3", "e4"};
+  auto stringData = makeRowVector({makeFlatVector<StringView>(
+      size, [&](auto row) { return StringView(strings[row % 5]); })});
+  exprSet = compileExpression(
+      "regexp_like(c0, '^x') or regexp_like(c0, '[34]$')",
+      ROW({"c0"}, {VARCHAR()}));
+  result = evaluate(exprSet.get(), stringData);
+  assertEqualVectors(
+      makeFlatVector<bool>(
+          size, [](auto row) { return row % 5 == 0 || row % 5 >= 3; }),
+      result);
+  stats = exprSet->resultCacheStats();
+  EXPECT_EQ(995, stats.hits);
+  EXPECT_EQ(5, stats.misses);
+}
@@ -199,3 +199,18 @@ TEST(SignatureBinderTest, unresolvable) {
     assertCannotResolve(signature, {INTEGER(), BIGINT()});
   }
 }
+
+TEST(SignatureBinderTest, customType) {
+  auto customType = ROW({"millis"}, {BIGINT()});
+  registerType(
+      "signature_binder_test_type",
+      [customType](auto /*childTypes*/) { return customType; });
+
+  auto signature = exec::FunctionSignatureBuilder()
+                       .returnType("bigint")
+                       .argumentType("signature_binder_test_type")
+                       .build();
+  testSignatureBinder(signature, {customType}, BIGINT());
+  assertCannotResolve(signature, {BIGINT()});
+  assertCannotResolve(signature, {ROW({"other"}, {VARCHAR()})});
+}
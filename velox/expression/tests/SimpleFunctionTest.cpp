@@ -338,4 +338,115 @@ TEST_F(SimpleFunctionTest, nonDefaultNullBehavior) {
   assertEqualVectors(expected, result);
 }
 
+// Functions over fixed width arguments that take the dense path when all
+// arguments are flat or constant.
+VELOX_UDF_BEGIN(dense_plus)
+static constexpr bool is_no_throw = true;
+
+FOLLY_ALWAYS_INLINE bool call(
+    int64_t& out,
+    const int64_t& a,
+    const int32_t& b) {
+  out = a + b;
+  return true;
+}
+VELOX_UDF_END();
+
+VELOX_UDF_BEGIN(null_if_odd)
+static constexpr bool is_no_throw = true;
+
+FOLLY_ALWAYS_INLINE bool call(double& out, const int64_t& a) {
+  out = a * 0.5;
+  return a % 2 == 0;
+}
+VELOX_UDF_END();
+
+// Counts its calls. The dense path calls it also on rows with null
+// arguments, while the row by row path skips these.
+int64_t numCountedNegateCalls = 0;
+
+VELOX_UDF_BEGIN(counted_negate)
+static constexpr bool is_no_throw = true;
+
+FOLLY_ALWAYS_INLINE bool call(int64_t& out, const int64_t& a) {
+  ++numCountedNegateCalls;
+  out = -a;
+  return true;
+}
+VELOX_UDF_END();
+
+VELOX_UDF_BEGIN(checked_divide)
+FOLLY_ALWAYS_INLINE bool call(
+    int64_t& out,
+    const int64_t& a,
+    const int64_t& b) {
+  VELOX_USER_CHECK_NE(b, 0, "division by zero");
+  out = a / b;
+  return true;
+}
+VELOX_UDF_END();
+
+TEST_F(SimpleFunctionTest, denseFixedWidth) {
+  registerFunction<udf_dense_plus, int64_t, int64_t, int32_t>();
+  registerFunction<udf_null_if_odd, double, int64_t>();
+  registerFunction<udf_checked_divide, int64_t, int64_t, int64_t>();
+  registerFunction<udf_counted_negate, int64_t, int64_t>();
+
+  const vector_size_t size = 1'000;
+  auto nullEvery7 = [](auto row) { return row % 7 == 0; };
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>(
+          size, [](auto row) { return row * 3; }, nullEvery7),
+      makeFlatVector<int32_t>(size, [](auto row) { return row; }),
+      makeFlatVector<int64_t>(size, [](auto row) { return row % 10; }),
+  });
+
+  auto result = evaluate<SimpleVector<int64_t>>("dense_plus(c0, c1)", data);
+  assertEqualVectors(
+      makeFlatVector<int64_t>(
+          size, [](auto row) { return row * 4; }, nullEvery7),
+      result);
+
+  result = evaluate<SimpleVector<int64_t>>("dense_plus(c2, c1)", data);
+  assertEqualVectors(
+      makeFlatVector<int64_t>(size, [](auto row) { return row % 10 + row; }),
+      result);
+
+  auto doubleResult = evaluate<SimpleVector<double>>("null_if_odd(c0)", data);
+  assertEqualVectors(
+      makeFlatVector<double>(
+          size,
+          [](auto row) { return row * 1.5; },
+          [](auto row) { return row % 7 == 0 || row % 2 == 1; }),
+      doubleResult);
+
+  doubleResult = evaluate<SimpleVector<double>>("null_if_odd(c2)", data);
+  assertEqualVectors(
+      makeFlatVector<double>(
+          size,
+          [](auto row) { return row % 10 * 0.5; },
+          [](auto row) { return row % 2 == 1; }),
+      doubleResult);
+
+  // Rows with a null argument are deselected before the function is called.
+  // The dense path still evaluates every row from the first to the last
+  // selected one and merges the nulls of the arguments into the result.
+  numCountedNegateCalls = 0;
+  result = evaluate<SimpleVector<int64_t>>("counted_negate(c0)", data);
+  EXPECT_EQ(size - 1, numCountedNegateCalls);
+  assertEqualVectors(
+      makeFlatVector<int64_t>(
+          size, [](auto row) { return -row * 3; }, nullEvery7),
+      result);
+
+  // Functions that may throw run row by row, which records the errors.
+  EXPECT_THROW(
+      evaluate<SimpleVector<int64_t>>("checked_divide(c0, c2)", data),
+      VeloxUserError);
+  result = evaluate<SimpleVector<int64_t>>("checked_divide(c0, 3)", data);
+  assertEqualVectors(
+      makeFlatVector<int64_t>(size, [](auto row) { return row; }, nullEvery7),
+      result);
+}
+
 } // namespace
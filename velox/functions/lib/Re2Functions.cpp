@@ -15,11 +15,17 @@
  */
 #include "velox/functions/lib/Re2Functions.h"
 
+#include <folly/container/EvictingCacheMap.h>
+#include <immintrin.h>
 #include <re2/re2.h>
+#include <re2/set.h>
+#include <algorithm>
 #include <optional>
+#include <string_view>
 
 #include "velox/expression/EvalCtx.h"
 #include "velox/expression/Expr.h"
+#include "velox/expression/ExprCompiler.h"
 #include "velox/expression/VectorUdfTypeSystem.h"
 #include "velox/vector/FlatVector.h"
 
@@ -83,6 +89,43 @@ FlatVector<StringView>& ensureWritableStringView(
   return *flat;
 }
 
+// Compiled regexes for patterns that vary by row. Keeps the most recently
+// used patterns, so that a pattern column with few distinct values compiles
+// each of them once. Not thread safe. Function instances that hold one are
+// created per expression.
+template <typename T>
+class CompiledPatternCache {
+ public:
+  static constexpr size_t kMaxCompiledPatterns = 20;
+
+  // Returns the value for 'key', making it with 'make' if not cached.
+  template <typename Make>
+  const T& get(std::string key, Make make) {
+    auto it = cache_.find(key);
+    if (it != cache_.end()) {
+      return *it->second;
+    }
+    auto value = make();
+    const T& result = *value;
+    cache_.set(std::move(key), std::move(value));
+    return result;
+  }
+
+ private:
+  folly::EvictingCacheMap<std::string, std::unique_ptr<T>> cache_{
+      kMaxCompiledPatterns};
+};
+
+using Re2Cache = CompiledPatternCache<RE2>;
+
+const RE2& getCompiledRe2(Re2Cache& cache, StringView pattern) {
+  const auto& re = cache.get(std::string(pattern), [&]() {
+    return std::make_unique<RE2>(toStringPiece(pattern), RE2::Quiet);
+  });
+  checkForBadPattern(re);
+  return re;
+}
+
 bool re2FullMatch(StringView str, const RE2& re) {
   return RE2::FullMatch(toStringPiece(str), re);
 }
@@ -119,6 +162,10 @@ bool re2Extract(
 template <bool (*Fn)(StringView, const RE2&)>
 class Re2MatchConstantPattern final : public VectorFunction {
  public:
+  bool isExpensive() const final {
+    return true;
+  }
+
   explicit Re2MatchConstantPattern(StringView pattern)
       : re_(toStringPiece(pattern), RE2::Quiet) {}
 
@@ -145,6 +192,10 @@ class Re2MatchConstantPattern final : public VectorFunction {
 template <bool (*Fn)(StringView, const RE2&)>
 class Re2Match final : public VectorFunction {
  public:
+  bool isExpensive() const final {
+    return true;
+  }
+
   void apply(
       const SelectivityVector& rows,
       std::vector<VectorPtr>& args,
@@ -163,11 +214,13 @@ class Re2Match final : public VectorFunction {
     exec::LocalDecodedVector toSearch(context, *args[0], rows);
     exec::LocalDecodedVector pattern(context, *args[1], rows);
     rows.applyToSelected([&](int row) {
-      RE2 re(toStringPiece(pattern->valueAt<StringView>(row)), RE2::Quiet);
-      checkForBadPattern(re);
+      auto& re = getCompiledRe2(cache_, pattern->valueAt<StringView>(row));
       result.set(row, Fn(toSearch->valueAt<StringView>(row), re));
     });
   }
+
+ private:
+  mutable Re2Cache cache_;
 };
 
 void checkForBadGroupId(int groupId, const RE2& re) {
@@ -179,6 +232,10 @@ void checkForBadGroupId(int groupId, const RE2& re) {
 template <typename T>
 class Re2SearchAndExtractConstantPattern final : public VectorFunction {
  public:
+  bool isExpensive() const final {
+    return true;
+  }
+
   explicit Re2SearchAndExtractConstantPattern(StringView pattern)
       : re_(toStringPiece(pattern), RE2::Quiet) {}
 
@@ -254,6 +311,10 @@ class Re2SearchAndExtractConstantPattern final : public VectorFunction {
 template <typename T>
 class Re2SearchAndExtract final : public VectorFunction {
  public:
+  bool isExpensive() const final {
+    return true;
+  }
+
   void apply(
       const SelectivityVector& rows,
       std::vector<VectorPtr>& args,
@@ -278,16 +339,14 @@ class Re2SearchAndExtract final : public VectorFunction {
     if (args.size() == 2) {
       groups.resize(1);
       rows.applyToSelected([&](int i) {
-        RE2 re(toStringPiece(pattern->valueAt<StringView>(i)), RE2::Quiet);
-        checkForBadPattern(re);
+        auto& re = getCompiledRe2(cache_, pattern->valueAt<StringView>(i));
         mustRefSourceStrings |= re2Extract(result, i, re, toSearch, groups, 0);
       });
     } else {
       exec::LocalDecodedVector groupIds(context, *args[2], rows);
       rows.applyToSelected([&](int i) {
         const auto groupId = groupIds->valueAt<T>(i);
-        RE2 re(toStringPiece(pattern->valueAt<StringView>(i)), RE2::Quiet);
-        checkForBadPattern(re);
+        auto& re = getCompiledRe2(cache_, pattern->valueAt<StringView>(i));
         checkForBadGroupId(groupId, re);
         groups.resize(groupId + 1);
         mustRefSourceStrings |=
@@ -298,6 +357,79 @@ class Re2SearchAndExtract final : public VectorFunction {
       result.acquireSharedStringBuffers(toSearch->base());
     }
   }
+
+ private:
+  mutable Re2Cache cache_;
+};
+
+// Returns whether a string has a substring that matches any of a set of
+// constant patterns. Scans the string once for all the patterns.
+class Re2SearchAnyConstantPatterns final : public VectorFunction {
+ public:
+  bool isExpensive() const final {
+    return true;
+  }
+
+  explicit Re2SearchAnyConstantPatterns(const std::vector<StringView>& patterns)
+      : set_(RE2::Options(RE2::Quiet), RE2::UNANCHORED) {
+    for (const auto& pattern : patterns) {
+      if (set_.Add(toStringPiece(pattern), &error_) < 0) {
+        return;
+      }
+      patterns_.push_back(
+          std::make_unique<RE2>(toStringPiece(pattern), RE2::Quiet));
+    }
+    compiled_ = set_.Compile();
+  }
+
+  void apply(
+      const SelectivityVector& rows,
+      std::vector<VectorPtr>& args,
+      Expr* /* caller */,
+      EvalCtx* context,
+      VectorPtr* resultRef) const final {
+    VELOX_CHECK_GE(args.size(), 2);
+    // Bad patterns fail when evaluated, like in Re2MatchConstantPattern.
+    if (UNLIKELY(!compiled_)) {
+      VELOX_USER_FAIL("invalid regular expression:{}", error_);
+    }
+    FlatVector<bool>& result =
+        ensureWritableBool(rows, context->pool(), resultRef);
+    exec::LocalDecodedVector toSearch(context, *args[0], rows);
+    rows.applyToSelected([&](int i) {
+      auto text = toStringPiece(toSearch->valueAt<StringView>(i));
+      result.set(i, matchAny(text));
+    });
+  }
+
+ private:
+  bool matchAny(const re2::StringPiece& text) const {
+    RE2::Set::ErrorInfo errorInfo;
+    if (set_.Match(text, nullptr, &errorInfo)) {
+      return true;
+    }
+    if (LIKELY(errorInfo.kind == RE2::Set::kNoError)) {
+      return false;
+    }
+    // The DFA of the set ran out of memory, e.g. for many patterns or a long
+    // text. Matches the patterns one at a time instead.
+    VELOX_CHECK(
+        errorInfo.kind == RE2::Set::kOutOfMemory,
+        "Unexpected error matching a set of regular expressions");
+    for (const auto& re : patterns_) {
+      if (RE2::PartialMatch(text, *re)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  RE2::Set set_;
+  // The patterns of 'set_' compiled one by one. Used if 'set_' fails to
+  // match for lack of memory.
+  std::vector<std::unique_ptr<RE2>> patterns_;
+  std::string error_;
+  bool compiled_{false};
 };
 
 template <bool (*Fn)(StringView, const RE2&)>
@@ -318,11 +450,321 @@ std::shared_ptr<VectorFunction> makeRe2MatchImpl(
     return std::make_shared<Re2MatchConstantPattern<Fn>>(
         constantPattern->as<ConstantVector<StringView>>()->valueAt(0));
   }
-  static std::shared_ptr<Re2Match<Fn>> kMatchExpr =
-      std::make_shared<Re2Match<Fn>>();
-  return kMatchExpr;
+  // Each instance has its own cache of compiled patterns.
+  return std::make_shared<Re2Match<Fn>>();
+}
+
+enum class LikeKind {
+  // No wildcards, e.g. 'abc'.
+  kExact,
+  // Literal followed by '%', e.g. 'abc%'.
+  kPrefix,
+  // '%' followed by literal, e.g. '%abc'.
+  kSuffix,
+  // Literal between '%', e.g. '%abc%'.
+  kSubstring,
+  // Only '_', e.g. '___'. Matches strings of exactly that many characters.
+  kFixedLength,
+  // Only '_' and '%', e.g. '__%'. Matches strings of at least as many
+  // characters as there are '_'.
+  kMinLength,
+  // Anything else. Matched with RE2.
+  kGeneric,
+};
+
+// Returns the number of UTF-8 characters in 'data'.
+int64_t countCharacters(const char* data, int64_t size) {
+  int64_t count = 0;
+  for (auto i = 0; i < size; ++i) {
+    // Counts all bytes except continuation bytes.
+    count += (data[i] & 0xC0) != 0x80;
+  }
+  return count;
+}
+
+// Returns true if 'needle' occurs in 'data'. Compares the first and the last
+// byte of 'needle' with 32 candidate positions at a time and compares the
+// rest of 'needle' only at positions where both match.
+bool containsSubstring(
+    const char* data,
+    int64_t size,
+    const std::string& needle) {
+  const int64_t needleSize = needle.size();
+  if (needleSize == 0) {
+    return true;
+  }
+  if (needleSize > size) {
+    return false;
+  }
+  if (needleSize == 1) {
+    return memchr(data, needle[0], size) != nullptr;
+  }
+  const auto first = _mm256_set1_epi8(needle[0]);
+  const auto last = _mm256_set1_epi8(needle[needleSize - 1]);
+  int64_t i = 0;
+  for (; i + needleSize - 1 + 32 <= size; i += 32) {
+    auto firstBlock =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+    auto lastBlock = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(data + i + needleSize - 1));
+    uint32_t candidates = _mm256_movemask_epi8(_mm256_and_si256(
+        _mm256_cmpeq_epi8(first, firstBlock),
+        _mm256_cmpeq_epi8(last, lastBlock)));
+    while (candidates) {
+      auto offset = __builtin_ctz(candidates);
+      if (memcmp(data + i + offset + 1, needle.data() + 1, needleSize - 2) ==
+          0) {
+        return true;
+      }
+      candidates &= candidates - 1;
+    }
+  }
+  // Fewer than 32 candidate positions are left.
+  return std::string_view(data + i, size - i).find(needle) !=
+      std::string_view::npos;
+}
+
+// A LIKE pattern classified by the shape of its wildcards. Simple shapes are
+// matched with memcmp or substring search, the rest with RE2.
+class LikeMatcher {
+ public:
+  LikeMatcher(StringView pattern, std::optional<char> escapeChar) {
+    // Unescaped pattern characters and whether each is a wildcard.
+    std::string chars;
+    std::vector<bool> isWildcard;
+    for (auto i = 0; i < pattern.size(); ++i) {
+      char c = pattern.data()[i];
+      if (escapeChar.has_value() && c == escapeChar.value()) {
+        VELOX_USER_CHECK(
+            i + 1 < pattern.size() &&
+                (pattern.data()[i + 1] == '%' ||
+                 pattern.data()[i + 1] == '_' ||
+                 pattern.data()[i + 1] == escapeChar.value()),
+            "Escape character must be followed by '%', '_' or the escape "
+            "character: {}",
+            std::string(pattern));
+        chars.push_back(pattern.data()[++i]);
+        isWildcard.push_back(false);
+      } else {
+        chars.push_back(c);
+        isWildcard.push_back(c == '%' || c == '_');
+      }
+    }
+
+    const int32_t size = chars.size();
+    int32_t firstLiteral = 0;
+    while (firstLiteral < size && isWildcard[firstLiteral]) {
+      ++firstLiteral;
+    }
+    if (firstLiteral == size) {
+      // Only wildcards.
+      length_ = std::count(chars.begin(), chars.end(), '_');
+      kind_ = length_ == size ? LikeKind::kFixedLength : LikeKind::kMinLength;
+      return;
+    }
+    int32_t endLiteral = firstLiteral;
+    while (endLiteral < size && !isWildcard[endLiteral]) {
+      ++endLiteral;
+    }
+    bool simple = std::all_of(
+        isWildcard.begin() + endLiteral, isWildcard.end(), [](bool b) {
+          return b;
+        });
+    for (auto i = 0; simple && i < size; ++i) {
+      simple = !isWildcard[i] || chars[i] == '%';
+    }
+    if (simple) {
+      literal_ = chars.substr(firstLiteral, endLiteral - firstLiteral);
+      bool leading = firstLiteral > 0;
+      bool trailing = endLiteral < size;
+      kind_ = leading
+          ? (trailing ? LikeKind::kSubstring : LikeKind::kSuffix)
+          : (trailing ? LikeKind::kPrefix : LikeKind::kExact);
+      return;
+    }
+
+    kind_ = LikeKind::kGeneric;
+    std::string regex;
+    std::string text;
+    for (auto i = 0; i < size; ++i) {
+      if (!isWildcard[i]) {
+        text.push_back(chars[i]);
+        continue;
+      }
+      regex += RE2::QuoteMeta(text);
+      text.clear();
+      regex += chars[i] == '%' ? ".*" : ".";
+    }
+    regex += RE2::QuoteMeta(text);
+    RE2::Options options(RE2::Quiet);
+    // '%' and '_' match line breaks too.
+    options.set_dot_nl(true);
+    re_ = std::make_unique<RE2>(regex, options);
+    checkForBadPattern(*re_);
+  }
+
+  LikeKind kind() const {
+    return kind_;
+  }
+
+  template <LikeKind kind>
+  bool match(StringView input) const {
+    const char* data = input.data();
+    const int64_t size = input.size();
+    const int64_t literalSize = literal_.size();
+    if constexpr (kind == LikeKind::kExact) {
+      return size == literalSize && memcmp(data, literal_.data(), size) == 0;
+    } else if constexpr (kind == LikeKind::kPrefix) {
+      return size >= literalSize &&
+          memcmp(data, literal_.data(), literalSize) == 0;
+    } else if constexpr (kind == LikeKind::kSuffix) {
+      return size >= literalSize &&
+          memcmp(data + size - literalSize, literal_.data(), literalSize) == 0;
+    } else if constexpr (kind == LikeKind::kSubstring) {
+      return containsSubstring(data, size, literal_);
+    } else if constexpr (kind == LikeKind::kFixedLength) {
+      // A character has at least one byte.
+      return size >= length_ && countCharacters(data, size) == length_;
+    } else if constexpr (kind == LikeKind::kMinLength) {
+      return size >= length_ && countCharacters(data, size) >= length_;
+    } else {
+      return RE2::FullMatch(toStringPiece(input), *re_);
+    }
+  }
+
+  bool match(StringView input) const {
+    switch (kind_) {
+      case LikeKind::kExact:
+        return match<LikeKind::kExact>(input);
+      case LikeKind::kPrefix:
+        return match<LikeKind::kPrefix>(input);
+      case LikeKind::kSuffix:
+        return match<LikeKind::kSuffix>(input);
+      case LikeKind::kSubstring:
+        return match<LikeKind::kSubstring>(input);
+      case LikeKind::kFixedLength:
+        return match<LikeKind::kFixedLength>(input);
+      case LikeKind::kMinLength:
+        return match<LikeKind::kMinLength>(input);
+      case LikeKind::kGeneric:
+        return match<LikeKind::kGeneric>(input);
+    }
+    VELOX_UNREACHABLE();
+  }
+
+ private:
+  LikeKind kind_;
+  // Unescaped literal for kExact, kPrefix, kSuffix and kSubstring.
+  std::string literal_;
+  // Number of '_' for kFixedLength and kMinLength.
+  int64_t length_{0};
+  // Set for kGeneric.
+  std::unique_ptr<RE2> re_;
+};
+
+std::optional<char> getEscapeChar(StringView escape) {
+  VELOX_USER_CHECK_EQ(
+      escape.size(), 1, "Escape string must be a single character");
+  return escape.data()[0];
 }
 
+class LikeConstantPattern final : public VectorFunction {
+ public:
+  // Patterns that are not matched with RE2 are cheap.
+  bool isExpensive() const final {
+    return matcher_.kind() == LikeKind::kGeneric;
+  }
+
+  LikeConstantPattern(StringView pattern, std::optional<char> escapeChar)
+      : matcher_(pattern, escapeChar) {}
+
+  void apply(
+      const SelectivityVector& rows,
+      std::vector<VectorPtr>& args,
+      Expr* /* caller */,
+      EvalCtx* context,
+      VectorPtr* resultRef) const final {
+    VELOX_CHECK(args.size() == 2 || args.size() == 3);
+    FlatVector<bool>& result =
+        ensureWritableBool(rows, context->pool(), resultRef);
+    exec::LocalDecodedVector toSearch(context, *args[0], rows);
+    switch (matcher_.kind()) {
+      case LikeKind::kExact:
+        return applyKind<LikeKind::kExact>(rows, *toSearch, result);
+      case LikeKind::kPrefix:
+        return applyKind<LikeKind::kPrefix>(rows, *toSearch, result);
+      case LikeKind::kSuffix:
+        return applyKind<LikeKind::kSuffix>(rows, *toSearch, result);
+      case LikeKind::kSubstring:
+        return applyKind<LikeKind::kSubstring>(rows, *toSearch, result);
+      case LikeKind::kFixedLength:
+        return applyKind<LikeKind::kFixedLength>(rows, *toSearch, result);
+      case LikeKind::kMinLength:
+        return applyKind<LikeKind::kMinLength>(rows, *toSearch, result);
+      case LikeKind::kGeneric:
+        return applyKind<LikeKind::kGeneric>(rows, *toSearch, result);
+    }
+  }
+
+ private:
+  template <LikeKind kind>
+  void applyKind(
+      const SelectivityVector& rows,
+      const DecodedVector& toSearch,
+      FlatVector<bool>& result) const {
+    rows.applyToSelected([&](int i) {
+      result.set(i, matcher_.match<kind>(toSearch.valueAt<StringView>(i)));
+    });
+  }
+
+  LikeMatcher matcher_;
+};
+
+// Pattern or escape character vary by row. Classifies the pattern of each
+// row.
+class Like final : public VectorFunction {
+ public:
+  bool isExpensive() const final {
+    return true;
+  }
+
+  void apply(
+      const SelectivityVector& rows,
+      std::vector<VectorPtr>& args,
+      Expr* /* caller */,
+      EvalCtx* context,
+      VectorPtr* resultRef) const final {
+    VELOX_CHECK(args.size() == 2 || args.size() == 3);
+    FlatVector<bool>& result =
+        ensureWritableBool(rows, context->pool(), resultRef);
+    exec::LocalDecodedVector toSearch(context, *args[0], rows);
+    exec::LocalDecodedVector pattern(context, *args[1], rows);
+    exec::LocalDecodedVector escape(context);
+    if (args.size() == 3) {
+      escape.get()->decode(*args[2], rows);
+    }
+    rows.applyToSelected([&](int row) {
+      std::optional<char> escapeChar;
+      // The escape character is part of the cache key.
+      std::string key = "-";
+      if (args.size() == 3) {
+        escapeChar = getEscapeChar(escape->valueAt<StringView>(row));
+        key[0] = 'e';
+        key.push_back(escapeChar.value());
+      }
+      auto rowPattern = pattern->valueAt<StringView>(row);
+      key.append(rowPattern.data(), rowPattern.size());
+      const auto& matcher = cache_.get(std::move(key), [&]() {
+        return std::make_unique<LikeMatcher>(rowPattern, escapeChar);
+      });
+      result.set(row, matcher.match(toSearch->valueAt<StringView>(row)));
+    });
+  }
+
+ private:
+  mutable CompiledPatternCache<LikeMatcher> cache_;
+};
+
 } // namespace
 
 std::shared_ptr<VectorFunction> makeRe2Match(
@@ -439,4 +881,183 @@ std::vector<std::shared_ptr<exec::FunctionSignature>> re2ExtractSignatures() {
   };
 }
 
+std::shared_ptr<VectorFunction> makeLike(
+    const std::string& name,
+    const std::vector<VectorFunctionArg>& inputArgs) {
+  auto numArgs = inputArgs.size();
+  VELOX_USER_CHECK(
+      numArgs == 2 || numArgs == 3,
+      "{} requires 2 or 3 arguments, but got {}",
+      name,
+      numArgs);
+  for (const auto& arg : inputArgs) {
+    VELOX_USER_CHECK(
+        arg.type->isVarchar(),
+        "{} requires arguments of type VARCHAR, but got {}",
+        name,
+        printTypesCsv(inputArgs));
+  }
+
+  BaseVector* constantPattern = inputArgs[1].constantValue.get();
+  if (constantPattern == nullptr || constantPattern->isNullAt(0)) {
+    return std::make_shared<Like>();
+  }
+  auto pattern = constantPattern->as<ConstantVector<StringView>>()->valueAt(0);
+  std::optional<char> escapeChar;
+  if (numArgs == 3) {
+    BaseVector* constantEscape = inputArgs[2].constantValue.get();
+    if (constantEscape == nullptr || constantEscape->isNullAt(0)) {
+      return std::make_shared<Like>();
+    }
+    escapeChar = getEscapeChar(
+        constantEscape->as<ConstantVector<StringView>>()->valueAt(0));
+  }
+  return std::make_shared<LikeConstantPattern>(pattern, escapeChar);
+}
+
+std::vector<std::shared_ptr<exec::FunctionSignature>> likeSignatures() {
+  // varchar, varchar -> boolean
+  // varchar, varchar, varchar -> boolean
+  return {
+      exec::FunctionSignatureBuilder()
+          .returnType("boolean")
+          .argumentType("varchar")
+          .argumentType("varchar")
+          .build(),
+      exec::FunctionSignatureBuilder()
+          .returnType("boolean")
+          .argumentType("varchar")
+          .argumentType("varchar")
+          .argumentType("varchar")
+          .build(),
+  };
+}
+
+std::shared_ptr<VectorFunction> makeRe2SearchAny(
+    const std::string& name,
+    const std::vector<VectorFunctionArg>& inputArgs) {
+  VELOX_USER_CHECK_GE(
+      inputArgs.size(),
+      2,
+      "{} requires at least 2 arguments, but got {}",
+      name,
+      inputArgs.size());
+  std::vector<StringView> patterns;
+  for (auto i = 0; i < inputArgs.size(); ++i) {
+    VELOX_USER_CHECK(
+        inputArgs[i].type->isVarchar(),
+        "{} requires arguments of type VARCHAR, but got {}",
+        name,
+        printTypesCsv(inputArgs));
+    if (i == 0) {
+      continue;
+    }
+    BaseVector* constantPattern = inputArgs[i].constantValue.get();
+    VELOX_USER_CHECK(
+        constantPattern != nullptr && !constantPattern->isNullAt(0),
+        "{} requires constant non-null patterns",
+        name);
+    patterns.push_back(
+        constantPattern->as<ConstantVector<StringView>>()->valueAt(0));
+  }
+  return std::make_shared<Re2SearchAnyConstantPatterns>(patterns);
+}
+
+std::vector<std::shared_ptr<exec::FunctionSignature>> re2SearchAnySignatures() {
+  // varchar, varchar... -> boolean
+  return {exec::FunctionSignatureBuilder()
+              .returnType("boolean")
+              .argumentType("varchar")
+              .argumentType("varchar")
+              .variableArity()
+              .build()};
+}
+
+namespace {
+
+// Returns the pattern of a call 'searchName(x, <constant pattern>)' or
+// std::nullopt if 'expr' is not such a call.
+std::optional<std::string> searchPattern(
+    const core::TypedExprPtr& expr,
+    const std::string& searchName) {
+  auto call = std::dynamic_pointer_cast<const core::CallTypedExpr>(expr);
+  if (!call || call->name() != searchName || call->inputs().size() != 2) {
+    return std::nullopt;
+  }
+  auto constant = std::dynamic_pointer_cast<const core::ConstantTypedExpr>(
+      call->inputs()[1]);
+  if (!constant || !constant->type()->isVarchar()) {
+    return std::nullopt;
+  }
+  if (constant->hasValueVector()) {
+    const auto& vector = constant->valueVector();
+    if (vector->isNullAt(0)) {
+      return std::nullopt;
+    }
+    return std::string(vector->as<SimpleVector<StringView>>()->valueAt(0));
+  }
+  if (constant->value().isNull()) {
+    return std::nullopt;
+  }
+  return constant->value().value<TypeKind::VARCHAR>();
+}
+
+} // namespace
+
+void registerRe2SearchAnyRewrite(
+    const std::string& searchName,
+    const std::string& searchAnyName) {
+  exec::registerDisjunctsRewrite(
+      searchAnyName,
+      [searchName, searchAnyName](const std::vector<core::TypedExprPtr>& inputs)
+          -> std::optional<std::vector<core::TypedExprPtr>> {
+        // Groups of searches of the same string. Each group is the positions
+        // of its searches in 'inputs'.
+        std::vector<std::vector<int32_t>> groups;
+        std::vector<int32_t> groupOf(inputs.size(), -1);
+        for (auto i = 0; i < inputs.size(); ++i) {
+          if (!searchPattern(inputs[i], searchName).has_value()) {
+            continue;
+          }
+          const auto& text = *inputs[i]->inputs()[0];
+          for (auto j = 0; j < groups.size(); ++j) {
+            if (*inputs[groups[j][0]]->inputs()[0] == text) {
+              groupOf[i] = j;
+              groups[j].push_back(i);
+              break;
+            }
+          }
+          if (groupOf[i] < 0) {
+            groupOf[i] = groups.size();
+            groups.push_back({i});
+          }
+        }
+
+        bool combined = false;
+        std::vector<core::TypedExprPtr> rewritten;
+        for (auto i = 0; i < inputs.size(); ++i) {
+          if (groupOf[i] < 0 || groups[groupOf[i]].size() < 2) {
+            rewritten.push_back(inputs[i]);
+            continue;
+          }
+          const auto& group = groups[groupOf[i]];
+          if (group[0] != i) {
+            // Added with the first search of the group.
+            continue;
+          }
+          std::vector<core::TypedExprPtr> args{inputs[i]->inputs()[0]};
+          for (auto position : group) {
+            args.push_back(inputs[position]->inputs()[1]);
+          }
+          rewritten.push_back(std::make_shared<core::CallTypedExpr>(
+              BOOLEAN(), std::move(args), searchAnyName));
+          combined = true;
+        }
+        if (!combined) {
+          return std::nullopt;
+        }
+        return rewritten;
+      });
+}
+
 } // namespace facebook::velox::functions
@@ -50,6 +50,25 @@ std::shared_ptr<exec::VectorFunction> makeRe2Search(
 
 std::vector<std::shared_ptr<exec::FunctionSignature>> re2SearchSignatures();
 
+/// re2SearchAny(string, pattern1, pattern2, ...) → bool
+///
+/// Returns whether str has a substr that matches any of the regex patterns.
+/// Patterns must be constant. All patterns are matched in one pass over the
+/// string using RE2::Set. If any pattern is invalid, throws an exception.
+std::shared_ptr<exec::VectorFunction> makeRe2SearchAny(
+    const std::string& name,
+    const std::vector<exec::VectorFunctionArg>& inputArgs);
+
+std::vector<std::shared_ptr<exec::FunctionSignature>> re2SearchAnySignatures();
+
+/// Makes the expression compiler rewrite ORs of two or more
+/// searchName(x, <constant pattern>) calls on the same x into one
+/// searchAnyName(x, pattern1, pattern2, ...) call. searchName must be
+/// registered as re2Search and searchAnyName as re2SearchAny.
+void registerRe2SearchAnyRewrite(
+    const std::string& searchName,
+    const std::string& searchAnyName);
+
 /// re2Extract(string, pattern, group_id) → string
 /// re2Extract(string, pattern) → string
 ///
@@ -73,4 +92,20 @@ std::shared_ptr<exec::VectorFunction> makeRe2Extract(
 
 std::vector<std::shared_ptr<exec::FunctionSignature>> re2ExtractSignatures();
 
+/// like(string, pattern) → bool
+/// like(string, pattern, escape) → bool
+///
+/// Returns whether string matches the SQL LIKE pattern. '%' matches any
+/// sequence of characters and '_' matches any single character. The escape
+/// character makes the following '%', '_' or escape character match itself.
+///
+/// Constant patterns that are an exact string, a prefix, a suffix, a
+/// substring or only wildcards are matched without RE2. Other patterns are
+/// translated to a regex.
+std::shared_ptr<exec::VectorFunction> makeLike(
+    const std::string& name,
+    const std::vector<exec::VectorFunctionArg>& inputArgs);
+
+std::vector<std::shared_ptr<exec::FunctionSignature>> likeSignatures();
+
 } // namespace facebook::velox::functions
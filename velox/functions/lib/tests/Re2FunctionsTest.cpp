@@ -34,8 +34,11 @@ class Re2FunctionsTest : public test::FunctionBaseTest {
         "re2_match", re2MatchSignatures(), makeRe2Match);
     exec::registerStatefulVectorFunction(
         "re2_search", re2SearchSignatures(), makeRe2Search);
+    exec::registerStatefulVectorFunction(
+        "re2_search_any", re2SearchAnySignatures(), makeRe2SearchAny);
     exec::registerStatefulVectorFunction(
         "re2_extract", re2ExtractSignatures(), makeRe2Extract);
+    exec::registerStatefulVectorFunction("like", likeSignatures(), makeLike);
   }
 };
 
@@ -324,5 +327,163 @@ TEST_F(Re2FunctionsTest, regexExtractConstantPatternNoGroupId) {
   EXPECT_EQ(extract("a b245 c3", "\\d+"), "245");
 }
 
+template <typename F>
+void testLike(F&& like) {
+  const std::string longString(100, 'x');
+  // Exact.
+  EXPECT_EQ(true, like("abc", "abc"));
+  EXPECT_EQ(false, like("abcd", "abc"));
+  EXPECT_EQ(true, like("", ""));
+  EXPECT_EQ(false, like("a", ""));
+  // Prefix.
+  EXPECT_EQ(true, like("abcd", "abc%"));
+  EXPECT_EQ(true, like("abc", "abc%%"));
+  EXPECT_EQ(false, like("ab", "abc%"));
+  // Suffix.
+  EXPECT_EQ(true, like("xabc", "%abc"));
+  EXPECT_EQ(false, like("abcx", "%abc"));
+  // Substring, with matches before, at and after the end of the first 32
+  // candidate positions.
+  EXPECT_EQ(true, like("xxabcxx", "%abc%"));
+  EXPECT_EQ(true, like("abc" + longString, "%abc%"));
+  EXPECT_EQ(true, like(longString + "abc", "%abc%"));
+  EXPECT_EQ(true, like(longString.substr(0, 31) + "abc" + longString, "%abc%"));
+  EXPECT_EQ(false, like(longString + "ab" + longString, "%abc%"));
+  EXPECT_EQ(true, like(longString + "a", "%a%"));
+  EXPECT_EQ(true, like("aaab", "%aab%"));
+  // Only wildcards. '_' matches a character, not a byte.
+  EXPECT_EQ(true, like("abc", "___"));
+  EXPECT_EQ(false, like("ab", "___"));
+  EXPECT_EQ(true, like("\u00e4\u00f6\u00fc", "___"));
+  EXPECT_EQ(true, like("abcd", "__%"));
+  EXPECT_EQ(false, like("a", "__%"));
+  EXPECT_EQ(true, like("", "%"));
+  // Generic patterns.
+  EXPECT_EQ(true, like("abxcd", "ab_cd"));
+  EXPECT_EQ(true, like("abxxcd", "ab%cd"));
+  EXPECT_EQ(false, like("abxxc", "ab%cd"));
+  EXPECT_EQ(true, like("a.b", "a._"));
+  EXPECT_EQ(false, like("axb", "a.b"));
+  EXPECT_EQ(true, like("a\nb", "a%b"));
+  // Null cases.
+  EXPECT_EQ(std::nullopt, like(std::nullopt, "abc"));
+}
+
+TEST_F(Re2FunctionsTest, likeConstantPattern) {
+  testLike([&](std::optional<std::string> str, const std::string& pattern) {
+    return evaluateOnce<bool>("like(c0, '" + pattern + "')", str);
+  });
+}
+
+TEST_F(Re2FunctionsTest, like) {
+  testLike([&](std::optional<std::string> str,
+               std::optional<std::string> pattern) {
+    return evaluateOnce<bool>("like(c0, c1)", str, pattern);
+  });
+  EXPECT_EQ(
+      std::nullopt,
+      evaluateOnce<bool>(
+          "like(c0, c1)",
+          std::optional<std::string>("abc"),
+          std::optional<std::string>()));
+}
+
+TEST_F(Re2FunctionsTest, likeEscape) {
+  auto like = [&](std::optional<std::string> str, const std::string& pattern) {
+    return evaluateOnce<bool>("like(c0, '" + pattern + "', '#')", str);
+  };
+  EXPECT_EQ(true, like("100%", "100#%"));
+  EXPECT_EQ(false, like("1000", "100#%"));
+  EXPECT_EQ(true, like("a_b", "%#_%"));
+  EXPECT_EQ(false, like("ab", "%#_%"));
+  EXPECT_EQ(true, like("a#b", "a##b"));
+  EXPECT_EQ(true, like("x%yz", "_#%y_"));
+  EXPECT_THROW(like("abc", "abc#"), VeloxUserError);
+  EXPECT_THROW(like("abc", "#abc"), VeloxUserError);
+  EXPECT_THROW(
+      evaluateOnce<bool>(
+          "like(c0, 'a%', '##')", std::optional<std::string>("abc")),
+      VeloxUserError);
+
+  auto variableEscape = [&](std::optional<std::string> str,
+                            std::optional<std::string> pattern,
+                            std::optional<std::string> escape) {
+    return evaluateOnce<bool>("like(c0, c1, c2)", str, pattern, escape);
+  };
+  EXPECT_EQ(true, variableEscape("a_b", "a\\_b", "\\"));
+  EXPECT_EQ(false, variableEscape("axb", "a\\_b", "\\"));
+}
+
+TEST_F(Re2FunctionsTest, variablePatternCache) {
+  // More distinct patterns than the cache holds, each repeated.
+  std::vector<std::string> strings;
+  std::vector<std::string> patterns;
+  std::vector<std::string> likePatterns;
+  for (auto i = 0; i < 1000; ++i) {
+    strings.push_back(fmt::format("{}xx", i % 70));
+    patterns.push_back(fmt::format("^{}x*$", i % 50));
+    likePatterns.push_back(fmt::format("{}%", i % 50));
+  }
+  auto data = makeRowVector({
+      makeFlatVector(strings),
+      makeFlatVector(patterns),
+      makeFlatVector(likePatterns),
+  });
+  auto search = evaluate<SimpleVector<bool>>("re2_search(c0, c1)", data);
+  auto like = evaluate<SimpleVector<bool>>("like(c0, c2)", data);
+  for (auto i = 0; i < strings.size(); ++i) {
+    EXPECT_EQ(i % 50 == i % 70, search->valueAt(i)) << i;
+    EXPECT_EQ(
+        strings[i].rfind(std::to_string(i % 50), 0) == 0, like->valueAt(i))
+        << i;
+  }
+}
+
+TEST_F(Re2FunctionsTest, regexSearchAny) {
+  auto searchAny = [&](std::optional<std::string> str) {
+    return evaluateOnce<bool>("re2_search_any(c0, 'ab+c', '^x', 'z$')", str);
+  };
+  EXPECT_EQ(true, searchAny("xyz"));
+  EXPECT_EQ(true, searchAny("--abbbc--"));
+  EXPECT_EQ(true, searchAny("xa"));
+  EXPECT_EQ(true, searchAny("az"));
+  EXPECT_EQ(false, searchAny("ac"));
+  EXPECT_EQ(false, searchAny("zx"));
+  EXPECT_EQ(std::nullopt, searchAny(std::nullopt));
+  EXPECT_THROW(
+      evaluateOnce<bool>(
+          "re2_search_any(c0, 'a', '(')", std::optional<std::string>("a")),
+      VeloxUserError);
+  EXPECT_THROW(
+      evaluateOnce<bool>(
+          "re2_search_any(c0, c1)",
+          std::optional<std::string>("a"),
+          std::optional<std::string>("a")),
+      VeloxUserError);
+}
+
+TEST_F(Re2FunctionsTest, regexSearchOrRewrite) {
+  registerRe2SearchAnyRewrite("re2_search", "re2_search_any");
+  auto data = makeRowVector({
+      makeNullableFlatVector<std::string>(
+          {"abc", "xyz", "b", std::nullopt, "q", "ab"}),
+      makeFlatVector<std::string>({"q", "q", "q", "q", "q", "z"}),
+  });
+  auto result = evaluate<SimpleVector<bool>>(
+      "re2_search(c0, 'a') or re2_search(c1, 'z') or re2_search(c0, '^x') "
+      "or re2_search(c0, 'q$')",
+      data);
+  std::vector<std::optional<bool>> expected{
+      true, true, false, std::nullopt, true, true};
+  ASSERT_EQ(expected.size(), result->size());
+  for (auto i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(
+        expected[i],
+        result->isNullAt(i) ? std::nullopt
+                            : std::optional<bool>(result->valueAt(i)))
+        << i;
+  }
+}
+
 } // namespace
 } // namespace facebook::velox::functions
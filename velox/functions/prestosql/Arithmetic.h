@@ -27,6 +27,8 @@ namespace facebook::velox::functions {
 
 template <typename T>
 VELOX_UDF_BEGIN(plus)
+static constexpr bool is_no_throw = true;
+
 FOLLY_ALWAYS_INLINE bool call(T& result, const T& a, const T& b) {
   result = plus(a, b);
   return true;
@@ -35,6 +37,8 @@ VELOX_UDF_END();
 
 template <typename T>
 VELOX_UDF_BEGIN(minus)
+static constexpr bool is_no_throw = true;
+
 FOLLY_ALWAYS_INLINE bool call(T& result, const T& a, const T& b) {
   result = minus(a, b);
   return true;
@@ -43,6 +47,8 @@ VELOX_UDF_END();
 
 template <typename T>
 VELOX_UDF_BEGIN(multiply)
+static constexpr bool is_no_throw = true;
+
 FOLLY_ALWAYS_INLINE bool call(T& result, const T& a, const T& b) {
   result = multiply(a, b);
   return true;
@@ -51,6 +57,8 @@ VELOX_UDF_END();
 
 template <typename T>
 VELOX_UDF_BEGIN(divide)
+static constexpr bool is_no_throw = true;
+
 FOLLY_ALWAYS_INLINE bool call(T& result, const T& a, const T& b)
 // depend on compiler have correct behaviour for divide by zero
 #if defined(__has_feature)
@@ -66,6 +74,8 @@ VELOX_UDF_END();
 
 template <typename T>
 VELOX_UDF_BEGIN(modulus)
+static constexpr bool is_no_throw = true;
+
 FOLLY_ALWAYS_INLINE bool call(T& result, const T& a, const T& b) {
   result = modulus(a, b);
   return true;
@@ -74,6 +84,8 @@ VELOX_UDF_END();
 
 template <typename T>
 VELOX_UDF_BEGIN(ceil)
+static constexpr bool is_no_throw = true;
+
 FOLLY_ALWAYS_INLINE bool call(T& result, const T& a) {
   result = ceil(a);
   return true;
@@ -82,6 +94,8 @@ VELOX_UDF_END();
 
 template <typename T>
 VELOX_UDF_BEGIN(floor)
+static constexpr bool is_no_throw = true;
+
 FOLLY_ALWAYS_INLINE bool call(T& result, const T& a) {
   result = floor(a);
   return true;
@@ -90,6 +104,8 @@ VELOX_UDF_END();
 
 template <typename T>
 VELOX_UDF_BEGIN(abs)
+static constexpr bool is_no_throw = true;
+
 FOLLY_ALWAYS_INLINE bool call(T& result, const T& a) {
   result = abs(a);
   return true;
@@ -98,6 +114,8 @@ VELOX_UDF_END();
 
 template <typename T>
 VELOX_UDF_BEGIN(negate)
+static constexpr bool is_no_throw = true;
+
 FOLLY_ALWAYS_INLINE bool call(T& result, const T& a) {
   result = negate(a);
   return true;
@@ -114,6 +132,8 @@ VELOX_UDF_END();
 
 template <typename T>
 VELOX_UDF_BEGIN(power)
+static constexpr bool is_no_throw = true;
+
 FOLLY_ALWAYS_INLINE bool call(double& result, const T& a, const T& b) {
   result = std::pow(a, b);
   return true;
@@ -121,6 +141,8 @@ FOLLY_ALWAYS_INLINE bool call(double& result, const T& a, const T& b) {
 VELOX_UDF_END();
 
 VELOX_UDF_BEGIN(exp)
+static constexpr bool is_no_throw = true;
+
 FOLLY_ALWAYS_INLINE bool call(double& result, double a) {
   result = std::exp(a);
   return true;
@@ -144,6 +166,8 @@ FOLLY_ALWAYS_INLINE bool call(T& result, const T& v, const T& lo, const T& hi) {
 VELOX_UDF_END();
 
 VELOX_UDF_BEGIN(ln)
+static constexpr bool is_no_throw = true;
+
 FOLLY_ALWAYS_INLINE bool call(double& result, double a) {
   result = std::log(a);
   return true;
@@ -151,6 +175,8 @@ FOLLY_ALWAYS_INLINE bool call(double& result, double a) {
 VELOX_UDF_END();
 
 VELOX_UDF_BEGIN(cos)
+static constexpr bool is_no_throw = true;
+
 FOLLY_ALWAYS_INLINE bool call(double& result, double a) {
   result = std::cos(a);
   return true;
@@ -158,6 +184,8 @@ FOLLY_ALWAYS_INLINE bool call(double& result, double a) {
 VELOX_UDF_END();
 
 VELOX_UDF_BEGIN(cosh)
+static constexpr bool is_no_throw = true;
+
 FOLLY_ALWAYS_INLINE bool call(double& result, double a) {
   result = std::cosh(a);
   return true;
@@ -165,6 +193,8 @@ FOLLY_ALWAYS_INLINE bool call(double& result, double a) {
 VELOX_UDF_END();
 
 VELOX_UDF_BEGIN(acos)
+static constexpr bool is_no_throw = true;
+
 FOLLY_ALWAYS_INLINE bool call(double& result, double a) {
   result = std::acos(a);
   return true;
@@ -172,6 +202,8 @@ FOLLY_ALWAYS_INLINE bool call(double& result, double a) {
 VELOX_UDF_END();
 
 VELOX_UDF_BEGIN(sin)
+static constexpr bool is_no_throw = true;
+
 FOLLY_ALWAYS_INLINE bool call(double& result, double a) {
   result = std::sin(a);
   return true;
@@ -179,6 +211,8 @@ FOLLY_ALWAYS_INLINE bool call(double& result, double a) {
 VELOX_UDF_END();
 
 VELOX_UDF_BEGIN(asin)
+static constexpr bool is_no_throw = true;
+
 FOLLY_ALWAYS_INLINE bool call(double& result, double a) {
   result = std::asin(a);
   return true;
@@ -186,6 +220,8 @@ FOLLY_ALWAYS_INLINE bool call(double& result, double a) {
 VELOX_UDF_END();
 
 VELOX_UDF_BEGIN(tan)
+static constexpr bool is_no_throw = true;
+
 FOLLY_ALWAYS_INLINE bool call(double& result, double a) {
   result = std::tan(a);
   return true;
@@ -193,6 +229,8 @@ FOLLY_ALWAYS_INLINE bool call(double& result, double a) {
 VELOX_UDF_END();
 
 VELOX_UDF_BEGIN(tanh)
+static constexpr bool is_no_throw = true;
+
 FOLLY_ALWAYS_INLINE bool call(double& result, double a) {
   result = std::tanh(a);
   return true;
@@ -200,6 +238,8 @@ FOLLY_ALWAYS_INLINE bool call(double& result, double a) {
 VELOX_UDF_END();
 
 VELOX_UDF_BEGIN(atan)
+static constexpr bool is_no_throw = true;
+
 FOLLY_ALWAYS_INLINE bool call(double& result, double a) {
   result = std::atan(a);
   return true;
@@ -207,6 +247,8 @@ FOLLY_ALWAYS_INLINE bool call(double& result, double a) {
 VELOX_UDF_END();
 
 VELOX_UDF_BEGIN(atan2)
+static constexpr bool is_no_throw = true;
+
 FOLLY_ALWAYS_INLINE bool call(double& result, double y, double x) {
   result = std::atan2(y, x);
   return true;
@@ -214,6 +256,8 @@ FOLLY_ALWAYS_INLINE bool call(double& result, double y, double x) {
 VELOX_UDF_END();
 
 VELOX_UDF_BEGIN(sqrt)
+static constexpr bool is_no_throw = true;
+
 FOLLY_ALWAYS_INLINE bool call(double& result, double a) {
   result = std::sqrt(a);
   return true;
@@ -221,6 +265,8 @@ FOLLY_ALWAYS_INLINE bool call(double& result, double a) {
 VELOX_UDF_END();
 
 VELOX_UDF_BEGIN(cbrt)
+static constexpr bool is_no_throw = true;
+
 FOLLY_ALWAYS_INLINE bool call(double& result, double a) {
   result = std::cbrt(a);
   return true;
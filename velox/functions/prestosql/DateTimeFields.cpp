@@ -0,0 +1,356 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <unordered_map>
+#include "velox/expression/Expr.h"
+#include "velox/expression/VectorFunction.h"
+#include "velox/functions/Macros.h"
+#include "velox/functions/prestosql/DateTimeImpl.h"
+#include "velox/functions/prestosql/TimestampWithTimeZoneType.h"
+#include "velox/type/tz/TimeZoneMap.h"
+
+namespace facebook::velox::functions {
+namespace {
+
+// Decodes an argument of type TIMESTAMP or TIMESTAMP WITH TIME ZONE. TIMESTAMP
+// values are in UTC. TIMESTAMP WITH TIME ZONE values are converted to local
+// time using offsets cached for the whole batch.
+class DecodedDateTime {
+ public:
+  DecodedDateTime(
+      const SelectivityVector& rows,
+      const BaseVector& arg,
+      exec::EvalCtx* context)
+      : decoded_(context, arg, rows),
+        millis_(context),
+        timeZones_(context),
+        hasTimeZone_(isTimestampWithTimeZoneType(arg.type())) {
+    if (hasTimeZone_) {
+      auto base = decoded_->base()->as<RowVector>();
+      SelectivityVector baseRows(base->size());
+      millis_.get()->decode(*base->childAt(0), baseRows);
+      timeZones_.get()->decode(*base->childAt(1), baseRows);
+    }
+  }
+
+  bool hasTimeZone() const {
+    return hasTimeZone_;
+  }
+
+  // Calls 'func(row, localSeconds)' for each of 'rows'. 'localSeconds' is
+  // the number of seconds since epoch in local time.
+  template <typename Func>
+  void applyToSelected(const SelectivityVector& rows, Func func) {
+    if (!hasTimeZone_) {
+      rows.applyToSelected([&](auto row) {
+        func(row, decoded_->valueAt<Timestamp>(row).getSeconds());
+      });
+      return;
+    }
+    rows.applyToSelected([&](auto row) {
+      auto index = decoded_->index(row);
+      auto seconds = floorDiv(millis_->valueAt<int64_t>(index), 1'000);
+      func(
+          row,
+          seconds +
+              offsets_.offsetSeconds(
+                  timeZones_->valueAt<int16_t>(index), seconds));
+    });
+  }
+
+  Timestamp timestamp(vector_size_t row) const {
+    return decoded_->valueAt<Timestamp>(row);
+  }
+
+  int64_t millis(vector_size_t row) const {
+    return millis_->valueAt<int64_t>(decoded_->index(row));
+  }
+
+  int16_t timeZoneID(vector_size_t row) const {
+    return timeZones_->valueAt<int16_t>(decoded_->index(row));
+  }
+
+  util::TimeZoneOffsetCache& offsets() {
+    return offsets_;
+  }
+
+ private:
+  exec::LocalDecodedVector decoded_;
+  // Children of TIMESTAMP WITH TIME ZONE values.
+  exec::LocalDecodedVector millis_;
+  exec::LocalDecodedVector timeZones_;
+  const bool hasTimeZone_;
+  util::TimeZoneOffsetCache offsets_;
+};
+
+FOLLY_ALWAYS_INLINE int64_t toDays(int64_t seconds) {
+  return floorDiv(seconds, kSecondsInDay);
+}
+
+struct YearField {
+  static int64_t extract(int64_t seconds) {
+    return civilFromDays(toDays(seconds)).year;
+  }
+};
+
+struct MonthField {
+  static int64_t extract(int64_t seconds) {
+    return civilFromDays(toDays(seconds)).month;
+  }
+};
+
+struct DayField {
+  static int64_t extract(int64_t seconds) {
+    return civilFromDays(toDays(seconds)).day;
+  }
+};
+
+struct HourField {
+  static int64_t extract(int64_t seconds) {
+    return (seconds - toDays(seconds) * kSecondsInDay) / 3'600;
+  }
+};
+
+struct DayOfWeekField {
+  static int64_t extract(int64_t seconds) {
+    return isoDayOfWeek(toDays(seconds));
+  }
+};
+
+// Extracts a calendar field as bigint from a TIMESTAMP or TIMESTAMP WITH TIME
+// ZONE. 'Field::extract' maps seconds since epoch in local time to the field.
+template <typename Field>
+class DateTimeFieldFunction : public exec::VectorFunction {
+ public:
+  void apply(
+      const SelectivityVector& rows,
+      std::vector<VectorPtr>& args,
+      exec::Expr* /*caller*/,
+      exec::EvalCtx* context,
+      VectorPtr* result) const override {
+    context->ensureWritable(rows, BIGINT(), result);
+    auto rawResults = (*result)->asFlatVector<int64_t>()->mutableRawValues();
+    DecodedDateTime dateTimes(rows, *args[0], context);
+    dateTimes.applyToSelected(rows, [&](auto row, int64_t seconds) {
+      rawResults[row] = Field::extract(seconds);
+    });
+  }
+
+  static std::vector<std::shared_ptr<exec::FunctionSignature>> signatures() {
+    // timestamp -> bigint
+    // timestamp with time zone -> bigint
+    return {
+        exec::FunctionSignatureBuilder()
+            .returnType("bigint")
+            .argumentType("timestamp")
+            .build(),
+        exec::FunctionSignatureBuilder()
+            .returnType("bigint")
+            .argumentType("timestamp with time zone")
+            .build(),
+    };
+  }
+};
+
+enum class DateTimeUnit {
+  kMillisecond,
+  kSecond,
+  kMinute,
+  kHour,
+  kDay,
+  kWeek,
+  kMonth,
+  kQuarter,
+  kYear
+};
+
+DateTimeUnit toDateTimeUnit(StringView unit) {
+  static const std::unordered_map<std::string, DateTimeUnit> kUnits{
+      {"millisecond", DateTimeUnit::kMillisecond},
+      {"second", DateTimeUnit::kSecond},
+      {"minute", DateTimeUnit::kMinute},
+      {"hour", DateTimeUnit::kHour},
+      {"day", DateTimeUnit::kDay},
+      {"week", DateTimeUnit::kWeek},
+      {"month", DateTimeUnit::kMonth},
+      {"quarter", DateTimeUnit::kQuarter},
+      {"year", DateTimeUnit::kYear},
+  };
+  std::string name(unit);
+  std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+  auto it = kUnits.find(name);
+  VELOX_USER_CHECK(
+      it != kUnits.end(), "Unsupported date_trunc unit: {}", std::string(unit));
+  return it->second;
+}
+
+// Returns 'seconds' since epoch in local time truncated to 'unit'. Units
+// below a second leave 'seconds' unchanged.
+FOLLY_ALWAYS_INLINE int64_t truncate(int64_t seconds, DateTimeUnit unit) {
+  switch (unit) {
+    case DateTimeUnit::kMillisecond:
+    case DateTimeUnit::kSecond:
+      return seconds;
+    case DateTimeUnit::kMinute:
+      return floorDiv(seconds, 60) * 60;
+    case DateTimeUnit::kHour:
+      return floorDiv(seconds, 3'600) * 3'600;
+    case DateTimeUnit::kDay:
+      return toDays(seconds) * kSecondsInDay;
+    case DateTimeUnit::kWeek: {
+      auto days = toDays(seconds);
+      return (days - isoDayOfWeek(days) + 1) * kSecondsInDay;
+    }
+    case DateTimeUnit::kMonth: {
+      auto date = civilFromDays(toDays(seconds));
+      return daysFromCivil(date.year, date.month, 1) * kSecondsInDay;
+    }
+    case DateTimeUnit::kQuarter: {
+      auto date = civilFromDays(toDays(seconds));
+      return daysFromCivil(date.year, (date.month - 1) / 3 * 3 + 1, 1) *
+          kSecondsInDay;
+    }
+    case DateTimeUnit::kYear:
+      return daysFromCivil(civilFromDays(toDays(seconds)).year, 1, 1) *
+          kSecondsInDay;
+  }
+  VELOX_UNREACHABLE();
+}
+
+// date_trunc(unit, x) -> x. Truncates a TIMESTAMP or TIMESTAMP WITH TIME ZONE
+// to the start of its millisecond, second, minute, hour, day, ISO week,
+// month, quarter or year in local time.
+class DateTruncFunction : public exec::VectorFunction {
+ public:
+  void apply(
+      const SelectivityVector& rows,
+      std::vector<VectorPtr>& args,
+      exec::Expr* caller,
+      exec::EvalCtx* context,
+      VectorPtr* result) const override {
+    VELOX_CHECK_EQ(args.size(), 2);
+    exec::LocalDecodedVector units(context, *args[0], rows);
+    std::optional<DateTimeUnit> constantUnit;
+    if (units->isConstantMapping()) {
+      constantUnit = toDateTimeUnit(units->valueAt<StringView>(rows.begin()));
+    }
+    auto unitAt = [&](auto row) {
+      return constantUnit.has_value()
+          ? constantUnit.value()
+          : toDateTimeUnit(units->valueAt<StringView>(row));
+    };
+
+    DecodedDateTime dateTimes(rows, *args[1], context);
+    if (!dateTimes.hasTimeZone()) {
+      context->ensureWritable(rows, TIMESTAMP(), result);
+      auto rawResults =
+          (*result)->asFlatVector<Timestamp>()->mutableRawValues();
+      dateTimes.applyToSelected(rows, [&](auto row, int64_t seconds) {
+        auto unit = unitAt(row);
+        uint64_t nanos = 0;
+        if (unit == DateTimeUnit::kMillisecond) {
+          nanos = dateTimes.timestamp(row).getNanos();
+          nanos -= nanos % kNanosecondsInMilliseconds;
+        }
+        rawResults[row] = Timestamp(truncate(seconds, unit), nanos);
+      });
+      return;
+    }
+
+    auto* pool = context->pool();
+    auto millis = BaseVector::create(BIGINT(), rows.size(), pool);
+    auto* rawMillis = millis->asFlatVector<int64_t>()->mutableRawValues();
+    auto timeZones = BaseVector::create(SMALLINT(), rows.size(), pool);
+    auto* rawTimeZones =
+        timeZones->asFlatVector<int16_t>()->mutableRawValues();
+    auto& offsets = dateTimes.offsets();
+    dateTimes.applyToSelected(rows, [&](auto row, int64_t seconds) {
+      auto unit = unitAt(row);
+      auto timeZoneID = dateTimes.timeZoneID(row);
+      rawTimeZones[row] = timeZoneID;
+      if (unit == DateTimeUnit::kMillisecond) {
+        rawMillis[row] = dateTimes.millis(row);
+        return;
+      }
+      auto truncated = truncate(seconds, unit);
+      // The offset at the truncated time may differ from the offset at the
+      // input time if there is a transition in between.
+      auto offset = seconds - floorDiv(dateTimes.millis(row), 1'000);
+      offset = offsets.offsetSeconds(timeZoneID, truncated - offset);
+      rawMillis[row] = (truncated - offset) * 1'000;
+    });
+
+    auto localResult = std::make_shared<RowVector>(
+        pool,
+        caller->type(),
+        BufferPtr(nullptr),
+        rows.size(),
+        std::vector<VectorPtr>{millis, timeZones},
+        0 /*nullCount*/);
+    context->moveOrCopyResult(localResult, rows, result);
+  }
+
+  static std::vector<std::shared_ptr<exec::FunctionSignature>> signatures() {
+    // varchar, timestamp -> timestamp
+    // varchar, timestamp with time zone -> timestamp with time zone
+    return {
+        exec::FunctionSignatureBuilder()
+            .returnType("timestamp")
+            .argumentType("varchar")
+            .argumentType("timestamp")
+            .build(),
+        exec::FunctionSignatureBuilder()
+            .returnType("timestamp with time zone")
+            .argumentType("varchar")
+            .argumentType("timestamp with time zone")
+            .build(),
+    };
+  }
+};
+
+} // namespace
+
+VELOX_DECLARE_VECTOR_FUNCTION(
+    udf_year,
+    DateTimeFieldFunction<YearField>::signatures(),
+    std::make_unique<DateTimeFieldFunction<YearField>>());
+
+VELOX_DECLARE_VECTOR_FUNCTION(
+    udf_month,
+    DateTimeFieldFunction<MonthField>::signatures(),
+    std::make_unique<DateTimeFieldFunction<MonthField>>());
+
+VELOX_DECLARE_VECTOR_FUNCTION(
+    udf_day,
+    DateTimeFieldFunction<DayField>::signatures(),
+    std::make_unique<DateTimeFieldFunction<DayField>>());
+
+VELOX_DECLARE_VECTOR_FUNCTION(
+    udf_hour,
+    DateTimeFieldFunction<HourField>::signatures(),
+    std::make_unique<DateTimeFieldFunction<HourField>>());
+
+VELOX_DECLARE_VECTOR_FUNCTION(
+    udf_day_of_week,
+    DateTimeFieldFunction<DayOfWeekField>::signatures(),
+    std::make_unique<DateTimeFieldFunction<DayOfWeekField>>());
+
+VELOX_DECLARE_VECTOR_FUNCTION(
+    udf_date_trunc,
+    DateTruncFunction::signatures(),
+    std::make_unique<DateTruncFunction>());
+
+} // namespace facebook::velox::functions
@@ -22,8 +22,64 @@ namespace facebook::velox::functions {
 namespace {
 constexpr double kNanosecondsInSecond = 1'000'000'000;
 constexpr int64_t kNanosecondsInMilliseconds = 1'000'000;
+constexpr int64_t kSecondsInDay = 86'400;
 } // namespace
 
+// Rounds 'value / divisor' down, also for negative values. 'divisor' must be
+// positive.
+FOLLY_ALWAYS_INLINE int64_t floorDiv(int64_t value, int64_t divisor) {
+  auto quotient = value / divisor;
+  return quotient - ((value % divisor) < 0);
+}
+
+// A date in the proleptic Gregorian calendar.
+struct CivilDate {
+  int64_t year;
+  // 1-12.
+  int32_t month;
+  // 1-31.
+  int32_t day;
+};
+
+// Returns the date 'days' after 1970-01-01 without branches on the input.
+// See http://howardhinnant.github.io/date_algorithms.html.
+FOLLY_ALWAYS_INLINE CivilDate civilFromDays(int64_t days) {
+  days += 719'468;
+  // 400 year eras starting on 0000-03-01.
+  const int64_t era = floorDiv(days, 146'097);
+  const int64_t dayOfEra = days - era * 146'097;
+  const int64_t yearOfEra =
+      (dayOfEra - dayOfEra / 1'460 + dayOfEra / 36'524 - dayOfEra / 146'096) /
+      365;
+  // Day of the year starting on March 1st.
+  const int64_t dayOfYear =
+      dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+  const int64_t shiftedMonth = (5 * dayOfYear + 2) / 153;
+  const int32_t day = dayOfYear - (153 * shiftedMonth + 2) / 5 + 1;
+  const int32_t month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9;
+  return {yearOfEra + era * 400 + (month <= 2), month, day};
+}
+
+// Returns the number of days from 1970-01-01 to 'year'-'month'-'day'.
+FOLLY_ALWAYS_INLINE int64_t
+daysFromCivil(int64_t year, int32_t month, int32_t day) {
+  year -= month <= 2;
+  const int64_t era = floorDiv(year, 400);
+  const int64_t yearOfEra = year - era * 400;
+  const int64_t dayOfYear =
+      (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+  const int64_t dayOfEra =
+      yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+  return era * 146'097 + dayOfEra - 719'468;
+}
+
+// Returns the ISO day of the week, 1 for Monday to 7 for Sunday, of the day
+// 'days' after 1970-01-01.
+FOLLY_ALWAYS_INLINE int64_t isoDayOfWeek(int64_t days) {
+  // 1970-01-01 is a Thursday.
+  return days + 3 - floorDiv(days + 3, 7) * 7 + 1;
+}
+
 FOLLY_ALWAYS_INLINE double toUnixtime(const Timestamp& timestamp) {
   double result = timestamp.getSeconds();
   result += static_cast<double>(timestamp.getNanos()) / kNanosecondsInSecond;
@@ -30,9 +30,12 @@ FOLLY_ALWAYS_INLINE bool call(
     const arg_type<Varchar>& jsonPath) {
   const folly::StringPiece& jsonStringPiece = json;
   const folly::StringPiece& jsonPathStringPiece = jsonPath;
-  auto extractResult = jsonExtractScalar(jsonStringPiece, jsonPathStringPiece);
-  if (extractResult.hasValue()) {
-    UDFOutputString::assign(result, *extractResult);
+  folly::StringPiece extractResult;
+  if (jsonExtractScalar(
+          jsonStringPiece, jsonPathStringPiece, extractResult, scratch_)) {
+    UDFOutputString::assign(
+        result,
+        std::string_view(extractResult.data(), extractResult.size()));
     return true;
 
   } else {
@@ -40,6 +43,9 @@ FOLLY_ALWAYS_INLINE bool call(
   }
 }
 
+// Holds unescaped strings and formatted numbers between rows.
+std::string scratch_;
+
 VELOX_UDF_END();
 
 } // namespace facebook::velox::functions
@@ -138,8 +138,7 @@ class VectorArithmetic : public VectorFunction {
           args[1].unique() && rightEncoding == VectorEncoding::Simple::FLAT) {
         *result = std::move(args[1]);
       } else {
-        *result =
-            BaseVector::create(caller->type(), rows.size(), context->pool());
+        context->ensureWritable(rows, caller->type(), result);
       }
     } else {
       // if the output is previously initialized, we prepare it for writing
@@ -72,10 +72,22 @@ void registerVectorFunctions() {
       "regexp_extract", re2ExtractSignatures(), makeRe2Extract);
   exec::registerStatefulVectorFunction(
       "regexp_like", re2SearchSignatures(), makeRe2Search);
+  exec::registerStatefulVectorFunction(
+      "regexp_like_any", re2SearchAnySignatures(), makeRe2SearchAny);
+  registerRe2SearchAnyRewrite("regexp_like", "regexp_like_any");
+  exec::registerStatefulVectorFunction("like", likeSignatures(), makeLike);
 
   VELOX_REGISTER_VECTOR_FUNCTION(udf_to_utf8, "to_utf8");
 
   VELOX_REGISTER_VECTOR_FUNCTION(udf_from_unixtime, "from_unixtime");
+  VELOX_REGISTER_VECTOR_FUNCTION(udf_year, "year");
+  VELOX_REGISTER_VECTOR_FUNCTION(udf_month, "month");
+  VELOX_REGISTER_VECTOR_FUNCTION(udf_day, "day");
+  VELOX_REGISTER_VECTOR_FUNCTION(udf_day, "day_of_month");
+  VELOX_REGISTER_VECTOR_FUNCTION(udf_hour, "hour");
+  VELOX_REGISTER_VECTOR_FUNCTION(udf_day_of_week, "day_of_week");
+  VELOX_REGISTER_VECTOR_FUNCTION(udf_day_of_week, "dow");
+  VELOX_REGISTER_VECTOR_FUNCTION(udf_date_trunc, "date_trunc");
 
   // TODO Fix Koski parser and clean this up.
   VELOX_REGISTER_VECTOR_FUNCTION(udf_concat_row, "ROW");
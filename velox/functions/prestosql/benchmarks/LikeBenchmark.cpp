@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+#include "velox/expression/tests/VectorFuzzer.h"
+#include "velox/functions/lib/benchmarks/FunctionBenchmarkBase.h"
+#include "velox/functions/prestosql/VectorFunctions.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::functions;
+
+namespace {
+
+class LikeBenchmark : public functions::test::FunctionBenchmarkBase {
+ public:
+  LikeBenchmark() : FunctionBenchmarkBase() {
+    functions::registerVectorFunctions();
+
+    VectorFuzzer::Options opts;
+    opts.stringLength = 100;
+    opts.vectorSize = 10'000;
+    VectorFuzzer fuzzer(opts, execCtx_.pool());
+    data_ = vectorMaker_.rowVector({fuzzer.fuzzFlat(VARCHAR())});
+  }
+
+  void run(const std::string& expression) {
+    folly::BenchmarkSuspender suspender;
+    auto exprSet = compileExpression(expression, data_->type());
+    suspender.dismiss();
+
+    uint32_t cnt = 0;
+    for (auto i = 0; i < 100; i++) {
+      cnt += evaluate(exprSet, data_)->size();
+    }
+    folly::doNotOptimizeAway(cnt);
+  }
+
+ private:
+  RowVectorPtr data_;
+};
+
+std::unique_ptr<LikeBenchmark> benchmark;
+
+BENCHMARK(regexpLikePrefix) {
+  benchmark->run("regexp_like(c0, '^abc')");
+}
+
+BENCHMARK_RELATIVE(likePrefix) {
+  benchmark->run("like(c0, 'abc%')");
+}
+
+BENCHMARK(regexpLikeSuffix) {
+  benchmark->run("regexp_like(c0, 'abc$')");
+}
+
+BENCHMARK_RELATIVE(likeSuffix) {
+  benchmark->run("like(c0, '%abc')");
+}
+
+BENCHMARK(regexpLikeSubstring) {
+  benchmark->run("regexp_like(c0, 'abc')");
+}
+
+BENCHMARK_RELATIVE(likeSubstring) {
+  benchmark->run("like(c0, '%abc%')");
+}
+
+BENCHMARK(regexpLikeFixedLength) {
+  benchmark->run("regexp_like(c0, '^.{100}$')");
+}
+
+BENCHMARK_RELATIVE(likeFixedLength) {
+  benchmark->run("like(c0, '" + std::string(100, '_') + "')");
+}
+
+BENCHMARK(regexpLikeGeneric) {
+  benchmark->run("regexp_like(c0, '^a.*b.c')");
+}
+
+BENCHMARK_RELATIVE(likeGeneric) {
+  benchmark->run("like(c0, 'a%b_c%')");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  benchmark = std::make_unique<LikeBenchmark>();
+  folly::runBenchmarks();
+  benchmark.reset();
+  return 0;
+}
@@ -16,6 +16,7 @@
 
 #include "velox/functions/prestosql/json/JsonExtractor.h"
 
+#include <immintrin.h>
 #include <cctype>
 #include <unordered_map>
 #include <vector>
@@ -67,6 +68,413 @@ bool isScalarType(const folly::Optional<folly::dynamic>& json) {
       !json->isNull();
 }
 
+// Returns a scalar as json_extract_scalar does. Booleans are 'true' and
+// 'false' like in Presto, not '1' and '0' like folly::dynamic::asString().
+std::string scalarToString(const folly::dynamic& json) {
+  if (json.isBool()) {
+    return json.asBool() ? "true" : "false";
+  }
+  return json.asString();
+}
+
+// A step of a JSON path for JsonScanner.
+struct PathStep {
+  std::string key;
+  // 'key' as an array index or -1 if 'key' is not an index.
+  int32_t index;
+};
+
+// A JSON path split into steps. JsonScanner cannot evaluate invalid paths or
+// paths with '*', which may select several values.
+struct ScalarPath {
+  std::vector<PathStep> steps;
+  bool isValid{false};
+  bool hasWildcard{false};
+};
+
+// The last path compiled by this thread. json_extract_scalar usually has a
+// constant path, so this avoids looking up the path for every row.
+thread_local std::string kLastScalarPath;
+thread_local ScalarPath kLastCompiledScalarPath;
+
+const ScalarPath& compileScalarPath(folly::StringPiece path) {
+  if (path == kLastScalarPath && kLastCompiledScalarPath.isValid) {
+    return kLastCompiledScalarPath;
+  }
+  kLastScalarPath = path.str();
+  auto& compiled = kLastCompiledScalarPath;
+  compiled = ScalarPath();
+  if (!kTokenizer.reset(path)) {
+    return compiled;
+  }
+  while (kTokenizer.hasNext()) {
+    auto token = kTokenizer.getNext();
+    if (!token) {
+      compiled.steps.clear();
+      return compiled;
+    }
+    auto index = folly::tryTo<int32_t>(token.value());
+    compiled.hasWildcard |= token.value() == "*";
+    compiled.steps.push_back(
+        {token.value(), index.hasValue() ? index.value() : -1});
+  }
+  compiled.isValid = true;
+  return compiled;
+}
+
+// Returns the first position in [pos, end) that holds one of 'kChars' or
+// 'end'. Compares 32 bytes at a time.
+template <char... kChars>
+const char* findAny(const char* pos, const char* end) {
+  for (; pos + 32 <= end; pos += 32) {
+    auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pos));
+    uint32_t hits = _mm256_movemask_epi8(
+        (_mm256_cmpeq_epi8(block, _mm256_set1_epi8(kChars)) | ...));
+    if (hits) {
+      return pos + __builtin_ctz(hits);
+    }
+  }
+  for (; pos < end; ++pos) {
+    if (((*pos == kChars) || ...)) {
+      return pos;
+    }
+  }
+  return end;
+}
+
+void appendUtf8(uint32_t codePoint, std::string& out) {
+  if (codePoint < 0x80) {
+    out.push_back(codePoint);
+  } else if (codePoint < 0x800) {
+    out.push_back(0xC0 | (codePoint >> 6));
+    out.push_back(0x80 | (codePoint & 0x3F));
+  } else if (codePoint < 0x10000) {
+    out.push_back(0xE0 | (codePoint >> 12));
+    out.push_back(0x80 | ((codePoint >> 6) & 0x3F));
+    out.push_back(0x80 | (codePoint & 0x3F));
+  } else {
+    out.push_back(0xF0 | (codePoint >> 18));
+    out.push_back(0x80 | ((codePoint >> 12) & 0x3F));
+    out.push_back(0x80 | ((codePoint >> 6) & 0x3F));
+    out.push_back(0x80 | (codePoint & 0x3F));
+  }
+}
+
+// Reads JSON text on demand. Only the values on a path are parsed. Values
+// off the path are skipped by matching quotes and brackets, so the text is
+// validated only up to the extracted value.
+class JsonScanner {
+ public:
+  // 'scratch' receives unescaped strings and formatted numbers.
+  JsonScanner(folly::StringPiece json, std::string& scratch)
+      : pos_(json.begin()), end_(json.end()), scratch_(scratch) {}
+
+  // Moves to the value at 'steps'. Returns false if there is no such value
+  // or the text on the way is malformed.
+  bool seek(const std::vector<PathStep>& steps) {
+    for (const auto& step : steps) {
+      skipWhitespace();
+      if (pos_ == end_) {
+        return false;
+      }
+      if (*pos_ == '{') {
+        if (!seekKey(step.key)) {
+          return false;
+        }
+      } else if (*pos_ == '[') {
+        if (step.index < 0 || !seekIndex(step.index)) {
+          return false;
+        }
+      } else {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Reads the scalar at the current position. Returns false if the value is
+  // null, an object, an array or malformed.
+  bool readScalar(folly::StringPiece& result) {
+    skipWhitespace();
+    if (pos_ == end_ || *pos_ == '{' || *pos_ == '[') {
+      return false;
+    }
+    if (*pos_ == '"') {
+      return readString(result);
+    }
+    auto start = pos_;
+    skipLiteral();
+    folly::StringPiece literal(start, pos_);
+    if (literal == "true" || literal == "false") {
+      result = literal;
+      return true;
+    }
+    if (literal == "null" || literal.empty()) {
+      return false;
+    }
+    return readNumber(literal, result);
+  }
+
+ private:
+  static bool isWhitespace(char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+  }
+
+  void skipWhitespace() {
+    while (pos_ < end_ && isWhitespace(*pos_)) {
+      ++pos_;
+    }
+  }
+
+  bool consume(char c) {
+    skipWhitespace();
+    if (pos_ < end_ && *pos_ == c) {
+      ++pos_;
+      return true;
+    }
+    return false;
+  }
+
+  // Skips a number, true, false or null.
+  void skipLiteral() {
+    while (pos_ < end_ && *pos_ != ',' && *pos_ != '}' && *pos_ != ']' &&
+           !isWhitespace(*pos_)) {
+      ++pos_;
+    }
+  }
+
+  // Positions at the value of 'key' in the object at the current position.
+  // If the object has 'key' more than once, the first occurrence is used,
+  // as in Presto's streaming extraction. The DOM-based extractor uses the
+  // last one instead.
+  bool seekKey(const std::string& key) {
+    ++pos_;
+    if (consume('}')) {
+      return false;
+    }
+    do {
+      skipWhitespace();
+      folly::StringPiece name;
+      if (pos_ == end_ || *pos_ != '"' || !readString(name) ||
+          !consume(':')) {
+        return false;
+      }
+      if (name == key) {
+        return true;
+      }
+      if (!skipValue()) {
+        return false;
+      }
+    } while (consume(','));
+    return false;
+  }
+
+  // Positions at element 'index' of the array at the current position.
+  bool seekIndex(int32_t index) {
+    ++pos_;
+    if (consume(']')) {
+      return false;
+    }
+    for (auto i = 0; i < index; ++i) {
+      if (!skipValue() || !consume(',')) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool skipValue() {
+    skipWhitespace();
+    if (pos_ == end_) {
+      return false;
+    }
+    switch (*pos_) {
+      case '"':
+        return skipString();
+      case '{':
+      case '[':
+        return skipContainer();
+      default: {
+        auto start = pos_;
+        skipLiteral();
+        return pos_ > start;
+      }
+    }
+  }
+
+  // Skips the string starting at the current position.
+  bool skipString() {
+    ++pos_;
+    for (;;) {
+      pos_ = findAny<'"', '\\'>(pos_, end_);
+      if (pos_ == end_) {
+        return false;
+      }
+      if (*pos_ == '"') {
+        ++pos_;
+        return true;
+      }
+      // Skips the backslash and the escaped character.
+      pos_ += 2;
+      if (pos_ > end_) {
+        pos_ = end_;
+        return false;
+      }
+    }
+  }
+
+  // Skips the object or array starting at the current position.
+  bool skipContainer() {
+    int32_t depth = 0;
+    for (;;) {
+      pos_ = findAny<'"', '{', '}', '[', ']'>(pos_, end_);
+      if (pos_ == end_) {
+        return false;
+      }
+      if (*pos_ == '"') {
+        if (!skipString()) {
+          return false;
+        }
+        continue;
+      }
+      depth += *pos_ == '{' || *pos_ == '[' ? 1 : -1;
+      ++pos_;
+      if (depth == 0) {
+        return true;
+      }
+    }
+  }
+
+  bool readHex4(uint32_t& value) {
+    if (end_ - pos_ < 4) {
+      return false;
+    }
+    value = 0;
+    for (auto i = 0; i < 4; ++i) {
+      char c = *pos_++;
+      uint32_t digit;
+      if (c >= '0' && c <= '9') {
+        digit = c - '0';
+      } else if (c >= 'a' && c <= 'f') {
+        digit = c - 'a' + 10;
+      } else if (c >= 'A' && c <= 'F') {
+        digit = c - 'A' + 10;
+      } else {
+        return false;
+      }
+      value = value * 16 + digit;
+    }
+    return true;
+  }
+
+  // Reads the string starting at the current position. 'result' points into
+  // the JSON text if the string has no escapes and into 'scratch_'
+  // otherwise.
+  bool readString(folly::StringPiece& result) {
+    auto start = ++pos_;
+    pos_ = findAny<'"', '\\'>(pos_, end_);
+    if (pos_ == end_) {
+      return false;
+    }
+    if (*pos_ == '"') {
+      result = folly::StringPiece(start, pos_++);
+      return true;
+    }
+    scratch_.assign(start, pos_);
+    for (;;) {
+      if (pos_ == end_) {
+        return false;
+      }
+      if (*pos_ == '"') {
+        ++pos_;
+        result = scratch_;
+        return true;
+      }
+      if (*pos_ != '\\') {
+        auto next = findAny<'"', '\\'>(pos_, end_);
+        scratch_.append(pos_, next);
+        pos_ = next;
+        continue;
+      }
+      if (++pos_ == end_) {
+        return false;
+      }
+      switch (*pos_++) {
+        case '"':
+          scratch_.push_back('"');
+          break;
+        case '\\':
+          scratch_.push_back('\\');
+          break;
+        case '/':
+          scratch_.push_back('/');
+          break;
+        case 'b':
+          scratch_.push_back('\b');
+          break;
+        case 'f':
+          scratch_.push_back('\f');
+          break;
+        case 'n':
+          scratch_.push_back('\n');
+          break;
+        case 'r':
+          scratch_.push_back('\r');
+          break;
+        case 't':
+          scratch_.push_back('\t');
+          break;
+        case 'u': {
+          uint32_t codePoint;
+          if (!readHex4(codePoint)) {
+            return false;
+          }
+          if (codePoint >= 0xD800 && codePoint <= 0xDBFF) {
+            // A high surrogate must be followed by a low surrogate.
+            uint32_t low;
+            if (end_ - pos_ < 2 || pos_[0] != '\\' || pos_[1] != 'u') {
+              return false;
+            }
+            pos_ += 2;
+            if (!readHex4(low) || low < 0xDC00 || low > 0xDFFF) {
+              return false;
+            }
+            codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+          }
+          appendUtf8(codePoint, scratch_);
+          break;
+        }
+        default:
+          return false;
+      }
+    }
+  }
+
+  // Formats 'literal' like folly::dynamic::asString() does after parsing.
+  bool readNumber(folly::StringPiece literal, folly::StringPiece& result) {
+    scratch_.clear();
+    if (literal.find_first_of(".eE") == folly::StringPiece::npos) {
+      auto value = folly::tryTo<int64_t>(literal);
+      if (!value.hasValue()) {
+        return false;
+      }
+      folly::toAppend(value.value(), &scratch_);
+    } else {
+      auto value = folly::tryTo<double>(literal);
+      if (!value.hasValue()) {
+        return false;
+      }
+      folly::toAppend(value.value(), &scratch_);
+    }
+    result = scratch_;
+    return true;
+  }
+
+  const char* pos_;
+  const char* const end_;
+  std::string& scratch_;
+};
+
 void extractObject(
     const folly::dynamic* jsonObj,
     const std::string& key,
@@ -192,13 +600,35 @@ folly::Optional<folly::dynamic> jsonExtract(
   return folly::none;
 }
 
+bool jsonExtractScalar(
+    folly::StringPiece json,
+    folly::StringPiece path,
+    folly::StringPiece& result,
+    std::string& scratch) {
+  const auto& compiled = compileScalarPath(folly::trimWhitespace(path));
+  if (!compiled.isValid || compiled.hasWildcard) {
+    // Invalid paths raise an error only for valid JSON, so they go through
+    // jsonExtract() like paths with '*'.
+    auto res = jsonExtract(json, path);
+    // Not a scalar value
+    if (!isScalarType(res)) {
+      return false;
+    }
+    scratch = scalarToString(*res);
+    result = scratch;
+    return true;
+  }
+  JsonScanner scanner(json, scratch);
+  return scanner.seek(compiled.steps) && scanner.readScalar(result);
+}
+
 folly::Optional<std::string> jsonExtractScalar(
     folly::StringPiece json,
     folly::StringPiece path) {
-  auto res = jsonExtract(json, path);
-  // Not a scalar value
-  if (isScalarType(res)) {
-    return res->asString();
+  std::string scratch;
+  folly::StringPiece result;
+  if (jsonExtractScalar(json, path, result, scratch)) {
+    return result.str();
   }
   return folly::none;
 }
@@ -206,12 +636,7 @@ folly::Optional<std::string> jsonExtractScalar(
 folly::Optional<std::string> jsonExtractScalar(
     const std::string& json,
     const std::string& path) {
-  auto res = jsonExtract(json, path);
-  // Not a scalar value
-  if (isScalarType(res)) {
-    return res->asString();
-  }
-  return folly::none;
+  return jsonExtractScalar(folly::StringPiece(json), folly::StringPiece(path));
 }
 
 } // namespace facebook::velox::functions
@@ -65,6 +65,18 @@ folly::Optional<std::string> jsonExtractScalar(
     folly::StringPiece json,
     folly::StringPiece path);
 
+/// Like jsonExtractScalar() above, but reads 'json' only up to the value at
+/// 'path' instead of parsing the whole document, and skips values off the
+/// path without parsing them. Sets 'result' to the value. 'result' points
+/// into 'json' or into 'scratch', which is reused across calls to avoid
+/// allocating per call. Returns false if there is no scalar at 'path' or
+/// the text before it is not valid JSON.
+bool jsonExtractScalar(
+    folly::StringPiece json,
+    folly::StringPiece path,
+    folly::StringPiece& result,
+    std::string& scratch);
+
 folly::Optional<folly::dynamic> jsonExtract(
     const std::string& json,
     const std::string& path);
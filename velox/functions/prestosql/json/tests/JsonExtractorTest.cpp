@@ -309,6 +309,71 @@ TEST(JsonExtractorTest, fullScalarTest) {
       "{\"15day\" : 0, \"30day\" : 1, \"90day\" : 2 }"s, "$[\"30day\"]"s, "1"s);
 }
 
+TEST(JsonExtractorTest, onDemandScalarTest) {
+  // Values before the path are skipped, including strings with brackets,
+  // quotes and escapes, and long values.
+  const auto longString = std::string(100, 'x');
+  EXPECT_SCALAR_VALUE_EQ(
+      "{\"a\": {\"b\": [1, \"]}\", {\"c\": \"\\\"{\"}]}, \"d\": 2}"s,
+      "$.d"s,
+      "2"s);
+  EXPECT_SCALAR_VALUE_EQ(
+      "[\"" + longString + "\\\\\", [[[\"" + longString + "\"]]], 3]",
+      "$[2]"s,
+      "3"s);
+  EXPECT_SCALAR_VALUE_EQ(
+      "{\"" + longString + "\": 1, \"a\": \"" + longString + "\"}",
+      "$.a"s,
+      longString);
+  EXPECT_SCALAR_VALUE_EQ(
+      " { \"a\" : [ 1 , { \"b\" : \"c\" } ] } "s, " $.a[1].b "s, "c"s);
+  // Escaped keys and values.
+  EXPECT_SCALAR_VALUE_EQ("{\"a\\nb\": 1}"s, "$[\"a\nb\"]"s, "1"s);
+  EXPECT_SCALAR_VALUE_EQ(
+      "{\"a\": \"x\\\"y\\\\z\\/\\t\"}"s, "$.a"s, "x\"y\\z/\t"s);
+  EXPECT_SCALAR_VALUE_EQ(
+      "{\"a\": \"\\u00e9\\ud834\\udd1e\"}"s, "$.a"s, "\u00e9\U0001D11E"s);
+  EXPECT_SCALAR_VALUE_NULL("{\"a\": \"\\ud834\"}"s, "$.a"s);
+  EXPECT_SCALAR_VALUE_NULL("{\"a\": \"\\x\"}"s, "$.a"s);
+  // Numbers and booleans are formatted like Presto does.
+  EXPECT_SCALAR_VALUE_EQ("{\"a\": 1.50}"s, "$.a"s, "1.5"s);
+  EXPECT_SCALAR_VALUE_EQ("{\"a\": 1e2}"s, "$.a"s, "100"s);
+  EXPECT_SCALAR_VALUE_EQ("{\"a\": -0}"s, "$.a"s, "0"s);
+  EXPECT_SCALAR_VALUE_EQ("{\"a\": true}"s, "$.a"s, "true"s);
+  EXPECT_SCALAR_VALUE_EQ("[false]"s, "$[0]"s, "false"s);
+  EXPECT_SCALAR_VALUE_EQ("[false]"s, "$[*]"s, "false"s);
+  EXPECT_SCALAR_VALUE_NULL("{\"a\": 1x}"s, "$.a"s);
+  // Malformed text before the value.
+  EXPECT_SCALAR_VALUE_NULL("{\"a\" 1, \"b\": 2}"s, "$.b"s);
+  EXPECT_SCALAR_VALUE_NULL("{\"a\": [1, 2, \"b\": 2}"s, "$.b"s);
+  EXPECT_SCALAR_VALUE_NULL("[1 2]"s, "$[1]"s);
+  EXPECT_SCALAR_VALUE_NULL("{\"a\": \"unterminated"s, "$.b"s);
+  EXPECT_SCALAR_VALUE_NULL(""s, "$"s);
+  // The first of duplicate keys is used.
+  EXPECT_SCALAR_VALUE_EQ("{\"a\": 1, \"a\": 2}"s, "$.a"s, "1"s);
+  EXPECT_SCALAR_VALUE_EQ(
+      "{\"a\": {\"b\": 1}, \"a\": {\"b\": 2}}"s, "$.a.b"s, "1"s);
+  EXPECT_SCALAR_VALUE_NULL("{\"a\": {\"c\": 1}, \"a\": {\"b\": 2}}"s, "$.a.b"s);
+  // Paths into scalars.
+  EXPECT_SCALAR_VALUE_NULL("{\"a\": 1}"s, "$.a.b"s);
+  EXPECT_SCALAR_VALUE_NULL("{\"a\": \"b\"}"s, "$.a[0]"s);
+  // Invalid paths still fail for valid JSON.
+  EXPECT_THROW(jsonExtractScalar("{}"s, "$.a."s), VeloxUserError);
+  EXPECT_SCALAR_VALUE_NULL("{"s, "$.a."s);
+
+  // The result points into the JSON text or the scratch string.
+  std::string scratch;
+  folly::StringPiece result;
+  std::string json = "{\"a\": \"abc\", \"b\": \"a\\tc\"}";
+  EXPECT_TRUE(jsonExtractScalar(json, "$.a", result, scratch));
+  EXPECT_EQ("abc", result);
+  EXPECT_TRUE(result.begin() >= json.data());
+  EXPECT_TRUE(result.end() <= json.data() + json.size());
+  EXPECT_TRUE(jsonExtractScalar(json, "$.b", result, scratch));
+  EXPECT_EQ("a\tc", result);
+  EXPECT_EQ(scratch.data(), result.data());
+}
+
 TEST(JsonExtractorTest, fullJsonValueTest) {
   EXPECT_JSON_VALUE_EQ("{}"s, "$"s, "{}"s);
   EXPECT_JSON_VALUE_EQ("{\"fuu\": {\"bar\": 1}}"s, "$.fuu"s, "{\"bar\":1}"s);
@@ -130,3 +130,118 @@ TEST_F(DateTimeFunctionsTest, millisecond) {
   EXPECT_EQ(123, millisecond(Timestamp(-1, 123000000)));
   EXPECT_EQ(12300, millisecond(Timestamp(-1, 12300000000)));
 }
+
+TEST_F(DateTimeFunctionsTest, dateTimeFields) {
+  const auto field = [&](const std::string& name,
+                         std::optional<Timestamp> timestamp) {
+    return evaluateOnce<int64_t>(name + "(c0)", timestamp);
+  };
+  // 2001-08-22 10:04:05.321 UTC, a Wednesday.
+  const Timestamp timestamp(998474645, 321000000);
+  EXPECT_EQ(2001, field("year", timestamp));
+  EXPECT_EQ(8, field("month", timestamp));
+  EXPECT_EQ(22, field("day", timestamp));
+  EXPECT_EQ(22, field("day_of_month", timestamp));
+  EXPECT_EQ(10, field("hour", timestamp));
+  EXPECT_EQ(3, field("day_of_week", timestamp));
+  EXPECT_EQ(3, field("dow", timestamp));
+
+  // 1969-12-31 23:59:59 UTC.
+  EXPECT_EQ(1969, field("year", Timestamp(-1, 0)));
+  EXPECT_EQ(12, field("month", Timestamp(-1, 0)));
+  EXPECT_EQ(31, field("day", Timestamp(-1, 0)));
+  EXPECT_EQ(23, field("hour", Timestamp(-1, 0)));
+  EXPECT_EQ(3, field("day_of_week", Timestamp(-1, 0)));
+  EXPECT_EQ(4, field("day_of_week", Timestamp(0, 0)));
+
+  // 2000-02-29 12:00:00 UTC, a Tuesday.
+  EXPECT_EQ(2, field("month", Timestamp(951825600, 0)));
+  EXPECT_EQ(29, field("day", Timestamp(951825600, 0)));
+  EXPECT_EQ(2, field("day_of_week", Timestamp(951825600, 0)));
+
+  EXPECT_EQ(std::nullopt, field("year", std::nullopt));
+}
+
+TEST_F(DateTimeFunctionsTest, dateTimeFieldsWithTimeZone) {
+  const auto field = [&](const std::string& name,
+                         const std::string& timeZone,
+                         std::optional<double> unixtime) {
+    return evaluateOnce<int64_t>(
+        fmt::format("{}(from_unixtime(c0, '{}'))", name, timeZone), unixtime);
+  };
+  // 2001-08-22 03:04:05.5 in Los Angeles, daylight saving time.
+  EXPECT_EQ(22, field("day", "America/Los_Angeles", 998474645.5));
+  EXPECT_EQ(3, field("hour", "America/Los_Angeles", 998474645.5));
+  // 2021-11-15 12:00:00 in Los Angeles, standard time.
+  EXPECT_EQ(12, field("hour", "America/Los_Angeles", 1637006400));
+  EXPECT_EQ(15, field("hour", "+05:30", 998474645.5));
+  EXPECT_EQ(2001, field("year", "-00:01", 998474645.5));
+  EXPECT_EQ(1969, field("year", "-00:01", 30));
+
+  // Time zones vary by row.
+  auto data = makeRowVector({
+      makeFlatVector<double>(
+          {998474645.5, 998474645.5, 998474645.5, 1637006400}),
+      makeFlatVector<StringView>(
+          {"America/Los_Angeles",
+           "+05:30",
+           "Asia/Kolkata",
+           "America/Los_Angeles"}),
+  });
+  auto result = evaluate<SimpleVector<int64_t>>(
+      "hour(from_unixtime(c0, c1))", data);
+  assertEqualVectors(makeFlatVector<int64_t>({3, 15, 15, 12}), result);
+}
+
+TEST_F(DateTimeFunctionsTest, dateTrunc) {
+  const auto dateTrunc = [&](const std::string& unit,
+                             std::optional<Timestamp> timestamp) {
+    return evaluateOnce<Timestamp>(
+        fmt::format("date_trunc('{}', c0)", unit), timestamp);
+  };
+  // 2001-08-22 10:04:05.321 UTC, a Wednesday.
+  const Timestamp timestamp(998474645, 321000000);
+  EXPECT_EQ(
+      Timestamp(998474645, 321000000), dateTrunc("millisecond", timestamp));
+  EXPECT_EQ(Timestamp(998474645, 0), dateTrunc("second", timestamp));
+  EXPECT_EQ(Timestamp(998474640, 0), dateTrunc("minute", timestamp));
+  EXPECT_EQ(Timestamp(998474400, 0), dateTrunc("hour", timestamp));
+  EXPECT_EQ(Timestamp(998438400, 0), dateTrunc("day", timestamp));
+  EXPECT_EQ(Timestamp(998265600, 0), dateTrunc("week", timestamp));
+  EXPECT_EQ(Timestamp(996624000, 0), dateTrunc("month", timestamp));
+  EXPECT_EQ(Timestamp(993945600, 0), dateTrunc("quarter", timestamp));
+  EXPECT_EQ(Timestamp(978307200, 0), dateTrunc("YEAR", timestamp));
+  EXPECT_EQ(Timestamp(-86400, 0), dateTrunc("day", Timestamp(-1, 0)));
+  EXPECT_EQ(std::nullopt, dateTrunc("day", std::nullopt));
+  EXPECT_THROW(dateTrunc("century", timestamp), VeloxUserError);
+}
+
+TEST_F(DateTimeFunctionsTest, dateTruncWithTimeZone) {
+  auto data = makeRowVector({
+      makeFlatVector<double>({998474645.5, 1637006400, 998474645.5}),
+      makeFlatVector<StringView>(
+          {"America/Los_Angeles", "America/Los_Angeles", "+05:30"}),
+  });
+  const auto dateTrunc = [&](const std::string& unit) {
+    auto result = evaluate<RowVector>(
+        fmt::format("date_trunc('{}', from_unixtime(c0, c1))", unit), data);
+    EXPECT_TRUE(isTimestampWithTimeZoneType(result->type()));
+    assertEqualVectors(
+        makeFlatVector<int16_t>({1825, 1825, 1170}), result->childAt(1));
+    return result->childAt(0);
+  };
+
+  assertEqualVectors(
+      makeFlatVector<int64_t>({998474645500, 1637006400000, 998474645500}),
+      dateTrunc("millisecond"));
+  // Midnight in Los Angeles is 07:00 UTC in August. Midnight in +05:30 is
+  // 18:30 UTC on the previous day.
+  assertEqualVectors(
+      makeFlatVector<int64_t>({998463600000, 1636963200000, 998418600000}),
+      dateTrunc("day"));
+  // 2021-11-01 is before the end of daylight saving time in Los Angeles, so
+  // the offset differs from the one of the input.
+  assertEqualVectors(
+      makeFlatVector<int64_t>({996649200000, 1635750000000, 996604200000}),
+      dateTrunc("month"));
+}
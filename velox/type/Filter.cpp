@@ -62,6 +62,9 @@ std::string Filter::toString() const {
     case FilterKind::kMultiRange:
       strKind = "MultiRange";
       break;
+    case FilterKind::kTimestampRange:
+      strKind = "TimestampRange";
+      break;
   };
 
   return fmt::format(
@@ -96,6 +99,16 @@ bool BigintValuesUsingBitmask::testInt64(int64_t value) const {
   return bitmask_[value - min_];
 }
 
+std::vector<int64_t> BigintValuesUsingBitmask::values() const {
+  std::vector<int64_t> result;
+  for (int64_t i = 0; i < bitmask_.size(); ++i) {
+    if (bitmask_[i]) {
+      result.push_back(min_ + i);
+    }
+  }
+  return result;
+}
+
 bool BigintValuesUsingBitmask::testInt64Range(
     int64_t min,
     int64_t max,
@@ -165,6 +178,19 @@ bool BigintValuesUsingHashTable::testInt64(int64_t value) const {
   return false;
 }
 
+std::vector<int64_t> BigintValuesUsingHashTable::values() const {
+  std::vector<int64_t> result;
+  for (auto value : hashTable_) {
+    if (value != kEmptyMarker) {
+      result.push_back(value);
+    }
+  }
+  if (containsEmptyMarker_) {
+    result.push_back(kEmptyMarker);
+  }
+  return result;
+}
+
 bool BigintValuesUsingHashTable::testInt64Range(
     int64_t min,
     int64_t max,
@@ -847,4 +873,31 @@ std::unique_ptr<Filter> BigintMultiRange::mergeWith(const Filter* other) const {
       VELOX_UNREACHABLE();
   }
 }
+
+std::unique_ptr<Filter> TimestampRange::mergeWith(const Filter* other) const {
+  switch (other->kind()) {
+    case FilterKind::kAlwaysTrue:
+    case FilterKind::kAlwaysFalse:
+    case FilterKind::kIsNull:
+      return other->mergeWith(this);
+    case FilterKind::kIsNotNull:
+      return std::make_unique<TimestampRange>(lower_, upper_, false);
+    case FilterKind::kTimestampRange: {
+      bool bothNullAllowed = nullAllowed_ && other->testNull();
+
+      auto otherRange = static_cast<const TimestampRange*>(other);
+
+      auto lower = std::max(lower_, otherRange->lower_);
+      auto upper = std::min(upper_, otherRange->upper_);
+
+      if (lower <= upper) {
+        return std::make_unique<TimestampRange>(lower, upper, bothNullAllowed);
+      }
+
+      return nullOrFalse(bothNullAllowed);
+    }
+    default:
+      VELOX_UNREACHABLE();
+  }
+}
 } // namespace facebook::velox::common
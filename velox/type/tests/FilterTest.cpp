@@ -627,6 +627,42 @@ TEST(FilterTest, multiRangeWithNaNs) {
   EXPECT_TRUE(filter->testDouble(1.3));
 }
 
+TEST(FilterTest, timestampRange) {
+  auto filter = std::make_unique<TimestampRange>(
+      Timestamp(100, 500), Timestamp(200, 0), false);
+  EXPECT_FALSE(filter->testNull());
+  EXPECT_FALSE(filter->testTimestamp(Timestamp(100, 499)));
+  EXPECT_TRUE(filter->testTimestamp(Timestamp(100, 500)));
+  EXPECT_TRUE(filter->testTimestamp(Timestamp(150, 999'999'999)));
+  EXPECT_TRUE(filter->testTimestamp(Timestamp(200, 0)));
+  EXPECT_FALSE(filter->testTimestamp(Timestamp(200, 1)));
+  EXPECT_TRUE(applyFilter(*filter, Timestamp(120, 0)));
+
+  auto withNulls = filter->clone(true);
+  EXPECT_TRUE(withNulls->testNull());
+  EXPECT_TRUE(withNulls->testTimestamp(Timestamp(100, 500)));
+
+  auto merged = filter->mergeWith(
+      std::make_unique<TimestampRange>(
+          Timestamp(150, 0), Timestamp(300, 0), true)
+          .get());
+  ASSERT_EQ(FilterKind::kTimestampRange, merged->kind());
+  EXPECT_FALSE(merged->testNull());
+  EXPECT_FALSE(merged->testTimestamp(Timestamp(149, 999'999'999)));
+  EXPECT_TRUE(merged->testTimestamp(Timestamp(150, 0)));
+  EXPECT_TRUE(merged->testTimestamp(Timestamp(200, 0)));
+  EXPECT_FALSE(merged->testTimestamp(Timestamp(200, 1)));
+
+  merged = filter->mergeWith(
+      std::make_unique<TimestampRange>(
+          Timestamp(300, 0), Timestamp(400, 0), false)
+          .get());
+  EXPECT_EQ(FilterKind::kAlwaysFalse, merged->kind());
+
+  EXPECT_TRUE(isNotNull()->testTimestamp(Timestamp(1, 0)));
+  EXPECT_FALSE(isNull()->testTimestamp(Timestamp(1, 0)));
+}
+
 TEST(FilterTest, createBigintValues) {
   // Small number of values from a very large range.
   {
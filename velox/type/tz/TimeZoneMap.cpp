@@ -16,7 +16,11 @@
 
 #include "velox/type/tz/TimeZoneMap.h"
 #include <fmt/core.h>
+#include <chrono>
+#include <limits>
+#include <optional>
 #include <unordered_map>
+#include "velox/external/date/tz.h"
 
 namespace facebook::velox::util {
 
@@ -57,4 +61,46 @@ int64_t getTimeZoneID(std::string_view timeZone) {
   return it->second;
 }
 
+namespace {
+// Returns the offset in seconds of a fixed offset time zone name like
+// "+05:30", or std::nullopt if 'name' is not one.
+std::optional<int64_t> parseFixedOffset(const std::string& name) {
+  if (name.size() != 6 || (name[0] != '+' && name[0] != '-') ||
+      name[3] != ':') {
+    return std::nullopt;
+  }
+  for (auto i : {1, 2, 4, 5}) {
+    if (name[i] < '0' || name[i] > '9') {
+      return std::nullopt;
+    }
+  }
+  int64_t hours = (name[1] - '0') * 10 + (name[2] - '0');
+  int64_t minutes = (name[4] - '0') * 10 + (name[5] - '0');
+  int64_t offset = hours * 3'600 + minutes * 60;
+  return name[0] == '-' ? -offset : offset;
+}
+} // namespace
+
+void TimeZoneOffsetCache::lookup(
+    int64_t timeZoneID,
+    int64_t seconds,
+    Entry& entry) {
+  if (!entry.zone) {
+    auto name = getTimeZoneName(timeZoneID);
+    if (auto offset = parseFixedOffset(name)) {
+      entry.begin = std::numeric_limits<int64_t>::min();
+      entry.end = std::numeric_limits<int64_t>::max();
+      entry.offset = offset.value();
+      return;
+    }
+    // Throws std::runtime_error if the time zone is not found.
+    entry.zone = date::locate_zone(name);
+  }
+  auto info =
+      entry.zone->get_info(date::sys_seconds(std::chrono::seconds(seconds)));
+  entry.begin = info.begin.time_since_epoch().count();
+  entry.end = info.end.time_since_epoch().count();
+  entry.offset = info.offset.count();
+}
+
 } // namespace facebook::velox::util
@@ -17,6 +17,11 @@
 #pragma once
 
 #include <string>
+#include <unordered_map>
+
+namespace date {
+class time_zone;
+}
 
 namespace facebook::velox::util {
 
@@ -26,4 +31,40 @@ std::string getTimeZoneName(int64_t timeZoneID);
 // Returns the timeZoneID for the timezone name.
 int64_t getTimeZoneID(std::string_view timeZone);
 
+// Returns offsets from UTC of time zones at given times. Remembers for each
+// time zone the interval between offset transitions around the last lookup,
+// so that timestamps close in time resolve without searching the time zone
+// database. Not thread safe; meant to be used for one batch of rows.
+class TimeZoneOffsetCache {
+ public:
+  // Returns the offset from UTC in seconds of 'timeZoneID' at 'seconds' since
+  // epoch in UTC.
+  int64_t offsetSeconds(int64_t timeZoneID, int64_t seconds) {
+    if (timeZoneID != lastTimeZoneID_) {
+      last_ = &entries_[timeZoneID];
+      lastTimeZoneID_ = timeZoneID;
+    }
+    if (seconds < last_->begin || seconds >= last_->end) {
+      lookup(timeZoneID, seconds, *last_);
+    }
+    return last_->offset;
+  }
+
+ private:
+  struct Entry {
+    // Null for fixed offset time zones.
+    const date::time_zone* zone{nullptr};
+    // The offset applies to [begin, end). Empty until the first lookup.
+    int64_t begin{0};
+    int64_t end{0};
+    int64_t offset{0};
+  };
+
+  void lookup(int64_t timeZoneID, int64_t seconds, Entry& entry);
+
+  std::unordered_map<int64_t, Entry> entries_;
+  int64_t lastTimeZoneID_{-1};
+  Entry* last_{nullptr};
+};
+
 } // namespace facebook::velox::util
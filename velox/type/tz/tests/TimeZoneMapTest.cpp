@@ -38,5 +38,24 @@ TEST(TimeZoneMapTest, invalid) {
   EXPECT_THROW(getTimeZoneID("This is a test"), std::runtime_error);
 }
 
+TEST(TimeZoneMapTest, offsetCache) {
+  TimeZoneOffsetCache cache;
+  // 2021-01-15 and 2021-07-15 00:00:00 UTC.
+  const int64_t winter = 1610668800;
+  const int64_t summer = 1626307200;
+
+  EXPECT_EQ(-8 * 3'600, cache.offsetSeconds(1825, winter));
+  EXPECT_EQ(-7 * 3'600, cache.offsetSeconds(1825, summer));
+  EXPECT_EQ(-8 * 3'600, cache.offsetSeconds(1825, winter + 60));
+  EXPECT_EQ(3 * 3'600, cache.offsetSeconds(2079, summer));
+  EXPECT_EQ(-7 * 3'600, cache.offsetSeconds(1825, summer - 60));
+
+  EXPECT_EQ(5 * 3'600 + 30 * 60, cache.offsetSeconds(1170, winter));
+  EXPECT_EQ(-60, cache.offsetSeconds(840, summer));
+  EXPECT_EQ(-14 * 3'600, cache.offsetSeconds(1, 0));
+
+  EXPECT_THROW(cache.offsetSeconds(0, winter), std::runtime_error);
+}
+
 } // namespace
 } // namespace facebook::velox::util
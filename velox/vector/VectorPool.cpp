@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/vector/VectorPool.h"
+#include "velox/vector/SimpleVector.h"
+
+namespace facebook::velox {
+
+namespace {
+// Returns true if 'vector' carries statistics about its content, which would
+// be wrong after reuse.
+template <TypeKind kind>
+bool hasStats(const BaseVector& vector) {
+  using T = typename TypeTraits<kind>::NativeType;
+  auto simple = vector.asUnchecked<SimpleVector<T>>();
+  return simple->getMin().has_value() || simple->getMax().has_value() ||
+      simple->isSorted().has_value() ||
+      vector.getDistinctValueCount().has_value() ||
+      vector.storageBytes().has_value() ||
+      vector.representedBytes().has_value();
+}
+} // namespace
+
+VectorPtr VectorPool::get(const TypePtr& type, vector_size_t size) {
+  ++stats_.numGets;
+  auto kindIndex = static_cast<int32_t>(type->kind());
+  if (kindIndex < kNumKinds && !vectors_[kindIndex].empty()) {
+    auto vector = std::move(vectors_[kindIndex].back());
+    vectors_[kindIndex].pop_back();
+    ++stats_.numHits;
+    vector->resize(size);
+    return vector;
+  }
+  return BaseVector::create(type, size, pool_);
+}
+
+bool VectorPool::release(VectorPtr& vector) {
+  if (!vector || !BaseVector::isReusableFlatVector(vector) ||
+      vector->pool() != pool_ || !vector->type()->isFixedWidth()) {
+    return false;
+  }
+  auto kindIndex = static_cast<int32_t>(vector->typeKind());
+  if (kindIndex >= kNumKinds || vectors_[kindIndex].size() >= kMaxPerKind) {
+    return false;
+  }
+  auto& values = vector->values();
+  if (!values || values->capacity() > kMaxBytes) {
+    return false;
+  }
+  if (VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH(
+          hasStats, vector->typeKind(), *vector)) {
+    return false;
+  }
+  vector->resetNulls();
+  vector->resize(0);
+  vectors_[kindIndex].push_back(std::move(vector));
+  vector = nullptr;
+  ++stats_.numReleases;
+  return true;
+}
+
+size_t VectorPool::release(std::vector<VectorPtr>& vectors) {
+  size_t numReleased = 0;
+  for (auto& vector : vectors) {
+    numReleased += release(vector);
+  }
+  return numReleased;
+}
+
+} // namespace facebook::velox
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "velox/vector/BaseVector.h"
+
+namespace facebook::velox {
+
+/// Keeps singly referenced flat vectors of fixed-width types for reuse, so
+/// that their buffers do not go back to the MemoryPool after each batch only
+/// to be allocated again for the next one. Vectors are recycled by type kind
+/// and grown on reuse if too small. Not thread-safe. There is one per thread
+/// of execution, see core::ExecCtx.
+class VectorPool {
+ public:
+  struct Stats {
+    // Number of calls to get().
+    int64_t numGets{0};
+    // Number of calls to get() that returned a recycled vector.
+    int64_t numHits{0};
+    // Number of vectors taken by release().
+    int64_t numReleases{0};
+  };
+
+  explicit VectorPool(memory::MemoryPool* pool) : pool_(pool) {}
+
+  /// Returns a flat vector of 'type' with 'size' rows and no nulls. Values
+  /// are not initialized. Reuses a released vector if one is available.
+  VectorPtr get(const TypePtr& type, vector_size_t size);
+
+  /// Takes 'vector' for reuse if it is a singly referenced flat vector of a
+  /// fixed-width type with singly referenced buffers from the pool of 'this'.
+  /// Sets 'vector' to nullptr and returns true if taken.
+  bool release(VectorPtr& vector);
+
+  /// Calls release() on each element of 'vectors'. Returns the number of
+  /// vectors taken.
+  size_t release(std::vector<VectorPtr>& vectors);
+
+  const Stats& stats() const {
+    return stats_;
+  }
+
+ private:
+  // Max number of vectors kept per type kind.
+  static constexpr int32_t kMaxPerKind = 10;
+
+  // Vectors with larger values buffers are not kept so as not to pin
+  // memory.
+  static constexpr uint64_t kMaxBytes = 1 << 20;
+
+  // Fixed-width kinds are BOOLEAN to DOUBLE and TIMESTAMP.
+  static constexpr int32_t kNumKinds =
+      static_cast<int32_t>(TypeKind::TIMESTAMP) + 1;
+
+  memory::MemoryPool* const pool_;
+
+  // Recycled vectors indexed by TypeKind.
+  std::array<std::vector<VectorPtr>, kNumKinds> vectors_;
+
+  Stats stats_;
+};
+
+} // namespace facebook::velox
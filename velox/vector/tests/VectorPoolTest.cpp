@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/vector/VectorPool.h"
+#include <gtest/gtest.h>
+#include "velox/vector/FlatVector.h"
+
+using namespace facebook::velox;
+
+class VectorPoolTest : public testing::Test {
+ protected:
+  std::unique_ptr<memory::ScopedMemoryPool> pool_{
+      memory::getDefaultScopedMemoryPool()};
+};
+
+TEST_F(VectorPoolTest, reuse) {
+  VectorPool vectorPool(pool_.get());
+  auto vector = vectorPool.get(BIGINT(), 100);
+  ASSERT_EQ(100, vector->size());
+  ASSERT_EQ(TypeKind::BIGINT, vector->typeKind());
+  vector->setNull(5, true);
+  auto* values = vector->values().get();
+
+  ASSERT_TRUE(vectorPool.release(vector));
+  ASSERT_EQ(nullptr, vector);
+
+  // A vector of another kind is newly allocated.
+  auto other = vectorPool.get(INTEGER(), 10);
+  EXPECT_EQ(TypeKind::INTEGER, other->typeKind());
+
+  // The released vector comes back without nulls and with the same values
+  // buffer.
+  auto reused = vectorPool.get(BIGINT(), 50);
+  EXPECT_EQ(50, reused->size());
+  EXPECT_EQ(values, reused->values().get());
+  EXPECT_FALSE(reused->mayHaveNulls());
+
+  // Grows on reuse.
+  ASSERT_TRUE(vectorPool.release(reused));
+  reused = vectorPool.get(BIGINT(), 10'000);
+  EXPECT_EQ(10'000, reused->size());
+  reused->asFlatVector<int64_t>()->set(9'999, 1);
+
+  auto& stats = vectorPool.stats();
+  EXPECT_EQ(4, stats.numGets);
+  EXPECT_EQ(2, stats.numHits);
+  EXPECT_EQ(2, stats.numReleases);
+}
+
+TEST_F(VectorPoolTest, notReusable) {
+  VectorPool vectorPool(pool_.get());
+
+  // Shared vector.
+  auto vector = vectorPool.get(DOUBLE(), 100);
+  auto copy = vector;
+  EXPECT_FALSE(vectorPool.release(vector));
+  EXPECT_NE(nullptr, vector);
+  copy.reset();
+
+  // Shared values buffer.
+  auto values = vector->values();
+  EXPECT_FALSE(vectorPool.release(vector));
+  values.reset();
+  EXPECT_TRUE(vectorPool.release(vector));
+
+  // Variable width type.
+  vector = BaseVector::create(VARCHAR(), 100, pool_.get());
+  EXPECT_FALSE(vectorPool.release(vector));
+
+  // Vector from another pool.
+  auto otherPool = memory::getDefaultScopedMemoryPool();
+  vector = BaseVector::create(DOUBLE(), 100, otherPool.get());
+  EXPECT_FALSE(vectorPool.release(vector));
+
+  EXPECT_EQ(1, vectorPool.stats().numReleases);
+}